@@ -288,6 +288,10 @@ void ArithCodec::startInputtingBits(void)
 {
   inGarbage = 0;	//Number of bytes read past end of file
   inBitPtr = 0;		//No valid bits yet in input buffer
+
+#ifdef FRUGAL_BITS
+  firstMessage = 1;	//No excess bits of the previous message
+#endif
 }
 
 
@@ -447,6 +451,9 @@ void ArithCodec::arithmeticEncode(FreqValue low, FreqValue high, FreqValue total
  The following code describes this function (The actual code is only written less legibly to improve speed, including storing the ratio in_r = R/total for use by arithmeticDecode()):
 
  \code
+ DECODE_RENORMALISE;		//Expand code range and input bits
+ 				//(postponed from the previous symbol)
+
  target = D / (R / total);	//D = V - L.  (Old terminology)
  				//D is the location within the range R
  				//that the code value is located
@@ -471,6 +478,8 @@ void ArithCodec::arithmeticEncode(FreqValue low, FreqValue high, FreqValue total
 FreqValue ArithCodec::arithmeticDecodeTarget(FreqValue total)
 {
   FreqValue target;
+
+  DECODE_RENORMALISE;
     
 #ifdef MULT_DIV
   in_r = in_R/total;
@@ -539,9 +548,9 @@ FreqValue ArithCodec::arithmeticDecodeTarget(FreqValue total)
    R = (high-low) * (R/total);	//Adjust range
  else
    R -= low * (R / total);	//End of range is a special case
- 
- DECODE_RENORMALISE;		//Expand code range and input bits
  \endcode
+
+ The range is expanded and the code bits are input only when the next symbol is decoded (or when the decoding is finished), so the bits are not read before they are needed. The number of bytes needed for that is returned by inputBytesNeeded().
  \par
 
  \param low Low bound of the subinterval.
@@ -590,8 +599,6 @@ void ArithCodec::arithmeticDecode(FreqValue low, FreqValue high, FreqValue total
       in_R -= temp;
   }
 #endif //shifts vs multiply
-
-  DECODE_RENORMALISE;
 }
 
 
@@ -710,6 +717,8 @@ void ArithCodec::finishDecode(void)
   unsigned int nbits, i;
   CodeValue roundup, bits, value;
   CodeValue in_L;
+
+  DECODE_RENORMALISE;
   
   //This gets us either the real L, or L + Half.  Either way, we can work
   //out the number of bit emitted by the encoder
@@ -747,14 +756,46 @@ CodeValue ArithCodec::retrieveExcessInputBits(void)
 #else
 
 /*!
- Throw away B_BITS in buffer by doing nothing (encoder wrote these for us to consume). They were mangled anyway as we only kept V - L, and cannot get back to V.
+ Throw away B_BITS in buffer by doing nothing (encoder wrote these for us to consume). They were mangled anyway as we only kept V - L, and cannot get back to V. Only the expansion of the range postponed from the last symbol is done.
  */
 void ArithCodec::finishDecode(void)
 {
-  //No action
+  DECODE_RENORMALISE;
 }
 #endif
 
+
+
+/*!
+  The decoder inputs the code bits only when it expands its range, which is postponed until the next symbol is decoded. The number of the bits input by the expansion is known in advance, so the caller can check whether the input data are available before the next symbol is decoded (useful when the compressed data arrive in chunks).
+
+  \param extraBits The number of bits needed in addition to the expansion of the range (e.g. up to 3 bits read by finishDecode()).
+
+  \return The number of bytes that have to be read from the input device.
+ */
+size_t ArithCodec::inputBytesNeeded(unsigned int extraBits = 0)
+{
+  CodeValue r = in_R;
+  unsigned int bits = extraBits;
+  unsigned int bufferedBits = 0;
+
+  //the bits input by the expansion of the range
+  while (r <= Quarter)
+    {
+      r <<= 1;
+      bits++;
+    }
+
+  //the bits still available in the input buffer
+  for (unsigned char ptr = inBitPtr; ptr; ptr >>= 1)
+    bufferedBits++;
+
+  if (bits <= bufferedBits)
+    return 0;
+  else
+    return (bits - bufferedBits + BYTE_SIZE - 1) / BYTE_SIZE;
+}
+
 size_t ArithCodec::numberOfOutputBytes(void)
 {
   return numberOfBytes;
@@ -138,6 +138,9 @@ public:
   //! Return the number of output bytes.
   virtual size_t numberOfOutputBytes(void);
 
+  //! Return the number of input bytes needed by the decoder before the next symbol.
+  virtual size_t inputBytesNeeded(unsigned int extraBits = 0);
+
 protected:
   // Input decoding state
 
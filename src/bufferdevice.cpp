@@ -0,0 +1,307 @@
+/***************************************************************************
+    bufferdevice.cpp  -  Definitions of BufferDevice class methods.
+                             -------------------
+    begin                : October 19 2026
+    copyright            : (C) 2003 by Vojtch Toman
+    email                : vtoman@lit.cz
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+
+/*!
+  \file bufferdevice.cpp
+  \brief Definitions of BufferDevice class methods.
+  
+  This file contains the definitions of BufferDevice class methods.
+*/
+
+
+#ifdef __GNUG__
+# pragma implementation
+#endif
+
+
+#include <cstring>	//for memcpy(), memmove()
+
+#include "bufferdevice.h"
+
+
+
+/*!
+  Allocates the buffer. The device is prepared immediately.
+ */
+BufferDevice::BufferDevice(void)
+  : IODevice()
+{
+  bufferSize = BUFFER_DEVICE_INITIAL_SIZE;
+  NEW(buffer, char[bufferSize]);
+
+  readPos = 0;
+  writePos = 0;
+  bReadTotal = 0;
+  bRead = 0;
+  bWritten = 0;
+  eofReached = false;
+
+  prepared = true;
+}
+
+
+
+/*!
+  Deletes the buffer.
+ */
+BufferDevice::~BufferDevice(void)
+{
+  DELETE_ARRAY(buffer);
+}
+
+
+
+/*!
+  Prepares the device for work.
+ */
+void BufferDevice::prepare(void) throw (ExaltIOException)
+{
+  prepared = true;
+}
+
+
+
+/*!
+  There are no data to be flushed.
+ */
+void BufferDevice::flush(void) throw (ExaltIOException)
+{
+}
+
+
+
+/*!
+  Ends the work with the device. The unread data are discarded. An attempt to work with finished device will cause an ExaltIOException to be raised.
+ */
+void BufferDevice::finish(void) throw (ExaltIOException)
+{
+  prepared = false;
+  readPos = 0;
+  writePos = 0;
+}
+
+
+
+/*!
+  Reads up to \a length bytes. If there is less data in the buffer, all of them are read and the end of file is reported.
+
+  \param buf Pointer to the buffer.
+  \param length Length of the buffer.
+
+  \return State of the device after the read operation.
+ */
+IOState BufferDevice::readData(char *buf, IOSize length) throw (ExaltIOException)
+{
+  if (!isPrepared())
+    throw ExaltDeviceNotPreparedIOException();
+
+  bRead = writePos - readPos;
+
+  if (bRead > length)
+    bRead = length;
+
+  memcpy(buf, buffer + readPos, bRead);
+  readPos += bRead;
+  bReadTotal += bRead;
+
+  eofReached = (bRead < length);
+
+  return eofReached ? EndOfFile : ReadOk;
+}
+
+
+
+/*!
+  Reads one character.
+
+  \param c Pointer where the read character is stored.
+
+  \return State of the device after the read operation.
+ */
+IOState BufferDevice::getChar(int *c) throw (ExaltIOException)
+{
+  if (!isPrepared())
+    throw ExaltDeviceNotPreparedIOException();
+
+  if (readPos == writePos)
+    {
+      bRead = 0;
+      eofReached = true;
+      return EndOfFile;
+    }
+
+  *c = (unsigned char)buffer[readPos++];
+  bRead = 1;
+  bReadTotal++;
+  eofReached = false;
+
+  return ReadOk;
+}
+
+
+
+/*!
+  The data are appended to the buffer.
+
+  \param buf Pointer to the buffer.
+  \param length Length of the buffer.
+
+  \return State of the device after the write operation.
+ */
+IOState BufferDevice::writeData(const char *buf, IOSize length) throw (ExaltIOException)
+{
+  if (!isPrepared())
+    throw ExaltDeviceNotPreparedIOException();
+
+  reserve(length);
+
+  memcpy(buffer + writePos, buf, length);
+  writePos += length;
+  bWritten += length;
+
+  return WriteOk;
+}
+
+
+
+/*!
+  The character is appended to the buffer.
+
+  \param c The character.
+
+  \return State of the device after the write operation.
+ */
+IOState BufferDevice::putChar(int c) throw (ExaltIOException)
+{
+  if (!isPrepared())
+    throw ExaltDeviceNotPreparedIOException();
+
+  reserve(1);
+
+  buffer[writePos++] = (char)c;
+  bWritten++;
+
+  return WriteOk;
+}
+
+
+
+/*!
+  Returns the total number of bytes read from the device.
+
+  \return Number of bytes.
+ */
+IOSize BufferDevice::bytesReadTotal(void)
+{
+  return bReadTotal;
+}
+
+
+
+/*!
+  Returns the number of bytes read from the device by the last read operation.
+
+  \return Number of bytes.
+ */
+IOSize BufferDevice::bytesRead(void)
+{
+  return bRead;
+}
+
+
+
+/*!
+  Returns the total number of bytes written to the device.
+  
+  \return Number of bytes.
+ */
+IOSize BufferDevice::bytesWritten(void)
+{
+  return bWritten;
+}
+
+
+
+/*!
+  No errors can occur.
+
+  \retval FALSE Always.
+ */
+bool BufferDevice::errorOccurred(void)
+{
+  return false;
+}
+
+
+
+/*!
+  \retval TRUE The last read operation reached the end of the data in the buffer.
+  \retval FALSE Otherwise.
+ */
+bool BufferDevice::eof(void)
+{
+  return eofReached;
+}
+
+
+
+/*!
+  \return Number of bytes written to the device, but not read yet.
+ */
+IOSize BufferDevice::bytesAvailable(void)
+{
+  return writePos - readPos;
+}
+
+
+
+/*!
+  The unread data are moved to the beginning of the buffer. If there is still not enough space, the buffer is enlarged.
+
+  \param length The number of bytes to be written.
+ */
+void BufferDevice::reserve(IOSize length)
+{
+  IOSize available = writePos - readPos;
+
+  if (writePos + length <= bufferSize)
+    return;
+
+  if (available + length > bufferSize)
+    {
+      //enlarge the buffer
+      char *newBuffer;
+      IOSize newSize = bufferSize;
+
+      while (available + length > newSize)
+	newSize *= 2;
+
+      NEW(newBuffer, char[newSize]);
+      memcpy(newBuffer, buffer + readPos, available);
+      DELETE_ARRAY(buffer);
+
+      buffer = newBuffer;
+      bufferSize = newSize;
+    }
+  else
+    //reuse the space of the data already read
+    memmove(buffer, buffer + readPos, available);
+
+  readPos = 0;
+  writePos = available;
+}
@@ -0,0 +1,134 @@
+/***************************************************************************
+    bufferdevice.h  -  Definition of the BufferDevice class.
+                             -------------------
+    begin                : October 19 2026
+    copyright            : (C) 2003 by Vojtch Toman
+    email                : vtoman@lit.cz
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+
+/*!
+  \file bufferdevice.h
+  \brief Definition of the BufferDevice class.
+  
+  This file contains the definition of the BufferDevice class.
+*/
+
+
+#ifndef BUFFERDEVICE_H
+#define BUFFERDEVICE_H
+
+#ifdef __GNUG__
+# pragma interface
+#endif
+
+
+#include "iodevice.h"
+#include "defs.h"
+
+
+/*!
+  \brief The initial size of the buffer of BufferDevice.
+ */
+#define BUFFER_DEVICE_INITIAL_SIZE	4096
+
+
+
+/*!
+  \brief A device that passes the data through a memory buffer.
+
+  The data written to the device are appended to the buffer and they are read from the device in the same order. The buffer grows as needed; the space of the data already read is reused. If the buffer is empty, the read operations result in the end of file (but the data written later can be read again).
+
+  The device is used by the PUSH decoder, which receives the compressed data in chunks.
+
+  \sa IODevice, FunnelDevice.
+ */
+class BufferDevice : public IODevice
+{
+public:
+  //! A constructor.
+  BufferDevice(void);
+
+  //! A destructor.
+  virtual ~BufferDevice(void);
+
+  //! Prepare the device.
+  virtual void prepare(void) throw (ExaltIOException);
+
+  //! Flush the device (does nothing).
+  virtual void flush(void) throw (ExaltIOException);
+
+  //! Finish the work with the device.
+  virtual void finish(void) throw (ExaltIOException);
+
+  //! Read up to the specified number of bytes into the buffer.
+  virtual IOState readData(char *buf, IOSize length) throw (ExaltIOException);
+
+  //! Read one char.
+  virtual IOState getChar(int *) throw (ExaltIOException);
+
+  //! Write the specified number of bytes from the buffer.
+  virtual IOState writeData(const char *buf, IOSize length) throw (ExaltIOException);
+
+  //! Write one char.
+  virtual IOState putChar(int) throw (ExaltIOException);
+
+  //! Return the number of bytes read so far.
+  virtual IOSize bytesReadTotal(void);
+
+  //! Return the number of bytes read by the last read operation.
+  virtual IOSize bytesRead(void);
+
+  //! Return the number of bytes written so far.
+  virtual IOSize bytesWritten(void);
+
+  //! Informs about an error.
+  virtual bool errorOccurred(void);
+
+  //! Informs about an end of file.
+  virtual bool eof(void);
+
+  //! Return the number of bytes which can be read.
+  virtual IOSize bytesAvailable(void);
+
+protected:
+  //! The buffer.
+  char *buffer;
+
+  //! The size of the buffer.
+  IOSize bufferSize;
+
+  //! The position of the first unread byte.
+  IOSize readPos;
+
+  //! The position after the last written byte.
+  IOSize writePos;
+
+  //! The total number of bytes read.
+  IOSize bReadTotal;
+
+  //! The number of bytes read by the last read operation.
+  IOSize bRead;
+
+  //! The total number of bytes written.
+  IOSize bWritten;
+
+  //! Indication whether the last read operation reached the end of the data.
+  bool eofReached;
+
+  //! Make room for \a length more bytes.
+  virtual void reserve(IOSize length);
+};
+
+
+
+#endif //BUFFERDEVICE_H
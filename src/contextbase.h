@@ -59,6 +59,9 @@ public:
   //! A constructor.
   ContextBase(void) { initialized = false; }
 
+  //! A destructor.
+  virtual ~ContextBase(void) {}
+
   //! An enum with results of some contex operations.
   enum OperationResult
   {
@@ -46,6 +46,10 @@
 #define DEFAULT_FILE_SUFFIX	".e"
 
 
+//! The default path of the elements searched by the query (the children of the root element).
+#define DEFAULT_QUERY_PATH	"/*/*"
+
+
 
 /*!
   \brief The stamp stored in compressed files.
@@ -131,6 +135,48 @@ enum UserAction
     Exalt will check if the input XML data is well-formed.
   */
   WellFormed,
+
+  /*!
+    \brief Create a dictionary.
+
+    Exalt will create a pre-trained dictionary from the specified training documents.
+  */
+  Train,
+
+  /*!
+    \brief Create a solid archive.
+
+    Exalt will compress the specified input documents into one solid archive.
+  */
+  CreateArchive,
+
+  /*!
+    \brief List a solid archive.
+
+    Exalt will display the members of a solid archive.
+  */
+  ListArchive,
+
+  /*!
+    \brief Extract a solid archive.
+
+    Exalt will extract the (specified) members of a solid archive.
+  */
+  ExtractArchive,
+
+  /*!
+    \brief Append to a solid archive.
+
+    Exalt will append the files to an existing solid archive.
+  */
+  AppendArchive,
+
+  /*!
+    \brief Query the compressed data.
+
+    Exalt will count or display the elements of the compressed documents matching a path (and containing a text pattern).
+  */
+  Query,
 };
 
 
@@ -83,6 +83,7 @@
   _tr_->node = _to_;							\
 									\
   ((ElementModel::Node *)_from_)->successors.append(_tr_);		\
+  transitionCounter++;							\
 }
 
 
@@ -118,6 +119,7 @@
   _node_->modeler = _modeler_;					\
   _node_->id = nodeCounter;					\
   _node_->mpt = 0;						\
+  _node_->reachable = false;					\
   nodeList.append(_node_);					\
   nodeCounter++;						\
   _node_->successors.setAutoDelete(true);			\
@@ -212,13 +214,19 @@
 
 /*!
   An initialization is performed.
+
+  \param name The name of the element.
+  \param graphLimit The maximal size of the graph (the number of nodes plus the number of transitions), 0 if not limited (see prune()).
 */
-ElementModeler::ElementModeler(XmlChar *name)
+ElementModeler::ElementModeler(XmlChar *name, size_t graphLimit)
 {
   elementName = name;
   nodeCounter = 0;
   refCount = 1;
   structuralEntropy = 0;
+  compiled = false;
+  transitionCounter = 0;
+  limit = graphLimit;
 
   CREATE_GRAPH_NODE(0, startNode, ElementModel::StartNode, this);
   CREATE_GRAPH_NODE(0, endNode, ElementModel::EndNode, this);
@@ -240,11 +248,12 @@ ElementModeler::~ElementModeler(void)
 
 
 /*!
-  Computes the structural entropy of the model.
+  Computes the structural entropy of the model. The entropy of the compiled graphs (see compile()) is not computed, since they may contain cycles.
 */
 void ElementModeler::computeStructuralEntropy(void)
 {
-  structuralEntropy = ElementModelEntropyCalculator::calculate(this);
+  if (!compiled)
+    structuralEntropy = ElementModelEntropyCalculator::calculate(this);
 }
 
 
@@ -321,6 +330,10 @@ ElementModel::TransitionState ElementModeler::moveToDesiredNode(ElementModel::No
       //there is no transition of desired type --> we need to create it
       ElementModel::Node *newNode;
 
+      if (limit && nodeList.count() + transitionCounter >= limit)
+	//the graph is too large --> forget its rarely used parts
+	prune();
+
       //create the desired successor
       if (desiredNodeType == ElementModel::ElementNode)
 	{
@@ -655,8 +668,17 @@ void ElementModeler::print(void)
   OUTPUTENL("    Structural entropy:\t\t\t" << structuralEntropy);
   OUTPUTEENDLINE;
 
-  printNode(startNode);
-  printNode(endNode);
+  if (compiled)
+    {
+      //the graph may contain cycles --> display the nodes one by one
+      for (ElementModel::Node *node = nodeList.first(); node; node = nodeList.next())
+	printNode(node, false);
+    }
+  else
+    {
+      printNode(startNode);
+      printNode(endNode);
+    }
 
   
   OUTPUTEENDLINE;
@@ -673,8 +695,9 @@ void ElementModeler::print(void)
   Displays a textual representation of the given element graph node.
 
   \param node Pointer to the graph node.
+  \param recursive Indication whether the successors of the node should be displayed as well.
 */
-void ElementModeler::printNode(ElementModel::Node *node)
+void ElementModeler::printNode(ElementModel::Node *node, bool recursive)
 {
 //   if (node == currentNode)
 //     {
@@ -736,6 +759,9 @@ void ElementModeler::printNode(ElementModel::Node *node)
 
   OUTPUTEENDLINE;
 
+  if (!recursive)
+    return;
+
   for (ElementModel::Transition *ss = node->successors.first(); ss; ss = node->successors.next())
     {
       if (ss->node->type != ElementModel::EndNode)
@@ -745,6 +771,213 @@ void ElementModeler::printNode(ElementModel::Node *node)
 
 
 
+/*!
+  Removes the rarely used parts of the graph, so that it fits in the limit given to the constructor. The frequencies of the transitions are halved and the transitions whose frequency drops to zero are removed. A node which loses all its transitions gets a transition to the end node instead, so each node which has already been passed through still predicts something. Then the nodes which can't be reached from the start node any more are removed; the current node and the nodes on the node stack (the positions of the unfinished instances of the element) are kept. This is repeated until the size of the graph drops to a half of the limit, or until there is nothing more to remove.
+
+  The method is called only when a new node or transition is about to be created. The transitions of the current node and of the nodes on the node stack are left intact and the remaining transitions are renumbered, so the result depends only on the state of the graph. The decoder creates the nodes at the same moments as the encoder, so both of them prune their graphs in the same way.
+*/
+void ElementModeler::prune(void)
+{
+  ElementModel::Node *node;
+  ElementModel::Transition *tr;
+  ElementModel::NodeStack liveNodes;
+  ElementModel::NodeStack pom;
+  size_t id;
+  bool hot = true;
+
+  while (hot && nodeList.count() + transitionCounter > limit / 2)
+    {
+      hot = false;
+      transitionCounter = 0;
+
+      //mark the live nodes (their transitions are left intact)
+      for (node = nodeList.first(); node; node = nodeList.next())
+	node->reachable = false;
+
+      currentNode->reachable = true;
+
+      while (!nodeStack.isEmpty())
+	{
+	  node = nodeStack.pop();
+	  node->reachable = true;
+	  pom.push(node);
+	}
+
+      while (!pom.isEmpty())
+	{
+	  node = pom.pop();
+	  liveNodes.push(node);
+	  nodeStack.push(node);
+	}
+
+      //age the transitions and remove the cold ones
+      for (node = nodeList.first(); node; node = nodeList.next())
+	{
+	  if (!node->reachable && !node->successors.isEmpty())
+	    {
+	      tr = node->successors.first();
+
+	      while (tr)
+		{
+		  tr->frequency /= 2;
+
+		  if (tr->frequency)
+		    {
+		      hot = true;
+		      tr = node->successors.next();
+		    }
+		  else
+		    {
+		      if (node->mpt == tr)
+			node->mpt = 0;
+
+		      node->successors.remove();
+		      tr = node->successors.current();
+		    }
+		}
+
+	      if (node->successors.isEmpty())
+		{
+		  //predict the end of the element
+		  NEW(tr, ElementModel::Transition);
+		  tr->frequency = 1;
+		  tr->node = endNode;
+		  node->successors.append(tr);
+		}
+
+	      //renumber the transitions (the surviving mpt remains the most probable one)
+	      id = 1;
+	      for (tr = node->successors.first(); tr; tr = node->successors.next())
+		{
+		  tr->id = id++;
+
+		  if (!node->mpt || tr->frequency > node->mpt->frequency)
+		    node->mpt = tr;
+		}
+	    }
+
+	  transitionCounter += node->successors.count();
+	}
+
+      //mark the nodes reachable from the start node and from the live nodes
+      for (node = nodeList.first(); node; node = nodeList.next())
+	node->reachable = false;
+
+      liveNodes.push(startNode);
+      liveNodes.push(endNode);
+      liveNodes.push(currentNode);
+
+      while (!liveNodes.isEmpty())
+	{
+	  node = liveNodes.pop();
+
+	  if (!node->reachable)
+	    {
+	      node->reachable = true;
+
+	      for (tr = node->successors.first(); tr; tr = node->successors.next())
+		liveNodes.push(tr->node);
+	    }
+	}
+
+      //remove the other nodes (together with their transitions)
+      node = nodeList.first();
+
+      while (node)
+	{
+	  if (node->reachable)
+	    node = nodeList.next();
+	  else
+	    {
+	      transitionCounter -= node->successors.count();
+	      nodeList.remove();
+	      node = nodeList.current();
+	    }
+	}
+    }
+}
+
+
+
+/*!
+  Builds the graph of the element from its content model (see XmlDtd), so the structure of the element doesn't have to be learnt. Each position of the content model becomes one node. In the element content, the start node and each element node are followed by a characters node for the white space between the elements, which is the most probable transition (the documents are expected to be indented). The other transitions are equally probable.
+
+  The nodes that are created later (when the element doesn't conform to its content model) are added as usual.
+
+  \param contentModel The content model of the element.
+  \param modelers The modelers of all elements of the DTD (indexed by the indices of the elements).
+*/
+void ElementModeler::compile(XmlContentModel *contentModel, ElementModeler **modelers)
+{
+  size_t n = contentModel->positions;
+  ElementModel::Node **nodes;
+  ElementModel::Node *from;
+  ElementModel::Node *space;
+  bool *successors;
+  bool canEnd;
+
+  compiled = true;
+
+  //the nodes of the positions (the last one is the start node)
+  NEW(nodes, ElementModel::Node *[n + 1]);
+
+  for (size_t i = 0; i < n; i++)
+    {
+      if (contentModel->elements[i] == XML_DTD_CHARACTERS)
+	{
+	  CREATE_GRAPH_NODE(0, nodes[i], ElementModel::CharactersNode, 0);
+	}
+      else
+	{
+	  CREATE_GRAPH_NODE(0, nodes[i], ElementModel::ElementNode, modelers[contentModel->elements[i]]);
+	}
+    }
+
+  nodes[n] = startNode;
+
+  for (size_t i = 0; i <= n; i++)
+    {
+      from = nodes[i];
+
+      if (i == n)
+	{
+	  successors = contentModel->first;
+	  canEnd = contentModel->nullable;
+	}
+      else
+	{
+	  successors = contentModel->follow + i * n;
+	  canEnd = contentModel->last[i];
+	}
+
+      if (!contentModel->mixed)
+	{
+	  //the white space after the node
+	  CREATE_GRAPH_NODE(0, space, ElementModel::CharactersNode, 0);
+	}
+      else
+	space = 0;
+
+      //the transitions created later are preferred
+      for (ElementModel::Node *node = from; node; node = (node == from) ? space : 0)
+	{
+	  for (size_t j = 0; j < n; j++)
+	    if (successors[j] && (nodes[j]->type != ElementModel::CharactersNode || node->type != ElementModel::CharactersNode))
+	      CREATE_GRAPH_TRANSITION(node, nodes[j]);
+
+	  if (canEnd)
+	    CREATE_GRAPH_TRANSITION(node, endNode);
+	}
+
+      if (space)
+	CREATE_GRAPH_TRANSITION(from, space);
+    }
+
+  DELETE_ARRAY(nodes);
+}
+
+
+
 //////////////////////////////////////////////////////////////////////
 //////////////////////////////////////////////////////////////////////
 //////////////////////////////////////////////////////////////////////
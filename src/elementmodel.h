@@ -37,6 +37,7 @@
 #include "stack.h"
 #include "xmlchar.h"
 #include "saxemitter.h"
+#include "xmldtd.h"
 
 
 //! The string indicating the "start node" node of the element model.
@@ -135,6 +136,9 @@ namespace ElementModel
 
     //! Pointer to the modeler of the referenced element (used only for element nodes).
     ElementModeler *modeler;
+
+    //! Indication whether the node is reachable (used by ElementModeler::prune()).
+    bool reachable;
   };
 
   /*! 
@@ -170,7 +174,7 @@ class ElementModeler
 {
 public:
   //! A constructor.
-  ElementModeler(XmlChar *name);
+  ElementModeler(XmlChar *name, size_t graphLimit = 0);
 
   //! A destructor.
   virtual ~ElementModeler(void);
@@ -227,7 +231,10 @@ public:
   virtual void print(void);
 
   //! Display one node of the graph.
-  virtual void printNode(ElementModel::Node *node);
+  virtual void printNode(ElementModel::Node *node, bool recursive = true);
+
+  //! Build the graph from the content model of the element.
+  virtual void compile(XmlContentModel *contentModel, ElementModeler **modelers);
 
 
 protected:
@@ -257,6 +264,18 @@ protected:
 
   //! List of the nodes of the model.
   List<ElementModel::Node> nodeList;
+
+  //! Indication whether the graph has been built from a content model (such graph may contain cycles).
+  bool compiled;
+
+  //! The number of transitions of the graph.
+  size_t transitionCounter;
+
+  //! The maximal size of the graph (the number of nodes plus the number of transitions), 0 if not limited.
+  size_t limit;
+
+  //! Remove the rarely used parts of the graph.
+  virtual void prune(void);
 };
 
 
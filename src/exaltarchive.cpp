@@ -0,0 +1,273 @@
+/***************************************************************************
+    exaltarchive.cpp  -  Definitions of ExaltArchive class methods.
+                             -------------------
+    begin                : October 19 2026
+    copyright            : (C) 2003 by Vojtch Toman
+    email                : vtoman@lit.cz
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+/*!
+  \file exaltarchive.cpp
+  \brief Definitions of ExaltArchive class methods.
+  
+  This file contains the definitions of ExaltArchive class methods.
+*/
+
+
+#ifdef __GNUG__
+# pragma implementation
+#endif
+
+
+#include <cstring>	//for strlen()
+
+#include "exaltarchive.h"
+#include "fibonacci.h"
+
+
+
+/*!
+  \brief Read one Fibonacci coded number from the device.
+
+  If the device ends prematurely, ExaltArchiveException is raised.
+
+  \param _device_ The input device.
+  \param _number_ The variable where the number is stored.
+ */
+#define ARCHIVE_READ_NUMBER(_device_, _number_)				\
+{									\
+  FibonacciDecoderState fibDecoder;					\
+  int c;								\
+									\
+  Fibonacci::resetDecoder(&fibDecoder);					\
+									\
+  do									\
+    {									\
+      if (_device_->getChar(&c) != ReadOk)				\
+	throw ExaltArchiveException();					\
+    }									\
+  while (!Fibonacci::decodeChar(&fibDecoder, (unsigned char)c, &_number_)); \
+}
+
+
+/*!
+  \brief Write one Fibonacci coded number to the device.
+
+  \param _device_ The output device.
+  \param _number_ The number (must be greater than 0).
+ */
+#define ARCHIVE_WRITE_NUMBER(_device_, _number_)				\
+{										\
+  char fibBuf[10];								\
+  size_t nrItems = Fibonacci::encodeToBuffer(fibBuf, SIZEOF_CHAR, _number_);	\
+  _device_->writeData(fibBuf, nrItems);						\
+}
+
+
+
+/*!
+  Creates an empty directory.
+ */
+ExaltArchive::ExaltArchive(void)
+{
+  NEW(memberList, ArchiveMemberList);
+}
+
+
+
+/*!
+  Deletes all members.
+ */
+ExaltArchive::~ExaltArchive(void)
+{
+  clear();
+  DELETE(memberList);
+}
+
+
+
+/*!
+  The name is copied.
+
+  \param name The name of the member.
+  \param size The size of the member in bytes (0 if not known).
+  \param device The device with the data of the member (needed only for encoding).
+
+  \return Pointer to the new member.
+ */
+ArchiveMember *ExaltArchive::addMember(const char *name, unsigned long size = 0, IODevice *device = 0)
+{
+  ArchiveMember *member;
+
+  NEW(member, ArchiveMember);
+  NEW(member->name, char[strlen(name) + 1]);
+  strcpy(member->name, name);
+  member->size = size;
+  member->device = device;
+
+  memberList->append(member);
+
+  return member;
+}
+
+
+
+/*!
+  \return Pointer to the list of the members.
+ */
+ArchiveMemberList *ExaltArchive::members(void)
+{
+  return memberList;
+}
+
+
+
+/*!
+  \return Number of the members.
+ */
+size_t ExaltArchive::count(void)
+{
+  return memberList->count();
+}
+
+
+
+/*!
+  The directory is stored as the Fibonacci code of the number of the members followed by the members. Each member is stored as the length of its name, the name, and its size increased by one (all numbers Fibonacci coded).
+
+  \param device The output device.
+ */
+void ExaltArchive::writeDirectory(IODevice *device) throw (ExaltIOException)
+{
+  ARCHIVE_WRITE_NUMBER(device, memberList->count() + 1);
+
+  for (ArchiveMember *member = memberList->first(); member; member = memberList->next())
+    {
+      size_t nameLength = strlen(member->name);
+
+      ARCHIVE_WRITE_NUMBER(device, nameLength + 1);
+      device->writeData(member->name, nameLength);
+      ARCHIVE_WRITE_NUMBER(device, member->size + 1);
+    }
+}
+
+
+
+/*!
+  The previous contents of the directory is discarded. If the directory is damaged, ExaltArchiveException is raised.
+
+  \param device The input device.
+ */
+void ExaltArchive::readDirectory(IODevice *device) throw (ExaltException)
+{
+  clear();
+
+  if (!appendDirectory(device))
+    throw ExaltArchiveException();
+}
+
+
+
+/*!
+  The members of the segment are appended to the members read so far. If the directory is damaged, ExaltArchiveException is raised.
+
+  \param device The input device.
+
+  \return False if there are no more segments (the device is at its end), true otherwise.
+ */
+bool ExaltArchive::appendDirectory(IODevice *device) throw (ExaltException)
+{
+  unsigned long nrMembers = 0, nameLength, size;
+  char *name;
+  int c;
+  FibonacciDecoderState fibDecoder;
+
+  //the end of the data is allowed only before the directory
+  if (device->getChar(&c) != ReadOk)
+    return false;
+
+  Fibonacci::resetDecoder(&fibDecoder);
+
+  if (!Fibonacci::decodeChar(&fibDecoder, (unsigned char)c, &nrMembers))
+    {
+      do
+	{
+	  if (device->getChar(&c) != ReadOk)
+	    throw ExaltArchiveException();
+	}
+      while (!Fibonacci::decodeChar(&fibDecoder, (unsigned char)c, &nrMembers));
+    }
+
+  for (unsigned long i = 1; i < nrMembers; i++)
+    {
+      ARCHIVE_READ_NUMBER(device, nameLength);
+      nameLength--;
+
+      NEW(name, char[nameLength + 1]);
+
+      if (nameLength && device->readData(name, nameLength) != ReadOk)
+	{
+	  DELETE_ARRAY(name);
+	  throw ExaltArchiveException();
+	}
+
+      name[nameLength] = 0;
+
+      ARCHIVE_READ_NUMBER(device, size);
+
+      addMember(name, size - 1);
+      DELETE_ARRAY(name);
+    }
+
+  return true;
+}
+
+
+
+/*!
+  The member is skipped by default.
+
+  \param member The member.
+
+  \return The SAX receptor for the member, or NULL if the member should be skipped.
+ */
+SAXReceptor *ExaltArchive::startMember(ArchiveMember *member)
+{
+  return 0;
+}
+
+
+
+/*!
+  Does nothing.
+
+  \param member The member.
+ */
+void ExaltArchive::endMember(ArchiveMember *member)
+{
+}
+
+
+
+/*!
+  Deletes all members.
+ */
+void ExaltArchive::clear(void)
+{
+  ArchiveMember *member;
+
+  while ((member = memberList->getFirst()))
+    {
+      DELETE_ARRAY(member->name);
+      DELETE(member);
+    }
+}
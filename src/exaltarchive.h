@@ -0,0 +1,117 @@
+/***************************************************************************
+    exaltarchive.h  -  Definition of the ExaltArchive class.
+                             -------------------
+    begin                : October 19 2026
+    copyright            : (C) 2003 by Vojtch Toman
+    email                : vtoman@lit.cz
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+/*!
+  \file exaltarchive.h
+  \brief Definition of the ExaltArchive class.
+  
+  This file contains the definition of the ExaltArchive class.
+*/
+
+
+#ifndef EXALTARCHIVE_H
+#define EXALTARCHIVE_H
+
+#ifdef __GNUG__
+# pragma interface
+#endif
+
+
+#include "defs.h"
+#include "exceptions.h"
+#include "iodevice.h"
+#include "list.h"
+#include "saxreceptor.h"
+
+
+
+/*!
+  \brief One member (document) of the archive.
+ */
+struct ArchiveMember
+{
+  //! The name of the member.
+  char *name;
+
+  //! The size of the uncompressed member in bytes (0 if not known).
+  unsigned long size;
+
+  //! The device with the data of the member (used only for encoding).
+  IODevice *device;
+};
+
+
+/*!
+  \brief Linked list of archive members.
+ */
+typedef List<ArchiveMember> ArchiveMemberList;
+
+
+
+/*!
+  \brief The directory of a solid archive.
+
+  A solid archive contains several XML documents (members) compressed as one stream. All members share one grammar and one arithmetic coding context, so the rules learned from the previous members are used for the following ones. The members are separated by the end-of-message symbol.
+
+  The directory is stored at the beginning of the archive and it contains the names and the sizes of the members. The documents appended to the archive later form a new segment which starts with its own directory; the members of all segments are kept in one list. While decoding, startMember() is called before each member and endMember() after it. The default implementation skips all members; reimplement startMember() to extract them.
+
+  \sa XmlCodec::encodeArchive(), XmlCodec::decodeArchive().
+ */
+class ExaltArchive
+{
+public:
+  //! A constructor.
+  ExaltArchive(void);
+
+  //! A destructor.
+  virtual ~ExaltArchive(void);
+
+  //! Add a member to the directory.
+  virtual ArchiveMember *addMember(const char *name, unsigned long size = 0, IODevice *device = 0);
+
+  //! Return the members of the archive.
+  virtual ArchiveMemberList *members(void);
+
+  //! Return the number of the members.
+  virtual size_t count(void);
+
+  //! Store the directory in the device.
+  virtual void writeDirectory(IODevice *device) throw (ExaltIOException);
+
+  //! Read the directory from the device.
+  virtual void readDirectory(IODevice *device) throw (ExaltException);
+
+  //! Read the directory of the next segment from the device.
+  virtual bool appendDirectory(IODevice *device) throw (ExaltException);
+
+  //! Called before the member is decoded.
+  virtual SAXReceptor *startMember(ArchiveMember *member);
+
+  //! Called after the member is decoded.
+  virtual void endMember(ArchiveMember *member);
+
+protected:
+  //! The members of the archive.
+  ArchiveMemberList *memberList;
+
+  //! Delete all members.
+  virtual void clear(void);
+};
+
+
+
+#endif //EXALTARCHIVE_H
@@ -49,6 +49,8 @@ ExaltCodec::ExaltCodec(void)
   : XmlCodecBase()
 {
   NEW(xmlCodec, XmlCodec());
+  ownDictionary = 0;
+  ownPathFilter = 0;
 }
 
 
@@ -61,6 +63,12 @@ ExaltCodec::~ExaltCodec(void)
   if (xmlCodec)
     DELETE(xmlCodec);
 
+  if (ownDictionary)
+    DELETE(ownDictionary);
+
+  if (ownPathFilter)
+    DELETE(ownPathFilter);
+
   deleteDefaultTextCodec();
 }
 /*!
@@ -106,6 +114,49 @@ bool ExaltCodec::encodePush(const char *data, int length, bool isFinal = false)
 
 
 
+/*!
+  Creates a flush point in the compressed data, so the receiver of the data can decode everything pushed so far.
+*/
+void ExaltCodec::sync(void)
+{
+  xmlCodec->sync();
+}
+
+
+
+/*!
+  Initializes the codec in PUSH decoding mode. The decoded data are passed to the SAX receptor.
+
+  \param receptor The SAX event receptor.
+  \param userData The pointer to the user data structure.
+ */
+void ExaltCodec::initializePushDecoder(SAXReceptor *receptor, void *userData = 0)
+{
+  if (!textCodec)
+    //create default text codec if none has been specified
+    createDefaultTextCodec();
+
+  xmlCodec->setTextCodec(textCodec);
+  xmlCodec->setDictionary(dictionary);
+  xmlCodec->initializePushDecoder(receptor, userData);
+}
+
+
+
+/*!
+  The decoder decodes given chunk of compressed data and emits the SAX events for all data which can be decoded so far.
+  
+  \param data The chunk of compressed data.
+  \param length The length of the data.
+  \param isFinal Indication whether the decoder received the last chunk of data.
+*/
+bool ExaltCodec::decodePush(const char *data, int length, bool isFinal = false)
+{
+  return xmlCodec->decodePush(data, length, isFinal);
+}
+
+
+
 
 
 /*!
@@ -261,6 +312,8 @@ bool ExaltCodec::decode(IODevice *inDevice, SAXReceptor *receptor, void *userDat
 
   NEW(xmlCodec, XmlCodec);
 
+  xmlCodec->setDictionary(dictionary);
+  xmlCodec->setPathFilter(pathFilter);
   res = xmlCodec->decode(inDevice, receptor, userData);
 
   DELETE(xmlCodec);
@@ -298,3 +351,570 @@ bool ExaltCodec::decode(const char *inFileName, SAXReceptor *receptor, void *use
 
   return res;
 }
+
+
+
+/*!
+  The document is decoded with the path filter of the query (the path filter of the codec is not used), so only the matching elements are passed to the query. The results are accumulated in the query.
+
+  \param inDevice The input device.
+  \param query The query.
+*/
+bool ExaltCodec::query(IODevice *inDevice, ExaltQuery *query)
+{
+  XmlCodec *xmlCodec;
+  bool res;
+
+  CHECK_POINTER(query);
+
+  NEW(xmlCodec, XmlCodec);
+
+  xmlCodec->setDictionary(dictionary);
+  xmlCodec->setPathFilter(query->getPathFilter());
+  res = xmlCodec->decode(inDevice, query);
+
+  DELETE(xmlCodec);
+
+  return res;
+}
+
+
+
+/*!
+  The document is decoded with the path filter of the query, so only the matching elements are passed to the query. The results are accumulated in the query.
+
+  \param inFileName The input file.
+  \param query The query.
+*/
+bool ExaltCodec::query(const char *inFileName, ExaltQuery *query)
+{
+  FileDevice *inFileDevice;
+
+  NEW(inFileDevice, FileDevice);
+
+  try
+    {
+      inFileDevice->prepare(inFileName, ios::in);
+    }
+  catch (ExaltException)
+    {
+      FATAL("Unable to set \"" << inFileName <<"\" as input device!");
+    }
+
+  bool res = this->query(inFileDevice, query);
+
+  DELETE(inFileDevice);
+
+  return res;
+}
+
+
+
+/*!
+  The dictionary is used both for encoding and decoding. The codec doesn't take the ownership of the dictionary.
+
+  \param dict The dictionary (NULL means no dictionary).
+ */
+void ExaltCodec::setDictionary(ExaltDictionary *dict)
+{
+  dictionary = dict;
+  xmlCodec->setDictionary(dict);
+}
+
+
+
+/*!
+  The dictionary is loaded and owned by the codec. If the file is not a valid dictionary, ExaltDictionaryException is raised.
+
+  \param fileName The name of the dictionary file.
+ */
+void ExaltCodec::setDictionary(const char *fileName) throw (ExaltException)
+{
+  ExaltDictionary *dict;
+
+  NEW(dict, ExaltDictionary);
+
+  try
+    {
+      dict->load(fileName);
+    }
+  catch (ExaltException)
+    {
+      DELETE(dict);
+      throw;
+    }
+
+  setDictionary(dict);
+
+  if (ownDictionary)
+    DELETE(ownDictionary);
+
+  ownDictionary = dict;
+}
+
+
+
+/*!
+  The DTD is added to the dictionary of the codec (if no dictionary is set, an empty one is created and owned by the codec). The elements declared in the DTD are then predicted by the adaptive model from their first occurrence. The same DTD has to be used for the compression and the decompression.
+
+  \param fileName The name of the file with the DTD (the external subset).
+ */
+void ExaltCodec::setDtd(const char *fileName) throw (ExaltException)
+{
+  if (!dictionary)
+    {
+      ExaltDictionary *dict;
+
+      NEW(dict, ExaltDictionary);
+      setDictionary(dict);
+
+      if (ownDictionary)
+	DELETE(ownDictionary);
+
+      ownDictionary = dict;
+    }
+
+  dictionary->setDtd(fileName);
+}
+
+
+
+/*!
+  The filter has to be set before the decoding starts.
+
+  \param filter The path filter (NULL means no filtering).
+ */
+void ExaltCodec::setPathFilter(XmlPathFilter *filter)
+{
+  pathFilter = filter;
+  xmlCodec->setPathFilter(filter);
+}
+
+
+
+/*!
+  The path is compiled and the filter is owned by the codec. If the path is not valid, ExaltPathSyntaxException is raised.
+
+  \param path The path expression (see XmlPathFilter).
+ */
+void ExaltCodec::setPathFilter(const char *path) throw (ExaltPathSyntaxException)
+{
+  XmlPathFilter *filter;
+
+  NEW(filter, XmlPathFilter(path));
+
+  setPathFilter(filter);
+
+  if (ownPathFilter)
+    DELETE(ownPathFilter);
+
+  ownPathFilter = filter;
+}
+
+
+
+/*!
+  The codec encodes the documents into one solid archive.
+
+  \param archive The directory of the archive with the input devices of the members.
+  \param outDevice The output device.
+*/
+bool ExaltCodec::encodeArchive(ExaltArchive *archive, IODevice *outDevice)
+{
+  bool res;
+
+  clock_t t1, t2;
+
+  t1 = clock();
+
+  if (!textCodec)
+    //use default TextCodec if none has been specified
+    createDefaultTextCodec();
+
+  xmlCodec->setTextCodec(textCodec);
+
+  res = xmlCodec->encodeArchive(archive, outDevice);
+
+  t2 = clock();
+  if (ExaltOptions::getOption(ExaltOptions::Verbose) == ExaltOptions::Yes)
+    {
+      SHOW_RUNNING_TIME(t1, t2);
+    }
+
+  return res;
+}
+
+
+
+/*!
+  The names of the files are used as the names of the members.
+
+  \param archiveFileName The output file.
+  \param fileNames The names of the input files.
+*/
+bool ExaltCodec::encodeArchive(const char *archiveFileName, List<char> *fileNames)
+{
+  ExaltArchive archive;
+  FileDevice *outFileDevice;
+  ArchiveMember *member;
+  bool res;
+
+  NEW(outFileDevice, FileDevice);
+
+  try
+    {
+      for (char *fileName = fileNames->first(); fileName; fileName = fileNames->next())
+	{
+	  FileDevice *inFileDevice;
+
+	  NEW(inFileDevice, FileDevice);
+	  member = archive.addMember(fileName, 0, inFileDevice);
+
+	  inFileDevice->prepare(fileName, ios::in);
+
+	  //find out the size of the member
+	  inFileDevice->seekg(0, ios::end);
+	  member->size = inFileDevice->tellg();
+	  inFileDevice->seekg(0, ios::beg);
+	}
+
+      outFileDevice->prepare(archiveFileName, ios::out);
+      res = encodeArchive(&archive, outFileDevice);
+    }
+  catch (ExaltException)
+    {
+      res = false;
+    }
+
+  if (outFileDevice->isPrepared())
+    outFileDevice->finish();
+
+  DELETE(outFileDevice);
+
+  for (member = archive.members()->first(); member; member = archive.members()->next())
+    {
+      if (member->device->isPrepared())
+	member->device->finish();
+
+      DELETE(member->device);
+    }
+
+  return res;
+}
+
+
+
+/*!
+  The codec decodes the members of the archive and passes them to the archive.
+
+  \param inDevice The input device.
+  \param archive The archive which receives the directory and the members.
+*/
+bool ExaltCodec::decodeArchive(IODevice *inDevice, ExaltArchive *archive)
+{
+  XmlCodec *xmlCodec;
+  bool res;
+
+  if (!textCodec)
+    //create default text codec if none has been specified
+    createDefaultTextCodec();
+
+  NEW(xmlCodec, XmlCodec);
+
+  xmlCodec->setTextCodec(textCodec);
+  xmlCodec->setDictionary(dictionary);
+  xmlCodec->setPathFilter(pathFilter);
+  res = xmlCodec->decodeArchive(inDevice, archive);
+
+  DELETE(xmlCodec);
+
+  return res;
+}
+
+
+
+/*!
+  The members are stored in the files with the names of the members.
+
+  \param archiveFileName The input file.
+  \param memberNames The names of the members to extract (NULL or an empty list means all members).
+  \param overwrite Overwrite existing files?
+*/
+bool ExaltCodec::decodeArchive(const char *archiveFileName, List<char> *memberNames = 0, bool overwrite = false)
+{
+  FileDevice *inFileDevice;
+  ExaltArchiveExtractor extractor(memberNames, overwrite);
+  bool res;
+
+  NEW(inFileDevice, FileDevice);
+
+  try
+    {
+      inFileDevice->prepare(archiveFileName, ios::in);
+      res = decodeArchive(inFileDevice, &extractor);
+    }
+  catch (ExaltException)
+    {
+      DELETE(inFileDevice);
+      throw;
+    }
+
+  inFileDevice->finish();
+  DELETE(inFileDevice);
+
+  return res;
+}
+
+
+
+/*!
+  The existing archive is decoded to restore the grammar and the context, and the new members are encoded as a new segment of the archive.
+
+  \param inDevice The input device with the existing archive.
+  \param archive The directory of the new members with their input devices.
+  \param outDevice The output device (positioned at the end of the existing archive).
+*/
+bool ExaltCodec::appendArchive(IODevice *inDevice, ExaltArchive *archive, IODevice *outDevice)
+{
+  bool res;
+
+  clock_t t1, t2;
+
+  t1 = clock();
+
+  if (!textCodec)
+    //use default TextCodec if none has been specified
+    createDefaultTextCodec();
+
+  xmlCodec->setTextCodec(textCodec);
+
+  res = xmlCodec->appendArchive(inDevice, archive, outDevice);
+
+  t2 = clock();
+  if (ExaltOptions::getOption(ExaltOptions::Verbose) == ExaltOptions::Yes)
+    {
+      SHOW_RUNNING_TIME(t1, t2);
+    }
+
+  return res;
+}
+
+
+
+/*!
+  The names of the files are used as the names of the members. The archive is read first and then the new segment is appended to the end of the file.
+
+  \param archiveFileName The archive file.
+  \param fileNames The names of the input files.
+*/
+bool ExaltCodec::appendArchive(const char *archiveFileName, List<char> *fileNames)
+{
+  ExaltArchive archive;
+  FileDevice *inFileDevice, *outFileDevice;
+  ArchiveMember *member;
+  bool res;
+
+  NEW(inFileDevice, FileDevice);
+  NEW(outFileDevice, FileDevice);
+
+  try
+    {
+      for (char *fileName = fileNames->first(); fileName; fileName = fileNames->next())
+	{
+	  FileDevice *memberFileDevice;
+
+	  NEW(memberFileDevice, FileDevice);
+	  member = archive.addMember(fileName, 0, memberFileDevice);
+
+	  memberFileDevice->prepare(fileName, ios::in);
+
+	  //find out the size of the member
+	  memberFileDevice->seekg(0, ios::end);
+	  member->size = memberFileDevice->tellg();
+	  memberFileDevice->seekg(0, ios::beg);
+	}
+
+      inFileDevice->prepare(archiveFileName, ios::in);
+      outFileDevice->prepare(archiveFileName, ios::out | ios::app);
+      res = appendArchive(inFileDevice, &archive, outFileDevice);
+    }
+  catch (ExaltException)
+    {
+      res = false;
+    }
+
+  if (inFileDevice->isPrepared())
+    inFileDevice->finish();
+
+  if (outFileDevice->isPrepared())
+    outFileDevice->finish();
+
+  DELETE(inFileDevice);
+  DELETE(outFileDevice);
+
+  for (member = archive.members()->first(); member; member = archive.members()->next())
+    {
+      if (member->device->isPrepared())
+	member->device->finish();
+
+      DELETE(member->device);
+    }
+
+  return res;
+}
+
+
+
+/*!
+  The directories of all segments of the archive are read.
+
+  \param inDevice The input device.
+  \param archive The archive which receives the directory.
+*/
+bool ExaltCodec::listArchive(IODevice *inDevice, ExaltArchive *archive)
+{
+  if (!textCodec)
+    //create default text codec if none has been specified
+    createDefaultTextCodec();
+
+  xmlCodec->setTextCodec(textCodec);
+
+  return xmlCodec->listArchive(inDevice, archive);
+}
+
+
+
+/*!
+  The directories of all segments of the archive are read.
+
+  \param archiveFileName The input file.
+  \param archive The archive which receives the directory.
+*/
+bool ExaltCodec::listArchive(const char *archiveFileName, ExaltArchive *archive)
+{
+  FileDevice *inFileDevice;
+  bool res;
+
+  NEW(inFileDevice, FileDevice);
+
+  try
+    {
+      inFileDevice->prepare(archiveFileName, ios::in);
+      res = listArchive(inFileDevice, archive);
+    }
+  catch (ExaltException)
+    {
+      DELETE(inFileDevice);
+      throw;
+    }
+
+  inFileDevice->finish();
+  DELETE(inFileDevice);
+
+  return res;
+}
+
+
+
+//////////////////////////////////////////////////////////////////////
+
+
+
+/*!
+  \param memberNames The names of the members to extract (NULL or an empty list means all members).
+  \param overwriteFiles Overwrite existing files?
+ */
+ExaltArchiveExtractor::ExaltArchiveExtractor(List<char> *memberNames = 0, bool overwriteFiles = false)
+  : ExaltArchive()
+{
+  selectedNames = memberNames;
+  overwrite = overwriteFiles;
+  memberDevice = 0;
+  memberReceptor = 0;
+  nrExtracted = 0;
+}
+
+
+
+/*!
+  Closes the file of the current member (if any).
+ */
+ExaltArchiveExtractor::~ExaltArchiveExtractor(void)
+{
+  endMember(0);
+}
+
+
+
+/*!
+  The member is skipped if it has not been selected, or if its file exists and it should not be overwritten.
+
+  \param member The member.
+
+  \return The receptor writing the member to the file, or NULL if the member is skipped.
+ */
+SAXReceptor *ExaltArchiveExtractor::startMember(ArchiveMember *member)
+{
+  if (selectedNames && !selectedNames->isEmpty())
+    {
+      char *name;
+
+      for (name = selectedNames->first(); name; name = selectedNames->next())
+	if (!strcmp(name, member->name))
+	  break;
+
+      if (!name)
+	//not selected
+	return 0;
+    }
+
+  if (!overwrite)
+    {
+      ifstream outFile(member->name);
+
+      if (outFile)
+	{
+	  outFile.close();
+	  ERR("'" << member->name << "' exists, skipping.");
+	  return 0;
+	}
+    }
+
+  if (ExaltOptions::getOption(ExaltOptions::Verbose) == ExaltOptions::Yes)
+    OUTPUTENL("Extracting '" << member->name << "'.");
+
+  NEW(memberDevice, FileDevice);
+
+  try
+    {
+      memberDevice->prepare(member->name, ios::out);
+    }
+  catch (ExaltException)
+    {
+      ERR("Unable to create '" << member->name << "', skipping.");
+      DELETE(memberDevice);
+      return 0;
+    }
+
+  NEW(memberReceptor, OutputSAXReceptor(memberDevice));
+  nrExtracted++;
+
+  return memberReceptor;
+}
+
+
+
+/*!
+  \param member The member.
+ */
+void ExaltArchiveExtractor::endMember(ArchiveMember *member)
+{
+  if (memberReceptor)
+    DELETE(memberReceptor);
+
+  if (memberDevice)
+    {
+      memberDevice->finish();
+      DELETE(memberDevice);
+    }
+}
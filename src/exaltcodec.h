@@ -32,20 +32,69 @@
 
 
 #include "defs.h"
+#include "exaltarchive.h"
+#include "exaltdictionary.h"
+#include "exaltquery.h"
 #include "filedevice.h"
 #include "iodevice.h"
+#include "list.h"
 #include "saxemitter.h"
 #include "saxreceptor.h"
 #include "outputsaxreceptor.h"
 #include "textcodec.h"
 #include "xmlcodec.h"
 #include "xmlcodecbase.h"
+#include "xmlpathfilter.h"
 
 
 #include <ctime>
 
 
 
+/*!
+  \brief An archive that extracts its members to files.
+
+  The members are stored in the files with the names of the members. Existing files are not overwritten unless requested.
+
+  \sa ExaltCodec::extractArchive().
+ */
+class ExaltArchiveExtractor : public ExaltArchive
+{
+public:
+  //! A constructor.
+  ExaltArchiveExtractor(List<char> *memberNames = 0, bool overwriteFiles = false);
+
+  //! A destructor.
+  virtual ~ExaltArchiveExtractor(void);
+
+  //! Open the file for the member.
+  virtual SAXReceptor *startMember(ArchiveMember *member);
+
+  //! Close the file of the member.
+  virtual void endMember(ArchiveMember *member);
+
+  //! Return the number of extracted members.
+  virtual size_t extracted(void) { return nrExtracted; }
+
+protected:
+  //! The names of the members to extract (NULL means all members).
+  List<char> *selectedNames;
+
+  //! Overwrite existing files?
+  bool overwrite;
+
+  //! The file of the current member.
+  FileDevice *memberDevice;
+
+  //! The receptor writing the current member.
+  OutputSAXReceptor *memberReceptor;
+
+  //! The number of extracted members.
+  size_t nrExtracted;
+};
+
+
+
 /*!
   \brief Convenience class for easy XML encoding/decoding.
 
@@ -75,6 +124,15 @@ public:
   //! Encode a chunk of XML data in PUSH mode.
   virtual bool encodePush(const char *data, int length, bool isFinal = false);
 
+  //! Make the data encoded so far decodable (PUSH mode).
+  virtual void sync(void);
+
+  //! Initialize the decoder in PUSH mode.
+  virtual void initializePushDecoder(SAXReceptor *receptor, void *userData = 0);
+
+  //! Decode a chunk of compressed data in PUSH mode.
+  virtual bool decodePush(const char *data, int length, bool isFinal = false);
+
 
   //! Decode data from specified file.
   virtual bool decode(const char *inFileName, const char *outFileName);
@@ -88,9 +146,60 @@ public:
   //! Decode data from specified file and use SAX event receptor.
   virtual bool decode(const char *inFileName, SAXReceptor *receptor, void *userData = 0);
 
+  //! Evaluate a query over the document from specified input device.
+  virtual bool query(IODevice *inDevice, ExaltQuery *query);
+
+  //! Evaluate a query over the document stored in specified file.
+  virtual bool query(const char *inFileName, ExaltQuery *query);
+
+  //! Encode several documents into one solid archive.
+  virtual bool encodeArchive(ExaltArchive *archive, IODevice *outDevice);
+
+  //! Create a solid archive from specified files.
+  virtual bool encodeArchive(const char *archiveFileName, List<char> *fileNames);
+
+  //! Decode the members of a solid archive.
+  virtual bool decodeArchive(IODevice *inDevice, ExaltArchive *archive);
+
+  //! Extract the members of a solid archive to files.
+  virtual bool decodeArchive(const char *archiveFileName, List<char> *memberNames = 0, bool overwrite = false);
+
+  //! Append documents to an existing solid archive.
+  virtual bool appendArchive(IODevice *inDevice, ExaltArchive *archive, IODevice *outDevice);
+
+  //! Append specified files to an existing solid archive.
+  virtual bool appendArchive(const char *archiveFileName, List<char> *fileNames);
+
+  //! Read the directory of a solid archive.
+  virtual bool listArchive(IODevice *inDevice, ExaltArchive *archive);
+
+  //! Read the directory of a solid archive stored in specified file.
+  virtual bool listArchive(const char *archiveFileName, ExaltArchive *archive);
+
+  //! Set the pre-trained dictionary.
+  virtual void setDictionary(ExaltDictionary *dict);
+
+  //! Load the pre-trained dictionary from specified file.
+  virtual void setDictionary(const char *fileName) throw (ExaltException);
+
+  //! Load the DTD of the documents from specified file.
+  virtual void setDtd(const char *fileName) throw (ExaltException);
+
+  //! Set the path filter for the decoding.
+  virtual void setPathFilter(XmlPathFilter *filter);
+
+  //! Decode only the subtrees matching specified path.
+  virtual void setPathFilter(const char *path) throw (ExaltPathSyntaxException);
+
 protected:
   //! The instance of the XmlCodec.
   XmlCodecBase *xmlCodec;
+
+  //! The dictionary loaded by the codec itself.
+  ExaltDictionary *ownDictionary;
+
+  //! The path filter compiled by the codec itself.
+  XmlPathFilter *ownPathFilter;
 }; //ExaltCodec
 
 
@@ -0,0 +1,537 @@
+/***************************************************************************
+    exaltdictionary.cpp  -  Definitions of ExaltDictionary class methods.
+                             -------------------
+    begin                : October 19 2026
+    copyright            : (C) 2003 by Vojtch Toman
+    email                : vtoman@lit.cz
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+/*!
+  \file exaltdictionary.cpp
+  \brief Definitions of ExaltDictionary class methods.
+  
+  This file contains the definitions of ExaltDictionary class methods.
+*/
+
+
+#ifdef __GNUG__
+# pragma implementation
+#endif
+
+
+#include <cstring>	//for memcpy()
+
+#include "exaltdictionary.h"
+#include "fibonacci.h"
+#include "filedevice.h"
+
+
+
+/*!
+  \brief Add one byte to the dictionary hash.
+
+  \param _hash_ The hash.
+  \param _byte_ The byte.
+ */
+#define DICTIONARY_HASH_BYTE(_hash_, _byte_)					\
+{										\
+  _hash_ = ((_hash_ ^ (unsigned char)(_byte_)) * DICTIONARY_HASH_PRIME) & 0xffffffffUL;	\
+}
+
+
+
+/*!
+  Creates an empty dictionary for the simple model.
+ */
+ExaltDictionary::ExaltDictionary(void)
+{
+  NEW(documentList, DictionaryDocumentList);
+  modelType = ExaltOptions::SimpleModel;
+  hashComputed = false;
+  hashValue = 0;
+  dtdData = 0;
+  dtdLength = 0;
+  parsedDtd = 0;
+}
+
+
+
+/*!
+  Deletes all training documents and the DTD.
+ */
+ExaltDictionary::~ExaltDictionary(void)
+{
+  clear();
+  DELETE(documentList);
+}
+
+
+
+/*!
+  \param model The model (ExaltOptions::SimpleModel or ExaltOptions::AdaptiveModel).
+ */
+void ExaltDictionary::setModel(ExaltOptions::OptionValue model)
+{
+  modelType = model;
+  hashComputed = false;
+}
+
+
+
+/*!
+  \return The model (ExaltOptions::SimpleModel or ExaltOptions::AdaptiveModel).
+ */
+ExaltOptions::OptionValue ExaltDictionary::getModel(void)
+{
+  return modelType;
+}
+
+
+
+/*!
+  The data are copied.
+
+  \param data The data of the document.
+  \param length The length of the data.
+ */
+void ExaltDictionary::addDocument(const char *data, size_t length)
+{
+  DictionaryDocument *doc;
+
+  if (!length)
+    return;
+
+  NEW(doc, DictionaryDocument);
+  NEW(doc->data, char[length]);
+  memcpy(doc->data, data, length);
+  doc->length = length;
+
+  documentList->append(doc);
+  hashComputed = false;
+}
+
+
+
+/*!
+  The whole contents of the device is read.
+
+  \param device The input device.
+ */
+void ExaltDictionary::addDocument(IODevice *device) throw (ExaltIOException)
+{
+  char *buf;
+  size_t length;
+
+  buf = readDevice(device, &length);
+  addDocument(buf, length);
+
+  DELETE_ARRAY(buf);
+}
+
+
+
+/*!
+  \param fileName The name of the file.
+ */
+void ExaltDictionary::addDocument(const char *fileName) throw (ExaltIOException)
+{
+  FileDevice *device;
+
+  NEW(device, FileDevice);
+
+  try
+    {
+      device->prepare(fileName, ios::in);
+      addDocument(device);
+    }
+  catch (ExaltIOException)
+    {
+      DELETE(device);
+      throw;
+    }
+
+  device->finish();
+  DELETE(device);
+}
+
+
+
+/*!
+  The data are copied. The previous DTD is discarded.
+
+  \param data The text of the DTD (the declarations of the external subset).
+  \param length The length of the text.
+ */
+void ExaltDictionary::setDtd(const char *data, size_t length)
+{
+  if (dtdData)
+    DELETE_ARRAY(dtdData);
+
+  if (parsedDtd)
+    DELETE(parsedDtd);
+
+  NEW(dtdData, char[length + 1]);
+  memcpy(dtdData, data, length);
+  dtdData[length] = 0;
+  dtdLength = length;
+
+  hashComputed = false;
+}
+
+
+
+/*!
+  The whole contents of the device is read.
+
+  \param device The input device.
+ */
+void ExaltDictionary::setDtd(IODevice *device) throw (ExaltIOException)
+{
+  char *buf;
+  size_t length;
+
+  buf = readDevice(device, &length);
+  setDtd(buf, length);
+
+  DELETE_ARRAY(buf);
+}
+
+
+
+/*!
+  \param fileName The name of the file.
+ */
+void ExaltDictionary::setDtd(const char *fileName) throw (ExaltIOException)
+{
+  FileDevice *device;
+
+  NEW(device, FileDevice);
+
+  try
+    {
+      device->prepare(fileName, ios::in);
+      setDtd(device);
+    }
+  catch (ExaltIOException)
+    {
+      DELETE(device);
+      throw;
+    }
+
+  device->finish();
+  DELETE(device);
+}
+
+
+
+/*!
+  The DTD is parsed by the first call.
+
+  \return Pointer to the DTD (NULL if the dictionary contains no DTD).
+ */
+XmlDtd *ExaltDictionary::dtd(void)
+{
+  if (!dtdData)
+    return 0;
+
+  if (!parsedDtd)
+    {
+      NEW(parsedDtd, XmlDtd);
+      parsedDtd->parse(dtdData, dtdLength);
+    }
+
+  return parsedDtd;
+}
+
+
+
+/*!
+  \return Pointer to the list of the training documents.
+ */
+DictionaryDocumentList *ExaltDictionary::documents(void)
+{
+  return documentList;
+}
+
+
+
+/*!
+  \return Number of the training documents.
+ */
+size_t ExaltDictionary::count(void)
+{
+  return documentList->count();
+}
+
+
+
+/*!
+  The hash (32-bit FNV-1a) covers the model, the DTD (if any) and all training documents including their lengths.
+
+  \return The hash of the dictionary.
+ */
+unsigned long ExaltDictionary::hash(void)
+{
+  if (!hashComputed)
+    {
+      hashValue = DICTIONARY_HASH_BASIS;
+
+      DICTIONARY_HASH_BYTE(hashValue, modelType);
+
+      if (dtdData)
+	{
+	  DICTIONARY_HASH_BYTE(hashValue, DICTIONARY_DTD_FLAG);
+
+	  for (int i = 0; i < 4; i++)
+	    DICTIONARY_HASH_BYTE(hashValue, dtdLength >> (8 * i));
+
+	  for (size_t i = 0; i < dtdLength; i++)
+	    DICTIONARY_HASH_BYTE(hashValue, dtdData[i]);
+	}
+
+      for (DictionaryDocument *doc = documentList->first(); doc; doc = documentList->next())
+	{
+	  for (int i = 0; i < 4; i++)
+	    DICTIONARY_HASH_BYTE(hashValue, doc->length >> (8 * i));
+
+	  for (size_t i = 0; i < doc->length; i++)
+	    DICTIONARY_HASH_BYTE(hashValue, doc->data[i]);
+	}
+
+      hashComputed = true;
+    }
+
+  return hashValue;
+}
+
+
+
+/*!
+  The dictionary is stored as the dictionary stamp, one byte indicating the model (and the presence of the DTD), the DTD and the training documents. The DTD and each document are preceded by the Fibonacci code of their length.
+
+  \param device The output device.
+ */
+void ExaltDictionary::save(IODevice *device) throw (ExaltIOException)
+{
+  char fibBuf[10];
+  size_t nrItems;
+
+  device->writeData(DICTIONARY_STAMP, strlen(DICTIONARY_STAMP));
+  device->putChar((modelType == ExaltOptions::SimpleModel ? 0 : 1) | (dtdData ? DICTIONARY_DTD_FLAG : 0));
+
+  if (dtdData)
+    {
+      nrItems = Fibonacci::encodeToBuffer(fibBuf, SIZEOF_CHAR, dtdLength);
+      device->writeData(fibBuf, nrItems);
+      device->writeData(dtdData, dtdLength);
+    }
+
+  for (DictionaryDocument *doc = documentList->first(); doc; doc = documentList->next())
+    {
+      nrItems = Fibonacci::encodeToBuffer(fibBuf, SIZEOF_CHAR, doc->length);
+      device->writeData(fibBuf, nrItems);
+      device->writeData(doc->data, doc->length);
+    }
+}
+
+
+
+/*!
+  \param fileName The name of the file.
+ */
+void ExaltDictionary::save(const char *fileName) throw (ExaltIOException)
+{
+  FileDevice *device;
+
+  NEW(device, FileDevice);
+
+  try
+    {
+      device->prepare(fileName, ios::out);
+      save(device);
+    }
+  catch (ExaltIOException)
+    {
+      DELETE(device);
+      throw;
+    }
+
+  device->finish();
+  DELETE(device);
+}
+
+
+
+/*!
+  The previous contents of the dictionary is discarded. If the data are not a valid dictionary, ExaltDictionaryException is raised.
+
+  \param device The input device.
+ */
+void ExaltDictionary::load(IODevice *device) throw (ExaltException)
+{
+  size_t stampLength = strlen(DICTIONARY_STAMP);
+  char *stamp;
+  FibonacciDecoderState fibDecoder;
+  unsigned long length;
+  char *buf;
+  bool dtdFollows;
+  int c;
+
+  clear();
+
+  NEW(stamp, char[stampLength + 1]);
+
+  if (device->readData(stamp, stampLength) != ReadOk)
+    {
+      DELETE_ARRAY(stamp);
+      ERR("Dictionary format not recognized!");
+      throw ExaltDictionaryException();
+    }
+
+  stamp[stampLength] = '\0';
+
+  if (strcmp(stamp, DICTIONARY_STAMP))
+    {
+      DELETE_ARRAY(stamp);
+      ERR("Dictionary format not recognized!");
+      throw ExaltDictionaryException();
+    }
+
+  DELETE_ARRAY(stamp);
+
+  if (device->getChar(&c) != ReadOk)
+    throw ExaltDictionaryException();
+
+  setModel((c & 1) ? ExaltOptions::AdaptiveModel : ExaltOptions::SimpleModel);
+
+  //the DTD (if any) precedes the documents
+  dtdFollows = c & DICTIONARY_DTD_FLAG;
+
+  //read the documents until the end of data
+  while (device->getChar(&c) == ReadOk)
+    {
+      Fibonacci::resetDecoder(&fibDecoder);
+
+      while (!Fibonacci::decodeChar(&fibDecoder, (unsigned char)c, &length))
+	{
+	  if (device->getChar(&c) != ReadOk)
+	    throw ExaltDictionaryException();
+	}
+
+      NEW(buf, char[length]);
+
+      if (device->readData(buf, length) != ReadOk)
+	{
+	  DELETE_ARRAY(buf);
+	  throw ExaltDictionaryException();
+	}
+
+      if (dtdFollows)
+	setDtd(buf, length);
+      else
+	addDocument(buf, length);
+
+      dtdFollows = false;
+      DELETE_ARRAY(buf);
+    }
+}
+
+
+
+/*!
+  \param fileName The name of the file.
+ */
+void ExaltDictionary::load(const char *fileName) throw (ExaltException)
+{
+  FileDevice *device;
+
+  NEW(device, FileDevice);
+
+  try
+    {
+      device->prepare(fileName, ios::in);
+      load(device);
+    }
+  catch (ExaltException)
+    {
+      DELETE(device);
+      throw;
+    }
+
+  device->finish();
+  DELETE(device);
+}
+
+
+
+/*!
+  The whole contents of the device is read into a newly allocated buffer, which has to be deleted by the caller.
+
+  \param device The input device.
+  \param length The variable where the length of the data is stored.
+  \return Pointer to the buffer.
+ */
+char *ExaltDictionary::readDevice(IODevice *device, size_t *length)
+{
+  char *buf, *pom;
+  size_t bufSize = DICTIONARY_READ_BUFFER_SIZE;
+  IOState state;
+
+  *length = 0;
+
+  NEW(buf, char[bufSize]);
+
+  do
+    {
+      if (*length == bufSize)
+	{
+	  //buffer is full --> enlarge it
+	  NEW(pom, char[2 * bufSize]);
+	  memcpy(pom, buf, *length);
+	  DELETE_ARRAY(buf);
+	  buf = pom;
+	  bufSize *= 2;
+	}
+
+      state = device->readData(buf + *length, bufSize - *length);
+      *length += device->bytesRead();
+    }
+  while (state == ReadOk);
+
+  return buf;
+}
+
+
+
+/*!
+  Deletes all training documents and the DTD.
+ */
+void ExaltDictionary::clear(void)
+{
+  DictionaryDocument *doc;
+
+  while ((doc = documentList->getFirst()))
+    {
+      DELETE_ARRAY(doc->data);
+      DELETE(doc);
+    }
+
+  if (dtdData)
+    DELETE_ARRAY(dtdData);
+
+  if (parsedDtd)
+    DELETE(parsedDtd);
+
+  dtdLength = 0;
+
+  hashComputed = false;
+}
@@ -0,0 +1,187 @@
+/***************************************************************************
+    exaltdictionary.h  -  Definition of the ExaltDictionary class.
+                             -------------------
+    begin                : October 19 2026
+    copyright            : (C) 2003 by Vojtch Toman
+    email                : vtoman@lit.cz
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+/*!
+  \file exaltdictionary.h
+  \brief Definition of the ExaltDictionary class.
+  
+  This file contains the definition of the ExaltDictionary class.
+*/
+
+
+#ifndef EXALTDICTIONARY_H
+#define EXALTDICTIONARY_H
+
+#ifdef __GNUG__
+# pragma interface
+#endif
+
+
+#include "defs.h"
+#include "exceptions.h"
+#include "iodevice.h"
+#include "list.h"
+#include "options.h"
+#include "xmldtd.h"
+
+
+
+/*!
+  \brief The string identifying the dictionary files.
+ */
+#define DICTIONARY_STAMP	"EXD"
+
+/*!
+  \brief The size of the blocks in which the documents are read.
+ */
+#define DICTIONARY_READ_BUFFER_SIZE	65536
+
+/*!
+  \brief The initial value of the dictionary hash (32-bit FNV-1a).
+ */
+#define DICTIONARY_HASH_BASIS	2166136261UL
+
+/*!
+  \brief The multiplier of the dictionary hash (32-bit FNV-1a).
+ */
+#define DICTIONARY_HASH_PRIME	16777619UL
+
+/*!
+  \brief The flag of the model byte of the dictionary file indicating that a DTD follows.
+ */
+#define DICTIONARY_DTD_FLAG	2
+
+
+
+/*!
+  \brief One training document of the dictionary.
+ */
+struct DictionaryDocument
+{
+  //! The data of the document.
+  char *data;
+
+  //! The length of the data.
+  size_t length;
+};
+
+
+/*!
+  \brief Linked list of training documents.
+ */
+typedef List<DictionaryDocument> DictionaryDocumentList;
+
+
+
+/*!
+  \brief A pre-trained dictionary for the compression of small documents.
+
+  The dictionary consists of a set of typical (training) documents, of the type of the model used to process them and optionally of a DTD of the documents (see XmlAdaptiveModel::setDtd()). Before the actual data are processed, both the encoder and the decoder replay the training documents through the grammar and the arithmetic coding context. The data then start with a grammar that already knows the common markup and with adapted symbol statistics.
+
+  The dictionary is identified by a hash of its contents, which is stored in the compressed data. Decoding with a different dictionary is therefore detected.
+
+  \sa XmlCodec::primeWithDictionary().
+ */
+class ExaltDictionary
+{
+public:
+  //! A constructor.
+  ExaltDictionary(void);
+
+  //! A destructor.
+  virtual ~ExaltDictionary(void);
+
+  //! Set the model used for processing of the training documents.
+  virtual void setModel(ExaltOptions::OptionValue model);
+
+  //! Return the model used for processing of the training documents.
+  virtual ExaltOptions::OptionValue getModel(void);
+
+  //! Add a training document.
+  virtual void addDocument(const char *data, size_t length);
+
+  //! Add a training document read from the device.
+  virtual void addDocument(IODevice *device) throw (ExaltIOException);
+
+  //! Add a training document read from the file.
+  virtual void addDocument(const char *fileName) throw (ExaltIOException);
+
+  //! Return the training documents.
+  virtual DictionaryDocumentList *documents(void);
+
+  //! Return the number of training documents.
+  virtual size_t count(void);
+
+  //! Set the DTD of the documents.
+  virtual void setDtd(const char *data, size_t length);
+
+  //! Set the DTD of the documents read from the device.
+  virtual void setDtd(IODevice *device) throw (ExaltIOException);
+
+  //! Set the DTD of the documents read from the file.
+  virtual void setDtd(const char *fileName) throw (ExaltIOException);
+
+  //! Return the DTD of the documents.
+  virtual XmlDtd *dtd(void);
+
+  //! Return the hash of the dictionary.
+  virtual unsigned long hash(void);
+
+  //! Store the dictionary in the device.
+  virtual void save(IODevice *device) throw (ExaltIOException);
+
+  //! Store the dictionary in the file.
+  virtual void save(const char *fileName) throw (ExaltIOException);
+
+  //! Load the dictionary from the device.
+  virtual void load(IODevice *device) throw (ExaltException);
+
+  //! Load the dictionary from the file.
+  virtual void load(const char *fileName) throw (ExaltException);
+
+protected:
+  //! The training documents.
+  DictionaryDocumentList *documentList;
+
+  //! The model used for processing of the training documents.
+  ExaltOptions::OptionValue modelType;
+
+  //! The hash of the dictionary.
+  unsigned long hashValue;
+
+  //! Indication whether \a hashValue is valid.
+  bool hashComputed;
+
+  //! The text of the DTD.
+  char *dtdData;
+
+  //! The length of the text of the DTD.
+  size_t dtdLength;
+
+  //! The parsed DTD (created on demand).
+  XmlDtd *parsedDtd;
+
+  //! Read the whole contents of the device.
+  virtual char *readDevice(IODevice *device, size_t *length);
+
+  //! Delete all training documents and the DTD.
+  virtual void clear(void);
+};
+
+
+
+#endif //EXALTDICTIONARY_H
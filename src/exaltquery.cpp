@@ -0,0 +1,319 @@
+/***************************************************************************
+    exaltquery.cpp  -  Definitions of ExaltQuery class methods.
+                             -------------------
+    begin                : October 19 2026
+    copyright            : (C) 2003 by Vojtch Toman
+    email                : vtoman@lit.cz
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+
+/*!
+  \file exaltquery.cpp
+  \brief Definitions of ExaltQuery class methods.
+  
+  This file contains the definitions of ExaltQuery class methods.
+*/
+
+
+#ifdef __GNUG__
+# pragma implementation
+#endif
+
+
+#include "exaltquery.h"
+
+
+
+/*!
+  The path is compiled. If the path is not valid, ExaltPathSyntaxException is raised.
+
+  \param path The path expression (see XmlPathFilter).
+ */
+ExaltQuery::ExaltQuery(const char *path) throw (ExaltPathSyntaxException)
+  : SAXReceptor()
+{
+  NEW(pathFilter, XmlPathFilter(path));
+
+  pattern = 0;
+  patternLength = 0;
+  failure = 0;
+  matchedLength = 0;
+  patternFound = true;
+
+  outputReceptor = 0;
+  NEW(nameTable, XmlNameTable);
+  NEW(record, SAXEventBatch(nameTable));
+
+  depth = 0;
+  nrMatches = 0;
+}
+
+
+
+/*!
+  Deletes the path filter and the pattern.
+ */
+ExaltQuery::~ExaltQuery(void)
+{
+  if (pattern)
+    {
+      DELETE_ARRAY(pattern);
+      DELETE_ARRAY(failure);
+    }
+
+  DELETE(record);
+  DELETE(nameTable);
+  DELETE(pathFilter);
+}
+
+
+
+/*!
+  Only the elements containing the pattern are matched. The failure function of the pattern is computed.
+
+  \param text The pattern (NULL or empty means no pattern).
+ */
+void ExaltQuery::setPattern(const char *text)
+{
+  size_t i, k;
+
+  if (pattern)
+    {
+      DELETE_ARRAY(pattern);
+      DELETE_ARRAY(failure);
+      patternLength = 0;
+    }
+
+  if (!text || !text[0])
+    return;
+
+  patternLength = strlen(text);
+  NEW(pattern, XmlChar[patternLength + 1]);
+  xmlchar_cstrcpy(pattern, text);
+
+  NEW(failure, size_t[patternLength]);
+  failure[0] = 0;
+
+  for (i = 1, k = 0; i < patternLength; i++)
+    {
+      while (k && pattern[i] != pattern[k])
+	k = failure[k - 1];
+
+      if (pattern[i] == pattern[k])
+	k++;
+
+      failure[i] = k;
+    }
+}
+
+
+
+/*!
+  The events of each matching element are recorded, and passed to the receptor by SAXReceptor::eventBatch() when the element ends (and the pattern has been found).
+
+  \param receptor The receptor (NULL means no output).
+ */
+void ExaltQuery::setOutputReceptor(SAXReceptor *receptor)
+{
+  outputReceptor = receptor;
+}
+
+
+
+/*!
+  The query can be then evaluated on another document.
+ */
+void ExaltQuery::reset(void)
+{
+  nrMatches = 0;
+  depth = 0;
+  record->clear();
+}
+
+
+
+/*!
+  The search continues from the prefix of the pattern matched by the previous data.
+
+  \param data The data.
+  \param length The length of the data.
+ */
+void ExaltQuery::searchPattern(const XmlChar *data, size_t length)
+{
+  for (size_t i = 0; i < length && !patternFound; i++)
+    {
+      while (matchedLength && data[i] != pattern[matchedLength])
+	matchedLength = failure[matchedLength - 1];
+
+      if (data[i] == pattern[matchedLength])
+	if (++matchedLength == patternLength)
+	  patternFound = true;
+    }
+}
+
+
+
+/*!
+  \param type The type of the event.
+  \param name The name of the element or the attribute (or NULL).
+  \param data The data of the event.
+  \param length The length of the data.
+ */
+void ExaltQuery::recordEvent(SAXBatchEventType type, const XmlChar *name, const XmlChar *data, size_t length)
+{
+  if (!record->fits(1, length))
+    record->reserve(1, length);
+
+  record->appendData(record->appendEvent(type, name ? nameTable->intern(name) : 0), data, length);
+}
+
+
+
+/*!
+  \param userData Pointer to the user data structure.
+ */
+void ExaltQuery::finishElement(void *userData)
+{
+  if (patternFound)
+    {
+      nrMatches++;
+
+      if (outputReceptor)
+	outputReceptor->eventBatch(userData, record);
+    }
+
+  record->clear();
+}
+
+
+
+/*!
+  \param userData Pointer to the user data structure.
+  \param name Name of the element.
+  \param attr An array of attributes.
+ */
+void ExaltQuery::startElement(void *userData, const XmlChar *name, const XmlChar **attr)
+{
+  if (!depth)
+    {
+      //new matching element
+      patternFound = !pattern;
+      record->clear();
+    }
+
+  depth++;
+  matchedLength = 0;
+
+  if (outputReceptor)
+    recordEvent(BatchStartElement, name, 0, 0);
+
+  if (attr)
+    for (int i = 0; attr[i]; i += 2)
+      {
+	if (outputReceptor)
+	  recordEvent(BatchAttribute, attr[i], attr[i + 1], xmlchar_strlen(attr[i + 1]));
+
+	if (!patternFound)
+	  {
+	    searchPattern(attr[i + 1], xmlchar_strlen(attr[i + 1]));
+	    matchedLength = 0;
+	  }
+      }
+}
+
+
+
+/*!
+  \param userData Pointer to the user data structure.
+  \param name Name of the element.
+ */
+void ExaltQuery::endElement(void *userData, const XmlChar *name)
+{
+  matchedLength = 0;
+
+  if (outputReceptor)
+    recordEvent(BatchEndElement, name, 0, 0);
+
+  if (depth && !--depth)
+    finishElement(userData);
+}
+
+
+
+/*!
+  \param userData Pointer to the user data structure.
+  \param data Character data.
+  \param length Length of the data.
+ */
+void ExaltQuery::characterData(void *userData, const XmlChar *data, int length)
+{
+  if (outputReceptor)
+    recordEvent(BatchCharacters, 0, data, length);
+
+  if (!patternFound)
+    searchPattern(data, length);
+}
+
+
+
+/*!
+  \param userData Pointer to the user data structure.
+  \param data The comment data.
+ */
+void ExaltQuery::comment(void *userData, const XmlChar *data)
+{
+  matchedLength = 0;
+
+  if (outputReceptor)
+    recordEvent(BatchComment, 0, data, xmlchar_strlen(data));
+}
+
+
+
+/*!
+  \param userData Pointer to the user data structure.
+ */
+void ExaltQuery::startCDATASection(void *userData)
+{
+  matchedLength = 0;
+
+  if (outputReceptor)
+    recordEvent(BatchStartCDATA, 0, 0, 0);
+}
+
+
+
+/*!
+  \param userData Pointer to the user data structure.
+ */
+void ExaltQuery::endCDATASection(void *userData)
+{
+  matchedLength = 0;
+
+  if (outputReceptor)
+    recordEvent(BatchEndCDATA, 0, 0, 0);
+}
+
+
+
+/*!
+  \param userData Pointer to the user data structure.
+  \param data The default data.
+  \param length The length of the default data.
+ */
+void ExaltQuery::defaultHandler(void *userData, const XmlChar *data, int length)
+{
+  matchedLength = 0;
+
+  if (outputReceptor)
+    recordEvent(BatchDefault, 0, data, length);
+}
@@ -0,0 +1,156 @@
+/***************************************************************************
+    exaltquery.h  -  Definition of the ExaltQuery class.
+                             -------------------
+    begin                : October 19 2026
+    copyright            : (C) 2003 by Vojtch Toman
+    email                : vtoman@lit.cz
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+
+/*!
+  \file exaltquery.h
+  \brief Definition of the ExaltQuery class.
+  
+  This file contains the definition of the ExaltQuery class.
+*/
+
+
+#ifndef EXALTQUERY_H
+#define EXALTQUERY_H
+
+#ifdef __GNUG__
+# pragma interface
+#endif
+
+
+#include "defs.h"
+#include "exceptions.h"
+#include "saxbatch.h"
+#include "saxreceptor.h"
+#include "xmlchar.h"
+#include "xmldefs.h"
+#include "xmlnametable.h"
+#include "xmlpathfilter.h"
+
+
+
+/*!
+  \brief A query over a compressed document.
+
+  The query counts the elements matching a path (see XmlPathFilter), optionally only those whose content contains given text pattern. The elements nested in a matching element are not matched again. The matching elements can also be passed to another receptor (e.g. OutputSAXReceptor), which is the equivalent of decompressing the document and searching it.
+
+  The query is evaluated by ExaltCodec::query(): the codec decodes the document with the path filter of the query, so the events outside the matching elements are dropped immediately, and the query receives only the matching elements. Nothing is converted or written except the elements passed to the output receptor.
+
+  The pattern is searched for in the character data and in the values of the attributes (the same way as in the decompressed document, except that the characters are not replaced by the entities). The pattern cannot span markup.
+
+  \sa ExaltCodec::query().
+ */
+class ExaltQuery : public SAXReceptor
+{
+public:
+  //! A constructor.
+  ExaltQuery(const char *path) throw (ExaltPathSyntaxException);
+
+  //! A destructor.
+  virtual ~ExaltQuery(void);
+
+  //! Set the text pattern.
+  virtual void setPattern(const char *text);
+
+  //! Set the receptor of the matching elements.
+  virtual void setOutputReceptor(SAXReceptor *receptor);
+
+  /*!
+    \brief Get the path filter of the query.
+
+    \return The path filter.
+   */
+  virtual XmlPathFilter *getPathFilter(void) { return pathFilter; }
+
+  /*!
+    \brief Get the number of the matching elements.
+
+    \return The number of the elements.
+   */
+  virtual unsigned long count(void) { return nrMatches; }
+
+  //! Reset the number of the matching elements.
+  virtual void reset(void);
+
+  //! Start element handler.
+  virtual void startElement(void *userData, const XmlChar *name, const XmlChar **attr);
+
+  //! End element handler.
+  virtual void endElement(void *userData, const XmlChar *name);
+
+  //! Character data handler.
+  virtual void characterData(void *userData, const XmlChar *data, int length);
+
+  //! Comment handler.
+  virtual void comment(void *userData, const XmlChar *data);
+
+  //! Start CDATA section handler.
+  virtual void startCDATASection(void *userData);
+
+  //! End CDATA section handler.
+  virtual void endCDATASection(void *userData);
+
+  //! Default handler.
+  virtual void defaultHandler(void *userData, const XmlChar *data, int length);
+
+protected:
+  //! The path filter.
+  XmlPathFilter *pathFilter;
+
+  //! The text pattern (NULL if not set).
+  XmlChar *pattern;
+
+  //! The length of the pattern.
+  size_t patternLength;
+
+  //! The failure function of the pattern (Knuth-Morris-Pratt).
+  size_t *failure;
+
+  //! The length of the prefix of the pattern matched so far.
+  size_t matchedLength;
+
+  //! Indication whether the pattern has been found in the current element.
+  bool patternFound;
+
+  //! The depth inside the current matching element (0 if outside).
+  size_t depth;
+
+  //! The number of the matching elements.
+  unsigned long nrMatches;
+
+  //! The receptor of the matching elements.
+  SAXReceptor *outputReceptor;
+
+  //! The names of the recorded elements.
+  XmlNameTable *nameTable;
+
+  //! The events of the current matching element (recorded only if there is an output receptor).
+  SAXEventBatch *record;
+
+  //! Search for the pattern in the data.
+  virtual void searchPattern(const XmlChar *data, size_t length);
+
+  //! Record one event of the current element.
+  virtual void recordEvent(SAXBatchEventType type, const XmlChar *name, const XmlChar *data, size_t length);
+
+  //! Finish the current matching element.
+  virtual void finishElement(void *userData);
+};
+
+
+
+#endif //EXALTQUERY_H
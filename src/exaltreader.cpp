@@ -0,0 +1,431 @@
+/***************************************************************************
+    exaltreader.cpp  -  Definitions of ExaltReader class methods.
+                             -------------------
+    begin                : October 19 2026
+    copyright            : (C) 2003 by Vojtch Toman
+    email                : vtoman@lit.cz
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+
+/*!
+  \file exaltreader.cpp
+  \brief Definitions of ExaltReader class methods.
+  
+  This file contains the definitions of ExaltReader class methods.
+*/
+
+
+#ifdef __GNUG__
+# pragma implementation
+#endif
+
+
+#include <cstring>	//for memcpy()
+
+#include "exaltreader.h"
+
+
+
+/*!
+  The reader has to be opened by open() before reading the events.
+ */
+ExaltReader::ExaltReader(void)
+  : SAXReceptor()
+{
+  codec = 0;
+  dictionary = 0;
+  inputDevice = 0;
+  inputFile = 0;
+  currentEvent = 0;
+  inputFinished = true;
+  error = false;
+
+  NEW(readBuffer, char[EXALT_READER_BLOCK_SIZE]);
+  NEW(events, List<ExaltReaderEvent>);
+  NEW(nameTable, XmlNameTable);
+}
+
+
+
+/*!
+  Closes the reader if it is open.
+ */
+ExaltReader::~ExaltReader(void)
+{
+  close();
+
+  DELETE(nameTable);
+  DELETE(events);
+  DELETE_ARRAY(readBuffer);
+}
+
+
+
+/*!
+  The dictionary has to be set before open() is called.
+
+  \param dict The dictionary.
+ */
+void ExaltReader::setDictionary(ExaltDictionary *dict)
+{
+  dictionary = dict;
+}
+
+
+
+/*!
+  If the reader is already open, it is closed first. The device has to be prepared; it is not finished by the reader.
+
+  \param inDevice The input device with the compressed data.
+ */
+void ExaltReader::open(IODevice *inDevice)
+{
+  close();
+
+  inputDevice = inDevice;
+  inputFinished = false;
+  error = false;
+
+  NEW(codec, ExaltCodec);
+  codec->setDictionary(dictionary);
+  codec->initializePushDecoder(this);
+}
+
+
+
+/*!
+  If the reader is already open, it is closed first.
+
+  \param fileName The name of the file with the compressed data.
+ */
+void ExaltReader::open(const char *fileName) throw (ExaltIOException)
+{
+  FileDevice *file;
+
+  close();
+
+  NEW(file, FileDevice);
+
+  try
+    {
+      file->prepare(fileName, ios::in);
+    }
+  catch (ExaltIOException)
+    {
+      DELETE(file);
+      throw;
+    }
+
+  open(file);
+  inputFile = file;
+}
+
+
+
+/*!
+  The compressed data are decoded only as far as needed to return the event. The event remains valid until the next call of next() or close().
+
+  \return The event, or \a NULL if there are no more events (or an error occurred, see errorOccurred()).
+ */
+ExaltReaderEvent *ExaltReader::next(void)
+{
+  if (currentEvent)
+    {
+      deleteEvent(currentEvent);
+      currentEvent = 0;
+    }
+
+  while (!events->count())
+    if (inputFinished || !decodeBlock())
+      return 0;
+
+  currentEvent = events->getFirst();
+  return currentEvent;
+}
+
+
+
+/*!
+  The remaining data are not decoded. All events returned so far become invalid. The interned names remain valid until the reader is deleted.
+ */
+void ExaltReader::close(void)
+{
+  ExaltReaderEvent *event;
+
+  if (codec)
+    {
+      DELETE(codec);
+    }
+
+  if (inputFile)
+    {
+      inputFile->finish();
+      DELETE(inputFile);
+    }
+
+  inputDevice = 0;
+  inputFinished = true;
+
+  if (currentEvent)
+    {
+      deleteEvent(currentEvent);
+      currentEvent = 0;
+    }
+
+  while ((event = events->getFirst()))
+    deleteEvent(event);
+}
+
+
+
+/*!
+  \param name The name.
+  \return The id of the name.
+ */
+unsigned long ExaltReader::getNameId(const XmlChar *name)
+{
+  return nameTable->intern(name);
+}
+
+
+
+/*!
+  \param id The id of the name.
+  \return The name, or \a NULL if there is no such id.
+ */
+const XmlChar *ExaltReader::getName(unsigned long id)
+{
+  return nameTable->getName(id);
+}
+
+
+
+/*!
+  Reads one block of compressed data and passes it to the decoder, which appends the decoded events to the queue.
+
+  \retval true The block has been decoded.
+  \retval false The data ended prematurely.
+ */
+bool ExaltReader::decodeBlock(void)
+{
+  IOState state;
+
+  state = inputDevice->readData(readBuffer, EXALT_READER_BLOCK_SIZE);
+  inputFinished = (state != ReadOk);
+
+  if (!codec->decodePush(readBuffer, inputDevice->bytesRead(), inputFinished))
+    {
+      error = true;
+      inputFinished = true;
+      return false;
+    }
+
+  return true;
+}
+
+
+
+/*!
+  \param type The type of the event.
+  \return The event.
+ */
+ExaltReaderEvent *ExaltReader::appendEvent(ExaltReaderEventType type)
+{
+  ExaltReaderEvent *event;
+
+  NEW(event, ExaltReaderEvent);
+  event->type = type;
+  event->nameId = 0;
+  event->name = 0;
+  event->attributes = 0;
+  event->data = 0;
+  event->length = 0;
+
+  events->append(event);
+  return event;
+}
+
+
+
+/*!
+  The copy is terminated by zero.
+
+  \param data The data.
+  \param length The length of the data.
+  \return The copy of the data.
+ */
+XmlChar *ExaltReader::copyData(const XmlChar *data, int length)
+{
+  XmlChar *copy;
+
+  NEW(copy, XmlChar[length + 1]);
+  memcpy(copy, data, length * sizeof(XmlChar));
+  copy[length] = 0;
+
+  return copy;
+}
+
+
+
+/*!
+  The names of the element and the attributes belong to the name table, so only the attribute values are deleted.
+
+  \param event The event.
+ */
+void ExaltReader::deleteEvent(ExaltReaderEvent *event)
+{
+  if (event->attributes)
+    {
+      for (int i = 1; event->attributes[i - 1]; i += 2)
+	DELETE_ARRAY(event->attributes[i]);
+
+      DELETE_ARRAY(event->attributes);
+    }
+
+  if (event->type == ReaderProcessingInstruction && event->name)
+    DELETE_ARRAY(event->name);
+
+  if (event->data)
+    DELETE_ARRAY(event->data);
+
+  DELETE(event);
+}
+
+
+
+/*!
+  \param userData Pointer to the user data structure.
+  \param name Name of the element.
+  \param attr An Array of attributes.
+*/
+void ExaltReader::startElement(void *userData, const XmlChar *name, const XmlChar **attr)
+{
+  ExaltReaderEvent *event = appendEvent(ReaderStartElement);
+  int nrAttributes = 0;
+
+  event->nameId = nameTable->intern(name);
+  event->name = nameTable->getName(event->nameId);
+
+  if (attr)
+    while (attr[2 * nrAttributes])
+      nrAttributes++;
+
+  if (nrAttributes)
+    {
+      const XmlChar **attributes;
+
+      NEW(attributes, const XmlChar *[2 * nrAttributes + 1]);
+
+      for (int i = 0; i < nrAttributes; i++)
+	{
+	  attributes[2 * i] = nameTable->getName(nameTable->intern(attr[2 * i]));
+	  attributes[2 * i + 1] = copyData(attr[2 * i + 1], xmlchar_strlen(attr[2 * i + 1]));
+	}
+
+      attributes[2 * nrAttributes] = 0;
+      event->attributes = attributes;
+    }
+}
+
+
+
+/*!
+  \param userData Pointer to the user data structure.
+  \param name Name of the element.
+*/
+void ExaltReader::endElement(void *userData, const XmlChar *name)
+{
+  ExaltReaderEvent *event = appendEvent(ReaderEndElement);
+
+  event->nameId = nameTable->intern(name);
+  event->name = nameTable->getName(event->nameId);
+}
+
+
+
+/*!
+  \param userData Pointer to the user data structure.
+  \param data Character data.
+  \param length Length of the data.
+*/
+void ExaltReader::characterData(void *userData, const XmlChar *data, int length)
+{
+  ExaltReaderEvent *event = appendEvent(ReaderCharacters);
+
+  event->data = copyData(data, length);
+  event->length = length;
+}
+
+
+
+/*!
+  \param userData Pointer to the user data structure.
+  \param target Target of the instruction.
+  \param data Data of the instruction.
+*/
+void ExaltReader::processingInstruction(void *userData, const XmlChar *target, const XmlChar *data)
+{
+  ExaltReaderEvent *event = appendEvent(ReaderProcessingInstruction);
+
+  event->name = copyData(target, xmlchar_strlen(target));
+  event->length = xmlchar_strlen(data);
+  event->data = copyData(data, event->length);
+}
+
+
+
+/*!
+  \param userData Pointer to the user data structure.
+  \param data The comment data.
+*/
+void ExaltReader::comment(void *userData, const XmlChar *data)
+{
+  ExaltReaderEvent *event = appendEvent(ReaderComment);
+
+  event->length = xmlchar_strlen(data);
+  event->data = copyData(data, event->length);
+}
+
+
+
+/*!
+  \param userData Pointer to the user data structure.
+*/
+void ExaltReader::startCDATASection(void *userData)
+{
+  appendEvent(ReaderStartCDATA);
+}
+
+
+
+/*!
+  \param userData Pointer to the user data structure.
+*/
+void ExaltReader::endCDATASection(void *userData)
+{
+  appendEvent(ReaderEndCDATA);
+}
+
+
+
+/*!
+  \param userData Pointer to the user data structure.
+  \param data The default data.
+  \param length The length of the default data.
+*/
+void ExaltReader::defaultHandler(void *userData, const XmlChar *data, int length)
+{
+  ExaltReaderEvent *event = appendEvent(ReaderDefault);
+
+  event->data = copyData(data, length);
+  event->length = length;
+}
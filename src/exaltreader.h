@@ -0,0 +1,244 @@
+/***************************************************************************
+    exaltreader.h  -  Definition of the ExaltReader class.
+                             -------------------
+    begin                : October 19 2026
+    copyright            : (C) 2003 by Vojtch Toman
+    email                : vtoman@lit.cz
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+
+/*!
+  \file exaltreader.h
+  \brief Definition of the ExaltReader class.
+  
+  This file contains the definition of the ExaltReader class.
+*/
+
+
+#ifndef EXALTREADER_H
+#define EXALTREADER_H
+
+#ifdef __GNUG__
+# pragma interface
+#endif
+
+
+#include "defs.h"
+#include "exaltcodec.h"
+#include "exaltdictionary.h"
+#include "filedevice.h"
+#include "iodevice.h"
+#include "list.h"
+#include "saxreceptor.h"
+#include "xmldefs.h"
+#include "xmlnametable.h"
+
+
+/*!
+  \brief The size of the blocks of compressed data read by ExaltReader.
+ */
+#define EXALT_READER_BLOCK_SIZE		4096
+
+
+
+/*!
+  \brief The types of the events returned by ExaltReader.
+ */
+enum ExaltReaderEventType
+{
+  //! Start of an element.
+  ReaderStartElement,
+
+  //! End of an element.
+  ReaderEndElement,
+
+  //! Character data.
+  ReaderCharacters,
+
+  //! Processing instruction.
+  ReaderProcessingInstruction,
+
+  //! Comment.
+  ReaderComment,
+
+  //! Start of a CDATA section.
+  ReaderStartCDATA,
+
+  //! End of a CDATA section.
+  ReaderEndCDATA,
+
+  //! Data not reported by any other event (for example the entity references).
+  ReaderDefault
+}; //ExaltReaderEventType
+
+
+
+/*!
+  \brief An event returned by ExaltReader.
+
+  The fields which are not relevant for the type of the event are NULL (or zero).
+ */
+struct ExaltReaderEvent
+{
+  //! The type of the event.
+  ExaltReaderEventType type;
+
+  //! The interned id of the element name (start and end of an element).
+  unsigned long nameId;
+
+  //! The name of the element, or the target of the processing instruction.
+  const XmlChar *name;
+
+  //! NULL-terminated array of the attribute names and values (start of an element).
+  const XmlChar **attributes;
+
+  //! The character data, the data of the processing instruction, the comment, or the default data.
+  XmlChar *data;
+
+  //! The length of the data.
+  int length;
+}; //ExaltReaderEvent
+
+
+
+/*!
+  \brief A PULL interface to the compressed documents.
+
+  Unlike the SAX interface, the reader does not call the application: the application asks the reader for the events one by one by calling next(). The reader decodes the compressed data lazily: it reads the input in blocks of EXALT_READER_BLOCK_SIZE bytes and only as many blocks as needed for the next event. An application that needs only the beginning of a document (or that merges several compressed documents) can thus stop early without decoding the rest of the data.
+
+  The element and attribute names are interned, so the names of the elements can be compared by their ids (see ExaltReaderEvent::nameId and getNameId()).
+
+  A typical use looks as follows:
+
+  \code
+  ExaltReader reader;
+  ExaltReaderEvent *event;
+
+  reader.open("file.xml.e");
+
+  while ((event = reader.next()))
+    {
+      if (event->type == ReaderStartElement)
+        //...do something with the element
+    }
+
+  reader.close();
+  \endcode
+
+  The reader uses the PUSH decoder of ExaltCodec internally.
+
+  \sa ExaltCodec::initializePushDecoder(), SAXReceptor.
+ */
+class ExaltReader : public SAXReceptor
+{
+public:
+  //! A constructor.
+  ExaltReader(void);
+
+  //! A destructor.
+  virtual ~ExaltReader(void);
+
+  //! Set the dictionary the documents have been compressed with.
+  virtual void setDictionary(ExaltDictionary *dict);
+
+  //! Start reading from the device.
+  virtual void open(IODevice *inDevice);
+
+  //! Start reading from the file.
+  virtual void open(const char *fileName) throw (ExaltIOException);
+
+  //! Return the next event.
+  virtual ExaltReaderEvent *next(void);
+
+  //! Stop reading.
+  virtual void close(void);
+
+  //! Return the interned id of the name.
+  virtual unsigned long getNameId(const XmlChar *name);
+
+  //! Return the name with given interned id.
+  virtual const XmlChar *getName(unsigned long id);
+
+  //! Indication whether an error occurred.
+  virtual bool errorOccurred(void) { return error; }
+
+  //! Start element handler.
+  virtual void startElement(void *userData, const XmlChar *name, const XmlChar **attr);
+
+  //! End element handler.
+  virtual void endElement(void *userData, const XmlChar *name);
+
+  //! Character data handler.
+  virtual void characterData(void *userData, const XmlChar *data, int length);
+
+  //! Processing instruction handler.
+  virtual void processingInstruction(void *userData, const XmlChar *target, const XmlChar *data);
+
+  //! Comment handler.
+  virtual void comment(void *userData, const XmlChar *data);
+
+  //! Start CDATA section handler.
+  virtual void startCDATASection(void *userData);
+
+  //! End CDATA section handler.
+  virtual void endCDATASection(void *userData);
+
+  //! Default handler.
+  virtual void defaultHandler(void *userData, const XmlChar *data, int length);
+
+protected:
+  //! The codec.
+  ExaltCodec *codec;
+
+  //! The dictionary.
+  ExaltDictionary *dictionary;
+
+  //! The input device.
+  IODevice *inputDevice;
+
+  //! The input file (if the reader opened it itself).
+  FileDevice *inputFile;
+
+  //! The buffer for the compressed data.
+  char *readBuffer;
+
+  //! The decoded events not returned yet.
+  List<ExaltReaderEvent> *events;
+
+  //! The event returned by the last call of next().
+  ExaltReaderEvent *currentEvent;
+
+  //! The table of the interned names.
+  XmlNameTable *nameTable;
+
+  //! Indication whether all input has been read.
+  bool inputFinished;
+
+  //! Indication whether an error occurred.
+  bool error;
+
+  //! Decode next block of the compressed data.
+  virtual bool decodeBlock(void);
+
+  //! Create a new event and append it to the queue.
+  virtual ExaltReaderEvent *appendEvent(ExaltReaderEventType type);
+
+  //! Create a copy of the data.
+  virtual XmlChar *copyData(const XmlChar *data, int length);
+
+  //! Delete the event.
+  virtual void deleteEvent(ExaltReaderEvent *event);
+};
+
+
+
+#endif //EXALTREADER_H
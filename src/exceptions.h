@@ -55,6 +55,9 @@ class ExaltFatalErrorException : public ExaltException {};
 //! Exception reporting wrong program options.
 class ExaltOptionException : public ExaltException {};
 
+//! Syntax error in a path expression (see XmlPathFilter).
+class ExaltPathSyntaxException : public ExaltOptionException {};
+
 
 ////////////////////
 
@@ -80,6 +83,15 @@ class ExaltCoderIsPushException : public ExaltCompressionException {};
 //! An attempt to use unitialized PUSH coder.
 class ExaltPushCoderNotInitializedException : public ExaltCompressionException {};
 
+//! A generic dictionary exception (e.g. invalid dictionary file).
+class ExaltDictionaryException : public ExaltCompressionException {};
+
+//! The data were compressed with another dictionary (or without any).
+class ExaltDictionaryMismatchException : public ExaltDictionaryException {};
+
+//! A damaged directory of a solid archive.
+class ExaltArchiveException : public ExaltCompressionException {};
+
 ////////////////////
 
 
@@ -57,13 +57,20 @@ static unsigned long Order2FibonacciNumbers_[] = {
   121393, 196418, 317811, 514229, 832040,
   1346269, 2178309, 3524578, 5702887, 9227465,
   14930352, 24157817, 39088169, 63245986, 102334155,
-  165580141, 267914296, 433494437, 701408733, 1134903170
+  165580141, 267914296, 433494437, 701408733, 1134903170,
+  1836311903	//used only by the table-driven decoder
 };
 
 //! Number of generated Fibonacci numbers of order 2.
 #define NUMBER_OF_ORDER2_FIBS 		44
 
 
+bool Fibonacci::tablesInitialized = false;
+FibonacciDecodeEntry Fibonacci::decodeTable[2][1 << (SIZEOF_CHAR*8)];
+unsigned char Fibonacci::encodeTable[FIBONACCI_CACHED_CODES][FIBONACCI_CACHED_CODE_LENGTH];
+unsigned char Fibonacci::encodeTableLength[FIBONACCI_CACHED_CODES];
+
+
 /*!
   Constructs a Fibonacci code for given \a number. The code is stored reversely (eg. as 11000 instead of 00011) which allows easier manipulation using shifts.
 
@@ -74,13 +81,17 @@ static unsigned long Order2FibonacciNumbers_[] = {
  */
 unsigned long Fibonacci::encode(unsigned long number)
 {
-  int i = NUMBER_OF_ORDER2_FIBS - 1;
+  int i = 0;
 
   unsigned long fn;
   unsigned long code;
   
   code = 1;
 
+  //start with the largest Fibonacci number not greater than the encoded number
+  while (i < NUMBER_OF_ORDER2_FIBS - 1 && Order2FibonacciNumbers_[i + 1] <= number)
+    i++;
+
   while (i > -1)
     {
       fn = Order2FibonacciNumbers_[i];
@@ -145,26 +156,85 @@ unsigned long Fibonacci::decode(unsigned long code)
 
 
 /*!
-  Constructs Fibonacci code for given \a number and stores it in the \a buffer. The \a itemSize parameter indicates the size of one buffer item in bytes (or more precisely, in chars).
+  Initializes the decoding table and the table of precomputed codes.
 
-  \warning No checks are performed, so memory error can occur in case of too short buffer!
+  For each char and each value of the "last was one" flag, the decoding table describes the value of the bits that precede the end of the code (if any). Since F(p+k) = c(k) * F(p) + d(k) * F(p+1), where c(k) and d(k) are again Fibonacci-like sequences, this value can be expressed independently of the position \a p of the char in the code.
+ */
+void Fibonacci::initTables(void)
+{
+  unsigned long c[SIZEOF_CHAR*8], d[SIZEOF_CHAR*8];
+  unsigned char charBuf[sizeof(unsigned long) + 1];
+  size_t k;
 
-  \param buffer Pointer to the buffer.
-  \param itemSize Size of one item of the buffer (in bytes).
-  \param number Encoded number.
+  c[0] = 1;
+  d[0] = 0;
+  c[1] = 0;
+  d[1] = 1;
 
-  \return Number of buffer items which contain the code.
+  for (k = 2; k < SIZEOF_CHAR*8; k++)
+    {
+      c[k] = c[k-1] + c[k-2];
+      d[k] = d[k-1] + d[k-2];
+    }
 
-  \sa encode(), decodeFromBuffer().
+  for (int lastWasOne = 0; lastWasOne < 2; lastWasOne++)
+    for (unsigned int ch = 0; ch < (1 << (SIZEOF_CHAR*8)); ch++)
+      {
+	FibonacciDecodeEntry *entry = &decodeTable[lastWasOne][ch];
+	bool last = lastWasOne;
+
+	entry->a = 0;
+	entry->b = 0;
+	entry->terminated = false;
+
+	for (k = 0; k < SIZEOF_CHAR*8; k++)
+	  {
+	    if (ch & (1 << (SIZEOF_CHAR*8 - 1 - k)))
+	      {
+		if (last)
+		  {
+		    //two 11 appeared --> code ended
+		    entry->terminated = true;
+		    break;
+		  }
+
+		entry->a += c[k];
+		entry->b += d[k];
+		last = true;
+	      }
+	    else
+	      last = false;
+	  }
+
+	entry->lastWasOne = last;
+      }
+
+  for (unsigned long number = 0; number < FIBONACCI_CACHED_CODES; number++)
+    {
+      encodeTableLength[number] = packCode(charBuf, encode(number));
+
+      for (k = 0; k < encodeTableLength[number]; k++)
+	encodeTable[number][k] = charBuf[k];
+    }
+
+  tablesInitialized = true;
+}
+
+
+
+/*!
+  Stores the reversed Fibonacci \a code to the buffer, starting with the most significant bit of the first char. The last char is padded with zeros.
+
+  \param charBuf Pointer to the buffer.
+  \param code The reversed Fibonacci code.
+
+  \return Number of chars which contain the code.
  */
-size_t Fibonacci::encodeToBuffer(void *buffer, size_t itemSize, unsigned long number)
+size_t Fibonacci::packCode(unsigned char *charBuf, unsigned long code)
 {
-  unsigned char *charBuf = (unsigned char *)buffer;
   unsigned char tmpChar = 0;
   unsigned char bits = 0;
   size_t charsTotal = 0;
-  unsigned long code = encode(number);
-
 
   while (code)
     {
@@ -184,34 +254,117 @@ size_t Fibonacci::encodeToBuffer(void *buffer, size_t itemSize, unsigned long nu
       code >>= 1;
     }
 
-  if (!bits)
-    //exactly n bytes
-    charsTotal--;
-  else
+  if (bits)
     {
       //output the last "partial" char
       //"align it to the left"
-      while (bits < SIZEOF_CHAR*8)
-      {
-	tmpChar <<= 1;
-	bits++;
-      }
-      charBuf[charsTotal] = tmpChar;
+      charBuf[charsTotal] = tmpChar << (SIZEOF_CHAR*8 - bits);
+      charsTotal++;
     }
 
+  return charsTotal;
+}
+
+
+
+/*!
+  Constructs Fibonacci code for given \a number and stores it in the \a buffer. The \a itemSize parameter indicates the size of one buffer item in bytes (or more precisely, in chars). The codes of small numbers are taken from the table of precomputed codes.
+
+  \warning No checks are performed, so memory error can occur in case of too short buffer!
 
-  while ((charsTotal + 1) % itemSize)
+  \param buffer Pointer to the buffer.
+  \param itemSize Size of one item of the buffer (in bytes).
+  \param number Encoded number.
+
+  \return Number of buffer items which contain the code.
+
+  \sa encode(), decodeFromBuffer().
+ */
+size_t Fibonacci::encodeToBuffer(void *buffer, size_t itemSize, unsigned long number)
+{
+  unsigned char *charBuf = (unsigned char *)buffer;
+  size_t charsTotal;
+
+  if (!tablesInitialized)
+    initTables();
+
+  if (number < FIBONACCI_CACHED_CODES)
+    {
+      charsTotal = encodeTableLength[number];
+
+      for (size_t i = 0; i < charsTotal; i++)
+	charBuf[i] = encodeTable[number][i];
+    }
+  else
+    charsTotal = packCode(charBuf, encode(number));
+
+  while (charsTotal % itemSize)
     {
       //add fill chars if needed
-      charsTotal++;
       charBuf[charsTotal] = 0;
+      charsTotal++;
     }
 
-  return (charsTotal+1) / itemSize;
+  return charsTotal / itemSize;
+}
+
+
+
+/*!
+  Resets the state of the resumable decoder, so that it can start decoding a new code.
+
+  \param state The state of the decoder.
+
+  \sa decodeChar().
+ */
+void Fibonacci::resetDecoder(FibonacciDecoderState *state)
+{
+  state->number = 0;
+  state->position = 0;
+  state->lastWasOne = false;
 }
 
 
 
+/*!
+  Feeds one char of the Fibonacci code to the resumable decoder. The bits of the char following the end of the code are ignored (they are the padding).
+
+  \param state The state of the decoder.
+  \param c The char of the code.
+  \param number The decoded number (set only if the code is complete).
+
+  \retval true The code is complete, the decoded number is stored in \a number and the decoder is reset.
+  \retval false The code continues in the next char.
+
+  \sa resetDecoder(), decodeFromBuffer().
+ */
+bool Fibonacci::decodeChar(FibonacciDecoderState *state, unsigned char c, unsigned long *number)
+{
+  const FibonacciDecodeEntry *entry;
+
+  if (!tablesInitialized)
+    initTables();
+
+  entry = &decodeTable[state->lastWasOne][c];
+
+  if (state->position < NUMBER_OF_ORDER2_FIBS)
+    state->number += entry->a * Order2FibonacciNumbers_[state->position]
+      + entry->b * Order2FibonacciNumbers_[state->position + 1];
+
+  if (entry->terminated)
+    {
+      *number = state->number;
+      resetDecoder(state);
+      return true;
+    }
+
+  state->position += SIZEOF_CHAR*8;
+  state->lastWasOne = entry->lastWasOne;
+
+  return false;
+}
+
+
 
 /*!
   Decodes Fibonacci \a buffer and returns the decoded number.
@@ -228,52 +381,23 @@ size_t Fibonacci::encodeToBuffer(void *buffer, size_t itemSize, unsigned long nu
  */
 size_t Fibonacci::decodeFromBuffer(void *buffer, size_t itemSize, size_t *nrItems)
 {
-  unsigned long code = 0;
-  unsigned long number;
   unsigned char *charBuf = (unsigned char *)buffer;
-  bool lastWasOne = false;
-  unsigned char tmpChar = 0;
   size_t charsTotal = 0;
-  unsigned char mask;
+  unsigned long number;
+  FibonacciDecoderState state;
 
+  resetDecoder(&state);
 
-  while (true)
-    {
-      tmpChar = charBuf[charsTotal];
-      charsTotal++;
-      mask = 1 << (SIZEOF_CHAR*8-1);
+  while (!decodeChar(&state, charBuf[charsTotal], &number))
+    charsTotal++;
 
-      while (mask)
-	{
-	  if (tmpChar & mask)
-	    {
-	      if (!lastWasOne)
-		{
-		  code <<= 1;
-		  code |= 1;
-		  lastWasOne = true;
-		}
-	      else
-		{
-		  number = decode(code);
-
-		  while (charsTotal % itemSize)
-		    charsTotal++;
-		  
-		  *nrItems = charsTotal / itemSize;
-		  return number;
-		}
-	    }
-	  else
-	    {
-	      code <<= 1;
-	      lastWasOne = false;
-	    }
+  charsTotal++;
 
-	  mask >>= 1;
-	}
-    }
+  while (charsTotal % itemSize)
+    charsTotal++;
 
-}
+  *nrItems = charsTotal / itemSize;
 
+  return number;
+}
 
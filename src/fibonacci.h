@@ -40,10 +40,61 @@
 #include "defs.h"
 #include "iodevice.h"
 
+//! Numbers smaller than this value have their Fibonacci codes precomputed.
+#define FIBONACCI_CACHED_CODES		256
+
+//! The maximum length (in chars) of a precomputed Fibonacci code.
+#define FIBONACCI_CACHED_CODE_LENGTH	2
+
+
+
+/*!
+  \brief State of the resumable Fibonacci decoder.
+
+  The Fibonacci codes are decoded by whole chars (see Fibonacci::decodeChar()). The state holds the partially decoded number between the calls, so the code may be split among several blocks of data.
+ */
+struct FibonacciDecoderState
+{
+  //! The part of the number decoded so far.
+  unsigned long number;
+
+  //! The index of the Fibonacci number corresponding to the next bit.
+  size_t position;
+
+  //! Was the last bit a one?
+  bool lastWasOne;
+};
+
+
+
+/*!
+  \brief One entry of the Fibonacci decoding table.
+
+  Describes the effect of one char of the code on the decoder. The value of the bits is expressed as \a a * F(p) + \a b * F(p+1), where \a p is the index of the Fibonacci number corresponding to the first bit of the char.
+ */
+struct FibonacciDecodeEntry
+{
+  //! The coefficient of F(p).
+  unsigned long a;
+
+  //! The coefficient of F(p+1).
+  unsigned long b;
+
+  //! Does the code end in this char?
+  bool terminated;
+
+  //! Was the last bit of the char a one (valid only if the code continues)?
+  bool lastWasOne;
+};
+
+
+
 /*!
   \brief Class for representing integer numbers with Fibonacci codes.
 
   This class provides some basic functionality for manipulating with order 2 Fibonacci numbers. It can encode and decode integers (greater than 0). In addition, it is capable of encoding numbers into data buffer, and also decoding this buffers.
+
+  Encoding and decoding of the buffers is table-driven: the codes of small numbers are precomputed, and the decoder processes whole chars using a table indexed by the char value.
  */
 class Fibonacci
 {
@@ -60,6 +111,30 @@ public:
   //! Decode given Fibonacci buffer.
   static size_t decodeFromBuffer(void *buffer, size_t itemSize, size_t *nrItems);
 
+  //! Reset the state of the resumable decoder.
+  static void resetDecoder(FibonacciDecoderState *state);
+
+  //! Feed one char of the Fibonacci code to the resumable decoder.
+  static bool decodeChar(FibonacciDecoderState *state, unsigned char c, unsigned long *number);
+
+protected:
+  //! Initialize the encoding and decoding tables.
+  static void initTables(void);
+
+  //! Store the reversed Fibonacci code to the buffer (without padding).
+  static size_t packCode(unsigned char *charBuf, unsigned long code);
+
+  //! Have the tables been initialized?
+  static bool tablesInitialized;
+
+  //! The decoding table (indexed by the "last was one" flag and by the char).
+  static FibonacciDecodeEntry decodeTable[2][1 << (SIZEOF_CHAR*8)];
+
+  //! The precomputed codes of small numbers.
+  static unsigned char encodeTable[FIBONACCI_CACHED_CODES][FIBONACCI_CACHED_CODE_LENGTH];
+
+  //! The lengths (in chars) of the precomputed codes.
+  static unsigned char encodeTableLength[FIBONACCI_CACHED_CODES];
 }; //of Fibonacci
 
 #endif //FIBONACCI_H
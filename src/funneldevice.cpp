@@ -27,6 +27,8 @@
 # pragma implementation
 #endif
 
+#include <cstring>	//for memcpy()
+
 #include "funneldevice.h"
 
 
@@ -35,7 +37,7 @@
 /*!
   Initialization is performed.
 
-  In order to use the device, one has to specify the object that will receive the data (it must inherit UserOfFunnelDevice). The device stores the data in an inner buffer. If the buffer is full, the data is delivered to the receiving object. If \a isImmediate is set to \a TRUE, the data is not buffered.
+  In order to use the device, one has to specify the object that will receive the data (it must inherit UserOfFunnelDevice). The device stores the data in an inner buffer. If the buffer is full, the data is delivered to the receiving object, so the receiver gets the data in large blocks. If \a isImmediate is set to \a TRUE, the data is not buffered.
 
   \param rcvr Pointer to the receiver.
   \param isImmediate Is the data delivered immediately?
@@ -151,6 +153,9 @@ IOState FunnelDevice::getChar(int *c) throw (ExaltIOException)
 */
 IOState FunnelDevice::writeData(const char *buf, IOSize length) throw (ExaltIOException)
 {
+  const XmlChar *data = (const XmlChar *)buf;
+  size_t chunk;
+
   bw += length;
 
   if (!buffer)
@@ -159,26 +164,55 @@ IOState FunnelDevice::writeData(const char *buf, IOSize length) throw (ExaltIOEx
       return WriteError;
     }
 
-  if (length + dataLength > bufferSize)
+  if (immediate)
     {
-      throw ExaltDeviceFullIOException();
-      return WriteError;
+      if (length + dataLength > bufferSize)
+	{
+	  throw ExaltDeviceFullIOException();
+	  return WriteError;
+	}
+
+      memcpy(buffer + dataLength, data, length * sizeof(XmlChar));
+      dataLength += length;
+      dataPresent = (dataLength != 0);
+
+      flush();
+      return WriteOk;
     }
 
-  for (size_t i = 0; i < length; i++)
+  //buffered mode
+  if (!dataLength && length >= bufferSize)
     {
-      buffer[dataLength + i] = ((XmlChar *)buf)[i];
+      //the data would fill the whole buffer --> deliver it without copying
+      try
+	{
+	  receiver->receiveData((XmlChar *)data, length);
+	}
+      catch (ExaltException)
+	{
+	  throw ExaltIOException();
+	}
+
+      return WriteOk;
     }
 
-  if (length)
-    dataPresent = true;
-  else
-    dataPresent = false;
+  while (length)
+    {
+      if (dataLength == bufferSize)
+	//the buffer is full --> deliver its content to the receiver
+	flush();
 
-  dataLength += length;
+      chunk = bufferSize - dataLength;
+      if (chunk > length)
+	chunk = length;
 
-  if (immediate)
-    flush();
+      memcpy(buffer + dataLength, data, chunk * sizeof(XmlChar));
+      dataLength += chunk;
+      dataPresent = true;
+
+      data += chunk;
+      length -= chunk;
+    }
 
   return WriteOk;
 }
@@ -203,8 +237,14 @@ IOState FunnelDevice::putChar(int c) throw (ExaltIOException)
 
   if (dataLength >= bufferSize)
     {
-      throw ExaltDeviceFullIOException();
-      return WriteError;
+      if (immediate)
+	{
+	  throw ExaltDeviceFullIOException();
+	  return WriteError;
+	}
+
+      //the buffer is full --> deliver its content to the receiver
+      flush();
     }
 
 
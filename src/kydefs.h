@@ -31,6 +31,7 @@
 #include "grammardefs.h"
 #include "hashtable.h"
 #include "list.h"
+#include "pool.h"
 #include "stack.h"
 
 
@@ -48,8 +49,59 @@ typedef unsigned int RuleFreq;
 
 /*!
   \brief Type for rule identifications.
+
+  The identifiers are small numbers (they are reused after the rules are deleted), so 32 bits are sufficient.
+ */
+typedef unsigned int RuleId;
+
+
+/*!
+  \brief Type for numbering the "transformation runs" of the grammar.
+ */
+typedef unsigned int RunNumber;
+
+
+/*!
+  \brief Flags of the rule events stored in the explicit rules format.
+
+  In the explicit rules format, each symbol appended to the root rule is followed by the combination of these flags, which describes how the grammar changed after the symbol had been appended. The decoder uses them to maintain the table of the rules without repeating the transformation of the grammar (see KYRuleTable).
+ */
+enum RuleEvent
+{
+  //! A new rule has been created from the last two symbols of the root rule.
+  RuleCreated = 1,
+
+  //! The rule referenced by the first symbol of the new rule has been deleted (Reduction %Rule 1).
+  RuleInlined = 2,
+
+  //! The grammar has been purged.
+  GrammarPurged = 4
+};
+
+
+/*!
+  \brief The number of different rule events (the size of the contexts used for coding them).
  */
-typedef unsigned long RuleId;
+#define RULE_EVENTS		8
+
+
+/*!
+  \brief The number of the contexts used for coding the rule events.
+
+  The context is selected by RULE_EVENT_CONTEXT().
+ */
+#define RULE_EVENT_CONTEXTS	4
+
+
+/*!
+  \brief Select the context for coding the rule event.
+
+  A rule is much more likely to be created after a variable than after a terminal, and the Reduction %Rule 1 can only follow another created rule.
+
+  \param _lastEvents_ The rule events of the previous transformation run.
+  \param _isVariable_ Indication whether the appended symbol is a variable.
+ */
+#define RULE_EVENT_CONTEXT(_lastEvents_, _isVariable_)	((((_lastEvents_) & RuleCreated) << 1) | ((_isVariable_) ? 1 : 0))
 
 
 
@@ -108,33 +160,47 @@ enum RuleMatchResult
  \brief Structure representing one rule.
 
  Each rule has its reference counter, right side (represented by a doubly-linked list of RuleElement), pointer to the last element of the right side, and unique rule identifier.
+
+ The members are ordered so that the structure contains no padding.
  */
 struct Rule
 {
 public:
-  //! Reference count of the rule.
-  RuleFreq refCount;
-
-  //! Counter used during arithmetic coding.
-  FreqValue counter;
-
   //! Body of the rule.
   RuleElement *body;
 
   //! Last element of the body.
   RuleElement *last;
 
+  //! Counter used during arithmetic coding.
+  FreqValue counter;
+
+  //! Reference count of the rule.
+  RuleFreq refCount;
+
   //! Unique identifier of the rule.
   RuleId id;
 
   //! Identification of the run when the rule was matched.
-  unsigned long matchRun;
+  RunNumber matchRun;
 
   //! Result of last rule-matching operation.
   RuleMatchResult matchResult;
 };
 
 
+/*!
+  \brief Pool of rule elements.
+ */
+typedef Pool<RuleElement> RuleElementPool;
+
+
+/*!
+  \brief Pool of rules.
+ */
+typedef Pool<Rule> RulePool;
+
+
 /*!
   \brief Definition of a rule set.
 
@@ -143,6 +209,20 @@ public:
 typedef List<Rule> RuleSet;
 
 
+/*!
+  \brief Linked list of rules whose expansions start with the same terminal.
+ */
+typedef List<Rule> RuleIndexList;
+
+
+/*!
+  \brief Hash array mapping values of terminals to the lists of rules whose expansions start with given terminal.
+
+  Since the string represented by a rule never changes, the first terminal of the rule is determined once, when the rule is created.
+ */
+typedef HashTable<unsigned long, RuleIndexList, List, 3079> RuleIndex;
+
+
 /*!
   \brief Description of symbol following given symbol - a neighbour.
 
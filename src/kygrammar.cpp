@@ -272,6 +272,18 @@ void KYGrammar::initKYGrammar(void)
   context = 0;
   useContextForOutput = false;
 
+  ruleContexts = 0;
+  ruleEvents = lastRuleEvents = 0;
+
+  NEW(elementPool, RuleElementPool);
+  NEW(rulePool, RulePool);
+
+  ruleTableSize = KY_GRAMMAR_RULE_TABLE_SIZE;
+  NEW(ruleTable, Rule*[ruleTableSize]);
+
+  for (size_t i = 0; i < ruleTableSize; i++)
+    ruleTable[i] = 0;
+
   NEW(ruleSet, RuleSet);
 
   ruleCounter = 0;
@@ -289,6 +301,9 @@ void KYGrammar::initKYGrammar(void)
   rootRule = 0;
   createRootRule();
 
+  NEW(ruleIndex, RuleIndex);
+  ruleIndex->setAutoDelete(true);
+
   NEW(terminalDigrams, TerminalDigrams);
   terminalDigrams->setAutoDelete(true);
  
@@ -351,9 +366,15 @@ KYGrammar::~KYGrammar(void)
   DELETE(testedRules);
   DELETE(availableRuleNumbers);
 
+  DELETE(ruleIndex);
   DELETE(terminalDigrams);
   DELETE(variableDigrams);
 
+  //free all the rules and their elements
+  DELETE_ARRAY(ruleTable);
+  DELETE(rulePool);
+  DELETE(elementPool);
+
   deleteDefaultTextCodec();
 }
 
@@ -372,9 +393,17 @@ void KYGrammar::purge(void)
   DELETE(testedRules);
   DELETE(availableRuleNumbers);
 
+  DELETE(ruleIndex);
   DELETE(terminalDigrams);
   DELETE(variableDigrams);
 
+  //free all the rules and their elements
+  rulePool->clear();
+  elementPool->clear();
+
+  for (size_t i = 0; i < ruleTableSize; i++)
+    ruleTable[i] = 0;
+
 
   NEW(flushStack, RuleElement*[KY_GRAMMAR_FLUSH_STACK_SIZE]);
   flushStackPos = -1;
@@ -396,6 +425,9 @@ void KYGrammar::purge(void)
   rootRule = 0;
   createRootRule();
 
+  NEW(ruleIndex, RuleIndex);
+  ruleIndex->setAutoDelete(true);
+
   NEW(terminalDigrams, TerminalDigrams);
   terminalDigrams->setAutoDelete(true);
  
@@ -439,6 +471,18 @@ void KYGrammar::setAlphabetBaseSize(size_t size)
 
 
 
+/*!
+  If the contexts are set, the encoder describes the changes of the grammar caused by each appended symbol (see RuleEvent), so the decoder doesn't have to repeat the transformation of the grammar. The contexts have to be initialized and bound to the arithmetic coder.
+
+  \param ctxts An array of RULE_EVENT_CONTEXTS contexts (NULL means the standard format).
+ */
+void KYGrammar::setRuleContexts(ContextBase **ctxts)
+{
+  ruleContexts = ctxts;
+}
+
+
+
 /*!
   The device used for the output of data is set.
 
@@ -464,21 +508,22 @@ Rule *KYGrammar::createRootRule(void)
     }
   else
     {
-      NEW(rootRule, Rule);
+      rootRule = rulePool->alloc();
 
       rootRule->counter = 1;
       
-      if (!rootRule)
-	return 0;
-      
       rootRule->refCount = 1;
       rootRule->id = ruleCounter;
       rootRule->body = 0;
       rootRule->last = 0;
 
+      rootRule->matchRun = 0;
+      rootRule->matchResult = Ignore;
+
       ruleCounter++;
 
       ruleSet->append(rootRule);
+      ruleTableInsert(rootRule);
 
       return rootRule;
     }
@@ -498,7 +543,7 @@ Rule *KYGrammar::createRule(RuleElement *start, RuleElement *last)
 {
   Rule *rule;
 
-  NEW(rule, Rule);
+  rule = rulePool->alloc();
 
 
   rule->counter = 1;
@@ -512,6 +557,8 @@ Rule *KYGrammar::createRule(RuleElement *start, RuleElement *last)
   rule->refCount = 0;
 
 
+  ruleEvents |= RuleCreated;
+
   if (availableRuleNumbers->isEmpty())
     {
       //if no of the old ids can be reused, use ruleCounter
@@ -536,12 +583,107 @@ Rule *KYGrammar::createRule(RuleElement *start, RuleElement *last)
     }
 
   ruleSet->append(rule);
+  ruleTableInsert(rule);
+  ruleIndexInsert(rule);
 
   return rule;
 }
 
 
 
+/*!
+  Stores the rule in the table of rules at the position given by its id. If necessary, the table is enlarged.
+
+  \param rule Pointer to the rule.
+
+  \sa findRule()
+ */
+void KYGrammar::ruleTableInsert(Rule *rule)
+{
+  if (rule->id >= ruleTableSize)
+    {
+      Rule **newTable;
+      size_t newSize = ruleTableSize;
+
+      while (rule->id >= newSize)
+	newSize *= 2;
+
+      NEW(newTable, Rule*[newSize]);
+
+      for (size_t i = 0; i < newSize; i++)
+	newTable[i] = (i < ruleTableSize) ? ruleTable[i] : 0;
+
+      DELETE_ARRAY(ruleTable);
+      ruleTable = newTable;
+      ruleTableSize = newSize;
+    }
+
+  ruleTable[rule->id] = rule;
+}
+
+
+
+/*!
+  Descends through the first elements of the rules until a terminal is reached.
+
+  \param rule Pointer to the rule.
+
+  \return The first terminal of the string represented by the rule.
+ */
+TerminalValue KYGrammar::getRuleFirstTerminal(Rule *rule)
+{
+  RuleElement *rel = rule->body;
+
+  CHECK_POINTER(rel);
+
+  while (rel->type != Terminal)
+    rel = rel->rule->body;
+
+  return rel->value;
+}
+
+
+
+/*!
+  Appends the rule to the list of the rules whose expansions start with the same terminal.
+
+  \param rule Pointer to the rule.
+
+  \sa ruleIndexRemove()
+ */
+void KYGrammar::ruleIndexInsert(Rule *rule)
+{
+  RuleIndexList *rl;
+  TerminalValue first = getRuleFirstTerminal(rule);
+
+  if (!(rl = ruleIndex->find(first)))
+    {
+      NEW(rl, RuleIndexList);
+      ruleIndex->insert(first, rl);
+    }
+
+  rl->append(rule);
+}
+
+
+
+/*!
+  Removes the rule from the rule index. The body of the rule has to be still valid.
+
+  \param rule Pointer to the rule.
+
+  \sa ruleIndexInsert()
+ */
+void KYGrammar::ruleIndexRemove(Rule *rule)
+{
+  RuleIndexList *rl = ruleIndex->find(getRuleFirstTerminal(rule));
+
+  if (rl)
+    rl->remove(rule);
+}
+
+
+
 /*!
   This method finds the rule with given rule.
 
@@ -551,13 +693,22 @@ Rule *KYGrammar::createRule(RuleElement *start, RuleElement *last)
  */
 Rule *KYGrammar::findRule(RuleId id)
 {
-  for (Rule *r = ruleSet->first(); r; r = ruleSet->next())
-    {
-      if (r->id == id)
-	return r;
-    }
+  if (id < ruleTableSize)
+    return ruleTable[id];
+  else
+    return 0;
+}
+
+
 
-  return 0;
+/*!
+  Allocates new rule element from the pool of the grammar. The elements passed to appendToRootRule() have to be allocated by this method.
+
+  \return Pointer to the rule element.
+ */
+RuleElement *KYGrammar::newRuleElement(void)
+{
+  return elementPool->alloc();
 }
 
 
@@ -906,23 +1057,14 @@ void KYGrammar::eatData(bool forced)
       bestTestedRule.rule = 0;
       bestTestedRule.length = 1;
 
-      //filter rules in ruleSet against the input
-      for (Rule *r = ruleSet->first(); r; r = ruleSet->next())
-	{
-	  //ignore the root rule
-	  if (r == rootRule)
-	    continue;
+      //only the rules starting with the first input symbol can match
+      RuleIndexList *candidates = ruleIndex->find(inputFirst->value);
 
+      for (Rule *r = candidates ? candidates->first() : 0; r; r = candidates->next())
+	{
 	  if (r->matchRun == runCount && r->matchResult == DoesntMatch)
 	    continue;
 
-	  if (r->body->type == Terminal && r->body->value != inputFirst->value)
-	    {
-	      r->matchResult = DoesntMatch;
-	      r->matchRun = runCount;
-	      continue;
-	    }
-
 	  //DBG("! Testing rule " << r->id);
 	  testedRule.rule = r;
 	  testedRule.currentElements = 0;
@@ -942,7 +1084,7 @@ void KYGrammar::eatData(bool forced)
 	}
       
       RuleElement *rel;
-      NEW(rel, RuleElement);
+      rel = elementPool->alloc();
 
       if (bestTestedRule.rule)
 	//use matched rule
@@ -990,6 +1132,7 @@ void KYGrammar::eatData(bool forced)
   else
     {
       bool canEnd = false;
+      bool representedByPushed;
       NeighboursDescription *nd;
       RuleElementNeighbour *ren;
       Rule *r, *rr;
@@ -1016,6 +1159,7 @@ void KYGrammar::eatData(bool forced)
 		{
 
 		  ruleStackPos = -1;
+		  representedByPushed = false;
 
 		  for (ren = nd->neighbours.first(); ren; ren = nd->neighbours.next())
 		    {
@@ -1027,25 +1171,39 @@ void KYGrammar::eatData(bool forced)
 			{
 			  if (ren->rule->matchRun != runCount)
 			    {
-			      ruleStackPos++;
-			      if (ruleStackPos == KY_GRAMMAR_RULE_STACK_SIZE)
+			      //the rule can't match if its second terminal differs from the input
+			      //(some terminals are followed by many different symbols)
+			      if (ren->origin->type != Terminal || !inputFirst->next ||
+				  ren->origin->value == inputFirst->next->value)
 				{
-				  FATAL("Size of the rule stack exceeded!");
+				  ruleStackPos++;
+				  if (ruleStackPos == KY_GRAMMAR_RULE_STACK_SIZE)
+				    {
+				      FATAL("Size of the rule stack exceeded!");
+				    }
+				  ruleStack[ruleStackPos] = ren->rule;
 				}
-			      ruleStack[ruleStackPos] = ren->rule;
-			      for (rr = nd->representedBy.first(); rr; rr = nd->representedBy.next())
+
+			      //all the rules pushed here are tested (or ignored) below, so it is enough
+			      //to go through them once
+			      if (!representedByPushed)
 				{
-				  if (rr->matchRun != runCount)
+				  representedByPushed = true;
+
+				  for (rr = nd->representedBy.first(); rr; rr = nd->representedBy.next())
 				    {
-				      //rule candidate that hasn't been tested in this run
-				      ruleStackPos++;
-				      if (ruleStackPos == KY_GRAMMAR_RULE_STACK_SIZE)
+				      if (rr->matchRun != runCount)
 					{
-					  FATAL("Size of the rule stack exceeded!");
+					  //rule candidate that hasn't been tested in this run
+					  ruleStackPos++;
+					  if (ruleStackPos == KY_GRAMMAR_RULE_STACK_SIZE)
+					    {
+					      FATAL("Size of the rule stack exceeded!");
+					    }
+
+					  ruleStack[ruleStackPos] = rr;
+					  //  DBG("EATDATA (mode 0) pushed rule: " << rr->id);
 					}
-
-				      ruleStack[ruleStackPos] = rr;
-				      //  DBG("EATDATA (mode 0) pushed rule: " << rr->id);
 				    }
 				}
 			    }
@@ -1165,7 +1323,7 @@ void KYGrammar::eatData(bool forced)
 	  if (testedRules->isEmpty())
 	    {
 	      RuleElement *rel;
-	      NEW(rel, RuleElement);
+	      rel = elementPool->alloc();
 
 	      if (bestTestedRule.rule)
 		//use matched rule
@@ -1277,17 +1435,35 @@ void KYGrammar::append(TerminalValue value)
 
 
 /*!
-  After call to this method, all symbols in the input queue are processed.
+  After call to this method, all symbols in the input queue are processed. The rules that were tested against the (now empty) input queue are forgotten, so the grammar may continue with new input.
 
   \sa eatData()
 */
 void KYGrammar::flush(void)
 {
+  TestedRule *tr;
+  TestedElement *s;
+
   DBG("Flushing the grammar...");
   while (inputFirst)
     {
       eatData(true);
     }
+
+  //the tested rules refer to the items of the input queue that are gone
+  for (tr = testedRules->first(); tr; tr = testedRules->next())
+    {
+      while (tr->currentElements)
+	{
+	  s = tr->currentElements;
+	  tr->currentElements = s->next;
+	  DELETE(s);
+	}
+
+      DELETE(tr);
+    }
+
+  testedRules->clear();
 }
 
 
@@ -1521,6 +1697,18 @@ void KYGrammar::appendToRootRule(RuleElement *newElement)
 //      }
 
 
+  if (ruleContexts && useContextForOutput)
+    {
+      //describe the changes of the grammar (explicit rules format)
+      if (size == KY_GRAMMAR_MAX_SIZE)
+	ruleEvents |= GrammarPurged;
+
+      ruleContexts[RULE_EVENT_CONTEXT(lastRuleEvents, appendedElement.type == Variable)]->encode(ruleEvents);
+    }
+
+  lastRuleEvents = ruleEvents;
+  ruleEvents = 0;
+
   if (size == KY_GRAMMAR_MAX_SIZE)
     {
       DBG("PURGING THE GRAMMAR");
@@ -1573,6 +1761,8 @@ void KYGrammar::reductionRule1(Rule *rule)
 
   availableRuleNumbers->enqueue(rid);
 
+  ruleEvents |= RuleInlined;
+
   //change all digrams of origRule to rule
   // :( some optimalisations would be fine...
   origRuleEl = origRule->body;
@@ -1646,11 +1836,13 @@ void KYGrammar::reductionRule1(Rule *rule)
     }
   
 
-  DELETE(rel);
+  elementPool->release(rel);
 
 
+  ruleIndexRemove(origRule);
   ruleSet->remove(origRule);
-  DELETE(origRule);
+  ruleTable[origRule->id] = 0;
+  rulePool->release(origRule);
 
 
   //the size of the grammar has to be decreased by one
@@ -1695,7 +1887,7 @@ Rule *KYGrammar::reductionRule2(RuleElement *elOrig1, RuleElement *elNew1)
     elOrig2->rule->refCount--;
 
   //create non-terminal substituting first pair (elOrig1, elOrig2)
-  NEW(var1, RuleElement);
+  var1 = elementPool->alloc();
   var1->type = Variable;
   var1->value = 0;
   var1->rule = 0;	//for safe
@@ -1714,7 +1906,7 @@ Rule *KYGrammar::reductionRule2(RuleElement *elOrig1, RuleElement *elNew1)
   CHECK_POINTER(elNew2);
 
   //create non-terminal substituting second pair (elNew1, elNew2)
-  NEW(var2, RuleElement);
+  var2 = elementPool->alloc();
   var2->type = Variable;
   var2->value = 0;
   var2->rule = 0;	//for safe
@@ -1764,8 +1956,8 @@ Rule *KYGrammar::reductionRule2(RuleElement *elOrig1, RuleElement *elNew1)
 
 
   //delete second pair of terminals
-  DELETE(elNew1);
-  DELETE(elNew2);
+  elementPool->release(elNew1);
+  elementPool->release(elNew2);
 
 
   RuleElement *relRep;
@@ -1839,7 +2031,7 @@ Rule *KYGrammar::reductionRule3(Rule *ruleOrig, RuleElement *elOrig1, RuleElemen
     elOrig2->rule->refCount--;
 
   //create non-terminal substituting first pair (elOrig1, elOrig2)
-  NEW(var1, RuleElement);
+  var1 = elementPool->alloc();
   var1->type = Variable;
   var1->value = 0;
   var1->rule = 0;	//for safe
@@ -1870,7 +2062,7 @@ Rule *KYGrammar::reductionRule3(Rule *ruleOrig, RuleElement *elOrig1, RuleElemen
   CHECK_POINTER(elNew2);
 
   //create non-terminal substituting second pair (elNew1, elNew2)
-  NEW(var2, RuleElement);
+  var2 = elementPool->alloc();
   var2->type = Variable;
   var2->value = 0;
   var2->rule = 0;	//for safe
@@ -1925,8 +2117,8 @@ Rule *KYGrammar::reductionRule3(Rule *ruleOrig, RuleElement *elOrig1, RuleElemen
 
 
   //delete second pair of terminals
-  DELETE(elNew1);
-  DELETE(elNew2);
+  elementPool->release(elNew1);
+  elementPool->release(elNew2);
 
 
   NeighboursDescription *ndRep;
@@ -75,6 +75,14 @@
 #define KY_GRAMMAR_EATDATA_PERIODICITY	800
 
 
+/*!
+  \brief The initial size of the table mapping rule ids to rules.
+
+  The table grows as necessary.
+ */
+#define KY_GRAMMAR_RULE_TABLE_SIZE	1024
+
+
 
 /*!
   \brief Class implementing the Kieffer-Yang grammar based data compression.
@@ -103,6 +111,9 @@ public:
   //! Set output device for output.
   void setOutputDevice(IODevice *device);
 
+  //! Set contexts for coding the rule events (explicit rules format).
+  virtual void setRuleContexts(ContextBase **ctxts);
+
   //! Append one terminal symbol to the root rule of the grammar.
   virtual void append(TerminalValue);
 
@@ -115,6 +126,9 @@ public:
   //! Find rule with given id.
   virtual Rule *findRule(RuleId id);
 
+  //! Allocate new rule element.
+  virtual RuleElement *newRuleElement(void);
+
   //! Print contents of the grammar.
   virtual void print(void);
 
@@ -135,6 +149,21 @@ protected:
   //! Indication is the arithmetic context is used for output (when compressing).
   bool useContextForOutput;
 
+  /*!
+    \brief The contexts for coding the rule events.
+
+    If the contexts are set, the encoder stores the rule events after each symbol appended to the root rule (the explicit rules format).
+
+    \sa setRuleContexts(), RuleEvent
+  */
+  ContextBase **ruleContexts;
+
+  //! The rule events of the current transformation run.
+  int ruleEvents;
+
+  //! The rule events of the previous transformation run.
+  int lastRuleEvents;
+
   //! A value of the symbol that has to be installed.
   long newSymbolToInstall;
 
@@ -182,6 +211,39 @@ protected:
   */
   Rule *rootRule;
 
+  /*!
+    \brief Pool of the rule elements of the grammar.
+
+    All rule elements (including those passed to appendToRootRule()) are allocated from this pool.
+
+    \sa newRuleElement()
+  */
+  RuleElementPool *elementPool;
+
+  //! Pool of the rules of the grammar.
+  RulePool *rulePool;
+
+  /*!
+    \brief Table mapping rule ids to rules.
+
+    Since the rule ids are reused, the table is dense.
+
+    \sa findRule()
+  */
+  Rule **ruleTable;
+
+  //! The size of the \a ruleTable.
+  size_t ruleTableSize;
+
+  /*!
+    \brief Index of the rules by the first terminals of their expansions.
+
+    Used for finding the candidates for the longest match of the input queue without examining all the rules of the grammar. The root rule is not indexed.
+
+    \sa ruleIndexInsert(), ruleIndexRemove()
+  */
+  RuleIndex *ruleIndex;
+
   /*!
     \brief Structure with information about dograms starting with terminals.
 
@@ -242,7 +304,7 @@ protected:
 
     New input run occurs when some symbol was appended to the right side of the root rule.
    */
-  unsigned long runCount;
+  RunNumber runCount;
 
 
   //! The size of the input queue.
@@ -274,6 +336,18 @@ protected:
   //! Create new rule with give right side.
   virtual Rule *createRule(RuleElement *, RuleElement *);
 
+  //! Store the rule in the table of rules.
+  virtual void ruleTableInsert(Rule *rule);
+
+  //! Get the first terminal of the string represented by the rule.
+  virtual TerminalValue getRuleFirstTerminal(Rule *rule);
+
+  //! Insert the rule into the rule index.
+  virtual void ruleIndexInsert(Rule *rule);
+
+  //! Remove the rule from the rule index.
+  virtual void ruleIndexRemove(Rule *rule);
+
 
   //! Test if the rule matches the current input.
   virtual bool ruleMatchesInput(TestedRule *testedRule, bool flush = false);
@@ -0,0 +1,450 @@
+/***************************************************************************
+    kyruletable.cpp  -  Definitions of KYRuleTable class methods.
+                             -------------------
+    begin                : October 19 2026
+    copyright            : (C) 2003 by Vojtch Toman
+    email                : vtoman@lit.cz
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+
+/*!
+  \file kyruletable.cpp
+  \brief Definitions of KYRuleTable class methods.
+  
+  This file contains the definitions of KYRuleTable class methods.
+*/
+
+#ifdef __GNUG__
+# pragma implementation
+#endif
+
+
+#include "kyruletable.h"
+
+
+
+/*!
+  Creates an empty table.
+ */
+KYRuleTable::KYRuleTable(void)
+{
+  context = 0;
+  ruleContexts = 0;
+  lastRuleEvents = 0;
+  ruleBodyContext = 0;
+  pendingRuleSymbol = -1;
+  outputDevice = 0;
+
+  NEW(nodePool, RuleNodePool);
+
+  ruleTableSize = KY_GRAMMAR_RULE_TABLE_SIZE;
+  NEW(ruleTable, RuleNode*[ruleTableSize]);
+
+  for (size_t i = 0; i < ruleTableSize; i++)
+    ruleTable[i] = 0;
+
+  NEW(availableRuleNumbers, Queue<RuleId>);
+  availableRuleNumbers->setAutoDelete(true);
+
+  //id 0 belongs to the root rule
+  ruleCounter = 1;
+
+  lastSymbol.node = appendedSymbol.node = 0;
+
+  expandStackSize = KY_RULE_TABLE_STACK_SIZE;
+  NEW(expandStack, RuleSymbol*[expandStackSize]);
+
+  NEW(buffer, XmlChar[KY_RULE_TABLE_BUFFER_SIZE]);
+}
+
+
+
+/*!
+  Frees the rules.
+ */
+KYRuleTable::~KYRuleTable(void)
+{
+  DELETE(availableRuleNumbers);
+  DELETE_ARRAY(ruleTable);
+  DELETE(nodePool);
+  DELETE_ARRAY(expandStack);
+  DELETE_ARRAY(buffer);
+}
+
+
+
+/*!
+  The context is used for distinguishing the terminals from the variables. The symbols of the new rules are installed into the context in the same way as the encoder does.
+
+  \param ctxt The context.
+ */
+void KYRuleTable::setContext(ContextBase *ctxt)
+{
+  context = ctxt;
+}
+
+
+
+/*!
+  \param ctxts An array of RULE_EVENT_CONTEXTS contexts (the same as used by the encoder, see KYGrammar::setRuleContexts()).
+ */
+void KYRuleTable::setRuleContexts(ContextBase **ctxts)
+{
+  ruleContexts = ctxts;
+}
+
+
+
+/*!
+  The context is selected in the same way as by the encoder.
+ */
+void KYRuleTable::decodeRuleEvent(void)
+{
+  CHECK_POINTER(ruleContexts);
+
+  applyRuleEvent(ruleContexts[RULE_EVENT_CONTEXT(lastRuleEvents, appendedSymbol.node)]->decode());
+}
+
+
+
+/*!
+  \param device The output device.
+ */
+void KYRuleTable::setOutputDevice(IODevice *device)
+{
+  outputDevice = device;
+}
+
+
+
+/*!
+  The string represented by the symbol is written to the output device. The symbol becomes the last symbol of the root rule after applyRuleEvent() is called.
+
+  \param symbol The decoded symbol (as returned by the context).
+ */
+void KYRuleTable::append(int symbol)
+{
+  makeSymbol(&appendedSymbol, symbol);
+
+  if (outputDevice)
+    {
+      if (appendedSymbol.node)
+	expandNode(appendedSymbol.node);
+      else
+	outputDevice->writeData((const char *)&appendedSymbol.value, SIZEOF_XML_CHAR);
+    }
+}
+
+
+
+/*!
+  The reference count of the variable is increased.
+
+  \param ruleSymbol The symbol.
+  \param symbol The decoded symbol (as returned by the context).
+ */
+void KYRuleTable::makeSymbol(RuleSymbol *ruleSymbol, int symbol)
+{
+  CHECK_POINTER(context);
+
+  if (symbol > context->lastFixedSymbol())
+    {
+      //a variable
+      RuleId id = symbol - context->lastFixedSymbol();
+
+      if (id >= ruleTableSize || !ruleTable[id])
+	{
+	  FATAL("Unknown rule decoded: " << id);
+	}
+
+      ruleSymbol->node = ruleTable[id];
+      ruleSymbol->id = id;
+      ruleSymbol->node->refCount++;
+    }
+  else
+    {
+      //a terminal
+      ruleSymbol->node = 0;
+      ruleSymbol->value = symbol;
+    }
+}
+
+
+
+/*!
+  If a new rule has been created, it consists of the last symbol of the root rule and of the appended symbol, and it becomes the last symbol of the root rule. Otherwise the appended symbol becomes the last symbol of the root rule.
+
+  \param events The combination of the flags of RuleEvent.
+ */
+void KYRuleTable::applyRuleEvent(int events)
+{
+  if (events & RuleCreated)
+    {
+      RuleNode *node;
+      RuleId id;
+
+      //the same id as assigned by KYGrammar::createRule()
+      if (availableRuleNumbers->isEmpty())
+	{
+	  id = ruleCounter++;
+	  context->installSymbol(context->lastFixedSymbol() + id);
+	}
+      else
+	{
+	  RuleId *rid = availableRuleNumbers->dequeue();
+
+	  id = *rid;
+	  DELETE(rid);
+	}
+
+      node = nodePool->alloc();
+      node->left = lastSymbol;
+      node->right = appendedSymbol;
+
+      //the references of the symbols are passed to the node,
+      //the node is referenced by the table and by the root rule
+      node->refCount = 2;
+      ruleTableInsert(id, node);
+
+      if (events & RuleInlined)
+	{
+	  //the rule referenced by the first symbol has been deleted
+	  RuleId *rid;
+
+	  NEW(rid, RuleId(lastSymbol.id));
+	  availableRuleNumbers->enqueue(rid);
+	}
+
+      lastSymbol.node = node;
+      lastSymbol.id = id;
+    }
+  else
+    {
+      releaseSymbol(&lastSymbol);
+      lastSymbol = appendedSymbol;
+    }
+
+  appendedSymbol.node = 0;
+  lastRuleEvents = events;
+
+  if (events & GrammarPurged)
+    purge();
+}
+
+
+
+/*!
+  The table is emptied in the same way as KYGrammar::purge() empties the grammar.
+ */
+void KYRuleTable::purge(void)
+{
+  nodePool->clear();
+
+  for (size_t i = 0; i < ruleTableSize; i++)
+    ruleTable[i] = 0;
+
+  availableRuleNumbers->clear();
+
+  ruleCounter = 1;
+  lastSymbol.node = appendedSymbol.node = 0;
+  pendingRuleSymbol = -1;
+}
+
+
+
+/*!
+  The context has to be initialized with the same base size as the context of the decoded symbols.
+
+  \param ctxt The context.
+ */
+void KYRuleTable::setRuleBodyContext(ContextBase *ctxt)
+{
+  ruleBodyContext = ctxt;
+}
+
+
+
+/*!
+  Each rule of the Re-Pair format is encoded as a pair of symbols, every other call therefore creates a new rule (see defineRule()). The rules of each block have to be decoded after purge().
+
+  \return False if the end-of-message symbol (the end of the rules of the block) has been decoded, true otherwise.
+ */
+bool KYRuleTable::decodeRuleBody(void)
+{
+  CHECK_POINTER(ruleBodyContext);
+
+  int symbol = ruleBodyContext->decode();
+
+  if (symbol == ruleBodyContext->endOfMessage)
+    return false;
+
+  if (symbol == ContextBase::NotKnown)
+    {
+      FATAL("Unknown symbol decoded!!!");
+    }
+
+  if (pendingRuleSymbol < 0)
+    pendingRuleSymbol = symbol;
+  else
+    {
+      defineRule(pendingRuleSymbol, symbol);
+      pendingRuleSymbol = -1;
+    }
+
+  return true;
+}
+
+
+
+/*!
+  The rule gets the next id of the counter, and its symbol is installed into the context of the decoded symbols (and into the context of the rule bodies, if set) in the same way as by RePairGrammar::encodeGrammar().
+
+  \param left The first symbol (as returned by the context).
+  \param right The second symbol (as returned by the context).
+ */
+void KYRuleTable::defineRule(int left, int right)
+{
+  RuleNode *node;
+  RuleId id = ruleCounter++;
+
+  node = nodePool->alloc();
+  makeSymbol(&node->left, left);
+  makeSymbol(&node->right, right);
+
+  //the node is referenced by the table
+  node->refCount = 1;
+  ruleTableInsert(id, node);
+
+  context->installSymbol(context->lastFixedSymbol() + id);
+
+  if (ruleBodyContext)
+    ruleBodyContext->installSymbol(context->lastFixedSymbol() + id);
+}
+
+
+
+/*!
+  If the symbol is a variable and its node is not referenced any more, the node is deleted (together with the references of its symbols).
+
+  \param symbol The symbol.
+ */
+void KYRuleTable::releaseSymbol(RuleSymbol *symbol)
+{
+  RuleNode *node = symbol->node;
+
+  while (node && !--node->refCount)
+    {
+      RuleNode *left = node->left.node;
+
+      //release the right subtree recursively, the left one iteratively
+      releaseSymbol(&node->right);
+      nodePool->release(node);
+      node = left;
+    }
+}
+
+
+
+/*!
+  If the id was used by another rule before, the node of that rule is released.
+
+  \param id The id of the rule.
+  \param node The node of the rule.
+ */
+void KYRuleTable::ruleTableInsert(RuleId id, RuleNode *node)
+{
+  if (id >= ruleTableSize)
+    {
+      RuleNode **newTable;
+      size_t newSize = ruleTableSize;
+
+      while (id >= newSize)
+	newSize *= 2;
+
+      NEW(newTable, RuleNode*[newSize]);
+
+      for (size_t i = 0; i < newSize; i++)
+	newTable[i] = (i < ruleTableSize) ? ruleTable[i] : 0;
+
+      DELETE_ARRAY(ruleTable);
+      ruleTable = newTable;
+      ruleTableSize = newSize;
+    }
+
+  if (ruleTable[id])
+    {
+      RuleSymbol old;
+
+      old.node = ruleTable[id];
+      releaseSymbol(&old);
+    }
+
+  ruleTable[id] = node;
+}
+
+
+
+/*!
+  The symbols are expanded using an explicit stack, and the terminals are written to the output device in blocks.
+
+  \param node The node.
+ */
+void KYRuleTable::expandNode(RuleNode *node)
+{
+  size_t stackPos = 0;
+  size_t length = 0;
+  RuleSymbol *symbol;
+
+  expandStack[stackPos++] = &node->right;
+  expandStack[stackPos++] = &node->left;
+
+  while (stackPos)
+    {
+      symbol = expandStack[--stackPos];
+
+      if (!symbol->node)
+	{
+	  //a terminal
+	  buffer[length++] = symbol->value;
+
+	  if (length == KY_RULE_TABLE_BUFFER_SIZE)
+	    {
+	      outputDevice->writeData((const char *)buffer, length * SIZEOF_XML_CHAR);
+	      length = 0;
+	    }
+
+	  continue;
+	}
+
+      if (stackPos + 2 > expandStackSize)
+	{
+	  //enlarge the stack
+	  RuleSymbol **newStack;
+
+	  NEW(newStack, RuleSymbol*[2 * expandStackSize]);
+
+	  for (size_t i = 0; i < stackPos; i++)
+	    newStack[i] = expandStack[i];
+
+	  DELETE_ARRAY(expandStack);
+	  expandStack = newStack;
+	  expandStackSize *= 2;
+	}
+
+      //the left symbol is expanded first
+      expandStack[stackPos++] = &symbol->node->right;
+      expandStack[stackPos++] = &symbol->node->left;
+    }
+
+  if (length)
+    outputDevice->writeData((const char *)buffer, length * SIZEOF_XML_CHAR);
+}
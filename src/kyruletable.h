@@ -0,0 +1,225 @@
+/***************************************************************************
+    kyruletable.h  -  Definition of KYRuleTable class.
+                             -------------------
+    begin                : October 19 2026
+    copyright            : (C) 2003 by Vojtch Toman
+    email                : vtoman@lit.cz
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+
+/*!
+  \file kyruletable.h
+  \brief Definition of KYRuleTable class.
+  
+  This file contains the definition of KYRuleTable class.
+*/
+
+#ifdef __GNUG__
+# pragma interface
+#endif
+
+#ifndef KYRULETABLE_H
+#define KYRULETABLE_H
+
+
+#include "defs.h"
+#include "contextbase.h"
+#include "iodevice.h"
+#include "kydefs.h"
+#include "kygrammar.h"
+#include "pool.h"
+#include "queue.h"
+
+
+
+/*!
+  \brief The initial size of the stack used for expanding the rules.
+
+  The stack grows as necessary.
+ */
+#define KY_RULE_TABLE_STACK_SIZE	1024
+
+
+/*!
+  \brief The size of the buffer for the expanded data.
+ */
+#define KY_RULE_TABLE_BUFFER_SIZE	4096
+
+
+
+struct RuleNode;	//forward definition of the RuleNode structure
+
+
+
+/*!
+  \brief A symbol of the rule table.
+
+  The symbol is either a terminal, or a variable (a node of the rule table).
+ */
+struct RuleSymbol
+{
+  //! The node of the variable (NULL for a terminal).
+  RuleNode *node;
+
+  //! The id of the variable.
+  RuleId id;
+
+  //! The value of the terminal.
+  TerminalValue value;
+};
+
+
+/*!
+  \brief A rule of the rule table.
+
+  Each rule consists of exactly two symbols. The nodes are shared by the rules which contain them, and they are deleted when no rule (and no entry of the table) refers to them, so the string represented by a node never changes, even if its id is reused for another rule.
+ */
+struct RuleNode
+{
+  //! The first symbol of the rule.
+  RuleSymbol left;
+
+  //! The second symbol of the rule.
+  RuleSymbol right;
+
+  //! The number of references to the node.
+  RuleFreq refCount;
+};
+
+
+/*!
+  \brief Pool of rule nodes.
+ */
+typedef Pool<RuleNode> RuleNodePool;
+
+
+
+/*!
+  \brief Class implementing the decoder of the explicit rules format.
+
+  In the explicit rules format, the encoder (KYGrammar) stores a rule event (see RuleEvent) after each symbol appended to the root rule. The event tells whether the last two symbols of the root rule have been replaced by a new rule, whether the rule referenced by the first of them has been deleted, and whether the grammar has been purged. This is all the decoder needs to know to maintain the mapping of the rule ids to the strings they represent: the ids are assigned in the same way as by the encoder, so they don't have to be stored.
+
+  The decoder therefore doesn't repeat the transformation of the grammar (there is no digram bookkeeping and no reduction rules); it only expands the decoded symbols.
+
+  The table is also used by the decoder of the Re-Pair format (see RePairGrammar). There the rules of each block are decoded by decodeRuleBody() before the symbols of the root sequence, and no rule events are used.
+*/
+class KYRuleTable
+{
+public:
+  //! A constructor.
+  KYRuleTable(void);
+
+  //! A destructor.
+  virtual ~KYRuleTable(void);
+
+  //! Set the context of the decoded symbols.
+  virtual void setContext(ContextBase *ctxt);
+
+  //! Set the device for the expanded data.
+  virtual void setOutputDevice(IODevice *device);
+
+  //! Expand one decoded symbol.
+  virtual void append(int symbol);
+
+  //! Set the contexts of the rule events.
+  virtual void setRuleContexts(ContextBase **ctxts);
+
+  //! Decode and apply the rule event which follows the symbol.
+  virtual void decodeRuleEvent(void);
+
+  //! Apply the rule event which follows the symbol.
+  virtual void applyRuleEvent(int events);
+
+  //! Delete all rules.
+  virtual void purge(void);
+
+  //! Set the context of the rule bodies (Re-Pair format).
+  virtual void setRuleBodyContext(ContextBase *ctxt);
+
+  //! Decode one symbol of the rule bodies (Re-Pair format).
+  virtual bool decodeRuleBody(void);
+
+  //! Create a new rule consisting of the two symbols.
+  virtual void defineRule(int left, int right);
+
+protected:
+  //! The context of the decoded symbols.
+  ContextBase *context;
+
+  //! The contexts of the rule events.
+  ContextBase **ruleContexts;
+
+  //! The rule events of the previous symbol.
+  int lastRuleEvents;
+
+  //! The context of the rule bodies (Re-Pair format).
+  ContextBase *ruleBodyContext;
+
+  //! The decoded first symbol of the rule (-1 if none).
+  int pendingRuleSymbol;
+
+  //! The device for the expanded data.
+  IODevice *outputDevice;
+
+  //! The pool of the nodes.
+  RuleNodePool *nodePool;
+
+  //! Table mapping rule ids to the nodes.
+  RuleNode **ruleTable;
+
+  //! The size of the \a ruleTable.
+  size_t ruleTableSize;
+
+  //! Counter for numbering rules (the same as KYGrammar::ruleCounter).
+  RuleId ruleCounter;
+
+  //! Queue of available rule ids (the same as KYGrammar::availableRuleNumbers).
+  Queue<RuleId> *availableRuleNumbers;
+
+  //! The last symbol of the root rule.
+  RuleSymbol lastSymbol;
+
+  //! The symbol appended to the root rule.
+  RuleSymbol appendedSymbol;
+
+  //! The stack of symbols used when expanding the rules.
+  RuleSymbol **expandStack;
+
+  //! The size of the \a expandStack.
+  size_t expandStackSize;
+
+  //! The buffer for the expanded data.
+  XmlChar *buffer;
+
+  //! Make a symbol of the decoded one.
+  virtual void makeSymbol(RuleSymbol *ruleSymbol, int symbol);
+
+  //! Increase the reference count of the symbol.
+  inline void retainSymbol(RuleSymbol *symbol)
+  {
+    if (symbol->node)
+      symbol->node->refCount++;
+  }
+
+  //! Decrease the reference count of the symbol.
+  virtual void releaseSymbol(RuleSymbol *symbol);
+
+  //! Store the node in the table of rules.
+  virtual void ruleTableInsert(RuleId id, RuleNode *node);
+
+  //! Write the string represented by the node.
+  virtual void expandNode(RuleNode *node);
+};
+
+
+
+#endif //KYRULETABLE_H
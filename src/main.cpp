@@ -24,7 +24,9 @@
 
 
 #include <cstdio>
+#include <cstdlib>
 #include <fstream>
+#include <unistd.h>	//for truncate()
 
 
 #include "defs.h"
@@ -230,9 +232,45 @@ static void usage(void)
   OUTPUTNL("  -f|--force            overwrite files, don't stop on errors");
   OUTPUTNL("  -c|--stdout           write on standard output");
   OUTPUTNL("  -a|--adaptive         use the adaptive model");
+  OUTPUTNL("  -M|--model name       use the model name (simple, adaptive, or auto to");
+  OUTPUTNL("                        select it by compressing the first 256 kB with both)");
+  OUTPUTNL("  -O|--objective obj    select the model by obj (ratio or speed, default");
+  OUTPUTNL("                        ratio)");
+  OUTPUTNL("  -r|--explicit-rules   store the rules explicitly (faster decompression)");
+  OUTPUTNL("  -R|--repair           build the grammar offline by Re-Pair (needs more");
+  OUTPUTNL("                        memory)");
+  OUTPUTNL("  -k|--containers       code the text of each path by a separate grammar");
+  OUTPUTNL("                        (simple model only)");
+  OUTPUTNL("  -n|--typed-values     code numbers and dates in binary form (simple model");
+  OUTPUTNL("                        only)");
+  OUTPUTNL("  -i|--value-cache      code repeated values by their indices (adaptive");
+  OUTPUTNL("                        model only)");
+  OUTPUTNL("  -w|--word-tokens      code repeated words of the text by their ids");
+  OUTPUTNL("                        (simple model only)");
+  OUTPUTNL("  -N|--graph-limit n    limit the model of each element to n nodes and");
+  OUTPUTNL("                        transitions (adaptive model only)");
   OUTPUTNL("  -x|--erase            erase source files after (de)compression");
   OUTPUTNL("  -e|--encoding enc     set decompressed output encoding (to be implemented)");
   OUTPUTNL("  -l|--list-encodings   list recognized encodings");
+  OUTPUTNL("  -b|--buffer-size kb   set the size of the input blocks to kb kilobytes");
+  OUTPUTNL("                        (64 to 4096, default 64)");
+  OUTPUTNL("  -t|--train            create a dictionary from the files (requires -o)");
+  OUTPUTNL("  -o|--output file      write the dictionary to file");
+  OUTPUTNL("  -D|--dictionary file  use the dictionary in file for (de)compression");
+  OUTPUTNL("  -S|--dtd file         predict the structure by the DTD in file (adaptive");
+  OUTPUTNL("                        model only)");
+  OUTPUTNL("  -p|--path expr        decompress only the elements matching the path");
+  OUTPUTNL("                        (e.g. /dblp/article/title or //title)");
+  OUTPUTNL("  -C|--count expr       count the elements matching the path in the");
+  OUTPUTNL("                        compressed files");
+  OUTPUTNL("  -G|--grep text        display the elements containing the text in the");
+  OUTPUTNL("                        compressed files (the elements are given by -p or");
+  OUTPUTNL("                        --count, default /*/*)");
+  OUTPUTNL("  -A|--archive file     compress the files into one solid archive file");
+  OUTPUTNL("  -P|--append file      append the files to the solid archive file");
+  OUTPUTNL("  -T|--list file        list the members of the solid archive file");
+  OUTPUTNL("  -X|--extract file     extract the solid archive file (all members, or");
+  OUTPUTNL("                        only the members given as files)");
   OUTPUTNL("  -v|--verbose          be verbose");
   OUTPUTNL("  -m|--print-models     display the models of the elements (requires the adaptive model)");
   OUTPUTNL("                        (warning: the models may be huge!)");
@@ -277,8 +315,24 @@ int main(int argc, char **argv)
   bool printGrammar = false;			//the resulting grammar is not printed by default
   bool printModels = false;			//the resulting models are not printed by default
   bool useStdout = false;			//use standard output?
-  bool adaptiveModel = false;			//use adaptive model?
+  ExaltOptions::OptionValue model = ExaltOptions::SimpleModel;	//the model used for compression
+  ExaltOptions::OptionValue modelObjective = ExaltOptions::Ratio;	//the objective of the selection of the model
+  bool explicitRules = false;			//store the rules explicitly?
+  bool rePair = false;				//use the Re-Pair grammar?
+  bool useContainers = false;			//route the character data to the containers?
+  bool typedValues = false;			//code the numbers and the dates in the binary form?
+  bool valueCache = false;			//code the repeated values by their indices?
+  bool wordTokens = false;			//code the repeated words by their ids?
   bool erase = false;				//erase source files after (de)compression?
+  int bufferSize = ExaltOptions::None;		//size of the parser input buffer (in bytes)
+  int graphLimit = ExaltOptions::None;		//maximal size of the graphs of the elements
+  char *dictionaryFileName = 0;			//the dictionary used for (de)compression
+  char *dtdFileName = 0;			//the DTD used for (de)compression
+  char *path = 0;				//the path filter used for decompression
+  char *countPath = 0;				//the path of the counted elements
+  char *grepPattern = 0;			//the text searched for in the elements
+  char *trainOutputFileName = 0;		//the file where the trained dictionary is stored
+  char *archiveFileName = 0;			//the solid archive
 
   //list of recognized encodings (not necessarily supported!)
   Encodings::EncodingName encodingNames[] = { ENCODING_NAMES };
@@ -338,7 +392,88 @@ int main(int argc, char **argv)
 
 	  else if (OPT("--adaptive") || OPT("-a"))
 	    {
-	      adaptiveModel = true;
+	      model = ExaltOptions::AdaptiveModel;
+	    }
+
+	  else if (OPT("--model") || OPT("-M"))
+	    {
+	      //set the model
+	      if ((++i) >= argc)
+		OPT_ERROR(i);
+
+	      if (OPT("simple"))
+		model = ExaltOptions::SimpleModel;
+	      else if (OPT("adaptive"))
+		model = ExaltOptions::AdaptiveModel;
+	      else if (OPT("auto"))
+		model = ExaltOptions::AutoModel;
+	      else
+		{
+		  ERR("Invalid model: '" << argv[i] << "'.");
+		  throw ExaltOptionException();
+		}
+	    }
+
+	  else if (OPT("--objective") || OPT("-O"))
+	    {
+	      //set the objective of the selection of the model
+	      if ((++i) >= argc)
+		OPT_ERROR(i);
+
+	      if (OPT("ratio"))
+		modelObjective = ExaltOptions::Ratio;
+	      else if (OPT("speed"))
+		modelObjective = ExaltOptions::Speed;
+	      else
+		{
+		  ERR("Invalid objective: '" << argv[i] << "'.");
+		  throw ExaltOptionException();
+		}
+	    }
+
+	  else if (OPT("--explicit-rules") || OPT("-r"))
+	    {
+	      explicitRules = true;
+	    }
+
+	  else if (OPT("--repair") || OPT("-R"))
+	    {
+	      rePair = true;
+	    }
+
+	  else if (OPT("--containers") || OPT("-k"))
+	    {
+	      useContainers = true;
+	    }
+
+	  else if (OPT("--typed-values") || OPT("-n"))
+	    {
+	      typedValues = true;
+	    }
+
+	  else if (OPT("--value-cache") || OPT("-i"))
+	    {
+	      valueCache = true;
+	    }
+
+	  else if (OPT("--word-tokens") || OPT("-w"))
+	    {
+	      wordTokens = true;
+	    }
+
+	  else if (OPT("--graph-limit") || OPT("-N"))
+	    {
+	      //set the maximal size of the graphs of the elements
+	      if ((++i) >= argc)
+		OPT_ERROR(i);
+
+	      graphLimit = atoi(argv[i]);
+
+	      if (graphLimit <= 0)
+		{
+		  ERR("Invalid graph limit: '" << argv[i] << "'.");
+		  throw ExaltOptionException();
+		}
 	    }
 
 	  else if (OPT("--encoding") || OPT("-e"))
@@ -350,6 +485,102 @@ int main(int argc, char **argv)
 	      SET_OUTPUT_ENCODING(argv[i]);
 	    }
 
+	  else if (OPT("--buffer-size") || OPT("-b"))
+	    {
+	      //set the size of the parser input buffer
+	      if ((++i) >= argc)
+		OPT_ERROR(i);
+
+	      bufferSize = atoi(argv[i]);
+
+	      if (bufferSize <= 0)
+		{
+		  ERR("Invalid buffer size: '" << argv[i] << "'.");
+		  throw ExaltOptionException();
+		}
+
+	      bufferSize *= 1024;
+	    }
+
+	  else if (OPT("--train") || OPT("-t"))
+	    {
+	      selectedAction = Train;
+	    }
+
+	  else if (OPT("--output") || OPT("-o"))
+	    {
+	      //set the output file of the dictionary
+	      if ((++i) >= argc)
+		OPT_ERROR(i);
+
+	      trainOutputFileName = argv[i];
+	    }
+
+	  else if (OPT("--dictionary") || OPT("-D"))
+	    {
+	      //set the dictionary file
+	      if ((++i) >= argc)
+		OPT_ERROR(i);
+
+	      dictionaryFileName = argv[i];
+	    }
+
+	  else if (OPT("--dtd") || OPT("-S"))
+	    {
+	      //set the DTD file
+	      if ((++i) >= argc)
+		OPT_ERROR(i);
+
+	      dtdFileName = argv[i];
+	    }
+
+	  else if (OPT("--path") || OPT("-p"))
+	    {
+	      //set the path filter
+	      if ((++i) >= argc)
+		OPT_ERROR(i);
+
+	      path = argv[i];
+	    }
+
+	  else if (OPT("--count") || OPT("-C"))
+	    {
+	      //count the matching elements
+	      if ((++i) >= argc)
+		OPT_ERROR(i);
+
+	      selectedAction = Query;
+	      countPath = argv[i];
+	    }
+
+	  else if (OPT("--grep") || OPT("-G"))
+	    {
+	      //display the elements containing the text
+	      if ((++i) >= argc)
+		OPT_ERROR(i);
+
+	      selectedAction = Query;
+	      grepPattern = argv[i];
+	    }
+
+	  else if (OPT("--archive") || OPT("-A") || OPT("--append") || OPT("-P") || OPT("--list") || OPT("-T") || OPT("--extract") || OPT("-X"))
+	    {
+	      //set the archive file
+	      if (OPT("--archive") || OPT("-A"))
+		selectedAction = CreateArchive;
+	      else if (OPT("--append") || OPT("-P"))
+		selectedAction = AppendArchive;
+	      else if (OPT("--list") || OPT("-T"))
+		selectedAction = ListArchive;
+	      else
+		selectedAction = ExtractArchive;
+
+	      if ((++i) >= argc)
+		OPT_ERROR(i);
+
+	      archiveFileName = argv[i];
+	    }
+
 	  else if (OPT("--list-encodings") || OPT("-l"))
 	    {
 	      OUTPUTNL("List of recognized input/output encodings (not necessarily supported!):");
@@ -422,6 +653,21 @@ int main(int argc, char **argv)
 	  else
 	    filesToProcess.append(unrecognized);
 	}
+
+      if ((selectedAction == CreateArchive || selectedAction == AppendArchive) && filesToProcess.isEmpty())
+	OPT_NONE;
+
+      if (selectedAction == Train)
+	{
+	  if (filesToProcess.isEmpty())
+	    OPT_NONE;
+
+	  if (!trainOutputFileName)
+	    {
+	      ERR("No output file for the dictionary specified.");
+	      throw ExaltOptionException();
+	    }
+	}
     }
 
   catch (ExaltException)
@@ -447,14 +693,48 @@ int main(int argc, char **argv)
   else
     ExaltOptions::setOption(ExaltOptions::PrintGrammar, ExaltOptions::No);
 
-  if (adaptiveModel)
-    ExaltOptions::setOption(ExaltOptions::Model, ExaltOptions::AdaptiveModel);
+  ExaltOptions::setOption(ExaltOptions::Model, model);
+  ExaltOptions::setOption(ExaltOptions::ModelObjective, modelObjective);
+
+  if (explicitRules)
+    ExaltOptions::setOption(ExaltOptions::ExplicitRules, ExaltOptions::Yes);
+  else
+    ExaltOptions::setOption(ExaltOptions::ExplicitRules, ExaltOptions::No);
+
+  if (rePair)
+    ExaltOptions::setOption(ExaltOptions::Grammar, ExaltOptions::RePair);
+  else
+    ExaltOptions::setOption(ExaltOptions::Grammar, ExaltOptions::KiefferYang);
+
+  if (useContainers)
+    ExaltOptions::setOption(ExaltOptions::Containers, ExaltOptions::Yes);
+  else
+    ExaltOptions::setOption(ExaltOptions::Containers, ExaltOptions::No);
+
+  if (typedValues)
+    ExaltOptions::setOption(ExaltOptions::TypedValues, ExaltOptions::Yes);
+  else
+    ExaltOptions::setOption(ExaltOptions::TypedValues, ExaltOptions::No);
+
+  if (valueCache)
+    ExaltOptions::setOption(ExaltOptions::ValueCache, ExaltOptions::Yes);
+  else
+    ExaltOptions::setOption(ExaltOptions::ValueCache, ExaltOptions::No);
+
+  if (wordTokens)
+    ExaltOptions::setOption(ExaltOptions::WordTokens, ExaltOptions::Yes);
   else
-    ExaltOptions::setOption(ExaltOptions::Model, ExaltOptions::SimpleModel);
+    ExaltOptions::setOption(ExaltOptions::WordTokens, ExaltOptions::No);
 
   //set output encoding
   ExaltOptions::setOption(ExaltOptions::Encoding, encodingMIB);
 
+  //set the size of the parser input buffer
+  ExaltOptions::setOption(ExaltOptions::ParserBufferSize, bufferSize);
+
+  //set the maximal size of the graphs of the elements
+  ExaltOptions::setOption(ExaltOptions::GraphLimit, graphLimit);
+
 
   //perform selected action
   switch (selectedAction)
@@ -514,6 +794,13 @@ int main(int argc, char **argv)
 	  try
 	    {
 	      ExaltCodec exaltCodec;
+
+	      if (dictionaryFileName)
+		exaltCodec.setDictionary(dictionaryFileName);
+
+	      if (dtdFileName)
+		exaltCodec.setDtd(dtdFileName);
+
 	      ENCODE_DECODE(encode);
 	    }
 
@@ -606,6 +893,15 @@ int main(int argc, char **argv)
 	  
 	  try
 	    {
+	      if (dictionaryFileName)
+		exaltCodec.setDictionary(dictionaryFileName);
+
+	      if (dtdFileName)
+		exaltCodec.setDtd(dtdFileName);
+
+	      if (path)
+		exaltCodec.setPathFilter(path);
+
 	      ENCODE_DECODE(decode);
 	    }
 	  
@@ -629,6 +925,324 @@ int main(int argc, char **argv)
       
       break;
 
+    case Train:
+      {
+	ExaltDictionary dictionary;
+
+	//the documents are not sampled, so the automatic selection uses the default model
+	dictionary.setModel(model == ExaltOptions::SimpleModel ? ExaltOptions::SimpleModel : ExaltOptions::AdaptiveModel);
+
+	try
+	  {
+	    if (dtdFileName)
+	      dictionary.setDtd(dtdFileName);
+
+	    for (char *fileName = filesToProcess.first(); fileName; fileName = filesToProcess.next())
+	      {
+		if (verbose)
+		  OUTPUTENL("Adding '" << fileName << "' to the dictionary.");
+
+		dictionary.addDocument(fileName);
+	      }
+
+	    if (verbose)
+	      OUTPUTENL("Writing the dictionary to '" << trainOutputFileName << "'.");
+
+	    dictionary.save(trainOutputFileName);
+	  }
+
+	catch (ExaltException)
+	  {
+	    ERR("Failed to create the dictionary '" << trainOutputFileName << "'!");
+	    remove(trainOutputFileName);
+	    exit(EXIT_FAILURE);
+	  }
+      }
+
+      break;
+
+    case CreateArchive:
+      {
+	ExaltCodec exaltCodec;
+	bool res = false;
+
+	if (!force)
+	  {
+	    ifstream outFile(archiveFileName);
+
+	    if (outFile)
+	      {
+		outFile.close();
+		ERR("File '" << archiveFileName << "' exists, use -f to overwrite it.");
+		exit(EXIT_FAILURE);
+	      }
+	  }
+
+	for (char *fileName = filesToProcess.first(); fileName; fileName = filesToProcess.next())
+	  {
+	    ifstream inFile(fileName);
+
+	    if (inFile)
+	      inFile.close();
+	    else
+	      {
+		ERR("'" << fileName << "' doesn't exist!");
+		exit(EXIT_FAILURE);
+	      }
+	  }
+
+	try
+	  {
+	    if (dictionaryFileName)
+	      exaltCodec.setDictionary(dictionaryFileName);
+
+	    if (dtdFileName)
+	      exaltCodec.setDtd(dtdFileName);
+
+	    res = exaltCodec.encodeArchive(archiveFileName, &filesToProcess);
+	  }
+
+	catch (ExaltException)
+	  {
+	    res = false;
+	  }
+
+	if (!res)
+	  {
+	    ERR("Failed to create the archive '" << archiveFileName << "'!");
+	    remove(archiveFileName);
+	    exit(EXIT_FAILURE);
+	  }
+	else
+	  if (erase)
+	    for (char *fileName = filesToProcess.first(); fileName; fileName = filesToProcess.next())
+	      remove(fileName);
+      }
+
+      break;
+
+    case AppendArchive:
+      {
+	ExaltCodec exaltCodec;
+	bool res = false;
+	long archiveSize = 0;
+	ifstream archiveFile(archiveFileName);
+
+	if (archiveFile)
+	  {
+	    //remember the size, so the archive can be restored if appending fails
+	    archiveFile.seekg(0, ios::end);
+	    archiveSize = archiveFile.tellg();
+	    archiveFile.close();
+	  }
+	else
+	  {
+	    ERR("'" << archiveFileName << "' doesn't exist!");
+	    exit(EXIT_FAILURE);
+	  }
+
+	for (char *fileName = filesToProcess.first(); fileName; fileName = filesToProcess.next())
+	  {
+	    ifstream inFile(fileName);
+
+	    if (inFile)
+	      inFile.close();
+	    else
+	      {
+		ERR("'" << fileName << "' doesn't exist!");
+		exit(EXIT_FAILURE);
+	      }
+	  }
+
+	try
+	  {
+	    if (dictionaryFileName)
+	      exaltCodec.setDictionary(dictionaryFileName);
+
+	    if (dtdFileName)
+	      exaltCodec.setDtd(dtdFileName);
+
+	    res = exaltCodec.appendArchive(archiveFileName, &filesToProcess);
+	  }
+
+	catch (ExaltException)
+	  {
+	    res = false;
+	  }
+
+	if (!res)
+	  {
+	    ERR("Failed to append to the archive '" << archiveFileName << "'!");
+	    truncate(archiveFileName, archiveSize);
+	    exit(EXIT_FAILURE);
+	  }
+	else
+	  if (erase)
+	    for (char *fileName = filesToProcess.first(); fileName; fileName = filesToProcess.next())
+	      remove(fileName);
+      }
+
+      break;
+
+    case ListArchive:
+      {
+	ExaltCodec exaltCodec;
+	ExaltArchive archive;
+
+	try
+	  {
+	    if (dictionaryFileName)
+	      exaltCodec.setDictionary(dictionaryFileName);
+
+	    if (dtdFileName)
+	      exaltCodec.setDtd(dtdFileName);
+
+	    if (!exaltCodec.listArchive(archiveFileName, &archive))
+	      throw ExaltArchiveException();
+	  }
+
+	catch (ExaltException)
+	  {
+	    ERR("Failed to read the archive '" << archiveFileName << "'!");
+	    exit(EXIT_FAILURE);
+	  }
+
+	for (ArchiveMember *member = archive.members()->first(); member; member = archive.members()->next())
+	  OUTPUTNL(member->size << "\t" << member->name);
+      }
+
+      break;
+
+    case ExtractArchive:
+      {
+	ExaltCodec exaltCodec;
+
+	try
+	  {
+	    if (dictionaryFileName)
+	      exaltCodec.setDictionary(dictionaryFileName);
+
+	    if (dtdFileName)
+	      exaltCodec.setDtd(dtdFileName);
+
+	    if (path)
+	      exaltCodec.setPathFilter(path);
+
+	    if (!exaltCodec.decodeArchive(archiveFileName, &filesToProcess, force))
+	      throw ExaltArchiveException();
+	  }
+
+	catch (ExaltException)
+	  {
+	    ERR("Failed to extract the archive '" << archiveFileName << "'!");
+	    exit(EXIT_FAILURE);
+	  }
+      }
+
+      break;
+
+    case Query:
+      {
+	ExaltCodec exaltCodec;
+	ExaltQuery *query = 0;
+	FileDevice outDevice;
+	OutputSAXReceptor outputReceptor;
+	const char *queryPath = countPath ? countPath : (path ? path : DEFAULT_QUERY_PATH);
+
+	if (filesToProcess.isEmpty())
+	  //if no files have been specified, use stdin
+	  filesToProcess.append("-");
+
+	try
+	  {
+	    NEW(query, ExaltQuery(queryPath));
+	  }
+
+	catch (ExaltException)
+	  {
+	    ERR("Invalid path: '" << queryPath << "'.");
+	    exit(EXIT_FAILURE);
+	  }
+
+	query->setPattern(grepPattern);
+
+	if (!countPath)
+	  {
+	    //display the matching elements
+	    outDevice.prepare(0, ios::out);
+	    outputReceptor.setOutputDevice(&outDevice);
+	    query->setOutputReceptor(&outputReceptor);
+	  }
+
+	for (char *fileName = filesToProcess.first(); fileName; fileName = filesToProcess.next())
+	  {
+	    bool res = false;
+
+	    if (!strcmp(fileName, "-"))
+	      fileName = 0;
+	    else
+	      {
+		ifstream inFile(fileName);
+
+		if (inFile)
+		  inFile.close();
+		else
+		  {
+		    ERR("'" << fileName << "' doesn't exist!");
+
+		    if (!force)
+		      exit(EXIT_FAILURE);
+
+		    continue;
+		  }
+	      }
+
+	    query->reset();
+
+	    try
+	      {
+		if (dictionaryFileName)
+		  exaltCodec.setDictionary(dictionaryFileName);
+
+		if (dtdFileName)
+		  exaltCodec.setDtd(dtdFileName);
+
+		res = exaltCodec.query(fileName, query);
+	      }
+
+	    catch (ExaltException)
+	      {
+		res = false;
+	      }
+
+	    if (!res)
+	      {
+		if (fileName)
+		  ERR("Failed to query '" << fileName << "'!");
+		else
+		  ERR("Failed to query standard input!");
+
+		if (!force)
+		  exit(EXIT_FAILURE);
+	      }
+	    else
+	      if (countPath)
+		{
+		  if (filesToProcess.count() > 1)
+		    OUTPUTNL((fileName ? fileName : "-") << ":" << query->count());
+		  else
+		    OUTPUTNL(query->count());
+		}
+	  }
+
+	if (!countPath)
+	  outDevice.finish();
+
+	DELETE(query);
+      }
+
+      break;
+
     default:
       ERR("Don't know what to do!");
       return EXIT_FAILURE;
@@ -0,0 +1,214 @@
+/***************************************************************************
+    nulldevice.cpp  -  Definitions of NullDevice class methods.
+                             -------------------
+    begin                : October 19 2026
+    copyright            : (C) 2003 by Vojtch Toman
+    email                : vtoman@lit.cz
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+/*!
+  \file nulldevice.cpp
+  \brief Definitions of NullDevice class methods.
+  
+  This file contains the definitions of NullDevice class methods.
+*/
+
+
+#ifdef __GNUG__
+# pragma implementation
+#endif
+
+
+#include "nulldevice.h"
+
+
+
+/*!
+  The device is prepared immediately.
+ */
+NullDevice::NullDevice(void)
+  : IODevice()
+{
+  bWritten = 0;
+  prepared = true;
+}
+
+
+
+/*!
+  Does nothing.
+ */
+NullDevice::~NullDevice(void)
+{
+}
+
+
+
+/*!
+  Prepares the device for work.
+ */
+void NullDevice::prepare(void) throw (ExaltIOException)
+{
+  prepared = true;
+}
+
+
+
+/*!
+  There are no data to be flushed.
+ */
+void NullDevice::flush(void) throw (ExaltIOException)
+{
+}
+
+
+
+/*!
+  Ends the work with the device. An attempt to work with finished device will cause an ExaltIOException to be raised.
+ */
+void NullDevice::finish(void) throw (ExaltIOException)
+{
+  prepared = false;
+  bWritten = 0;
+}
+
+
+
+/*!
+  No data can be read from the device.
+
+  \param buf Pointer to the buffer.
+  \param length Length of the buffer.
+
+  \return Always EndOfFile.
+ */
+IOState NullDevice::readData(char *buf, IOSize length) throw (ExaltIOException)
+{
+  if (!isPrepared())
+    throw ExaltDeviceNotPreparedIOException();
+
+  return EndOfFile;
+}
+
+
+
+/*!
+  No data can be read from the device.
+
+  \param c Pointer where the read character would be stored.
+
+  \return Always EndOfFile.
+ */
+IOState NullDevice::getChar(int *c) throw (ExaltIOException)
+{
+  if (!isPrepared())
+    throw ExaltDeviceNotPreparedIOException();
+
+  return EndOfFile;
+}
+
+
+
+/*!
+  The data are counted and discarded.
+
+  \param buf Pointer to the buffer.
+  \param length Length of the buffer.
+
+  \return State of the device after the write operation.
+ */
+IOState NullDevice::writeData(const char *buf, IOSize length) throw (ExaltIOException)
+{
+  if (!isPrepared())
+    throw ExaltDeviceNotPreparedIOException();
+
+  bWritten += length;
+  return WriteOk;
+}
+
+
+
+/*!
+  The character is counted and discarded.
+
+  \param c The character.
+
+  \return State of the device after the write operation.
+ */
+IOState NullDevice::putChar(int c) throw (ExaltIOException)
+{
+  if (!isPrepared())
+    throw ExaltDeviceNotPreparedIOException();
+
+  bWritten++;
+  return WriteOk;
+}
+
+
+
+/*!
+  No data are ever read from the device.
+
+  \return Always 0.
+ */
+IOSize NullDevice::bytesReadTotal(void)
+{
+  return 0;
+}
+
+
+
+/*!
+  No data are ever read from the device.
+
+  \return Always 0.
+ */
+IOSize NullDevice::bytesRead(void)
+{
+  return 0;
+}
+
+
+
+/*!
+  Returns the total number of bytes written to (and discarded by) the device.
+  
+  \return Number of bytes.
+ */
+IOSize NullDevice::bytesWritten(void)
+{
+  return bWritten;
+}
+
+
+
+/*!
+  No errors can occur.
+
+  \retval FALSE Always.
+ */
+bool NullDevice::errorOccurred(void)
+{
+  return false;
+}
+
+
+
+/*!
+  There are never any data to read.
+
+  \retval TRUE Always.
+ */
+bool NullDevice::eof(void)
+{
+  return true;
+}
@@ -0,0 +1,98 @@
+/***************************************************************************
+    nulldevice.h  -  Definition of the NullDevice class.
+                             -------------------
+    begin                : October 19 2026
+    copyright            : (C) 2003 by Vojtch Toman
+    email                : vtoman@lit.cz
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+/*!
+  \file nulldevice.h
+  \brief Definition of the NullDevice class.
+  
+  This file contains the definition of the NullDevice class.
+*/
+
+
+#ifndef NULLDEVICE_H
+#define NULLDEVICE_H
+
+#ifdef __GNUG__
+# pragma interface
+#endif
+
+
+#include "iodevice.h"
+#include "defs.h"
+
+
+
+/*!
+  \brief A device that discards all written data.
+
+  The device is used when the side effects of encoding (such as the state of the grammar or of the coding context) are needed, but the encoded data are not. Reading from the device always results in the end of file.
+
+  \sa IODevice, FileDevice.
+ */
+class NullDevice : public IODevice
+{
+public:
+  //! A constructor.
+  NullDevice(void);
+
+  //! A destructor.
+  virtual ~NullDevice(void);
+
+  //! Prepare the device.
+  virtual void prepare(void) throw (ExaltIOException);
+
+  //! Flush the device (does nothing).
+  virtual void flush(void) throw (ExaltIOException);
+
+  //! Finish the work with the device.
+  virtual void finish(void) throw (ExaltIOException);
+
+  //! Read up to the specified number of bytes into the buffer (always fails).
+  virtual IOState readData(char *buf, IOSize length) throw (ExaltIOException);
+
+  //! Read one char (always fails).
+  virtual IOState getChar(int *) throw (ExaltIOException);
+
+  //! Write (and discard) the specified number of bytes from the buffer.
+  virtual IOState writeData(const char *buf, IOSize length) throw (ExaltIOException);
+
+  //! Write (and discard) one char.
+  virtual IOState putChar(int) throw (ExaltIOException);
+
+  //! Return the number of bytes read so far.
+  virtual IOSize bytesReadTotal(void);
+
+  //! Return the number of bytes read by the last read operation.
+  virtual IOSize bytesRead(void);
+
+  //! Return the number of bytes written so far.
+  virtual IOSize bytesWritten(void);
+
+  //! Informs about an error.
+  virtual bool errorOccurred(void);
+
+  //! Informs about an end of file.
+  virtual bool eof(void);
+
+protected:
+  //! The number of bytes written so far.
+  IOSize bWritten;
+};
+
+
+
+#endif //NULLDEVICE_H
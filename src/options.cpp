@@ -30,4 +30,12 @@ ExaltOptions::OptionValue ExaltOptions::options[] = {
   DEFAULT_OUTPUT_ENCODING,	//Use the default output encoding
   ExaltOptions::No,		//Don't print the grammar
   ExaltOptions::No,		//Don't print the element models
-  ExaltOptions::None};
+  ExaltOptions::None,		//Use the default size of the parser buffer
+  ExaltOptions::No,		//Don't store the rules explicitly
+  ExaltOptions::KiefferYang,	//Use the KY grammar
+  ExaltOptions::No,		//Don't use the containers
+  ExaltOptions::No,		//Don't code the typed values
+  ExaltOptions::No,		//Don't use the value cache
+  ExaltOptions::No,		//Don't code the words by their ids
+  ExaltOptions::Ratio,		//Select the model with the better ratio
+  ExaltOptions::None};		//Don't limit the graphs of the elements
@@ -55,6 +55,33 @@ public:
     //! The "print models" option.
     PrintModels,
 
+    //! The size of the parser input buffer (in bytes).
+    ParserBufferSize,
+
+    //! The "explicit rules" option (see XML_CODEC_EXPLICIT_RULES_FLAG).
+    ExplicitRules,
+
+    //! The grammar used for compression (see XML_CODEC_REPAIR_FLAG).
+    Grammar,
+
+    //! The "containers" option (see XML_CODEC_CONTAINERS_FLAG).
+    Containers,
+
+    //! The "typed values" option (see XML_CODEC_TYPED_VALUES_FLAG).
+    TypedValues,
+
+    //! The "value cache" option (see XML_CODEC_VALUE_CACHE_FLAG).
+    ValueCache,
+
+    //! The "word tokens" option (see XML_CODEC_WORD_TOKENS_FLAG).
+    WordTokens,
+
+    //! The objective of the automatic selection of the model (see XmlCodec::selectModel()).
+    ModelObjective,
+
+    //! The maximal size of the graphs of the elements (see XML_CODEC_GRAPH_LIMIT_FLAG).
+    GraphLimit,
+
     //! Dummy option, has to be the last one!
     LastOption		//keep this option at the end of the enum!
   };
@@ -78,7 +105,22 @@ public:
     SimpleModel,
 
     //! Use the adaptive model.
-    AdaptiveModel
+    AdaptiveModel,
+
+    //! Select the model by sampling the input data.
+    AutoModel,
+
+    //! Use the online Kieffer-Yang grammar (KYGrammar).
+    KiefferYang,
+
+    //! Use the offline Re-Pair grammar (RePairGrammar).
+    RePair,
+
+    //! Select the model with the faster compression.
+    Speed,
+
+    //! Select the model with the better compression ratio.
+    Ratio
   };
 
   /*!
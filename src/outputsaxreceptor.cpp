@@ -158,6 +158,81 @@ void OutputSAXReceptor::reportError(void)
 
 
 
+/*!
+  Outputs all events of the batch without calling the handlers of the individual events.
+
+  \param userData Pointer to the user data structure.
+  \param batch The batch of the events.
+ */
+void OutputSAXReceptor::eventBatch(void *userData, SAXEventBatch *batch)
+{
+  const SAXBatchEvent *event;
+  size_t nrEvents = batch->count();
+
+  for (size_t i = 0; i < nrEvents; i++)
+    {
+      event = batch->getEvent(i);
+
+      switch (event->type)
+	{
+	case BatchStartElement:
+	  OUTPUT_TO_DEVICE("<");
+	  OUTPUT_TO_DEVICE(batch->getName(event->nameId));
+
+	  //the attributes follow the element
+	  while (i + 1 < nrEvents && batch->getEvent(i + 1)->type == BatchAttribute)
+	    {
+	      event = batch->getEvent(++i);
+
+	      OUTPUT_TO_DEVICE(" ");
+	      OUTPUT_TO_DEVICE(batch->getName(event->nameId));
+	      OUTPUT_TO_DEVICE("=\"");
+	      OUTPUT_TO_DEVICE_LENGTH(batch->getData(event), event->length);
+	      OUTPUT_TO_DEVICE("\"");
+	    }
+
+	  OUTPUT_TO_DEVICE(">");
+	  break;
+
+	case BatchAttribute:
+	  //the attributes are output with their element
+	  break;
+
+	case BatchEndElement:
+	  OUTPUT_TO_DEVICE("</");
+	  OUTPUT_TO_DEVICE(batch->getName(event->nameId));
+	  OUTPUT_TO_DEVICE(">");
+	  break;
+
+	case BatchCharacters:
+	  outputCharacters(batch->getData(event), event->length);
+	  break;
+
+	case BatchComment:
+	  OUTPUT_TO_DEVICE("<!--");
+	  OUTPUT_TO_DEVICE_LENGTH(batch->getData(event), event->length);
+	  OUTPUT_TO_DEVICE("-->");
+	  break;
+
+	case BatchStartCDATA:
+	  OUTPUT_TO_DEVICE("<![CDATA[");
+	  inCDATA = true;
+	  break;
+
+	case BatchEndCDATA:
+	  OUTPUT_TO_DEVICE("]]>");
+	  inCDATA = false;
+	  break;
+
+	case BatchDefault:
+	  OUTPUT_TO_DEVICE_LENGTH(batch->getData(event), event->length);
+	  break;
+	}
+    }
+}
+
+
+
 /*!
   Examines the name of the element and the values of its attributes and emits corresponding events to the XML model.
 
@@ -225,6 +300,22 @@ void OutputSAXReceptor::characterData(void *userData,
 				      const XmlChar *data,
 				      int length)
 {
+  outputCharacters(data, length);
+}
+
+
+
+/*!
+  If the data contain characters \&, ', ", \< or \>, these are substituted by corresponding entities (\&amp;, \&apos;, \&quot;, \&lt; or \&gt;), unless the receptor is in a CDATA section. The runs of the characters without substitutions are output at once.
+
+  \param data Character data.
+  \param length Length of the data.
+ */
+void OutputSAXReceptor::outputCharacters(const XmlChar *data, int length)
+{
+  const XmlChar *entity;
+  int start = 0;
+
   if (!inCDATA)
     {
       //output character data and substitute XML's reserved entites
@@ -233,41 +324,43 @@ void OutputSAXReceptor::characterData(void *userData,
 	  switch (data[i])
 	    {
 	    case AMP_REPLACEMENT:
-	      //&gt;
-	      OUTPUT_TO_DEVICE("&");
+	      entity = "&";
 	      break;
 	  
 	    case '>':
-	      //&gt;
-	      OUTPUT_TO_DEVICE(ENT_GT);
+	      entity = ENT_GT;
 	      break;
 	  
 	    case '<':
-	      //&lt;
-	      OUTPUT_TO_DEVICE(ENT_LT);
+	      entity = ENT_LT;
 	      break;
 	  
 	    case '&':
-	      //&amp;
-	      OUTPUT_TO_DEVICE(ENT_AMP);
+	      entity = ENT_AMP;
 	      break;
 	  
 	    case '\'':
-	      //&apos;
-	      OUTPUT_TO_DEVICE(ENT_APOS);
+	      entity = ENT_APOS;
 	      break;
 	  
 	    case '\"':
-	      //&quot;
-	      OUTPUT_TO_DEVICE(ENT_QUOT);
+	      entity = ENT_QUOT;
 	      break;
 	  
-	  
-	  
 	    default:
-	      OUTPUT_TO_DEVICE_CHAR(data[i]);
+	      continue;
 	    }
+
+	  //output the characters preceding the reserved one
+	  if (i > start)
+	    OUTPUT_TO_DEVICE_LENGTH(data + start, i - start);
+
+	  OUTPUT_TO_DEVICE(entity);
+	  start = i + 1;
 	}
+
+      if (length > start)
+	OUTPUT_TO_DEVICE_LENGTH(data + start, length - start);
     }
   else
     //we are in CDATA --> no substitutions
@@ -60,6 +60,12 @@ public:
   //! Report error messages.
   virtual void reportError(void);
 
+  //! The receptor accepts the events in batches.
+  virtual bool acceptsEventBatches(void) { return true; }
+
+  //! Batch of events handler.
+  virtual void eventBatch(void *userData, SAXEventBatch *batch);
+
   //! Start element handler.
   virtual void startElement(void *userData,
 			    const XmlChar *name,
@@ -147,6 +153,9 @@ protected:
 
   //! Initialize the receptor.
   void init(void);
+
+  //! Output the character data.
+  void outputCharacters(const XmlChar *data, int length);
 };
 
 #endif //OUTPUTSAXRECEPTOR_H
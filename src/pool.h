@@ -0,0 +1,191 @@
+/***************************************************************************
+    pool.h  -  Definition of Pool template class.
+                             -------------------
+    begin                : October 19 2026
+    copyright            : (C) 2003 by Vojtch Toman
+    email                : vtoman@lit.cz
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+/*!
+  \file pool.h
+  \brief Definition of Pool template class.
+
+  This file contains definition of Pool template class.
+*/
+
+#ifndef POOL_H
+#define POOL_H
+
+
+#include "defs.h"
+#include "debug.h"
+
+
+/*!
+  \brief The number of items allocated at once by the Pool.
+ */
+#define POOL_BLOCK_SIZE		4096
+
+
+/*!
+  \brief Template class representing one block of items of the Pool.
+ */
+template<class T_> struct PoolBlock
+{
+  //! Pointer to the next block.
+  struct PoolBlock<T_> *next_;
+
+  //! The items of the block.
+  T_ *items_;
+
+}; //PoolBlock
+
+
+/*!
+  \brief Template class representing a pool of items of the same type.
+
+  The items are allocated in large contiguous blocks, so there is no per-item overhead of the heap and the items used together lie close to each other in the memory. The released items are reused by subsequent allocations. All items of the pool are freed at once by clear().
+
+  \warning The pool is intended for plain structures only: no constructors or destructors of the items are called, and the size of the item must not be smaller than the size of a pointer.
+ */
+template<class T_> class Pool
+{
+public:
+  /*!
+    \brief A constructor.
+
+    Calls initPool()
+   */
+  Pool(void) { initPool(); }
+
+  /*!
+    \brief A destructor.
+
+    Calls clear()
+   */
+  virtual ~Pool(void) { clear(); }
+
+
+
+  /*!
+    \brief Allocate one item.
+
+    \return Pointer to the item.
+   */
+  virtual T_ *alloc(void)
+  {
+    T_ *item;
+
+    cnt_++;
+
+    if (freeList_)
+      {
+	//reuse a released item
+	item = freeList_;
+	freeList_ = *(T_ **)freeList_;
+	return item;
+      }
+
+    if (!blocks_ || used_ == POOL_BLOCK_SIZE)
+      {
+	//current block is full --> allocate new one
+	PoolBlock<T_> *pom;
+
+	NEW(pom, PoolBlock<T_>);
+	NEW(pom->items_, T_[POOL_BLOCK_SIZE]);
+
+	pom->next_ = blocks_;
+	blocks_ = pom;
+	used_ = 0;
+      }
+
+    return &blocks_->items_[used_++];
+  }
+
+
+
+  /*!
+    \brief Return one item to the pool.
+
+    The item will be reused by subsequent call to alloc().
+
+    \param item Pointer to the item.
+   */
+  virtual void release(T_ *item)
+  {
+    CHECK_POINTER(item);
+
+    *(T_ **)item = freeList_;
+    freeList_ = item;
+
+    cnt_--;
+  }
+
+
+
+  /*!
+    \brief Free all items of the pool.
+
+    All pointers to the items of the pool become invalid.
+   */
+  virtual void clear(void)
+  {
+    PoolBlock<T_> *pom;
+
+    while (blocks_)
+      {
+	pom = blocks_;
+	blocks_ = blocks_->next_;
+
+	DELETE_ARRAY(pom->items_);
+	DELETE(pom);
+      }
+
+    initPool();
+  }
+
+
+
+  /*!
+    \brief Get the number of allocated items.
+
+    \return Number of items.
+   */
+  virtual size_t count(void) { return cnt_; }
+
+
+protected:
+  //! Linked list of allocated blocks (the current block is the first).
+  struct PoolBlock<T_> *blocks_;
+
+  //! Linked list of released items.
+  T_ *freeList_;
+
+  //! Number of used items in the current block.
+  size_t used_;
+
+  //! Number of allocated items.
+  size_t cnt_;
+
+  //! Initialize the pool.
+  virtual void initPool(void)
+  {
+    blocks_ = 0;
+    freeList_ = 0;
+    used_ = 0;
+    cnt_ = 0;
+  }
+
+}; //Pool
+
+
+#endif //POOL_H
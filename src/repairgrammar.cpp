@@ -0,0 +1,712 @@
+/***************************************************************************
+    repairgrammar.cpp  -  Definitions of RePairGrammar class methods.
+                             -------------------
+    begin                : October 19 2026
+    copyright            : (C) 2003 by Vojtch Toman
+    email                : vtoman@lit.cz
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+
+
+/*!
+  \file repairgrammar.cpp
+  \brief Definitions of RePairGrammar class methods.
+  
+  This file contains the definitions of RePairGrammar class methods.
+*/
+
+
+#ifdef __GNUG__
+# pragma implementation
+#endif
+
+
+#include "repairgrammar.h"
+
+
+
+/*!
+  Creates an empty grammar.
+ */
+RePairGrammar::RePairGrammar(void)
+  : GrammarBase()
+{
+  context = 0;
+  ruleBodyContext = 0;
+  useContextForOutput = true;
+  outputDevice = 0;
+
+  length = 0;
+  built = false;
+  size = REPAIR_GRAMMAR_INITIAL_SIZE;
+  NEW(symbols, int[size]);
+
+  prevPosition = nextPosition = 0;
+  prevOccurrence = nextOccurrence = 0;
+
+  ruleCount = 0;
+  rulesSize = 0;
+  ruleLeft = ruleRight = 0;
+
+  NEW(digramPool, RePairDigramPool);
+  digramTable = 0;
+  digramTableSize = 0;
+  queue = 0;
+  queueSize = 0;
+  topBucket = 0;
+  currentDigram = 0;
+
+  totalSymbols = 0;
+  totalRules = 0;
+  sequenceSymbols = 0;
+}
+
+
+
+/*!
+  The symbols which haven't been encoded yet are encoded by flush().
+ */
+RePairGrammar::~RePairGrammar(void)
+{
+  //force processing of the unprocessed data
+  flush();
+
+  if (ExaltOptions::getOption(ExaltOptions::PrintGrammar) == ExaltOptions::Yes)
+    print();
+
+  if (ExaltOptions::getOption(ExaltOptions::Verbose) == ExaltOptions::Yes)
+    {
+      OUTPUTENL("Re-Pair grammar statistics");
+      OUTPUTENL("  Total symbols processed: \t\t" << totalSymbols);
+      OUTPUTENL("  Number of rules: \t\t\t" << totalRules);
+      OUTPUTENL("  Symbols of the root sequences: \t" << sequenceSymbols);
+      OUTPUTEENDLINE;
+    }
+
+  DELETE_ARRAY(symbols);
+
+  if (ruleLeft)
+    {
+      DELETE_ARRAY(ruleLeft);
+      DELETE_ARRAY(ruleRight);
+    }
+
+  DELETE(digramPool);
+
+  deleteDefaultTextCodec();
+}
+
+
+
+/*!
+  The context of the rule bodies is initialized together with the main context, with the same base size.
+
+  \param size The size of the alphabet.
+ */
+void RePairGrammar::setAlphabetBaseSize(size_t size)
+{
+  if (context)
+    {
+      if (!context->isInitialized())
+	{
+	  //initialize the context only if it is not initialized yet
+	  context->setType(size, DynamicContext);
+	  context->initialize();
+
+	  if (ruleBodyContext)
+	    {
+	      ruleBodyContext->setType(size, DynamicContext);
+	      ruleBodyContext->initialize();
+	    }
+
+	  //store the size of the alphabet in output device
+	  char fibBuf[10];
+	  size_t nrItems = Fibonacci::encodeToBuffer(fibBuf, SIZEOF_CHAR, size);
+	  outputDevice->writeData(fibBuf, nrItems);
+	}
+    }
+
+  //output device is needed only for storing the alphabet size
+  outputDevice = 0;
+}
+
+
+
+/*!
+  The symbol is only stored; the grammar is built by flush().
+
+  \param value The terminal symbol.
+ */
+void RePairGrammar::append(TerminalValue value)
+{
+  if (!textCodec)
+    //use default TextCodec if none has been specified
+    createDefaultTextCodec();
+
+  if (context && !context->isInitialized())
+    //some character data occurred before the XML declaration
+    //initialize the context with some default base size
+    setAlphabetBaseSize(textCodec->suggestAlphabetBaseSize(Encodings::UTF_8));
+
+  if (built)
+    {
+      //the previous block has been encoded
+      length = 0;
+      built = false;
+    }
+
+  if (length == size)
+    {
+      //enlarge the buffer
+      int *newSymbols;
+
+      NEW(newSymbols, int[2 * size]);
+      memcpy(newSymbols, symbols, size * sizeof(int));
+      DELETE_ARRAY(symbols);
+      symbols = newSymbols;
+      size *= 2;
+    }
+
+  symbols[length++] = (int)(unsigned char)value;
+  totalSymbols++;
+}
+
+
+
+/*!
+  The grammar of the symbols appended since the last call is built and encoded as one block. A block is encoded even if no symbols have been appended (the decoder expects the list of the rules after each flush point, see XmlCodec::sync()). After the call, the grammar of the block is available to print() and reconstructInput() until the next symbol is appended.
+ */
+void RePairGrammar::flush(void)
+{
+  if (!context || !context->isInitialized())
+    //nothing has been appended yet
+    return;
+
+  if (built)
+    //no symbols have been appended since the last block
+    length = 0;
+
+  buildGrammar();
+  built = true;
+
+  if (useContextForOutput)
+    encodeGrammar();
+}
+
+
+
+/*!
+  This method outputs a human-readable representation of the grammar of the last block on the standard error output.
+ */
+void RePairGrammar::print(void)
+{
+  OUTPUTENL("Re-Pair grammar content");
+
+  OUTPUTE("  R0 (length: " << length << ") ---> \'");
+  for (long i = 0; i < length; i++)
+    printSymbol(symbols[i]);
+  OUTPUTE("\'");
+  OUTPUTEENDLINE;
+
+  for (RuleId r = 1; r <= ruleCount; r++)
+    {
+      OUTPUTE("  R" << std::dec << r << " ---> \'");
+      printSymbol(ruleLeft[r]);
+      printSymbol(ruleRight[r]);
+      OUTPUTE("\'");
+      OUTPUTEENDLINE;
+    }
+
+  OUTPUTE(std::dec);
+  OUTPUTEENDLINE;
+}
+
+
+
+/*!
+  The data of the last block are written to the output device.
+ */
+void RePairGrammar::reconstructInput(void)
+{
+  if (!outputDevice)
+    return;
+
+  for (long i = 0; i < length; i++)
+    expandSymbol(symbols[i], outputDevice);
+}
+
+
+
+/*!
+  \param ctxt Pointer to the context.
+  \param useForOutput Indication whether the contexts should be used for the output of data.
+ */
+void RePairGrammar::setContext(ContextBase *ctxt, bool useForOutput = true)
+{
+  context = ctxt;
+  useContextForOutput = useForOutput;
+}
+
+
+
+/*!
+  The context has to be bound to the same arithmetic coder as the main context. It is initialized by the grammar.
+
+  \param ctxt Pointer to the context.
+ */
+void RePairGrammar::setRuleBodyContext(ContextBase *ctxt)
+{
+  ruleBodyContext = ctxt;
+}
+
+
+
+/*!
+  \param device The output device.
+ */
+void RePairGrammar::setOutputDevice(IODevice *device)
+{
+  outputDevice = device;
+}
+
+
+
+/*!
+  The most frequent digram is replaced by a new rule until no digram occurs twice. The sequence is kept as a doubly linked list of positions, and the occurrences of each digram are linked in a list as well. When an occurrence is replaced, only the digrams which overlap it (with the previous and the next symbol) change, so they are unlinked before the replacement and the new ones are linked afterwards. The frequency of a new digram never exceeds the frequency of the replaced one, so the queue is searched from the top bucket downwards only once.
+
+  The occurrences of a digram of two equal symbols must not overlap (in \c aaa, only the first \c aa is counted).
+
+  After the replacements, the remaining symbols are moved to the beginning of the buffer.
+ */
+void RePairGrammar::buildGrammar(void)
+{
+  long pos;
+  long n = length;
+
+  //the previous block (if any) has already been encoded
+  ruleCount = 0;
+
+  if (n < 2)
+    //there is no digram
+    return;
+
+  NEW(prevPosition, long[n]);
+  NEW(nextPosition, long[n]);
+  NEW(prevOccurrence, long[n]);
+  NEW(nextOccurrence, long[n]);
+
+  for (pos = 0; pos < n; pos++)
+    {
+      prevPosition[pos] = pos - 1;
+      nextPosition[pos] = pos + 1;
+      prevOccurrence[pos] = nextOccurrence[pos] = REPAIR_NOT_LINKED;
+    }
+
+  nextPosition[n - 1] = REPAIR_NO_POSITION;
+
+  //the number of the digrams is smaller than the length of the sequence
+  for (digramTableSize = 1; digramTableSize < n; digramTableSize <<= 1);
+
+  NEW(digramTable, RePairDigram*[digramTableSize]);
+  for (long i = 0; i < digramTableSize; i++)
+    digramTable[i] = 0;
+
+  //the frequencies up to the square root of the length have their own buckets
+  for (queueSize = 1; queueSize * queueSize < n; queueSize++);
+  queueSize += 2;
+
+  NEW(queue, RePairDigram*[queueSize]);
+  for (long i = 0; i < queueSize; i++)
+    queue[i] = 0;
+
+  topBucket = queueSize - 1;
+
+  //count the digrams
+  for (pos = 0; pos < n - 1; pos++)
+    addOccurrence(pos);
+
+  //replace the digrams
+  while ((currentDigram = extractDigram()))
+    {
+      int rule = createRule(currentDigram->left, currentDigram->right);
+
+      while ((pos = currentDigram->firstOccurrence) != REPAIR_NO_POSITION)
+	{
+	  long prev = prevPosition[pos];
+	  long next = nextPosition[pos];
+	  long nextNext = nextPosition[next];
+
+	  //unlink the digrams which will change
+	  removeOccurrence(pos);
+
+	  if (prev != REPAIR_NO_POSITION)
+	    removeOccurrence(prev);
+
+	  if (nextNext != REPAIR_NO_POSITION)
+	    removeOccurrence(next);
+
+	  //replace the occurrence
+	  symbols[pos] = rule;
+	  symbols[next] = -1;
+
+	  nextPosition[pos] = nextNext;
+	  if (nextNext != REPAIR_NO_POSITION)
+	    prevPosition[nextNext] = pos;
+
+	  //link the new digrams
+	  if (prev != REPAIR_NO_POSITION)
+	    addOccurrence(prev);
+
+	  addOccurrence(pos);
+	}
+    }
+
+  //the first position is never deleted
+  length = 0;
+  for (pos = 0; pos != REPAIR_NO_POSITION; pos = nextPosition[pos])
+    symbols[length++] = symbols[pos];
+
+  deleteDigrams();
+}
+
+
+
+/*!
+  The rules are encoded in the order of their creation, so each rule refers only to the terminals and to the rules encoded before it. The list of the rules is terminated by the end-of-message symbol of the context of the rule bodies. Then the root sequence is encoded.
+ */
+void RePairGrammar::encodeGrammar(void)
+{
+  CHECK_POINTER(ruleBodyContext);
+
+  long lastFixedSymbol = context->lastFixedSymbol();
+
+  for (RuleId r = 1; r <= ruleCount; r++)
+    {
+      if (ruleBodyContext->encode(ruleLeft[r]) == ContextBase::NotKnown
+	  || ruleBodyContext->encode(ruleRight[r]) == ContextBase::NotKnown)
+	{
+	  FATAL("Encoding unknown symbol in rule: " << r);
+	}
+
+      //the rule can be used by the following rules and by the root sequence
+      ruleBodyContext->installSymbol(lastFixedSymbol + r);
+      context->installSymbol(lastFixedSymbol + r);
+    }
+
+  ruleBodyContext->encodeEndOfMessage();
+
+  for (long i = 0; i < length; i++)
+    if (context->encode(symbols[i]) == ContextBase::NotKnown)
+      {
+	FATAL("Encoding unknown symbol: " << symbols[i]);
+      }
+
+  sequenceSymbols += length;
+}
+
+
+
+/*!
+  The digrams themselves are freed with the pool.
+ */
+void RePairGrammar::deleteDigrams(void)
+{
+  DELETE_ARRAY(prevPosition);
+  DELETE_ARRAY(nextPosition);
+  DELETE_ARRAY(prevOccurrence);
+  DELETE_ARRAY(nextOccurrence);
+  DELETE_ARRAY(digramTable);
+  DELETE_ARRAY(queue);
+
+  digramPool->clear();
+}
+
+
+
+/*!
+  \param left The first symbol of the digram.
+  \param right The second symbol of the digram.
+  \param create Indication whether the digram should be created if it doesn't exist.
+
+  \return Pointer to the digram, or NULL if it doesn't exist (and \a create is false).
+ */
+RePairDigram *RePairGrammar::findDigram(int left, int right, bool create)
+{
+  RePairDigram *digram;
+  unsigned long h = ((unsigned long)left * 31 + (unsigned long)right) * 2654435761UL;
+
+  h = (h ^ (h >> 15)) & (digramTableSize - 1);
+
+  for (digram = digramTable[h]; digram; digram = digram->hashNext)
+    if (digram->left == left && digram->right == right)
+      return digram;
+
+  if (!create)
+    return 0;
+
+  digram = digramPool->alloc();
+  digram->left = left;
+  digram->right = right;
+  digram->freq = 0;
+  digram->firstOccurrence = REPAIR_NO_POSITION;
+  digram->queuePrev = digram->queueNext = 0;
+  digram->bucket = 0;
+
+  digram->hashNext = digramTable[h];
+  digramTable[h] = digram;
+
+  return digram;
+}
+
+
+
+/*!
+  The occurrence is not linked if it overlaps the previous occurrence of the same digram.
+
+  \param pos The position of the first symbol of the digram.
+ */
+void RePairGrammar::addOccurrence(long pos)
+{
+  RePairDigram *digram;
+  long next = nextPosition[pos];
+  long prev = prevPosition[pos];
+
+  if (next == REPAIR_NO_POSITION)
+    //the last symbol of the sequence
+    return;
+
+  if (symbols[pos] == symbols[next] && prev != REPAIR_NO_POSITION
+      && symbols[prev] == symbols[pos] && prevOccurrence[prev] != REPAIR_NOT_LINKED)
+    //overlapping occurrence
+    return;
+
+  digram = findDigram(symbols[pos], symbols[next], true);
+
+  prevOccurrence[pos] = REPAIR_NO_POSITION;
+  nextOccurrence[pos] = digram->firstOccurrence;
+
+  if (digram->firstOccurrence != REPAIR_NO_POSITION)
+    prevOccurrence[digram->firstOccurrence] = pos;
+
+  digram->firstOccurrence = pos;
+  digram->freq++;
+
+  requeue(digram);
+}
+
+
+
+/*!
+  The digram which is being replaced stays out of the queue. The digrams whose frequency drops to zero stay in the hash table (with the exception of the replaced one, they may occur again).
+
+  \param pos The position of the first symbol of the digram.
+ */
+void RePairGrammar::removeOccurrence(long pos)
+{
+  RePairDigram *digram;
+  long prev = prevOccurrence[pos];
+  long next = nextOccurrence[pos];
+
+  if (prev == REPAIR_NOT_LINKED)
+    //the occurrence is not linked
+    return;
+
+  digram = findDigram(symbols[pos], symbols[nextPosition[pos]], false);
+  CHECK_POINTER(digram);
+
+  if (prev == REPAIR_NO_POSITION)
+    digram->firstOccurrence = next;
+  else
+    nextOccurrence[prev] = next;
+
+  if (next != REPAIR_NO_POSITION)
+    prevOccurrence[next] = prev;
+
+  prevOccurrence[pos] = nextOccurrence[pos] = REPAIR_NOT_LINKED;
+  digram->freq--;
+
+  if (digram != currentDigram)
+    requeue(digram);
+}
+
+
+
+/*!
+  The digrams which occur less than twice are not queued. The last bucket holds all digrams whose frequency is at least the number of the buckets minus one.
+
+  \param digram The digram.
+ */
+void RePairGrammar::requeue(RePairDigram *digram)
+{
+  long bucket;
+
+  if (digram->freq < 2)
+    bucket = 0;
+  else
+    bucket = (digram->freq < queueSize - 1) ? digram->freq : queueSize - 1;
+
+  if (bucket == digram->bucket)
+    return;
+
+  if (digram->bucket)
+    {
+      //unlink the digram from its old bucket
+      if (digram->queuePrev)
+	digram->queuePrev->queueNext = digram->queueNext;
+      else
+	queue[digram->bucket] = digram->queueNext;
+
+      if (digram->queueNext)
+	digram->queueNext->queuePrev = digram->queuePrev;
+    }
+
+  if (bucket)
+    {
+      //link the digram to the new bucket
+      digram->queuePrev = 0;
+      digram->queueNext = queue[bucket];
+
+      if (queue[bucket])
+	queue[bucket]->queuePrev = digram;
+
+      queue[bucket] = digram;
+    }
+
+  digram->bucket = bucket;
+}
+
+
+
+/*!
+  The digrams of the last bucket are not sorted, so the bucket is searched for the most frequent one.
+
+  \return The most frequent digram, or NULL if no digram occurs twice.
+ */
+RePairDigram *RePairGrammar::extractDigram(void)
+{
+  RePairDigram *digram;
+
+  while (topBucket > 1 && !queue[topBucket])
+    topBucket--;
+
+  if (topBucket <= 1)
+    return 0;
+
+  digram = queue[topBucket];
+
+  if (topBucket == queueSize - 1)
+    for (RePairDigram *d = digram->queueNext; d; d = d->queueNext)
+      if (d->freq > digram->freq)
+	digram = d;
+
+  //take the digram out of the queue
+  if (digram->queuePrev)
+    digram->queuePrev->queueNext = digram->queueNext;
+  else
+    queue[topBucket] = digram->queueNext;
+
+  if (digram->queueNext)
+    digram->queueNext->queuePrev = digram->queuePrev;
+
+  digram->bucket = 0;
+
+  return digram;
+}
+
+
+
+/*!
+  \param left The first symbol of the rule.
+  \param right The second symbol of the rule.
+
+  \return The symbol of the rule.
+ */
+int RePairGrammar::createRule(int left, int right)
+{
+  if (ruleCount + 1 >= rulesSize)
+    {
+      //enlarge the arrays of the rules
+      RuleId newSize = rulesSize ? 2 * rulesSize : REPAIR_GRAMMAR_INITIAL_SIZE;
+      int *newLeft, *newRight;
+
+      NEW(newLeft, int[newSize]);
+      NEW(newRight, int[newSize]);
+
+      if (ruleLeft)
+	{
+	  memcpy(newLeft, ruleLeft, rulesSize * sizeof(int));
+	  memcpy(newRight, ruleRight, rulesSize * sizeof(int));
+	  DELETE_ARRAY(ruleLeft);
+	  DELETE_ARRAY(ruleRight);
+	}
+
+      ruleLeft = newLeft;
+      ruleRight = newRight;
+      rulesSize = newSize;
+    }
+
+  ruleCount++;
+  totalRules++;
+
+  ruleLeft[ruleCount] = left;
+  ruleRight[ruleCount] = right;
+
+  return context->lastFixedSymbol() + ruleCount;
+}
+
+
+
+/*!
+  \param symbol The symbol.
+  \param device The output device.
+ */
+void RePairGrammar::expandSymbol(int symbol, IODevice *device)
+{
+  if (symbol > context->lastFixedSymbol())
+    {
+      RuleId r = symbol - context->lastFixedSymbol();
+
+      expandSymbol(ruleLeft[r], device);
+      expandSymbol(ruleRight[r], device);
+    }
+  else
+    {
+      TerminalValue value = symbol;
+
+      device->writeData((const char *)&value, SIZEOF_XML_CHAR);
+    }
+}
+
+
+
+/*!
+  \param symbol The symbol.
+ */
+void RePairGrammar::printSymbol(int symbol)
+{
+  if (symbol > context->lastFixedSymbol())
+    {
+      OUTPUTE("R" << std::dec << symbol - context->lastFixedSymbol() << " ");
+    }
+  else
+    if (symbol > 31)
+      {
+	//output the character
+	OUTPUTE((char)symbol << " ");
+      }
+    else
+      {
+	//output the hexadecimal code
+	OUTPUTE("0x");
+	OUTPUTE(std::hex << std::setw(2) << std::setfill('0') << symbol << std::dec << " ");
+      }
+}
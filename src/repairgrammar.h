@@ -0,0 +1,264 @@
+/***************************************************************************
+    repairgrammar.h  -  Definition of RePairGrammar class.
+                             -------------------
+    begin                : October 19 2026
+    copyright            : (C) 2003 by Vojtch Toman
+    email                : vtoman@lit.cz
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+
+
+/*!
+  \file repairgrammar.h
+  \brief Definition of RePairGrammar class.
+  
+  This file contains the definition of RePairGrammar class.
+*/
+
+
+#ifdef __GNUG__
+# pragma interface
+#endif
+
+#ifndef REPAIRGRAMMAR_H
+#define REPAIRGRAMMAR_H
+
+
+#include "defs.h"
+#include "debug.h"
+#include "options.h"
+#include "grammarbase.h"
+#include "contextbase.h"
+#include "iodevice.h"
+#include "kydefs.h"
+#include "fibonacci.h"
+#include "pool.h"
+
+
+
+/*!
+  \brief The initial size of the buffer of the appended symbols.
+
+  The buffer grows as necessary.
+ */
+#define REPAIR_GRAMMAR_INITIAL_SIZE	65536
+
+
+/*!
+  \brief The value of the positions which don't exist.
+ */
+#define REPAIR_NO_POSITION		-1
+
+
+/*!
+  \brief The value of the occurrence links of the positions which are not linked in any list of occurrences.
+ */
+#define REPAIR_NOT_LINKED		-2
+
+
+
+/*!
+  \brief A digram (a pair of adjacent symbols) of the sequence.
+
+  The non-overlapping occurrences of the digram are linked in a list, the digrams which occur at least twice are linked in the priority queue.
+ */
+struct RePairDigram
+{
+  //! The first symbol of the digram.
+  int left;
+
+  //! The second symbol of the digram.
+  int right;
+
+  //! The number of occurrences of the digram.
+  long freq;
+
+  //! The position of the first occurrence.
+  long firstOccurrence;
+
+  //! The next digram in the same slot of the hash table.
+  RePairDigram *hashNext;
+
+  //! The previous digram in the same bucket of the priority queue.
+  RePairDigram *queuePrev;
+
+  //! The next digram in the same bucket of the priority queue.
+  RePairDigram *queueNext;
+
+  //! The bucket of the priority queue (0 if the digram is not queued).
+  long bucket;
+};
+
+
+/*!
+  \brief Pool of digrams.
+ */
+typedef Pool<RePairDigram> RePairDigramPool;
+
+
+
+/*!
+  \brief Class implementing the offline Re-Pair grammar.
+
+  Unlike KYGrammar, which transforms the grammar after each appended symbol, RePairGrammar only collects the appended symbols. The grammar is built when flush() is called (at the latest when the grammar is deleted): the most frequent digram of the sequence is repeatedly replaced by a new rule, until no digram occurs twice. The digrams are kept in a priority queue ordered by their frequencies, and each replacement updates only the digrams that overlap the replaced occurrences, so the time needed is linear in the length of the sequence (see Larsson, Moffat: Offline Dictionary-Based Compression). The grammar therefore needs memory proportional to the length of the data, but it is built faster than by KYGrammar and it is usually smaller.
+
+  Each flush() produces one independent block of the grammar. The rules are encoded first, each of them as a pair of symbols in the context of the rule bodies, and their list is terminated by the end-of-message symbol of that context. The root sequence follows in the main context. The symbols of the rules are installed into both contexts in the order of their creation, and the rule ids start from 1 in each block. The decoder (see KYRuleTable::decodeRuleBody()) only expands the rules.
+*/
+class RePairGrammar : public GrammarBase
+{
+public:
+  //! A constructor.
+  RePairGrammar(void);
+
+  //! A destructor.
+  virtual ~RePairGrammar(void);
+
+  //! Set the base size of the terminal alphabet.
+  virtual void setAlphabetBaseSize(size_t size);
+
+  //! Append one terminal symbol.
+  virtual void append(TerminalValue value);
+
+  //! Build and encode the grammar of the appended symbols.
+  virtual void flush(void);
+
+  //! Print the grammar.
+  virtual void print(void);
+
+  //! Reconstruct the data represented by the grammar.
+  virtual void reconstructInput(void);
+
+  //! Set the context used for encoding the root sequence.
+  virtual void setContext(ContextBase *ctxt, bool useForOutput = true);
+
+  //! Set the context used for encoding the rules.
+  virtual void setRuleBodyContext(ContextBase *ctxt);
+
+  //! Set the output device.
+  virtual void setOutputDevice(IODevice *device);
+
+protected:
+  //! The context of the root sequence.
+  ContextBase *context;
+
+  //! The context of the rules.
+  ContextBase *ruleBodyContext;
+
+  //! Indication whether the contexts are used for the output.
+  bool useContextForOutput;
+
+  //! The output device (used for storing the alphabet size and by reconstructInput()).
+  IODevice *outputDevice;
+
+  //! The symbols of the sequence (-1 for the deleted positions).
+  int *symbols;
+
+  //! The number of the symbols appended since the last flush() (the length of the root sequence after flush()).
+  long length;
+
+  //! Indication whether the grammar of the last block has been built (the next symbol starts a new block).
+  bool built;
+
+  //! The size of the buffers of the sequence.
+  long size;
+
+  //! The previous position of the sequence.
+  long *prevPosition;
+
+  //! The next position of the sequence.
+  long *nextPosition;
+
+  //! The previous occurrence of the same digram.
+  long *prevOccurrence;
+
+  //! The next occurrence of the same digram.
+  long *nextOccurrence;
+
+  //! The first symbols of the rules (index 0 is unused).
+  int *ruleLeft;
+
+  //! The second symbols of the rules (index 0 is unused).
+  int *ruleRight;
+
+  //! The number of the rules of the current block.
+  RuleId ruleCount;
+
+  //! The size of the arrays of the rules.
+  RuleId rulesSize;
+
+  //! The pool of the digrams.
+  RePairDigramPool *digramPool;
+
+  //! The hash table of the digrams.
+  RePairDigram **digramTable;
+
+  //! The number of slots of the \a digramTable (a power of 2).
+  long digramTableSize;
+
+  //! The buckets of the priority queue (the last one holds all frequent digrams).
+  RePairDigram **queue;
+
+  //! The number of buckets of the \a queue.
+  long queueSize;
+
+  //! The highest bucket which may be non-empty.
+  long topBucket;
+
+  //! The digram being replaced.
+  RePairDigram *currentDigram;
+
+  //! The total number of the appended symbols.
+  unsigned long totalSymbols;
+
+  //! The total number of the created rules.
+  unsigned long totalRules;
+
+  //! The total number of the encoded symbols of the root sequences.
+  unsigned long sequenceSymbols;
+
+  //! Build the grammar of the appended symbols.
+  virtual void buildGrammar(void);
+
+  //! Encode the rules and the root sequence.
+  virtual void encodeGrammar(void);
+
+  //! Free the structures used for building the grammar.
+  virtual void deleteDigrams(void);
+
+  //! Find the digram (or create it).
+  virtual RePairDigram *findDigram(int left, int right, bool create);
+
+  //! Link the occurrence of the digram starting at given position.
+  virtual void addOccurrence(long pos);
+
+  //! Unlink the occurrence of the digram starting at given position.
+  virtual void removeOccurrence(long pos);
+
+  //! Move the digram to the bucket of the queue given by its frequency.
+  virtual void requeue(RePairDigram *digram);
+
+  //! Take the most frequent digram from the queue.
+  virtual RePairDigram *extractDigram(void);
+
+  //! Create a new rule.
+  virtual int createRule(int left, int right);
+
+  //! Write the string represented by the symbol.
+  virtual void expandSymbol(int symbol, IODevice *device);
+
+  //! Print the string represented by the symbol.
+  virtual void printSymbol(int symbol);
+};
+
+
+
+#endif //REPAIRGRAMMAR_H
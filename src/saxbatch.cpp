@@ -0,0 +1,254 @@
+/***************************************************************************
+    saxbatch.cpp  -  Definitions of SAXEventBatch class methods.
+                             -------------------
+    begin                : October 19 2026
+    copyright            : (C) 2003 by Vojtch Toman
+    email                : vtoman@lit.cz
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+
+/*!
+  \file saxbatch.cpp
+  \brief Definitions of SAXEventBatch class methods.
+  
+  This file contains the definitions of SAXEventBatch class methods.
+*/
+
+
+#ifdef __GNUG__
+# pragma implementation
+#endif
+
+
+#include <cstring>	//for memcpy()
+
+#include "saxbatch.h"
+
+
+
+/*!
+  Allocates the arrays of the batch.
+
+  \param names The table of the names of the elements and the attributes.
+ */
+SAXEventBatch::SAXEventBatch(XmlNameTable *names)
+{
+  nameTable = names;
+
+  eventsSize = SAX_BATCH_SIZE;
+  NEW(events, SAXBatchEvent[eventsSize]);
+  nrEvents = 0;
+
+  arenaSize = SAX_BATCH_ARENA_SIZE;
+  NEW(arena, XmlChar[arenaSize]);
+  arenaLength = 0;
+
+  attributes = 0;
+  attributesSize = 0;
+}
+
+
+
+/*!
+  Deletes the arrays of the batch.
+ */
+SAXEventBatch::~SAXEventBatch(void)
+{
+  DELETE_ARRAY(events);
+  DELETE_ARRAY(arena);
+
+  if (attributes)
+    DELETE_ARRAY(attributes);
+}
+
+
+
+/*!
+  \return The last event, or \a NULL if the batch is empty.
+ */
+SAXBatchEvent *SAXEventBatch::lastEvent(void)
+{
+  return nrEvents ? &events[nrEvents - 1] : 0;
+}
+
+
+
+/*!
+  \param nrNewEvents The number of the new events.
+  \param dataLength The total length of the new data.
+
+  \retval true The events and the data fit in the batch.
+  \retval false The batch is too full.
+ */
+bool SAXEventBatch::fits(size_t nrNewEvents, size_t dataLength)
+{
+  //each event has its data terminated by zero
+  return nrEvents + nrNewEvents <= eventsSize && arenaLength + dataLength + nrNewEvents <= arenaSize;
+}
+
+
+
+/*!
+  The arrays are enlarged if needed.
+
+  \param nrNewEvents The number of the new events.
+  \param dataLength The total length of the new data.
+ */
+void SAXEventBatch::reserve(size_t nrNewEvents, size_t dataLength)
+{
+  if (nrEvents + nrNewEvents > eventsSize)
+    {
+      SAXBatchEvent *pom;
+
+      eventsSize = nrEvents + nrNewEvents;
+      NEW(pom, SAXBatchEvent[eventsSize]);
+      memcpy(pom, events, nrEvents * sizeof(SAXBatchEvent));
+      DELETE_ARRAY(events);
+      events = pom;
+    }
+
+  if (arenaLength + dataLength + nrNewEvents > arenaSize)
+    {
+      XmlChar *pom;
+
+      arenaSize = arenaLength + dataLength + nrNewEvents;
+      NEW(pom, XmlChar[arenaSize]);
+      memcpy(pom, arena, arenaLength * sizeof(XmlChar));
+      DELETE_ARRAY(arena);
+      arena = pom;
+    }
+}
+
+
+
+/*!
+  The data of the event are empty. There has to be enough room in the batch (see fits() and reserve()).
+
+  \param type The type of the event.
+  \param nameId The id of the name of the element or the attribute.
+  \return The event.
+ */
+SAXBatchEvent *SAXEventBatch::appendEvent(SAXBatchEventType type, unsigned long nameId = 0)
+{
+  SAXBatchEvent *event = &events[nrEvents++];
+
+  event->type = type;
+  event->nameId = nameId;
+  event->offset = arenaLength;
+  event->length = 0;
+
+  arena[arenaLength++] = 0;
+
+  return event;
+}
+
+
+
+/*!
+  The data of the event have to be at the end of the arena (which holds for the last event), and there has to be enough room in the arena.
+
+  \param event The event.
+  \param data The data.
+  \param length The length of the data.
+ */
+void SAXEventBatch::appendData(SAXBatchEvent *event, const XmlChar *data, size_t length)
+{
+  memcpy(arena + event->offset + event->length, data, length * sizeof(XmlChar));
+  event->length += length;
+  arenaLength = event->offset + event->length;
+  arena[arenaLength++] = 0;
+}
+
+
+
+/*!
+  The arrays are kept for the next events.
+ */
+void SAXEventBatch::clear(void)
+{
+  nrEvents = 0;
+  arenaLength = 0;
+}
+
+
+
+/*!
+  Calls the handler of the receptor for each event of the batch. This way the receptors which do not process the batches themselves can be used with SAXBatchEmitter.
+
+  \param receptor The receptor.
+  \param userData Pointer to the user data structure.
+ */
+void SAXEventBatch::replay(SAXBase *receptor, void *userData)
+{
+  size_t i, j, nrAttributes;
+  SAXBatchEvent *event;
+
+  for (i = 0; i < nrEvents; i++)
+    {
+      event = &events[i];
+
+      switch (event->type)
+	{
+	case BatchStartElement:
+	  for (nrAttributes = 0; i + nrAttributes + 1 < nrEvents && events[i + nrAttributes + 1].type == BatchAttribute; nrAttributes++);
+
+	  if (2 * nrAttributes + 1 > attributesSize)
+	    {
+	      if (attributes)
+		DELETE_ARRAY(attributes);
+
+	      attributesSize = 2 * nrAttributes + 1;
+	      NEW(attributes, const XmlChar *[attributesSize]);
+	    }
+
+	  for (j = 0; j < nrAttributes; j++)
+	    {
+	      attributes[2 * j] = getName(events[i + j + 1].nameId);
+	      attributes[2 * j + 1] = getData(&events[i + j + 1]);
+	    }
+
+	  attributes[2 * nrAttributes] = 0;
+
+	  receptor->startElement(userData, getName(event->nameId), nrAttributes ? attributes : 0);
+	  i += nrAttributes;
+	  break;
+
+	case BatchAttribute:
+	  //the attributes are processed with their element
+	  break;
+
+	case BatchEndElement:
+	  receptor->endElement(userData, getName(event->nameId));
+	  break;
+
+	case BatchCharacters:
+	  receptor->characterData(userData, getData(event), event->length);
+	  break;
+
+	case BatchComment:
+	  receptor->comment(userData, getData(event));
+	  break;
+
+	case BatchStartCDATA:
+	  receptor->startCDATASection(userData);
+	  break;
+
+	case BatchEndCDATA:
+	  receptor->endCDATASection(userData);
+	  break;
+
+	case BatchDefault:
+	  receptor->defaultHandler(userData, getData(event), event->length);
+	  break;
+	}
+    }
+}
@@ -0,0 +1,209 @@
+/***************************************************************************
+    saxbatch.h  -  Definition of the SAXEventBatch class.
+                             -------------------
+    begin                : October 19 2026
+    copyright            : (C) 2003 by Vojtch Toman
+    email                : vtoman@lit.cz
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+
+/*!
+  \file saxbatch.h
+  \brief Definition of the SAXEventBatch class.
+  
+  This file contains the definition of the SAXEventBatch class.
+*/
+
+
+#ifndef SAXBATCH_H
+#define SAXBATCH_H
+
+#ifdef __GNUG__
+# pragma interface
+#endif
+
+
+#include "defs.h"
+#include "saxbase.h"
+#include "xmlchar.h"
+#include "xmldefs.h"
+#include "xmlnametable.h"
+
+
+/*!
+  \brief The initial number of the events of SAXEventBatch.
+
+  When the batch gets full, it is delivered to the receptor.
+ */
+#define SAX_BATCH_SIZE		4096
+
+/*!
+  \brief The initial size (in characters) of the data arena of SAXEventBatch.
+ */
+#define SAX_BATCH_ARENA_SIZE	65536
+
+
+
+/*!
+  \brief The types of the events in SAXEventBatch.
+ */
+enum SAXBatchEventType
+{
+  //! Start of an element (its attributes follow as BatchAttribute events).
+  BatchStartElement,
+
+  //! An attribute of the preceding element (the data are the value).
+  BatchAttribute,
+
+  //! End of an element.
+  BatchEndElement,
+
+  //! Character data.
+  BatchCharacters,
+
+  //! Comment.
+  BatchComment,
+
+  //! Start of a CDATA section.
+  BatchStartCDATA,
+
+  //! End of a CDATA section.
+  BatchEndCDATA,
+
+  //! Default data.
+  BatchDefault
+}; //SAXBatchEventType
+
+
+
+/*!
+  \brief One event of SAXEventBatch.
+ */
+struct SAXBatchEvent
+{
+  //! The type of the event.
+  SAXBatchEventType type;
+
+  //! The id of the name of the element or the attribute (see SAXEventBatch::getName()).
+  unsigned long nameId;
+
+  //! The offset of the data in the arena of the batch.
+  size_t offset;
+
+  //! The length of the data.
+  size_t length;
+}; //SAXBatchEvent
+
+
+
+/*!
+  \brief A batch of SAX events.
+
+  The events are stored in one contiguous array. The names of the elements and the attributes are represented by their ids in a name table, and the character data, the attribute values and the comments are stored in one shared arena of characters (each of them is terminated by zero). The batch is filled by SAXBatchEmitter and delivered to the receptor by SAXReceptor::eventBatch() at once, so there is only one virtual call per thousands of events.
+
+  The receptors which do not process the batches themselves receive the events one by one by replay().
+
+  \sa SAXBatchEmitter, SAXReceptor::acceptsEventBatches().
+ */
+class SAXEventBatch
+{
+public:
+  //! A constructor.
+  SAXEventBatch(XmlNameTable *names);
+
+  //! A destructor.
+  virtual ~SAXEventBatch(void);
+
+  /*!
+    \brief Get the number of the events.
+
+    \return The number of the events.
+   */
+  size_t count(void) const { return nrEvents; }
+
+  /*!
+    \brief Get the event.
+
+    \param index The index of the event.
+    \return The event.
+   */
+  const SAXBatchEvent *getEvent(size_t index) const { return &events[index]; }
+
+  /*!
+    \brief Get the data of the event.
+
+    \param event The event.
+    \return The data (terminated by zero).
+   */
+  const XmlChar *getData(const SAXBatchEvent *event) const { return arena + event->offset; }
+
+  /*!
+    \brief Get the name with given id.
+
+    \param id The id of the name.
+    \return The name.
+   */
+  const XmlChar *getName(unsigned long id) const { return nameTable->getName(id); }
+
+  //! Return the last event (or NULL).
+  virtual SAXBatchEvent *lastEvent(void);
+
+  //! Check whether the events and the data fit in the batch.
+  virtual bool fits(size_t nrNewEvents, size_t dataLength);
+
+  //! Make room for the events and the data.
+  virtual void reserve(size_t nrNewEvents, size_t dataLength);
+
+  //! Append a new event.
+  virtual SAXBatchEvent *appendEvent(SAXBatchEventType type, unsigned long nameId = 0);
+
+  //! Append the data to the data of the last event.
+  virtual void appendData(SAXBatchEvent *event, const XmlChar *data, size_t length);
+
+  //! Remove all events.
+  virtual void clear(void);
+
+  //! Send the events one by one to the receptor.
+  virtual void replay(SAXBase *receptor, void *userData);
+
+protected:
+  //! The table of the names.
+  XmlNameTable *nameTable;
+
+  //! The array of the events.
+  SAXBatchEvent *events;
+
+  //! The number of the events.
+  size_t nrEvents;
+
+  //! The size of the array of the events.
+  size_t eventsSize;
+
+  //! The arena of the data.
+  XmlChar *arena;
+
+  //! The length of the data in the arena.
+  size_t arenaLength;
+
+  //! The size of the arena.
+  size_t arenaSize;
+
+  //! The array of the attributes used by replay().
+  const XmlChar **attributes;
+
+  //! The size of the array of the attributes.
+  size_t attributesSize;
+};
+
+
+
+#endif //SAXBATCH_H
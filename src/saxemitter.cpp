@@ -91,6 +91,14 @@ void SAXEmitter::setSAXReceptor(SAXReceptor *receptor)
 }
 
 
+/*!
+  Does nothing, the events are sent to the receptor immediately.
+ */
+void SAXEmitter::flush(void)
+{
+}
+
+
 //+++++++++++++++++++++++++++++++++++++++++++++++++++++++++
 
 
@@ -326,3 +334,579 @@ void SAXEmitter::notationDecl(void *userData,
 
 
 
+
+//+++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+
+
+/*!
+  Creates the batch of the events.
+
+  \param receptor Pointer to the SAX receptor.
+ */
+SAXBatchEmitter::SAXBatchEmitter(SAXReceptor *receptor)
+  : SAXEmitter(receptor)
+{
+  NEW(nameTable, XmlNameTable);
+  NEW(batch, SAXEventBatch(nameTable));
+  batchUserData = 0;
+}
+
+
+
+/*!
+  Deletes the batch. The events which have not been delivered are lost (see flush()).
+ */
+SAXBatchEmitter::~SAXBatchEmitter(void)
+{
+  DELETE(batch);
+  DELETE(nameTable);
+}
+
+
+
+/*!
+  If the batch is not empty, it is delivered to the receptor and cleared.
+ */
+void SAXBatchEmitter::flush(void)
+{
+  if (batch->count())
+    {
+      if (saxReceptor)
+	saxReceptor->eventBatch(batchUserData, batch);
+
+      batch->clear();
+    }
+}
+
+
+
+/*!
+  If the batch is too full, it is delivered first. The batch is enlarged if the events do not fit in an empty batch.
+
+  \param userData Pointer to the user data structure.
+  \param nrEvents The number of the new events.
+  \param dataLength The total length of the new data.
+ */
+void SAXBatchEmitter::prepareBatch(void *userData, size_t nrEvents, size_t dataLength)
+{
+  if (userData != batchUserData)
+    {
+      flush();
+      batchUserData = userData;
+    }
+
+  if (!batch->fits(nrEvents, dataLength))
+    {
+      flush();
+      batch->reserve(nrEvents, dataLength);
+    }
+}
+
+
+
+/*!
+  \param userData Pointer to the user data structure.
+  \param type The type of the event.
+  \param data The data of the event.
+  \param length The length of the data.
+ */
+void SAXBatchEmitter::appendEvent(void *userData, SAXBatchEventType type, const XmlChar *data, size_t length)
+{
+  prepareBatch(userData, 1, length);
+  batch->appendData(batch->appendEvent(type), data, length);
+}
+
+
+
+/*!
+  Flushes the batch and calls the corresponding method of the SAX receptor.
+ */
+void SAXBatchEmitter::reportError(void)
+{
+  flush();
+  SAXEmitter::reportError();
+}
+
+
+
+/*!
+  The attributes are appended as separate events.
+
+  \param userData Pointer to the user data structure.
+  \param name Name of the element.
+  \param attr An array of attributes
+ */
+void SAXBatchEmitter::startElement(void *userData, const XmlChar *name, const XmlChar **attr)
+{
+  size_t nrAttributes = 0;
+  size_t dataLength = 0;
+
+  if (attr)
+    for (; attr[2 * nrAttributes]; nrAttributes++)
+      dataLength += xmlchar_strlen(attr[2 * nrAttributes + 1]);
+
+  prepareBatch(userData, nrAttributes + 1, dataLength);
+
+  batch->appendEvent(BatchStartElement, nameTable->intern(name));
+
+  for (size_t i = 0; i < nrAttributes; i++)
+    batch->appendData(batch->appendEvent(BatchAttribute, nameTable->intern(attr[2 * i])),
+		      attr[2 * i + 1], xmlchar_strlen(attr[2 * i + 1]));
+}
+
+
+
+/*!
+  \param userData Pointer to the user data structure.
+  \param name Name of the element.
+ */
+void SAXBatchEmitter::endElement(void *userData,
+				 const XmlChar *name)
+{
+  prepareBatch(userData, 1, 0);
+  batch->appendEvent(BatchEndElement, nameTable->intern(name));
+}
+
+
+
+/*!
+  If the last event of the batch are character data, the data are appended to it.
+
+  \param userData Pointer to the user data structure.
+  \param data Character data.
+  \param length Length of the data.
+ */
+void SAXBatchEmitter::characterData(void *userData,
+				    const XmlChar *data,
+				    int length)
+{
+  SAXBatchEvent *last = batch->lastEvent();
+
+  if (last && last->type == BatchCharacters && userData == batchUserData && batch->fits(0, length))
+    batch->appendData(last, data, length);
+  else
+    appendEvent(userData, BatchCharacters, data, length);
+}
+
+
+
+/*!
+  Flushes the batch and calls the corresponding method of the SAX receptor.
+
+  \param userData Pointer to the user data structure.
+  \param target Target of the instruction.
+  \param data Data of the instruction.
+ */
+void SAXBatchEmitter::processingInstruction(void *userData,
+					    const XmlChar *target,
+					    const XmlChar *data)
+{
+  flush();
+  SAXEmitter::processingInstruction(userData, target, data);
+}
+
+
+
+/*!
+  \param userData Pointer to the user data structure.
+  \param data Data of the comment.
+ */
+void SAXBatchEmitter::comment(void *userData,
+			      const XmlChar *data)
+{
+  appendEvent(userData, BatchComment, data, xmlchar_strlen(data));
+}
+
+
+
+/*!
+  \param userData Pointer to the user data structure.
+ */
+void SAXBatchEmitter::startCDATASection(void *userData)
+{
+  prepareBatch(userData, 1, 0);
+  batch->appendEvent(BatchStartCDATA);
+}
+
+
+
+/*!
+  \param userData Pointer to the user data structure.
+ */
+void SAXBatchEmitter::endCDATASection(void *userData)
+{
+  prepareBatch(userData, 1, 0);
+  batch->appendEvent(BatchEndCDATA);
+}
+
+
+
+/*!
+  \param userData Pointer to the user data structure.
+  \param data The default data.
+  \param length The length of the default data.
+ */
+void SAXBatchEmitter::defaultHandler(void *userData,
+				     const XmlChar *data,
+				     int length)
+{
+  appendEvent(userData, BatchDefault, data, length);
+}
+
+
+
+/*!
+  Flushes the batch and calls the corresponding method of the SAX receptor.
+
+  \param unknownEncodingData The data structure describing the unknown encoding.
+  \param name The name of the encoding.
+  \param info The information about the encoding.
+ */
+int SAXBatchEmitter::unknownEncoding(void *unknownEncodingData,
+				     const XmlChar *name,
+				     XML_Encoding *info)
+{
+  flush();
+  return SAXEmitter::unknownEncoding(unknownEncodingData, name, info);
+}
+
+
+
+/*!
+  Flushes the batch and calls the corresponding method of the SAX receptor.
+
+  \param userData Pointer to the user data structure.
+  \param version The XML version string.
+  \param encoding The encoding of the XML document.
+  \param standalone Is the document standalone?.
+ */
+void SAXBatchEmitter::xmlDecl(void *userData,
+			      const XmlChar *version,
+			      const XmlChar *encoding,
+			      int standalone)
+{
+  flush();
+  SAXEmitter::xmlDecl(userData, version, encoding, standalone);
+}
+
+
+
+/*!
+  Flushes the batch and calls the corresponding method of the SAX receptor.
+
+  \param userData Pointer to the user data structure.
+  \param doctypeName The name of the doctype.
+  \param systemId The system id.
+  \param publicId The public id.
+  \param hasInternalSubset Has the DTD an internal subset?
+ */
+void SAXBatchEmitter::startDoctypeDecl(void *userData,
+				       const XmlChar *doctypeName,
+				       const XmlChar *systemId,
+				       const XmlChar *publicId,
+				       int hasInternalSubset)
+{
+  flush();
+  SAXEmitter::startDoctypeDecl(userData, doctypeName, systemId, publicId, hasInternalSubset);
+}
+
+
+
+/*!
+  Flushes the batch and calls the corresponding method of the SAX receptor.
+
+  \param userData Pointer to the user data structure.
+ */
+void SAXBatchEmitter::endDoctypeDecl(void *userData)
+{
+  flush();
+  SAXEmitter::endDoctypeDecl(userData);
+}
+
+
+
+/*!
+  Flushes the batch and calls the corresponding method of the SAX receptor.
+
+  \param userData Pointer to the user data structure.
+  \param entityName The name of the entity.
+  \param isParameterEntity Is the entity a parameter entity?
+  \param value The value of the entity.
+  \param valueLength The length of the value.
+  \param base The base.
+  \param systemId The system id.
+  \param publicId The public id.
+  \param notationName The name of the notation.
+ */
+void SAXBatchEmitter::entityDecl(void *userData,
+				 const XmlChar *entityName,
+				 int isParameterEntity,
+				 const XmlChar *value,
+				 int valueLength,
+				 const XmlChar *base,
+				 const XmlChar *systemId,
+				 const XmlChar *publicId,
+				 const XmlChar *notationName)
+{
+  flush();
+  SAXEmitter::entityDecl(userData, entityName, isParameterEntity, value, valueLength, base, systemId, publicId, notationName);
+}
+
+
+
+/*!
+  Flushes the batch and calls the corresponding method of the SAX receptor.
+
+  \param userData Pointer to the user data structure.
+  \param notationName The name of the notation.
+  \param base The base.
+  \param systemId The system id.
+  \param publicId The public id.
+ */
+void SAXBatchEmitter::notationDecl(void *userData,
+				   const XmlChar *notationName,
+				   const XmlChar *base,
+				   const XmlChar *systemId,
+				   const XmlChar *publicId)
+{
+  flush();
+  SAXEmitter::notationDecl(userData, notationName, base, systemId, publicId);
+}
+
+
+
+
+//+++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+
+
+/*!
+  \brief Pass the event to the target emitter only inside a matching subtree.
+
+  \param x The method of the target emitter.
+ */
+#define CALL_IF_MATCHING(x)		\
+{					\
+  if (matchDepth)			\
+    targetEmitter->x;			\
+}
+
+
+/*!
+  The emitter takes the ownership of the target emitter. The filter is not owned.
+
+  \param emitter The emitter which receives the matching events.
+  \param filter The path filter.
+ */
+SAXPathFilterEmitter::SAXPathFilterEmitter(SAXEmitter *emitter, XmlPathFilter *filter)
+  : SAXEmitter()
+{
+  targetEmitter = emitter;
+  pathFilter = filter;
+
+  statesSize = 64;
+  NEW(states, XmlPathStates[statesSize]);
+  states[0] = pathFilter->initialStates();
+  depth = 0;
+  matchDepth = 0;
+}
+
+
+
+/*!
+  Deletes the target emitter.
+ */
+SAXPathFilterEmitter::~SAXPathFilterEmitter(void)
+{
+  DELETE_ARRAY(states);
+  DELETE(targetEmitter);
+}
+
+
+
+/*!
+  Sets the SAX receptor of the target emitter.
+
+  \param receptor Pointer to the SAX receptor.
+ */
+void SAXPathFilterEmitter::setSAXReceptor(SAXReceptor *receptor)
+{
+  targetEmitter->setSAXReceptor(receptor);
+}
+
+
+
+/*!
+  Flushes the target emitter.
+ */
+void SAXPathFilterEmitter::flush(void)
+{
+  targetEmitter->flush();
+}
+
+
+
+/*!
+  Errors are always passed on.
+ */
+void SAXPathFilterEmitter::reportError(void)
+{
+  targetEmitter->reportError();
+}
+
+
+
+/*!
+  Inside a matching subtree, the element is passed on. Otherwise, the filter is evaluated, and the element is passed on if it matches.
+
+  \param userData Pointer to the user data structure.
+  \param name Name of the element.
+  \param attr An array of attributes
+ */
+void SAXPathFilterEmitter::startElement(void *userData, const XmlChar *name, const XmlChar **attr)
+{
+  XmlPathStates newStates;
+
+  if (matchDepth)
+    {
+      matchDepth++;
+      targetEmitter->startElement(userData, name, attr);
+      return;
+    }
+
+  newStates = pathFilter->advance(states[depth], name);
+
+  if (pathFilter->matches(newStates))
+    {
+      //the matching subtree starts
+      matchDepth = 1;
+      targetEmitter->startElement(userData, name, attr);
+      return;
+    }
+
+  if (depth + 1 == statesSize)
+    {
+      XmlPathStates *pom;
+
+      NEW(pom, XmlPathStates[2 * statesSize]);
+
+      for (size_t i = 0; i < statesSize; i++)
+	pom[i] = states[i];
+
+      DELETE_ARRAY(states);
+      states = pom;
+      statesSize *= 2;
+    }
+
+  states[++depth] = newStates;
+}
+
+
+
+/*!
+  \param userData Pointer to the user data structure.
+  \param name Name of the element.
+ */
+void SAXPathFilterEmitter::endElement(void *userData,
+				      const XmlChar *name)
+{
+  if (matchDepth)
+    {
+      matchDepth--;
+      targetEmitter->endElement(userData, name);
+    }
+  else
+    if (depth)
+      depth--;
+}
+
+
+
+/*!
+  \param userData Pointer to the user data structure.
+  \param data Character data.
+  \param length Length of the data.
+ */
+void SAXPathFilterEmitter::characterData(void *userData,
+					 const XmlChar *data,
+					 int length)
+{
+  CALL_IF_MATCHING(characterData(userData, data, length));
+}
+
+
+
+/*!
+  \param userData Pointer to the user data structure.
+  \param target Target of the instruction.
+  \param data Data of the instruction.
+ */
+void SAXPathFilterEmitter::processingInstruction(void *userData,
+						 const XmlChar *target,
+						 const XmlChar *data)
+{
+  CALL_IF_MATCHING(processingInstruction(userData, target, data));
+}
+
+
+
+/*!
+  \param userData Pointer to the user data structure.
+  \param data Data of the comment.
+ */
+void SAXPathFilterEmitter::comment(void *userData,
+				   const XmlChar *data)
+{
+  CALL_IF_MATCHING(comment(userData, data));
+}
+
+
+
+/*!
+  \param userData Pointer to the user data structure.
+ */
+void SAXPathFilterEmitter::startCDATASection(void *userData)
+{
+  CALL_IF_MATCHING(startCDATASection(userData));
+}
+
+
+
+/*!
+  \param userData Pointer to the user data structure.
+ */
+void SAXPathFilterEmitter::endCDATASection(void *userData)
+{
+  CALL_IF_MATCHING(endCDATASection(userData));
+}
+
+
+
+/*!
+  \param userData Pointer to the user data structure.
+  \param data The default data.
+  \param length The length of the default data.
+ */
+void SAXPathFilterEmitter::defaultHandler(void *userData,
+					  const XmlChar *data,
+					  int length)
+{
+  CALL_IF_MATCHING(defaultHandler(userData, data, length));
+}
+
+
+
+/*!
+  The handler is always called.
+
+  \param unknownEncodingData The data structure describing the unknown encoding.
+  \param name The name of the encoding.
+  \param info The information about the encoding.
+ */
+int SAXPathFilterEmitter::unknownEncoding(void *unknownEncodingData,
+					  const XmlChar *name,
+					  XML_Encoding *info)
+{
+  return targetEmitter->unknownEncoding(unknownEncodingData, name, info);
+}
@@ -33,7 +33,10 @@
 
 #include "defs.h"
 #include "saxbase.h"
+#include "saxbatch.h"
 #include "saxreceptor.h"
+#include "xmlnametable.h"
+#include "xmlpathfilter.h"
 
 
 
@@ -52,9 +55,15 @@ public:
   //! A constructor.
   SAXEmitter(SAXReceptor *receptor);
 
+  //! A destructor.
+  virtual ~SAXEmitter(void) {}
+
   //! Set SAX receptor.
   virtual void setSAXReceptor(SAXReceptor *receptor);
 
+  //! Deliver the events held by the emitter.
+  virtual void flush(void);
+
 
   //! Report parser error messages.
   virtual void reportError(void);
@@ -140,4 +149,203 @@ protected:
   SAXReceptor *saxReceptor;
 };
 
+
+
+/*!
+  \brief An emitter of SAX events in batches.
+
+  The emitter collects the most frequent events (elements, attributes, character data, comments, CDATA sections and default data) in a SAXEventBatch, and delivers the whole batch to the receptor by SAXReceptor::eventBatch() when it gets full, when flush() is called, or before any other event. Adjacent character data are merged into one event.
+
+  \sa SAXReceptor::acceptsEventBatches().
+ */
+class SAXBatchEmitter : public SAXEmitter
+{
+public:
+  //! A constructor.
+  SAXBatchEmitter(SAXReceptor *receptor);
+
+  //! A destructor.
+  virtual ~SAXBatchEmitter(void);
+
+  //! Deliver the batch to the receptor.
+  virtual void flush(void);
+
+  //! Report parser error messages.
+  virtual void reportError(void);
+
+  //! Start element handler.
+  virtual void startElement(void *userData,
+			    const XmlChar *name,
+			    const XmlChar **atts);
+
+  //! End element handler.
+  virtual void endElement(void *userData,
+			  const XmlChar *name);
+
+  //! Character data handler.
+  virtual void characterData(void *userData,
+			     const XmlChar *data,
+			     int length);
+
+  //! Processing instruction handler.
+  virtual void processingInstruction(void *userData,
+				     const XmlChar *target,
+				     const XmlChar *data);
+
+  //! Comment handler.
+  virtual void comment(void *userData,
+		       const XmlChar *data);
+
+  //! Start CDATA section handler.
+  virtual void startCDATASection(void *userData);
+
+  //! End CDATA section handler.
+  virtual void endCDATASection(void *userData);
+
+  //! Default handler.
+  virtual void defaultHandler(void *userData,
+			      const XmlChar *data,
+			      int length);
+
+  //! Unknown encoding handler.
+  virtual int unknownEncoding(void *unknownEncodingData,
+			      const XmlChar *name,
+			      XML_Encoding *info);
+
+  //! XML declaration handler.
+  virtual void xmlDecl(void *userData,
+		       const XmlChar *version,
+		       const XmlChar *encoding,
+		       int standalone);
+
+  //! Start doctype handler.
+  virtual void startDoctypeDecl(void *userData,
+				const XmlChar *doctypeName,
+				const XmlChar *systemId,
+				const XmlChar *publicId,
+				int hasInternalSubset);
+
+  //! End doctype handler.
+  virtual void endDoctypeDecl(void *userData);
+
+  //! Entity declaration handler.
+  virtual void entityDecl(void *userData,
+			  const XmlChar *entityName,
+			  int isParameterEntity,
+			  const XmlChar *value,
+			  int valueLength,
+			  const XmlChar *base,
+			  const XmlChar *systemId,
+			  const XmlChar *publicId,
+			  const XmlChar *notationName);
+
+  //! Notation declaration handler.
+  virtual void notationDecl(void *userData,
+			    const XmlChar *notationName,
+			    const XmlChar *base,
+			    const XmlChar *systemId,
+			    const XmlChar *publicId);
+
+protected:
+  //! The table of the names of the elements and the attributes.
+  XmlNameTable *nameTable;
+
+  //! The batch of the events.
+  SAXEventBatch *batch;
+
+  //! The user data passed with the events of the batch.
+  void *batchUserData;
+
+  //! Make room for the events and the data (the batch is delivered if needed).
+  virtual void prepareBatch(void *userData, size_t nrEvents, size_t dataLength);
+
+  //! Append an event with data.
+  virtual void appendEvent(void *userData, SAXBatchEventType type, const XmlChar *data, size_t length);
+};
+
+
+/*!
+  \brief An emitter that passes on only the subtrees matching a path.
+
+  The emitter evaluates the path filter on the elements emitted by the XML model, and passes the events inside the matching elements (including the elements themselves) to another emitter. All other events are dropped immediately, so they are never converted or written by the receptor. The output thus consists of the sequence of the matching subtrees.
+
+  \sa XmlPathFilter.
+ */
+class SAXPathFilterEmitter : public SAXEmitter
+{
+public:
+  //! A constructor.
+  SAXPathFilterEmitter(SAXEmitter *emitter, XmlPathFilter *filter);
+
+  //! A destructor.
+  virtual ~SAXPathFilterEmitter(void);
+
+  //! Set SAX receptor.
+  virtual void setSAXReceptor(SAXReceptor *receptor);
+
+  //! Deliver the events held by the emitter.
+  virtual void flush(void);
+
+  //! Report parser error messages.
+  virtual void reportError(void);
+
+  //! Start element handler.
+  virtual void startElement(void *userData,
+			    const XmlChar *name,
+			    const XmlChar **atts);
+
+  //! End element handler.
+  virtual void endElement(void *userData,
+			  const XmlChar *name);
+
+  //! Character data handler.
+  virtual void characterData(void *userData,
+			     const XmlChar *data,
+			     int length);
+
+  //! Processing instruction handler.
+  virtual void processingInstruction(void *userData,
+				     const XmlChar *target,
+				     const XmlChar *data);
+
+  //! Comment handler.
+  virtual void comment(void *userData,
+		       const XmlChar *data);
+
+  //! Start CDATA section handler.
+  virtual void startCDATASection(void *userData);
+
+  //! End CDATA section handler.
+  virtual void endCDATASection(void *userData);
+
+  //! Default handler.
+  virtual void defaultHandler(void *userData,
+			      const XmlChar *data,
+			      int length);
+
+  //! Unknown encoding handler.
+  virtual int unknownEncoding(void *unknownEncodingData,
+			      const XmlChar *name,
+			      XML_Encoding *info);
+
+protected:
+  //! The emitter which receives the matching events.
+  SAXEmitter *targetEmitter;
+
+  //! The path filter.
+  XmlPathFilter *pathFilter;
+
+  //! The stack of the states of the open elements outside the matching subtrees.
+  XmlPathStates *states;
+
+  //! The number of the open elements outside the matching subtrees.
+  size_t depth;
+
+  //! The size of the stack of the states.
+  size_t statesSize;
+
+  //! The number of the open elements inside the matching subtree (0 if outside).
+  size_t matchDepth;
+};
+
 #endif //SAXEMITTER_H
@@ -31,6 +31,7 @@
 #include "defs.h"
 #include "options.h"
 #include "saxbase.h"
+#include "saxbatch.h"
 #include "xmldefs.h"
 
 
@@ -38,12 +39,31 @@
   \brief An abstract predecessor of all SAX receptors.
 
   Inherit this class whenever you want to implement your own SAX receptor.
+
+  A receptor can also receive the events in batches (see SAXEventBatch): if acceptsEventBatches() returns true, the decoder collects the events and delivers them by eventBatch(), which saves the virtual calls of the individual handlers.
  */
 class SAXReceptor : public SAXBase
 {
 public:
   //! A Constructor.
   SAXReceptor(void) : SAXBase() {}
+
+  /*!
+    \brief Indication whether the receptor wants to receive the events in batches.
+
+    Returns false, reimplement together with eventBatch().
+   */
+  virtual bool acceptsEventBatches(void) { return false; }
+
+  /*!
+    \brief Batch of events handler.
+
+    Calls the handlers of the individual events (see SAXEventBatch::replay()).
+
+    \param userData Pointer to the user data structure.
+    \param batch The batch of the events.
+   */
+  virtual void eventBatch(void *userData, SAXEventBatch *batch) { batch->replay(this, userData); }
 };
 
 #endif //SAXRECEPTOR_H
@@ -74,6 +74,53 @@ if (saxEmitter)				\
 #define RESET_STATE		state = AdaptiveStructuralSymbols::None
 
 
+/*!
+  \brief Test whether the symbol is a character of the character data.
+
+  All the structural symbols are smaller than or equal to AdaptiveStructuralSymbols::EmptyString.
+
+  \param _c_ The symbol.
+*/
+#define IS_PLAIN_CHARACTER(_c_)						\
+  ((unsigned long)(_c_) > (unsigned long)AdaptiveStructuralSymbols::EmptyString)
+
+
+/*!
+  \brief Append a run of character data to the buffer.
+
+  The data is copied to the buffer in blocks. Whenever the buffer gets full, its content is sent to the SAX emitter.
+
+  \param _data_ The character data.
+  \param _length_ The length of the data.
+*/
+#define APPEND_CHARACTER_RUN(_data_, _length_)					\
+{										\
+  const XmlChar *_run_ = (_data_);						\
+  size_t _runLength_ = (_length_);						\
+  size_t _chunk_;								\
+										\
+  while (_runLength_)								\
+    {										\
+      _chunk_ = XML_MODEL_BUFFER_DEFAULT_SIZE - bufferLength;			\
+      if (_chunk_ > _runLength_)						\
+	_chunk_ = _runLength_;							\
+										\
+      memcpy(buffer + bufferLength, _run_, _chunk_ * sizeof(XmlChar));	\
+      bufferLength += _chunk_;							\
+      _run_ += _chunk_;								\
+      _runLength_ -= _chunk_;							\
+										\
+      if (bufferLength == XML_MODEL_BUFFER_DEFAULT_SIZE)			\
+	{									\
+	  /* character data larger than the buffer --> split it */		\
+	  SAFE_CALL_EMITTER(characterData(userData, buffer, bufferLength));	\
+	  RESET_BUFFER;								\
+	  textValuePure = false;						\
+	}									\
+    }										\
+}
+
+
 /*!
   Append the \a data of length \a length to the right side of the root rule of the \a grammar. If \a complete is TRUE, insert also "end of chunk symbol".
 
@@ -166,11 +213,32 @@ if (saxEmitter)				\
 */
 #define END_CHARACTER_DATA_SECTION(_gr_)		\
 {							\
+  if (valueCache)					\
+    finishTextValue();					\
+							\
   _gr_->append(AdaptiveStructuralSymbols::EndOfBlock);	\
   inCharacters = false;					\
 }
 
 
+/*!
+  \brief The key of the character data of the element in the value cache.
+
+  The names are hashed, so the encoder and the decoder get the same keys even though they number the elements differently. The keys of the text are even, the keys of the attribute values are odd.
+
+  \param _elementName_ The name of the element.
+*/
+#define TEXT_VALUE_KEY(_elementName_)		(2 * hashXmlString(_elementName_))
+
+
+/*!
+  \brief The key of the values of the attribute in the value cache.
+
+  \param _attributeName_ The name of the attribute.
+*/
+#define ATTRIBUTE_VALUE_KEY(_attributeName_)	(2 * hashXmlString(_attributeName_) + 1)
+
+
 //! Resets the clueEdge value.
 #define RESET_CLUE_EDGE				\
 {						\
@@ -238,15 +306,18 @@ XmlAdaptiveModel::XmlAdaptiveModel(void)
 {
   grammar = 0;
 
+  valueCache = 0;
+  graphLimit = 0;
+  textValueLength = 0;
+  textValuePure = true;
+  valueRefPending = false;
 
   state = AdaptiveStructuralSymbols::None;
   
   buffer = 0;
   bufferLength = 0;
 
-  fibBits = 0;
-  fibCode = 0;
-  fibLastWasOne = false;
+  Fibonacci::resetDecoder(&fibDecoder);
   
   NEW(dataQueue, DataQueue);
   dataQueue->setAutoDelete(true);
@@ -260,6 +331,8 @@ XmlAdaptiveModel::XmlAdaptiveModel(void)
   inCDATA = false;
   inDoctype = false;
   inCharacters = false;
+  inComment = false;
+  inPI = 0;
   inProlog = true;
   inNACK = false;
   inAttr= false;
@@ -275,8 +348,7 @@ XmlAdaptiveModel::XmlAdaptiveModel(void)
 
   elementStack->setAutoDelete(true);
 
-  NEW(elementIds, ElementIds);
-  elementIds->setAutoDelete(true);
+  NEW(elementIds, XmlNameIdMap);
 
   NEW(elements, AdaptiveElementTable);
   elements->setAutoDelete(true);
@@ -288,8 +360,7 @@ XmlAdaptiveModel::XmlAdaptiveModel(void)
   elementNamesList->setAutoDelete(true);
 
 
-  NEW(attributeIds, AttributeIds);
-  attributeIds->setAutoDelete(true);
+  NEW(attributeIds, XmlNameIdMap);
 
   //list containing all attributes names
   //used just for freeing all the data
@@ -302,6 +373,8 @@ XmlAdaptiveModel::XmlAdaptiveModel(void)
   elementCounter = 1;
   attributeCounter = 1;
 
+  declaredElements = 0;
+
   elementModelerList.setAutoDelete(true);
 
   
@@ -323,9 +396,13 @@ XmlAdaptiveModel::~XmlAdaptiveModel(void)
 
   DELETE(dataQueue);
 
+  DELETE(elementIds);
   DELETE(attributeIds);
   DELETE(attributeNames);
 
+  if (declaredElements)
+    DELETE(declaredElements);
+
   //pre-compute the structural entropy of the element models if in verbose (or "print models") mode
   if (ExaltOptions::getOption(ExaltOptions::PrintModels) == ExaltOptions::Yes ||
       ExaltOptions::getOption(ExaltOptions::Verbose) == ExaltOptions::Yes)
@@ -376,6 +453,61 @@ XmlAdaptiveModel::~XmlAdaptiveModel(void)
 }
 
 
+/*!
+  The elements declared in the DTD get their ids in the order of their declarations (before any element of the document is read) and their models are built from their content models (see ElementModeler::compile()). The structure of the elements which conform to the DTD is then predicted from their first occurrence. The elements with required attributes are expected to have attributes.
+
+  The encoder and the decoder have to use the same DTD.
+
+  \param dtd The DTD (NULL means that the structure is learnt from the document only).
+*/
+void XmlAdaptiveModel::setDtd(XmlDtd *dtd)
+{
+  ElementModeler **modelers;
+  AdaptiveElementContext *ec;
+  XmlChar *elName;
+  size_t count;
+
+  if (!dtd || !(count = dtd->count()))
+    return;
+
+  NEW(declaredElements, XmlNameIds);
+  declaredElements->setAutoDelete(true);
+
+  NEW(modelers, ElementModeler *[count]);
+
+  for (size_t i = 0; i < count; i++)
+    {
+      NEW(elName, XmlChar[xmlchar_strlen(dtd->getName(i)) + 1]);
+      xmlchar_strcpy(elName, dtd->getName(i));
+      elementNamesList->append(elName);
+
+      NEW(ec, AdaptiveElementContext);
+      ec->name = elName;
+
+      NEW(ec->modeler, ElementModeler(elName, graphLimit));
+      elementModelerList.append(ec->modeler);
+      modelers[i] = ec->modeler;
+
+      elements->insert(elementCounter, ec);
+      declaredElements->insert(elName, new unsigned long(elementCounter));
+
+      elementCounter++;
+    }
+
+  for (size_t i = 0; i < count; i++)
+    {
+      if (dtd->getContentModel(i))
+	modelers[i]->compile(dtd->getContentModel(i), modelers);
+
+      if (dtd->hasRequiredAttributes(i))
+	modelers[i]->setAttributes(true);
+    }
+
+  DELETE_ARRAY(modelers);
+}
+
+
+
 /*!
   Sets the SAX emitter and (optionaly) the user data.
 
@@ -408,12 +540,12 @@ bool XmlAdaptiveModel::manageEvent(XmlModelEvent *event)
   XmlDefaultEvent *defaultEvent;
 
   XmlChar *elName;
-  unsigned long *elId;
+  unsigned long elId;
   unsigned long elementId;
   ElementModelerInfo *emi;
 
   XmlChar *attrName;
-  unsigned long *attrId;
+  unsigned long attrId;
   unsigned long attributeId;
 
   AdaptiveElementContext *ec;
@@ -666,7 +798,19 @@ bool XmlAdaptiveModel::manageEvent(XmlModelEvent *event)
  	}
 
 
-      if (!(elId = elementIds->find((XmlChar *)startElementEvent->name)))
+      if (!(elId = elementIds->find(startElementEvent->nameId)) && declaredElements)
+	{
+	  //the element may have been declared in the DTD
+	  unsigned long *declaredId = declaredElements->find((XmlChar *)startElementEvent->name);
+
+	  if (declaredId)
+	    {
+	      elId = *declaredId;
+	      elementIds->insert(startElementEvent->nameId, elId);
+	    }
+	}
+
+      if (!elId)
 	{
 	  //unknown element started
 	  //--> we'll create new element context for it
@@ -680,7 +824,7 @@ bool XmlAdaptiveModel::manageEvent(XmlModelEvent *event)
 
 	  //insert new element id to elementIds
 	  elementId = elementCounter;
-	  elementIds->insert(elName, new unsigned long(elementId));
+	  elementIds->insert(startElementEvent->nameId, elementId);
 
 
 	  NEW(ec, AdaptiveElementContext);
@@ -688,7 +832,7 @@ bool XmlAdaptiveModel::manageEvent(XmlModelEvent *event)
 	  //set unique element id
 	  ec->name = elName;
 
-	  NEW(ec->modeler, ElementModeler(elName));
+	  NEW(ec->modeler, ElementModeler(elName, graphLimit));
 
 	  NEW(emi, ElementModelerInfo);
 	  emi->modeler = ec->modeler;
@@ -777,11 +921,11 @@ bool XmlAdaptiveModel::manageEvent(XmlModelEvent *event)
 	{
 	  //known element started
 	  //--> update its element context
-	  ec = elements->find(*elId);
+	  ec = elements->find(elId);
 	  CHECK_POINTER(ec);
 
   	  DBG("KNOWN: " << ec->name);
-	  DBG("KNOWN ID: " << *elId);
+	  DBG("KNOWN ID: " << elId);
 
 	  NEW(emi, ElementModelerInfo);
 	  emi->modeler = ec->modeler;
@@ -790,53 +934,64 @@ bool XmlAdaptiveModel::manageEvent(XmlModelEvent *event)
 
 	  emi->modeler->increaseRefCount();
 
-	  elementId = *elId;
+	  elementId = elId;
 
 
-	  result = elementModelerStack.top()->modeler->moveToDesiredNode(ElementModel::ElementNode, &edge, &elts, emi->modeler);
-	  
-	  if (result == ElementModel::NewNodeCreated)
+	  if (elementModelerStack.isEmpty())
 	    {
-	      if (elementModelerStack.top()->building)
-		{
-		  DBG("BUILDING: New node created");
+	      //the root element declared in the DTD
+	      //--> its name is appended, as for the new elements
+	      grammar->append(AdaptiveStructuralSymbols::NewElement);
+	      APPEND_ALL_DATA(grammar, startElementEvent->name, true);
+	      clueEdge = 1;
+	    }
+	  else
+	    {
+	      result = elementModelerStack.top()->modeler->moveToDesiredNode(ElementModel::ElementNode, &edge, &elts, emi->modeler);
 
-		  grammar->append(AdaptiveStructuralSymbols::KnownElement);
-		  fibItems = Fibonacci::encodeToBuffer(fibBuf, SIZEOF_XML_CHAR, elementId);
-		  APPEND_BUFFER_DATA(grammar, fibBuf, fibItems);
-		  RESET_CLUE_EDGE;
-		}
-	      else
+	      if (result == ElementModel::NewNodeCreated)
 		{
-		  DBG("NACK: New node created");
-		  REPORT_NACK;
-		  RESET_CLUE_EDGE;
-		  //nack + new node created --> we're building
-		  elementModelerStack.top()->building = true;
+		  if (elementModelerStack.top()->building)
+		    {
+		      DBG("BUILDING: New node created");
+
+		      grammar->append(AdaptiveStructuralSymbols::KnownElement);
+		      fibItems = Fibonacci::encodeToBuffer(fibBuf, SIZEOF_XML_CHAR, elementId);
+		      APPEND_BUFFER_DATA(grammar, fibBuf, fibItems);
+		      RESET_CLUE_EDGE;
+		    }
+		  else
+		    {
+		      DBG("NACK: New node created");
+		      REPORT_NACK;
+		      RESET_CLUE_EDGE;
+		      //nack + new node created --> we're building
+		      elementModelerStack.top()->building = true;
 
-		  grammar->append(AdaptiveStructuralSymbols::KnownElement);
-		  fibItems = Fibonacci::encodeToBuffer(fibBuf, SIZEOF_XML_CHAR, elementId);
-		  APPEND_BUFFER_DATA(grammar, fibBuf, fibItems);
+		      grammar->append(AdaptiveStructuralSymbols::KnownElement);
+		      fibItems = Fibonacci::encodeToBuffer(fibBuf, SIZEOF_XML_CHAR, elementId);
+		      APPEND_BUFFER_DATA(grammar, fibBuf, fibItems);
+		    }
 		}
-	    }
-	  else
-	    if (result == ElementModel::Indefinite)
-	      {
-		//prediction failed --> use different edge
+	      else
+		if (result == ElementModel::Indefinite)
+		  {
+		    //prediction failed --> use different edge
 
-		DBG("NACK KNOWN indefinite - add code");
-		REPORT_NACK;
-		REPORT_DIFFERENT_EDGE(edge);
+		    DBG("NACK KNOWN indefinite - add code");
+		    REPORT_NACK;
+		    REPORT_DIFFERENT_EDGE(edge);
 
-		RESET_CLUE_EDGE;
-		clueEdge = 1;
-		clueEdgeReset = true;
-	      }
-	    else
-	      {
-		DBG("KNOWN definite");
- 		clueEdge++;
-	      }
+		    RESET_CLUE_EDGE;
+		    clueEdge = 1;
+		    clueEdgeReset = true;
+		  }
+		else
+		  {
+		    DBG("KNOWN definite");
+		    clueEdge++;
+		  }
+	    }
 	  
 	  
 
@@ -870,7 +1025,7 @@ bool XmlAdaptiveModel::manageEvent(XmlModelEvent *event)
 	  //here is the code that writes down the attributes
        	  for (size_t i = 0; startElementEvent->attr[i]; i += 2)
        	    {
-       	      if (!(attrId = attributeIds->find((XmlChar *)startElementEvent->attr[i])))
+       	      if (!(attrId = attributeIds->find(startElementEvent->attrIds[i / 2])))
        		{
        		  //unknown attribute started
        		  //--> we'll create new element context for it
@@ -884,7 +1039,7 @@ bool XmlAdaptiveModel::manageEvent(XmlModelEvent *event)
 
        		  //insert new element id to elementIds
        		  attributeId = attributeCounter;
-       		  attributeIds->insert(attrName, new unsigned long(attributeId));
+       		  attributeIds->insert(startElementEvent->attrIds[i / 2], attributeId);
 
 		  DBG("INSERTING ATTRIBUTE " << attributeId << ": " << attrName);
 		  attributeNames->insert(attributeId, attrName);
@@ -905,7 +1060,7 @@ bool XmlAdaptiveModel::manageEvent(XmlModelEvent *event)
        		{
        		  //known attribute started
        		  //--> update its element context
-       		  attributeId = *attrId;
+       		  attributeId = attrId;
 
        		  //append "known element" symbol to the grammar
        		  grammar->append(AdaptiveStructuralSymbols::KnownElement);
@@ -918,7 +1073,25 @@ bool XmlAdaptiveModel::manageEvent(XmlModelEvent *event)
        	      if (startElementEvent->attr[i+1][0] == 0)
        		grammar->append(AdaptiveStructuralSymbols::EmptyString);
        	      else
-       		APPEND_ALL_DATA(grammar, startElementEvent->attr[i+1], false);
+		if (valueCache)
+		  {
+		    size_t valueLength = xmlchar_strlen(startElementEvent->attr[i+1]);
+		    unsigned long valueKey = ATTRIBUTE_VALUE_KEY(startElementEvent->attr[i]);
+		    int index;
+
+		    if ((index = valueCache->find(valueKey, startElementEvent->attr[i+1], valueLength)) >= 0)
+		      {
+			//a recently used value --> append its index
+			grammar->append(AdaptiveStructuralSymbols::EmptyString);
+			grammar->append((TerminalValue)(XML_VALUE_CACHE_FIRST_INDEX_SYMBOL + index));
+		      }
+		    else
+		      APPEND_ALL_DATA(grammar, startElementEvent->attr[i+1], false);
+
+		    valueCache->update(valueKey, startElementEvent->attr[i+1], valueLength);
+		  }
+		else
+		  APPEND_ALL_DATA(grammar, startElementEvent->attr[i+1], false);
        	    }
 
 	  //append the "end of block" symbol to indicate the end of the attribute section
@@ -959,7 +1132,7 @@ bool XmlAdaptiveModel::manageEvent(XmlModelEvent *event)
 
       //AdaptiveElementContext *ec;
 
-      if (!(elId = elementIds->find((XmlChar *)endElementEvent->name)))
+      if (!(elId = elementIds->find(endElementEvent->nameId)))
 	{
 	  //end of unknown element occurred
 	  //--> should never happen
@@ -978,41 +1151,53 @@ bool XmlAdaptiveModel::manageEvent(XmlModelEvent *event)
 
       result = elementModelerStack.top()->modeler->moveToDesiredNode(ElementModel::EndNode, &edge, &elts);
 
-      if (result == ElementModel::NewNodeCreated)
+      if (elementModelerStack.count() == 1 && result != ElementModel::NewNodeCreated)
 	{
-	  if (elementModelerStack.top()->building)
-	    {
-	      DBG("BUILDING: New node created (end node)");
+	  //end of the root element (which may be declared in the DTD)
+	  //--> always explicit, the decoder doesn't move over it
+	  DBG("NACK: end of the root element");
+	  REPORT_NACK;
 
-	      RESET_CLUE_EDGE;
-
-	      grammar->append(AdaptiveStructuralSymbols::EndElement);
-	    }
-	  else
-	    {
-	      DBG("NACK: New node created (end node)");
-	      REPORT_NACK;
-
-	      RESET_CLUE_EDGE;
+	  RESET_CLUE_EDGE;
 
-	      grammar->append(AdaptiveStructuralSymbols::EndElement);
-	    }
+	  grammar->append(AdaptiveStructuralSymbols::EndElement);
 	}
       else
-	if (result == ElementModel::Indefinite)
+	if (result == ElementModel::NewNodeCreated)
 	  {
-	    //prediction failed --> use different edge
-	    DBG("NACK END: indefinite - add code");
-	    REPORT_NACK;
-	    REPORT_DIFFERENT_EDGE(edge);
+	    if (elementModelerStack.top()->building)
+	      {
+		DBG("BUILDING: New node created (end node)");
+
+		RESET_CLUE_EDGE;
 
-	    RESET_CLUE_EDGE;
+		grammar->append(AdaptiveStructuralSymbols::EndElement);
+	      }
+	    else
+	      {
+		DBG("NACK: New node created (end node)");
+		REPORT_NACK;
+
+		RESET_CLUE_EDGE;
+
+		grammar->append(AdaptiveStructuralSymbols::EndElement);
+	      }
 	  }
 	else
-	  {
-	    //  	    DBG("END definite - add code");
-	    INCREASE_CLUE_EDGE;
-	  }
+	  if (result == ElementModel::Indefinite)
+	    {
+	      //prediction failed --> use different edge
+	      DBG("NACK END: indefinite - add code");
+	      REPORT_NACK;
+	      REPORT_DIFFERENT_EDGE(edge);
+
+	      RESET_CLUE_EDGE;
+	    }
+	  else
+	    {
+	      //  	    DBG("END definite - add code");
+	      INCREASE_CLUE_EDGE;
+	    }
 
 
 
@@ -1081,7 +1266,10 @@ bool XmlAdaptiveModel::manageEvent(XmlModelEvent *event)
 	}
 
       //append the character data without the ending 0 (that will be appended at another time)
-      APPEND_ALL_DATA_LENGTH(grammar, charactersEvent->data, charactersEvent->length, false);
+      if (valueCache)
+	appendTextValue(charactersEvent->data, charactersEvent->length, false);
+      else
+	APPEND_ALL_DATA_LENGTH(grammar, charactersEvent->data, charactersEvent->length, false);
 	  
       break;
 
@@ -1149,7 +1337,10 @@ bool XmlAdaptiveModel::manageEvent(XmlModelEvent *event)
 	
 
 	  //grammar->append(AdaptiveStructuralSymbols::Default);
-	  APPEND_ALL_DATA_LENGTH_CONVERT_AMP(grammar, defaultEvent->data, defaultEvent->length, false);
+	  if (valueCache)
+	    appendTextValue(defaultEvent->data, defaultEvent->length, true);
+	  else
+	    APPEND_ALL_DATA_LENGTH_CONVERT_AMP(grammar, defaultEvent->data, defaultEvent->length, false);
 	}
       break;
 
@@ -1217,6 +1408,10 @@ bool XmlAdaptiveModel::manageEvent(XmlModelEvent *event)
 	}
 
 
+      //the section doesn't contain only the character data
+      if (valueCache && inCharacters)
+	flushTextValue();
+
       //append "comment" symbol to the grammar
       grammar->append(AdaptiveStructuralSymbols::Comment);
 
@@ -1277,6 +1472,10 @@ bool XmlAdaptiveModel::manageEvent(XmlModelEvent *event)
 
 
 
+      //the section doesn't contain only the character data
+      if (valueCache)
+	flushTextValue();
+
       //append "CDATA" symbol to the grammar
       grammar->append(AdaptiveStructuralSymbols::CDATA);
       break;
@@ -1355,6 +1554,10 @@ bool XmlAdaptiveModel::manageEvent(XmlModelEvent *event)
 	    }
 	}
 
+      //the section doesn't contain only the character data
+      if (valueCache && inCharacters)
+	flushTextValue();
+
       //append "pi" symbol to the grammar
       grammar->append(AdaptiveStructuralSymbols::PI);
 
@@ -1376,17 +1579,85 @@ bool XmlAdaptiveModel::manageEvent(XmlModelEvent *event)
 
     default:
       WRN("Unknown XML event: " << event->type);
-      DELETE(event);
       return false;
     }
 
-  //delete the event structure
-  DELETE(event);
   return true;
 }
 
 
 
+/*!
+  The data are kept while the section contains only short character data. Otherwise the kept data and the new data are appended to the grammar as text.
+
+  \param data The character data.
+  \param length The length of the data.
+  \param convertAmp Indication whether the ampersands should be replaced by AMP_REPLACEMENT (default data).
+ */
+void XmlAdaptiveModel::appendTextValue(const XmlChar *data, size_t length, bool convertAmp)
+{
+  if (textValuePure && textValueLength + length <= XML_VALUE_CACHE_MAX_LENGTH)
+    {
+      for (size_t i = 0; i < length; i++)
+	textValue[textValueLength++] = (convertAmp && data[i] == '&') ? (XmlChar)AMP_REPLACEMENT : data[i];
+    }
+  else
+    {
+      //the section is too long to be remembered
+      flushTextValue();
+
+      if (convertAmp)
+	{
+	  APPEND_ALL_DATA_LENGTH_CONVERT_AMP(grammar, data, length, false);
+	}
+      else
+	APPEND_ALL_DATA_LENGTH(grammar, data, length, false);
+    }
+}
+
+
+
+/*!
+  The rest of the section is appended directly and the section is not remembered by the value cache.
+ */
+void XmlAdaptiveModel::flushTextValue(void)
+{
+  APPEND_ALL_DATA_LENGTH(grammar, textValue, textValueLength, false);
+
+  textValueLength = 0;
+  textValuePure = false;
+}
+
+
+
+/*!
+  If the section contained only the character data, the data are appended either as text, or as the index of the data in the value cache. The cache is updated.
+ */
+void XmlAdaptiveModel::finishTextValue(void)
+{
+  if (textValuePure && textValueLength)
+    {
+      unsigned long valueKey = TEXT_VALUE_KEY(elementModelerStack.top()->modeler->getElementName());
+      int index;
+
+      if ((index = valueCache->find(valueKey, textValue, textValueLength)) >= 0)
+	{
+	  //recently used data --> append their index
+	  grammar->append(AdaptiveStructuralSymbols::EmptyString);
+	  grammar->append((TerminalValue)(XML_VALUE_CACHE_FIRST_INDEX_SYMBOL + index));
+	}
+      else
+	APPEND_ALL_DATA_LENGTH(grammar, textValue, textValueLength, false);
+
+      valueCache->update(valueKey, textValue, textValueLength);
+    }
+
+  textValueLength = 0;
+  textValuePure = true;
+}
+
+
+
 /*!
   This method implements the decoding procedure. It receives data from the underlying grammar and reconstructs the XML data.
 
@@ -1403,7 +1674,7 @@ void XmlAdaptiveModel::receiveData(XmlChar *data, size_t size)
   unsigned long *elId;
 
   //some variables for working with Fibonacci codes
-  unsigned char fibTmpChar, fibMask;
+  unsigned long fibNumber;
   bool fibFinished = false;
 
   size_t edge;
@@ -1418,6 +1689,29 @@ void XmlAdaptiveModel::receiveData(XmlChar *data, size_t size)
 
   for (size_t i = 0; i < size; i++)
     {
+      //the data contains many symbols --> reset the per-symbol variables
+      stateChanged = false;
+      fibFinished = false;
+      elts = 0;
+
+      if (valueRefPending && (unsigned char)data[i] < XML_VALUE_CACHE_FIRST_INDEX_SYMBOL)
+	//no index follows the empty string (the empty value of an attribute)
+	valueRefPending = false;
+
+      if (state == AdaptiveStructuralSymbols::Characters && !inAttrValue && !valueRefPending && IS_PLAIN_CHARACTER(data[i]))
+	{
+	  //a run of character data --> find the next structural symbol and copy the whole run at once
+	  size_t runEnd = i + 1;
+
+	  while (runEnd < size && IS_PLAIN_CHARACTER(data[runEnd]))
+	    runEnd++;
+
+	  APPEND_CHARACTER_RUN(data + i, runEnd - i);
+
+	  i = runEnd - 1;
+	  continue;
+	}
+
       if (state != AdaptiveStructuralSymbols::KnownElement)
 	{
 	  switch (data[i])
@@ -1438,6 +1732,9 @@ void XmlAdaptiveModel::receiveData(XmlChar *data, size_t size)
 		  DBG("1");
 		  FINISH_START_ELEMENT_WITH_NO_ATTRIBUTES;
 
+		  //a new section starts
+		  textValuePure = true;
+
 		  //if we are not reading the attribute values, move in the models
 		  if (!inAttr)
 		    {
@@ -1599,9 +1896,10 @@ void XmlAdaptiveModel::receiveData(XmlChar *data, size_t size)
 		      DBG("4");
 		      FINISH_START_ELEMENT_WITH_NO_ATTRIBUTES;
 
-		      elId = elementStack->pop();
-		      CHECK_POINTER(elId);
-		      ec = elements->find(*elId);
+		      //the elements entered by the prediction are not on the stack
+		      //(it may be empty at the end of the root element)
+		      if ((elId = elementStack->pop()))
+			ec = elements->find(*elId);
 
 	      
 
@@ -1637,6 +1935,10 @@ void XmlAdaptiveModel::receiveData(XmlChar *data, size_t size)
 				    eminfo->modeler = node->modeler;				
 				    eminfo->building = false;				
 	  							
+				    //the element passed through is started as well (with no attributes)
+				    SAFE_CALL_EMITTER(startElement(userData, eminfo->modeler->getElementName(), 0));
+				    eminfo->modeler->setAttributes(false);
+
 				    elementModelerStack.push(eminfo);			
 				    eminfo->modeler->resetCurrentNode();
 				  }							
@@ -1740,7 +2042,7 @@ void XmlAdaptiveModel::receiveData(XmlChar *data, size_t size)
 	      systemId = dataQueue->dequeue()->data;
 
 	      SAFE_CALL_EMITTER(startDoctypeDecl(userData, doctype, systemId, publicId,
-						 data[0] == AdaptiveStructuralSymbols::HasInternalSubsetYes));
+						 data[i] == AdaptiveStructuralSymbols::HasInternalSubsetYes));
 
 	      if (doctype)
 		{
@@ -1804,38 +2106,12 @@ void XmlAdaptiveModel::receiveData(XmlChar *data, size_t size)
 	    {
 	      DBG("NACK data");
 
-	      fibMask = 1 << (SIZEOF_CHAR*8 - 1);
-	      
 	      //decode symbol using Fibonacci code
-	      fibTmpChar = (unsigned char)data[i];
-	      DBG("SSS: " << (unsigned int)fibTmpChar);
-
-	      while (fibMask)
-		{
-		  fibCode >>= 1;
-		  fibBits++;
-		  
-		  if (fibTmpChar & fibMask)
-		    {
-		      fibCode = fibCode | ((unsigned long)1) << (SIZEOF_UNSIGNED_LONG*8-1);
-		      
-		      if (!fibLastWasOne)
-			fibLastWasOne = true;
-		      else
-			{
-			  //Fibonacci code is now complete
-			  //--> decode the symbol number
-			  fibCode >>= (SIZEOF_UNSIGNED_LONG*8 - fibBits);
-			  clueEdge = Fibonacci::decode(fibCode);
-			  fibFinished = true;
-			  break;
-			}
-		    }
-		  else
-		    fibLastWasOne = false;
-		  
-		  fibMask >>= 1;
-		}
+	      if (Fibonacci::decodeChar(&fibDecoder, (unsigned char)data[i], &fibNumber))
+	        {
+	          clueEdge = fibNumber;
+	          fibFinished = true;
+	        }
 
 	      if (fibFinished)
 		{
@@ -1845,10 +2121,6 @@ void XmlAdaptiveModel::receiveData(XmlChar *data, size_t size)
  		  readingNackData = true;
 
 		  //complete Fibonacci code read and decoded
-		  //reset fibCode, and fibBits
-		  fibCode = 0;
-		  fibBits = 0;
-		  fibLastWasOne = false;
 
 		  RESET_BUFFER;
 		  RESET_STATE;
@@ -1883,16 +2155,15 @@ void XmlAdaptiveModel::receiveData(XmlChar *data, size_t size)
 			    attrPos = 1;
 			    clueEdge--;
 
-			    if (clueEdge == 1)
-			      {
-				DBG("skipped the attribute node, because the element has no attributes");
-				dataQueueItem = dataQueue->dequeue();
-				      
-				//emit startElement event with no attributes
-				//FINISH_START_ELEMENT_WITH_NO_ATTRIBUTES;
-				SAFE_CALL_EMITTER(startElement(userData, dataQueueItem->data, 0));
-				elementModelerStack.top()->modeler->setAttributes(false);	//zz
-			      }
+			    DBG("skipped the attribute node, because the element has no attributes");
+			    dataQueueItem = dataQueue->dequeue();
+
+			    //emit startElement event with no attributes
+			    //(before the next move, which may end the element)
+			    SAFE_CALL_EMITTER(startElement(userData, dataQueueItem->data, 0));
+			    elementModelerStack.top()->modeler->setAttributes(false);	//zz
+
+			    moved = true;
 			    continue;
 
 			  }
@@ -2028,37 +2299,12 @@ void XmlAdaptiveModel::receiveData(XmlChar *data, size_t size)
 	    {
 	      DBG("DifferentEdge data");
 
-	      fibMask = 1 << (SIZEOF_CHAR*8 - 1);
-	      
 	      //decode symbol using Fibonacci code
-	      fibTmpChar = (unsigned char)data[i];
-
-	      while (fibMask)
-		{
-		  fibCode >>= 1;
-		  fibBits++;
-		  
-		  if (fibTmpChar & fibMask)
-		    {
-		      fibCode = fibCode | ((unsigned long)1) << (SIZEOF_UNSIGNED_LONG*8-1);
-		      
-		      if (!fibLastWasOne)
-			fibLastWasOne = true;
-		      else
-			{
-			  //Fibonacci code is now complete
-			  //--> decode the symbol number
-			  fibCode >>= (SIZEOF_UNSIGNED_LONG*8 - fibBits);
-			  differentEdge = Fibonacci::decode(fibCode);
-			  fibFinished = true;
-			  break;
-			}
-		    }
-		  else
-		    fibLastWasOne = false;
-		  
-		  fibMask >>= 1;
-		}
+	      if (Fibonacci::decodeChar(&fibDecoder, (unsigned char)data[i], &fibNumber))
+	        {
+	          differentEdge = fibNumber;
+	          fibFinished = true;
+	        }
 
 	      if (fibFinished)
 		{
@@ -2067,10 +2313,6 @@ void XmlAdaptiveModel::receiveData(XmlChar *data, size_t size)
 		  inNACK = false;
 
 		  //complete Fibonacci code read and decoded
-		  //reset fibCode, and fibBits
-		  fibCode = 0;
-		  fibBits = 0;
-		  fibLastWasOne = false;
 
 		  RESET_BUFFER;
 		  RESET_STATE;
@@ -2223,29 +2465,47 @@ void XmlAdaptiveModel::receiveData(XmlChar *data, size_t size)
 		  if (elementModelerStack.isEmpty())
 		    {
 		      //first element processed
+		      unsigned long *declaredId = 0;
 
+		      if (declaredElements)
+			declaredId = declaredElements->find(buffer);
 
-		      //save element name
-		      NEW(elName, XmlChar[bufferLength]);
-		      xmlchar_strcpy(elName, buffer);
-		      elementNamesList->append(elName);
-		      
-		      //create an  element contex for the new element
-		      NEW(ec, AdaptiveElementContext);
-		      
-		      //set unique element id
-		      ec->name = elName;
-		      
-		      elementId = elementCounter;
+		      if (declaredId)
+			{
+			  //the root element declared in the DTD
+			  elementId = *declaredId;
+			  ec = elements->find(elementId);
+			  CHECK_POINTER(ec);
+
+			  ec->modeler->increaseRefCount();
+			}
+		      else
+			{
+			  //save element name
+			  NEW(elName, XmlChar[bufferLength]);
+			  xmlchar_strcpy(elName, buffer);
+			  elementNamesList->append(elName);
+
+			  //create an  element contex for the new element
+			  NEW(ec, AdaptiveElementContext);
+
+			  //set unique element id
+			  ec->name = elName;
+
+			  elementId = elementCounter;
+
+			  DBG("NEW ELEMENT HAS THIS ID: " << elementId);
+
+			  //add new element context to the element hashtable
+			  elements->insert(elementCounter, ec);
+
+			  //update the element counter
+			  elementCounter++;
+
+			  NEW(ec->modeler, ElementModeler(elName, graphLimit));
+			  elementModelerList.append(ec->modeler);
+			}
 
-		      DBG("NEW ELEMENT HAS THIS ID: " << elementId);
-		      
-		      //add new element context to the element hashtable
-		      elements->insert(elementCounter, ec);
-		      
-		      //update the element counter
-		      elementCounter++;
-		      
 		      elementStack->push(new unsigned long(elementId));
 		      
 		      //reset buffer
@@ -2254,10 +2514,6 @@ void XmlAdaptiveModel::receiveData(XmlChar *data, size_t size)
 		      RESET_STATE;
 		      
 		      
-		      NEW(ec->modeler, ElementModeler(elName));
-		      elementModelerList.append(ec->modeler);
-
-		      
 		      NEW(emi, ElementModelerInfo);
 		      emi->modeler = ec->modeler;
 		      
@@ -2325,6 +2581,15 @@ void XmlAdaptiveModel::receiveData(XmlChar *data, size_t size)
 				  dataQueueItem = dataQueue->dequeue();
 				  XmlChar *attrName = dataQueueItem->data;
 
+				  //the name we read was the name of a new attribute
+				  XmlChar *newAttrName;
+				  NEW(newAttrName, XmlChar[xmlchar_strlen(attrName)+1]);
+				  xmlchar_strcpy(newAttrName, attrName);
+
+				  attributeNamesList->append(newAttrName);
+				  attributeNames->insert(attributeCounter, newAttrName);
+				  attributeCounter++;
+
 				  //enqueue the name of the element
 				  NEW(dataQueueItem, DataQueueItem);
 				  NEW(dataQueueItem->data, XmlChar[xmlchar_strlen(elementModelerStack.top()->modeler->getElementName())+1]);
@@ -2435,7 +2700,7 @@ void XmlAdaptiveModel::receiveData(XmlChar *data, size_t size)
 			  RESET_STATE;
 		      
 		      
-			  NEW(ec->modeler, ElementModeler(elName));
+			  NEW(ec->modeler, ElementModeler(elName, graphLimit));
 			  elementModelerList.append(ec->modeler);
 		      
 			  NEW(emi, ElementModelerInfo);
@@ -2480,7 +2745,7 @@ void XmlAdaptiveModel::receiveData(XmlChar *data, size_t size)
 			  RESET_STATE;
 		      
 		      
-			  NEW(ec->modeler, ElementModeler(elName));
+			  NEW(ec->modeler, ElementModeler(elName, graphLimit));
 			  elementModelerList.append(ec->modeler);
 		      
 			  NEW(emi, ElementModelerInfo);
@@ -2625,45 +2890,16 @@ void XmlAdaptiveModel::receiveData(XmlChar *data, size_t size)
 
 	      //construct reverse Fibonacci code (e.g. 1100101 instead of 1010011) from sequence of
 	      //following bytes
-	      fibMask = 1 << (SIZEOF_CHAR*8 - 1);
-	      
 	      //decode symbol using Fibonacci code
-	      fibTmpChar = (unsigned char)data[i];
-
-	      while (fibMask)
-		{
-		  fibCode >>= 1;
-		  fibBits++;
-		  
-		  if (fibTmpChar & fibMask)
-		    {
-		      fibCode = fibCode | ((unsigned long)1) << (SIZEOF_UNSIGNED_LONG*8-1);
-		      
-		      if (!fibLastWasOne)
-			fibLastWasOne = true;
-		      else
-			{
-			  //Fibonacci code is now complete
-			  //--> decode the symbol number
-			  fibCode >>= (SIZEOF_UNSIGNED_LONG*8 - fibBits);
-			  elementId = Fibonacci::decode(fibCode);
-			  fibFinished = true;
-			  break;
-			}
-		    }
-		  else
-		    fibLastWasOne = false;
-		  
-		  fibMask >>= 1;
-		}
+	      if (Fibonacci::decodeChar(&fibDecoder, (unsigned char)data[i], &fibNumber))
+	        {
+	          elementId = fibNumber;
+	          fibFinished = true;
+	        }
 
 	      if (fibFinished)
 		{
 		  //complete Fibonacci code read and decoded
-		  //reset fibCode, and fibBits
-		  fibCode = 0;
-		  fibBits = 0;
-		  fibLastWasOne = false;
 
 		  RESET_BUFFER;
 		  RESET_STATE;
@@ -2745,8 +2981,15 @@ void XmlAdaptiveModel::receiveData(XmlChar *data, size_t size)
 				  moved = false;
 
 				  //we have to flip the attribute name and the name of the element (:-)
+				  //(the id we read was the id of the attribute, not of the element)
 				  dataQueueItem = dataQueue->dequeue();
-				  XmlChar *attrName = dataQueueItem->data;
+				  XmlChar *attrName = attributeNames->find(elementId);
+				  CHECK_POINTER(attrName);
+
+				  DELETE_ARRAY(dataQueueItem->data);
+				  NEW(dataQueueItem->data, XmlChar[xmlchar_strlen(attrName)+1]);
+				  xmlchar_strcpy(dataQueueItem->data, attrName);
+				  attrName = dataQueueItem->data;
 
 				  //enqueue the name of the element
 				  NEW(dataQueueItem, DataQueueItem);
@@ -3044,7 +3287,7 @@ void XmlAdaptiveModel::receiveData(XmlChar *data, size_t size)
 	      else
 		valueLength = xmlchar_strlen(value);
 
-	      SAFE_CALL_EMITTER(entityDecl(userData, entityName, data[0] == AdaptiveStructuralSymbols::IsParameterEntityYes,
+	      SAFE_CALL_EMITTER(entityDecl(userData, entityName, data[i] == AdaptiveStructuralSymbols::IsParameterEntityYes,
 					   value, valueLength, 0/*base*/, systemId, publicId, notationName));
 
 	      if (entityName)
@@ -3174,8 +3417,32 @@ void XmlAdaptiveModel::receiveData(XmlChar *data, size_t size)
 	  //characters
 	  if (data[i] == AdaptiveStructuralSymbols::EmptyString)
 	    {
-	      //ignored
+	      //ignored, unless the index of a remembered value follows
+	      if (valueCache && !bufferLength &&
+		  (inAttrValue || (textValuePure && !inComment && !inCDATA && !inPI)))
+		valueRefPending = true;
 	    }
+	  else
+	    if (valueRefPending)
+	      {
+		//the index of a remembered value --> copy the value to the buffer
+		const XmlChar *value;
+		size_t valueLength;
+		unsigned long valueKey;
+
+		valueRefPending = false;
+
+		if (inAttrValue)
+		  valueKey = ATTRIBUTE_VALUE_KEY(dataQueue->last()->data);
+		else
+		  valueKey = TEXT_VALUE_KEY(elementModelerStack.top()->modeler->getElementName());
+
+		if (!(value = valueCache->value(valueKey, (unsigned char)data[i] - XML_VALUE_CACHE_FIRST_INDEX_SYMBOL, &valueLength)))
+		  FATAL("Invalid index of a remembered value: " << (unsigned int)(unsigned char)data[i]);
+
+		memcpy(buffer + bufferLength, value, valueLength * sizeof(XmlChar));
+		bufferLength += valueLength;
+	      }
 	  else
 	    if (inAttrValue)
 	      {
@@ -3199,6 +3466,9 @@ void XmlAdaptiveModel::receiveData(XmlChar *data, size_t size)
 		    bufferLength++;
 		    DBG("value of the attribute: " << buffer);
 
+		    if (valueCache)
+		      valueCache->update(ATTRIBUTE_VALUE_KEY(dataQueue->last()->data), buffer, bufferLength - 1);
+
 		    
 
 		    NEW(dataQueueItem, DataQueueItem);
@@ -3334,6 +3604,9 @@ void XmlAdaptiveModel::receiveData(XmlChar *data, size_t size)
 			      buffer[bufferLength] = 0;
 			      SAFE_CALL_EMITTER(characterData(userData, buffer, bufferLength));
 			    }
+
+			  if (valueCache && textValuePure)
+			    valueCache->update(TEXT_VALUE_KEY(elementModelerStack.top()->modeler->getElementName()), buffer, bufferLength);
 			  
 			  
 			  RESET_STATE;
@@ -3350,6 +3623,7 @@ void XmlAdaptiveModel::receiveData(XmlChar *data, size_t size)
 		    case AdaptiveStructuralSymbols::Comment:
 		      DBG("COMMENT");
 		      inComment = true;
+		      textValuePure = false;
 
 		      //if there are any character data in the buffer, send them and reset the buffer
 		      if (bufferLength)
@@ -3362,6 +3636,7 @@ void XmlAdaptiveModel::receiveData(XmlChar *data, size_t size)
 		    case AdaptiveStructuralSymbols::PI:
 		      DBG("PROCESSING INSTRUCTION");
 		      inPI = 2;
+		      textValuePure = false;
 
 		      //if there are any character data in the buffer, send them and reset the buffer
 		      if (bufferLength)
@@ -3374,6 +3649,7 @@ void XmlAdaptiveModel::receiveData(XmlChar *data, size_t size)
 		    case AdaptiveStructuralSymbols::CDATA:
 		      DBG("CDATA");
 		      inCDATA = true;
+		      textValuePure = false;
 
 		      //if there are any character data in the buffer, send them and reset the buffer
 		      if (bufferLength)
@@ -3399,6 +3675,7 @@ void XmlAdaptiveModel::receiveData(XmlChar *data, size_t size)
 
 			  SAFE_CALL_EMITTER(characterData(userData, buffer, bufferLength));
 			  RESET_BUFFER;
+			  textValuePure = false;
 			}
 		    }
 		}
@@ -184,6 +184,27 @@ public:
   */
   virtual void setGrammar(GrammarBase *gr) { grammar = gr; }
 
+  /*!
+    \brief Set the cache of the recently used values.
+
+    The attribute values and the character data of the elements which are in the cache of their path are replaced by the AdaptiveStructuralSymbols::EmptyString symbol followed by their index.
+
+    \param cache The cache (NULL means that all values are coded as text).
+  */
+  virtual void setValueCache(XmlValueCache *cache) { valueCache = cache; }
+
+  //! Set the DTD of the documents.
+  virtual void setDtd(XmlDtd *dtd);
+
+  /*!
+    \brief Set the maximal size of the graphs of the elements.
+
+    The graphs which grow beyond the limit are pruned (see ElementModeler::prune()). The limit has to be set before the DTD.
+
+    \param limit The maximal number of nodes plus transitions of each graph (0 means no limit).
+  */
+  virtual void setGraphLimit(size_t limit) { graphLimit = limit; }
+
   //! Set SAX emitter for decoding.
   virtual void setSAXEmitter(SAXEmitter *emitter, void *data = 0);
 
@@ -196,6 +217,41 @@ protected:
   //! The pointer to the grammar used for compression.
   GrammarBase *grammar;
 
+  //! The cache of the recently used values (may be NULL).
+  XmlValueCache *valueCache;
+
+  //! The maximal size of the graphs of the elements (0 if not limited).
+  size_t graphLimit;
+
+  /*!
+    \brief The character data of the current section.
+
+    Used during encoding. The data are kept until the end of the section, so the whole section can be coded by its index in the cache.
+  */
+  XmlChar textValue[XML_VALUE_CACHE_MAX_LENGTH];
+
+  //! The length of the character data of the current section.
+  size_t textValueLength;
+
+  //! Indication whether the current section contains only character data (no comments, PIs or CDATA sections) that fit in the cache.
+  bool textValuePure;
+
+  /*!
+    \brief Indication whether the index of a remembered value follows.
+
+    Used during decoding.
+  */
+  bool valueRefPending;
+
+  //! Append the character data to the current section.
+  virtual void appendTextValue(const XmlChar *data, size_t length, bool convertAmp);
+
+  //! Append the kept character data of the section as text.
+  virtual void flushTextValue(void);
+
+  //! Append the kept character data of the section at its end.
+  virtual void finishTextValue(void);
+
 
   //! Indication of CDATA section.
   bool inCDATA;
@@ -248,8 +304,8 @@ protected:
   */
   AdaptiveStructuralSymbols::Symbol state;
 
-  //! Hashtable of element ids.
-  ElementIds *elementIds;
+  //! Mapping of the interned name ids to element ids.
+  XmlNameIdMap *elementIds;
 
   //! Hashtable of element contexts.
   AdaptiveElementTable *elements;
@@ -263,10 +319,13 @@ protected:
   //! Counter for unique element numbering.
   unsigned long elementCounter;
 
+  //! Hashtable of the ids of the elements declared in the DTD (the keys are the names of the elements).
+  XmlNameIds *declaredElements;
 
 
-  //! Hashtable of attribute ids.
-  AttributeIds *attributeIds;
+
+  //! Mapping of the interned name ids to attribute ids.
+  XmlNameIdMap *attributeIds;
 
   //! %List of attribute names.
   AttributeNamesList *attributeNamesList;
@@ -309,22 +368,12 @@ protected:
 
   //some variables for working with Fibonacci codes
 
-  /*! 
-    \brief Number of read bits of Fibonacci code.
-    
-    Used during decoding.
-  */
-  size_t fibBits;
-
   /*!
-    \brief Read Fibonacci code.
+    rief State of the Fibonacci decoder.
     
     Used during decoding.
   */
-  unsigned long fibCode;
-
-  //! Helper variable for decoding the Fibonacci codes.
-  bool fibLastWasOne;
+  FibonacciDecoderState fibDecoder;
 
   //! A queue of decoded data items (such as attribute names and values, etc.)
   DataQueue *dataQueue;
@@ -61,15 +61,52 @@
 XmlCodec::XmlCodec(void)
   : XmlCodecBase()
 {
+  pushBuffer = 0;
+  pushFunnelDevice = 0;
+  pushSAXEmitter = 0;
+  pushReceptor = 0;
+  pushUserData = 0;
+  pushDecoderState = PushDecoderFinished;
+  pushModelByte = 0;
+  pushContainerSectionLength = 0;
+
+  ruleContexts = 0;
+  ruleTable = 0;
+  explicitRules = false;
+
+  rePairGrammar = 0;
+  grammar = 0;
+  ruleBodyContext = 0;
+  rePair = false;
+
+  useContainers = false;
+  graphLimit = 0;
+  containers = 0;
+  typedValues = 0;
+  valueCache = 0;
+  wordTokens = 0;
+  structureDevice = 0;
 }
 
 
 
 /*!
-  Deletes the default text codec (if any).
+  Deletes the default text codec (if any) and the objects of unfinished PUSH decoder.
  */
 XmlCodec::~XmlCodec(void)
 {
+  if (pushBuffer)
+    deletePushDecoder();
+
+  if (typedValues)
+    DELETE(typedValues);
+
+  if (valueCache)
+    DELETE(valueCache);
+
+  if (wordTokens)
+    DELETE(wordTokens);
+
   deleteDefaultTextCodec();
 }
 
@@ -94,18 +131,52 @@ void XmlCodec::initializePushCoder(IODevice *outDevice)
 	throw ExaltCoderIsPushException();
     }
 
+  int modelFlags = dictionary ? XML_CODEC_DICTIONARY_FLAG : 0;
+  ExaltOptions::OptionValue model = ExaltOptions::getOption(ExaltOptions::Model);
+
   inputDevice = 0;
   outputDevice = outDevice;
 
-  //Create a KY grammar
-  NEW(kyGrammar, KYGrammar);
+  if (model == ExaltOptions::AutoModel)
+    //the data are not known in advance --> use the default model
+    model = ExaltOptions::AdaptiveModel;
+
+  if (ExaltOptions::getOption(ExaltOptions::TypedValues) == ExaltOptions::Yes &&
+      model == ExaltOptions::SimpleModel)
+    {
+      //the numbers and the dates are coded in the binary form
+      modelFlags |= XML_CODEC_TYPED_VALUES_FLAG;
+      NEW(typedValues, XmlTypedValues);
+    }
+
+  if (ExaltOptions::getOption(ExaltOptions::ValueCache) == ExaltOptions::Yes &&
+      model == ExaltOptions::AdaptiveModel)
+    {
+      //the repeated values are coded by their indices
+      modelFlags |= XML_CODEC_VALUE_CACHE_FLAG;
+      NEW(valueCache, XmlValueCache);
+    }
+
+  graphLimit = 0;
+
+  if (ExaltOptions::getOption(ExaltOptions::GraphLimit) > 0 &&
+      model == ExaltOptions::AdaptiveModel)
+    {
+      //the graphs of the elements are pruned
+      modelFlags |= XML_CODEC_GRAPH_LIMIT_FLAG;
+      graphLimit = ExaltOptions::getOption(ExaltOptions::GraphLimit);
+    }
+
+  if (ExaltOptions::getOption(ExaltOptions::WordTokens) == ExaltOptions::Yes &&
+      model == ExaltOptions::SimpleModel)
+    {
+      //the repeated words are coded by their ids
+      modelFlags |= XML_CODEC_WORD_TOKENS_FLAG;
+      NEW(wordTokens, XmlWordTokens);
+    }
 
   //Create a coding context for the grammar
   NEW(context, Context);
-  kyGrammar->setContext(context);
-
-  kyGrammar->setOutputDevice(outputDevice);
-  kyGrammar->setTextCodec(textCodec);
 
   //Create arithmetic coder/decoder...
   NEW(arithCodec, ArithCodec);
@@ -113,20 +184,26 @@ void XmlCodec::initializePushCoder(IODevice *outDevice)
   //...and bind it with the contexts
   context->setArithCodec(arithCodec);
 
+  //Create the grammar
+  createEncoderGrammar(&modelFlags);
+
   //Create a XML parser with specified input device
   NEW(xmlParser, XmlParser);
   //xmlParser->setInputDevice(inputDevice);
 
+  //write the version string (excluding terminating \0)
+  outputDevice->writeData(FILE_STAMP, strlen(FILE_STAMP));
+
   //Create a XML model...
-  if (ExaltOptions::getOption(ExaltOptions::Model) == ExaltOptions::SimpleModel)
+  if (model == ExaltOptions::SimpleModel)
     {
       NEW(xmlModel, XmlSimpleModel);
-      outputDevice->putChar(0);		//to indicate the use of the simple model
+      outputDevice->putChar(0 | modelFlags);		//to indicate the use of the simple model
     }
   else
     {
       NEW(xmlModel, XmlAdaptiveModel);
-      outputDevice->putChar(1);		//to indicate the use of the adaptive model
+      outputDevice->putChar(1 | modelFlags);		//to indicate the use of the adaptive model
     }
 
 
@@ -134,16 +211,51 @@ void XmlCodec::initializePushCoder(IODevice *outDevice)
   xmlParser->setXmlModel(xmlModel);
 
   //...plus the grammar
-  xmlModel->setGrammar(kyGrammar);
+  xmlModel->setGrammar(grammar);
 
+  //...and the coder of the typed values
+  xmlModel->setTypedValues(typedValues);
 
+  //...and the value cache
+  xmlModel->setValueCache(valueCache);
 
-  //write the version string (excluding terminating \0)
-  outputDevice->writeData(FILE_STAMP, strlen(FILE_STAMP));
+  //...and the dictionary of the words
+  xmlModel->setWordTokens(wordTokens);
+
+  //...and the limit of the graphs
+  xmlModel->setGraphLimit(graphLimit);
+
+  //...and the DTD
+  xmlModel->setDtd(dictionary ? dictionary->dtd() : 0);
+
+
+  if (dictionary)
+    {
+      //store the hash of the dictionary
+      unsigned long dictionaryHash = dictionary->hash();
+
+      for (int i = 3; i >= 0; i--)
+	outputDevice->putChar((dictionaryHash >> (8 * i)) & 0xff);
+    }
+
+  if (graphLimit)
+    {
+      //store the limit of the graphs
+      for (int i = 3; i >= 0; i--)
+	outputDevice->putChar((graphLimit >> (8 * i)) & 0xff);
+    }
   
   //store F_BITS and B_BITS being used in output
   outputDevice->putChar(F_BITS);
   outputDevice->putChar(B_BITS);
+
+  if (dictionary)
+    {
+      primeWithDictionary();
+
+      //the alphabet size is stored only if the dictionary didn't initialize the context
+      kyGrammar->setOutputDevice(context->isInitialized() ? 0 : outputDevice);
+    }
   
   //prepare arithCodec for encoding
   arithCodec->setOutputDevice(outputDevice);
@@ -179,7 +291,16 @@ bool XmlCodec::encodePush(const char *data, int length, bool isFinal = false)
       DELETE(xmlParser);
       DELETE(xmlModel);
 
-      DELETE(kyGrammar);
+      if (typedValues)
+	DELETE(typedValues);
+
+      if (valueCache)
+	DELETE(valueCache);
+
+      if (wordTokens)
+	DELETE(wordTokens);
+
+      deleteEncoderGrammar();
 
 
       if (!parseResult)
@@ -206,7 +327,8 @@ bool XmlCodec::encodePush(const char *data, int length, bool isFinal = false)
       DELETE(arithCodec);
       DELETE(context);
 
-      DELETE(xmlModel);
+      if (ruleContexts)
+	deleteRuleContexts();
     }
 
   return parseResult;
@@ -214,6 +336,51 @@ bool XmlCodec::encodePush(const char *data, int length, bool isFinal = false)
 
 
 
+/*!
+  The grammar encodes all symbols waiting in its input queue, the end-of-message symbol marks the flush point and the arithmetic code is terminated and padded to whole bytes. The decoder is able to decode all symbols up to the flush point from the data written so far. Then a new arithmetic code is started; the model, the grammar and the context keep their state, so the cost of the flush point is only a few bytes.
+
+  If nothing has been encoded yet, only the output device is flushed.
+ */
+void XmlCodec::sync(void)
+{
+  if (coderType == PullCoder)
+    //PULL coder used in PUSH mode
+    throw ExaltCoderIsPullException();
+  else
+    if (coderType == UnknownCoder)
+      //Unitialized coder used in PUSH mode
+      throw ExaltPushCoderNotInitializedException();
+
+  //the context is initialized before the first symbol is encoded
+  if (context->isInitialized())
+    {
+      //encode all pending symbols
+      grammar->flush();
+
+      //mark the flush point
+      context->encodeEndOfMessage();
+
+      //terminate the arithmetic code
+      arithCodec->finishEncode();
+      arithCodec->doneOutputtingBits();
+
+      //the decoder reads B_BITS beyond the end of the code
+      for (int i = 0; i < B_BITS / 8; i++)
+	outputDevice->putChar(0);
+
+      //the data continue
+      outputDevice->putChar(XML_CODEC_SYNC_MARK);
+
+      //start a new arithmetic code
+      arithCodec->startOutputtingBits();
+      arithCodec->startEncode();
+    }
+
+  outputDevice->flush();
+}
+
+
+
 /*!
   The codec creates all of the necessary underlying components and encodes the data.
 
@@ -222,20 +389,72 @@ bool XmlCodec::encodePush(const char *data, int length, bool isFinal = false)
 */
 bool XmlCodec::encode(IODevice *inDevice, IODevice *outDevice)
 {
+  int modelFlags = dictionary ? XML_CODEC_DICTIONARY_FLAG : 0;
+  ExaltOptions::OptionValue model = ExaltOptions::getOption(ExaltOptions::Model);
+  char *sample = 0;
+  IOSize sampleLength = 0;
+
   inputDevice = inDevice;
   outputDevice = outDevice;
 
-  //Create a KY grammar
-  NEW(kyGrammar, KYGrammar);
+  if (model == ExaltOptions::AutoModel)
+    {
+      //try both models on the start of the data
+      sample = readSample(&sampleLength);
+      model = selectModel(sample, sampleLength);
+    }
 
-  //Create a coding context for the grammar
-  NEW(context, Context);
+  if (ExaltOptions::getOption(ExaltOptions::Containers) == ExaltOptions::Yes &&
+      model == ExaltOptions::SimpleModel)
+    {
+      //the character data are routed to the containers
+      modelFlags |= XML_CODEC_CONTAINERS_FLAG;
 
-  kyGrammar->setOutputDevice(outputDevice);
+      NEW(containers, XmlContainerSet);
+      containers->setTextCodec(textCodec);
 
-  kyGrammar->setTextCodec(textCodec);
+      //the containers precede the structure, so the structure is kept in memory
+      NEW(structureDevice, BufferDevice);
+      structureDevice->prepare();
+      outputDevice = structureDevice;
+    }
 
-  kyGrammar->setContext(context);
+  if (ExaltOptions::getOption(ExaltOptions::TypedValues) == ExaltOptions::Yes &&
+      model == ExaltOptions::SimpleModel)
+    {
+      //the numbers and the dates are coded in the binary form
+      modelFlags |= XML_CODEC_TYPED_VALUES_FLAG;
+      NEW(typedValues, XmlTypedValues);
+    }
+
+  if (ExaltOptions::getOption(ExaltOptions::ValueCache) == ExaltOptions::Yes &&
+      model == ExaltOptions::AdaptiveModel)
+    {
+      //the repeated values are coded by their indices
+      modelFlags |= XML_CODEC_VALUE_CACHE_FLAG;
+      NEW(valueCache, XmlValueCache);
+    }
+
+  graphLimit = 0;
+
+  if (ExaltOptions::getOption(ExaltOptions::GraphLimit) > 0 &&
+      model == ExaltOptions::AdaptiveModel)
+    {
+      //the graphs of the elements are pruned
+      modelFlags |= XML_CODEC_GRAPH_LIMIT_FLAG;
+      graphLimit = ExaltOptions::getOption(ExaltOptions::GraphLimit);
+    }
+
+  if (ExaltOptions::getOption(ExaltOptions::WordTokens) == ExaltOptions::Yes &&
+      model == ExaltOptions::SimpleModel)
+    {
+      //the repeated words are coded by their ids
+      modelFlags |= XML_CODEC_WORD_TOKENS_FLAG;
+      NEW(wordTokens, XmlWordTokens);
+    }
+
+  //Create a coding context for the grammar
+  NEW(context, Context);
 
   //Create arithmetic coder/decoder...
   NEW(arithCodec, ArithCodec);
@@ -243,31 +462,68 @@ bool XmlCodec::encode(IODevice *inDevice, IODevice *outDevice)
   //...and bind it with the contexts
   context->setArithCodec(arithCodec);
 
+  //Create the grammar
+  createEncoderGrammar(&modelFlags);
+
   //Create a XML parser with specified input device
   NEW(xmlParser, XmlParser);
   xmlParser->setInputDevice(inputDevice);
 
 
   //write the version string (excluding terminating \0)
-  outputDevice->writeData(FILE_STAMP, strlen(FILE_STAMP));
+  outDevice->writeData(FILE_STAMP, strlen(FILE_STAMP));
 
   //Create a XML model...
-  if (ExaltOptions::getOption(ExaltOptions::Model) == ExaltOptions::SimpleModel)
+  if (model == ExaltOptions::SimpleModel)
     {
       NEW(xmlModel, XmlSimpleModel);
-      outputDevice->putChar(0);		//to indicate the use of the simple model
+      outDevice->putChar(0 | modelFlags);		//to indicate the use of the simple model
     }
   else
     {
       NEW(xmlModel, XmlAdaptiveModel);
-      outputDevice->putChar(1);		//to indicate the use of the simple model
+      outDevice->putChar(1 | modelFlags);		//to indicate the use of the adaptive model
+    }
+
+  if (dictionary)
+    {
+      //store the hash of the dictionary
+      unsigned long dictionaryHash = dictionary->hash();
+
+      for (int i = 3; i >= 0; i--)
+	outDevice->putChar((dictionaryHash >> (8 * i)) & 0xff);
+    }
+
+  if (graphLimit)
+    {
+      //store the limit of the graphs
+      for (int i = 3; i >= 0; i--)
+	outDevice->putChar((graphLimit >> (8 * i)) & 0xff);
     }
 
   //...and bind it with the parser...
   xmlParser->setXmlModel(xmlModel);
 
   //...plus the grammar
-  xmlModel->setGrammar(kyGrammar);
+  xmlModel->setGrammar(grammar);
+
+  //...and the containers
+  xmlModel->setContainers(containers);
+
+  //...and the coder of the typed values
+  xmlModel->setTypedValues(typedValues);
+
+  //...and the value cache
+  xmlModel->setValueCache(valueCache);
+
+  //...and the dictionary of the words
+  xmlModel->setWordTokens(wordTokens);
+
+  //...and the limit of the graphs
+  xmlModel->setGraphLimit(graphLimit);
+
+  //...and the DTD
+  xmlModel->setDtd(dictionary ? dictionary->dtd() : 0);
 
 
 
@@ -275,6 +531,14 @@ bool XmlCodec::encode(IODevice *inDevice, IODevice *outDevice)
   //store F_BITS and B_BITS being used in output
   outputDevice->putChar(F_BITS);
   outputDevice->putChar(B_BITS);
+
+  if (dictionary)
+    {
+      primeWithDictionary();
+
+      //the alphabet size is stored only if the dictionary didn't initialize the context
+      kyGrammar->setOutputDevice(context->isInitialized() ? 0 : outputDevice);
+    }
   
   //prepare arithCodec for encoding
   arithCodec->setOutputDevice(outputDevice);
@@ -283,16 +547,32 @@ bool XmlCodec::encode(IODevice *inDevice, IODevice *outDevice)
 
   coderType = PullCoder;
 
+  if (sample)
+    {
+      //the sample has already been read from the input device
+      xmlParser->parsePush(sample, sampleLength, false);
+      DELETE_ARRAY(sample);
+    }
+
   //parse the data
   long parseResult = xmlParser->parse();
 
  
-  DELETE(kyGrammar);
+  deleteEncoderGrammar();
 
   //Delete all objects
   DELETE(xmlParser);
   DELETE(xmlModel);
 
+  if (typedValues)
+    DELETE(typedValues);
+
+  if (valueCache)
+    DELETE(valueCache);
+
+  if (wordTokens)
+    DELETE(wordTokens);
+
   if (!parseResult)
     {
       //something was wrong --> cleanup needed
@@ -306,6 +586,27 @@ bool XmlCodec::encode(IODevice *inDevice, IODevice *outDevice)
       //stop arithCodec
       arithCodec->finishEncode();
       arithCodec->doneOutputtingBits();
+
+      if (containers)
+	{
+	  //write the containers followed by the structure
+	  containers->write(outDevice);
+
+	  IOSize length = structureDevice->bytesAvailable();
+	  char *buf;
+
+	  NEW(buf, char[length + 1]);
+	  structureDevice->readData(buf, length);
+	  outDevice->writeData(buf, length);
+	  DELETE_ARRAY(buf);
+	}
+    }
+
+  if (containers)
+    {
+      DELETE(containers);
+      DELETE(structureDevice);
+      outputDevice = outDevice;
     }
 
 
@@ -317,6 +618,9 @@ bool XmlCodec::encode(IODevice *inDevice, IODevice *outDevice)
   DELETE(arithCodec);
   DELETE(context);
 
+  if (ruleContexts)
+    deleteRuleContexts();
+
 
   //return the result of the parsing
   return parseResult;
@@ -335,19 +639,11 @@ bool XmlCodec::encode(IODevice *inDevice, IODevice *outDevice)
 bool XmlCodec::decode(IODevice *inDevice, SAXReceptor *receptor, void *userData = 0)
 {
   FunnelDevice *funnelDevice;
-  char *fileStamp;
-  size_t fileStampLength = strlen(FILE_STAMP);
   int symbol;
-  int byte1, byte2;
+  int modelByte;
   long lastFixedContextSymbol;
-  RuleElement *rel;
-  unsigned char tmpChar, mask;
-  unsigned long fibCode = 0;
-  bool lastWasOne = false;
-  bool finished = false;
-  char bits = 0;
-  unsigned long alphabetBaseSize;
   SAXEmitter *saxEmitter;
+  bool decodingRules;
 
 
   inputDevice = inDevice;
@@ -368,29 +664,30 @@ bool XmlCodec::decode(IODevice *inDevice, SAXReceptor *receptor, void *userData
   context->setArithCodec(arithCodec);
 
 
-
-  NEW(fileStamp, char[fileStampLength + 1]);
-
-  inputDevice->readData(fileStamp, fileStampLength);
-  if (inputDevice->errorOccurred() || inputDevice->eof())
+  if (!readHeader(&modelByte))
     return false;
 
-  fileStamp[fileStampLength] = '\0';
-
-  if (strcmp(FILE_STAMP, fileStamp))
+  if (modelByte & XML_CODEC_ARCHIVE_FLAG)
     {
-      DELETE(fileStamp);
-      ERR("File format not recognized!");
+      ERR("The data are a solid archive!");
       throw ExaltUnknownFileFormatException();
     }
-  else
+
+  if (useContainers)
     {
-      DELETE(fileStamp);
+      size_t sectionLength;
+
+      //the length of the container section is needed only by the PUSH decoder
+      if (!XmlContainerSet::readSectionLength(inputDevice, &sectionLength) || !readContainers())
+	return false;
     }
 
+  if (explicitRules || rePair)
+    //the rules are maintained by the rule table
+    createRuleTable();
+
   //whether to use the simple, or the adaptive model
-  inputDevice->getChar(&byte1);
-  if (!byte1)
+  if (!modelByte)
     {
       //Create a xmlSimpleModel
       NEW(xmlModel, XmlSimpleModel);
@@ -401,157 +698,105 @@ bool XmlCodec::decode(IODevice *inDevice, SAXReceptor *receptor, void *userData
       NEW(xmlModel, XmlAdaptiveModel);
     }
 
-  NEW(saxEmitter, SAXEmitter(receptor));
+  saxEmitter = createSAXEmitter(receptor);
   xmlModel->setSAXEmitter(saxEmitter, userData);
-
-  NEW(funnelDevice, FunnelDevice(xmlModel, 4096, true));
+  xmlModel->setContainers(containers);
+  xmlModel->setTypedValues(typedValues);
+  xmlModel->setValueCache(valueCache);
+  xmlModel->setWordTokens(wordTokens);
+  xmlModel->setGraphLimit(graphLimit);
+  xmlModel->setDtd(dictionary ? dictionary->dtd() : 0);
+
+  NEW(funnelDevice, FunnelDevice(xmlModel, false, XML_CODEC_DECODE_BUFFER_SIZE));
   funnelDevice->prepare();
-  kyGrammar->setOutputDevice(funnelDevice);
   kyGrammar->setTextCodec(textCodec);
 
-    
-  inputDevice->getChar(&byte1);
-  if (inputDevice->errorOccurred() || inputDevice->eof())
-    return false;
-
-  inputDevice->getChar(&byte2);
-  if (inputDevice->errorOccurred() || inputDevice->eof())
+  if (!startDecoding(&lastFixedContextSymbol))
     return false;
 
-  if (byte1 != F_BITS || byte2 != B_BITS)
-    FATAL("Compressed file F_BITS = " << byte1 << ", B_BITS = " << byte2 << ")! Compressor was compiled with F_BITS = " << F_BITS << ", B_BITS = " << B_BITS << ".");
+  kyGrammar->setOutputDevice(funnelDevice);
 
-  //construct reverse Fibonacci code (e.g. 1100101 instead of 1010011) from sequence of
-  //following bytes. This code represents the base size of the terminal alphabet.
-  while (!finished)
-    {
-      mask = 1 << (SIZEOF_CHAR*8 - 1);
-      
-      int c;
+  if (ruleTable)
+    ruleTable->setOutputDevice(funnelDevice);
 
-      inputDevice->getChar(&c);
-      if (inputDevice->errorOccurred() || inputDevice->eof())
-	return false;
+  //in the Re-Pair format, the rules of the block come first
+  decodingRules = rePair;
 
-      tmpChar = (unsigned char)c;
-      
-      while (mask)
+  for (;;)
+    {
+      if (decodingRules)
 	{
-	  fibCode >>= 1;
-	  bits++;
-	  
-	  if (tmpChar & mask)
-	    {
-	      fibCode = fibCode | ((unsigned long)1) << (SIZEOF_UNSIGNED_LONG*8-1);
-	      
-	      if (!lastWasOne)
-		lastWasOne = true;
-	      else
-		{
-		  //Fibonacci code is now complete
-		  //--> decode the symbol number
-		  fibCode >>= (SIZEOF_UNSIGNED_LONG*8 - bits);
-		  alphabetBaseSize = Fibonacci::decode(fibCode);
-		  finished = true;
-		  break;
-		}
-	    }
-	  else
-	    lastWasOne = false;
-	  
-	  mask >>= 1;
+	  //decode next symbol of the rules
+	  decodingRules = ruleTable->decodeRuleBody();
+	  continue;
 	}
-    }
-	  
-  //reset Fibonacci state variables
-  fibCode = 0;
-  bits = 0;
-  finished = false;
-  lastWasOne = false;
-
-
-
-
-  context->setType(alphabetBaseSize, DynamicContext);
 
-  //get the last fixed symbol of the context table (EOM)
-  lastFixedContextSymbol = context->initialize();
-
-  //prepare arithCodec for decoding
-  arithCodec->setInputDevice(inputDevice);
-  arithCodec->startInputtingBits();
-  arithCodec->startDecode();
-
-  for (;;)
-    {
       //decode next symbol
       symbol = context->decode();
 
 
-      //in case of the EOM, break
       if (symbol == context->endOfMessage)
-	break;
-      
-      //New variable --> decode it from Fibonacci code
-      //that follows...
-
-      if (symbol == Context::NotKnown)
-	{
-	  FATAL("Unknown symbol decoded!!!");
-	}
-
-      if (symbol > lastFixedContextSymbol)
 	{
-	  //decoded a variable
-  	  //--> append it to the grammar
-
-	  Rule *rule;
+	  //deliver the data decoded so far to the model
+	  funnelDevice->flush();
+	  saxEmitter->flush();
 
-  	  NEW(rel, RuleElement);
-  	  rel->type = Variable;
+	  //finish decoding of the arithmetic code
+	  arithCodec->finishDecode();
+	  arithCodec->doneInputtingBits();
 
-	  //find rule with corresponding id
-	  rule = kyGrammar->findRule(symbol - lastFixedContextSymbol);
+	  //in case of the end of the data, break
+	  if (!readSyncMark())
+	    break;
 
-	  CHECK_POINTER(rule);
+	  //the data continue after a flush point
+	  arithCodec->startInputtingBits();
+	  arithCodec->startDecode();
 
-	  rel->rule = rule;
-
-	  //increase rule ref count
-	  rel->rule->refCount++;
+	  if (rePair)
+	    {
+	      //a new block of the Re-Pair grammar starts
+	      ruleTable->purge();
+	      decodingRules = true;
+	    }
+	  continue;
 	}
-      else
-	{
-	  //decoded a terminal
-	  //--> append it to the grammar
-	  NEW(rel, RuleElement);
 
-	  rel->type = Terminal;
-	  rel->value = symbol;
-	}
+      appendDecodedSymbol(symbol, lastFixedContextSymbol);
 
-      kyGrammar->appendToRootRule(rel);
+      if (explicitRules)
+	ruleTable->decodeRuleEvent();
     }
 
 
   //Delete all objects
   DELETE(kyGrammar);
 
-
-  //finish decoding
-  arithCodec->finishDecode();
-  arithCodec->doneInputtingBits();
-
   if (ExaltOptions::getOption(ExaltOptions::Verbose) == ExaltOptions::Yes)
     {
       DISPLAY_DECOMPRESSION_SUMMARY;
     }
 
+  if (ruleTable)
+    deleteRuleTable();
+
   DELETE(arithCodec);
   DELETE(context);
   DELETE(xmlModel);
   DELETE(funnelDevice);
 
+  if (containers)
+    DELETE(containers);
+
+  if (typedValues)
+    DELETE(typedValues);
+
+  if (valueCache)
+    DELETE(valueCache);
+
+  if (wordTokens)
+    DELETE(wordTokens);
+
 
   DELETE(saxEmitter);
 
@@ -559,3 +804,1446 @@ bool XmlCodec::decode(IODevice *inDevice, SAXReceptor *receptor, void *userData
 }
 
 
+
+/*!
+  Initializes the codec in PUSH decoding mode. The compressed data are then passed to the decoder by decodePush().
+
+  \param receptor The SAX event receptor.
+  \param userData The user data structure.
+ */
+void XmlCodec::initializePushDecoder(SAXReceptor *receptor, void *userData = 0)
+{
+  if (coderType == UnknownCoder)
+    //coder is now PUSH decoder
+    coderType = PushDecoder;
+  else
+    {
+      if (coderType == PullCoder)
+	//PULL coder used in PUSH mode
+	throw ExaltCoderIsPullException();
+      else
+	//An attempt to re-initialize a PUSH coder
+	throw ExaltCoderIsPushException();
+    }
+
+  pushReceptor = receptor;
+  pushUserData = userData;
+
+  //the compressed data are collected in the buffer...
+  NEW(pushBuffer, BufferDevice);
+  inputDevice = pushBuffer;
+
+  //...and decoded by the usual components
+  NEW(kyGrammar, KYGrammar);
+  NEW(context, Context);
+  kyGrammar->setContext(context, false);
+  kyGrammar->setTextCodec(textCodec);
+
+  NEW(arithCodec, ArithCodec);
+  context->setArithCodec(arithCodec);
+
+  xmlModel = 0;
+
+  pushContainerSectionLength = 0;
+  pushDecoderState = PushDecoderHeader;
+}
+
+
+
+/*!
+  The chunk of compressed data is appended to the buffer of the decoder, and the decoder decodes as many symbols as possible. The arithmetic decoder reads the code bits only when they are needed (see ArithCodec::inputBytesNeeded()), so a symbol is decoded only if all bits it needs have already arrived; otherwise the decoder waits for the next chunk. The decoded data are delivered to the model whenever the decoder runs out of the compressed data (and at each flush point, see sync()), so the model emits the SAX events for all data decoded so far.
+
+  After the last chunk (\a isFinal set) all remaining data are decoded and the decoder is deleted. The data following the end of the compressed data are ignored.
+
+  \param data The chunk of compressed data.
+  \param length The length of the data.
+  \param isFinal Indication whether the decoder received the last chunk of data.
+
+  \return False if the data end prematurely, true otherwise.
+*/
+bool XmlCodec::decodePush(const char *data, int length, bool isFinal = false)
+{
+  int symbol;
+  bool waiting = false;
+
+  if (coderType == UnknownCoder)
+    //Unitialized coder used in PUSH mode
+    throw ExaltPushCoderNotInitializedException();
+  else
+    if (coderType == PullCoder)
+      //PULL coder used in PUSH mode
+      throw ExaltCoderIsPullException();
+    else
+      if (coderType == PushCoder)
+	//PUSH coder used for decoding
+	throw ExaltCoderIsPushException();
+
+  if (pushDecoderState == PushDecoderFinished)
+    return true;
+
+  pushBuffer->writeData(data, length);
+
+  while (!waiting)
+    switch (pushDecoderState)
+      {
+      case PushDecoderHeader:
+	//the header is read at once
+	if (!isFinal && pushBuffer->bytesAvailable() < XML_CODEC_PUSH_HEADER_SIZE)
+	  {
+	    waiting = true;
+	    break;
+	  }
+
+	if (!readHeader(&pushModelByte))
+	  {
+	    deletePushDecoder();
+	    return false;
+	  }
+
+	if (pushModelByte & XML_CODEC_ARCHIVE_FLAG)
+	  {
+	    ERR("The data are a solid archive!");
+	    throw ExaltUnknownFileFormatException();
+	  }
+
+	//the containers (if any) precede the structure
+	pushDecoderState = useContainers ? PushDecoderContainers : PushDecoderStart;
+	break;
+
+      case PushDecoderContainers:
+	//the containers are decoded at once, so the decoder waits for the whole section
+	if (!pushContainerSectionLength)
+	  {
+	    if (!isFinal && pushBuffer->bytesAvailable() < XML_CONTAINER_SET_NUMBER_SIZE)
+	      {
+		waiting = true;
+		break;
+	      }
+
+	    if (!XmlContainerSet::readSectionLength(pushBuffer, &pushContainerSectionLength))
+	      {
+		deletePushDecoder();
+		return false;
+	      }
+	  }
+
+	//the start of the structure is read together with the containers (see PushDecoderStart)
+	if (!isFinal && pushBuffer->bytesAvailable() < pushContainerSectionLength + XML_CODEC_PUSH_HEADER_SIZE)
+	  {
+	    waiting = true;
+	    break;
+	  }
+
+	if (!readContainers())
+	  {
+	    deletePushDecoder();
+	    return false;
+	  }
+
+	pushDecoderState = PushDecoderStart;
+	break;
+
+      case PushDecoderStart:
+	//the start of the structure is available, since the decoder waited for the longest possible header
+	if (explicitRules || rePair)
+	  //the rules are maintained by the rule table
+	  createRuleTable();
+
+	//whether to use the simple, or the adaptive model
+	if (!pushModelByte)
+	  {
+	    NEW(xmlModel, XmlSimpleModel);
+	  }
+	else
+	  {
+	    NEW(xmlModel, XmlAdaptiveModel);
+	  }
+
+	pushSAXEmitter = createSAXEmitter(pushReceptor);
+	xmlModel->setSAXEmitter(pushSAXEmitter, pushUserData);
+	xmlModel->setContainers(containers);
+	xmlModel->setTypedValues(typedValues);
+	xmlModel->setValueCache(valueCache);
+	xmlModel->setWordTokens(wordTokens);
+	xmlModel->setGraphLimit(graphLimit);
+	xmlModel->setDtd(dictionary ? dictionary->dtd() : 0);
+
+	NEW(pushFunnelDevice, FunnelDevice(xmlModel, false, XML_CODEC_DECODE_BUFFER_SIZE));
+	pushFunnelDevice->prepare();
+
+	if (!startDecoding(&pushLastFixedContextSymbol))
+	  {
+	    deletePushDecoder();
+	    return false;
+	  }
+
+	kyGrammar->setOutputDevice(pushFunnelDevice);
+
+	if (ruleTable)
+	  ruleTable->setOutputDevice(pushFunnelDevice);
+
+	//in the Re-Pair format, the rules of the block come first
+	pushDecoderState = rePair ? PushDecoderRules : PushDecoderSymbols;
+	break;
+
+      case PushDecoderRules:
+	if (!isFinal && pushBuffer->bytesAvailable() < arithCodec->inputBytesNeeded())
+	  {
+	    waiting = true;
+	    break;
+	  }
+
+	if (!ruleTable->decodeRuleBody())
+	  //the end of the rules
+	  pushDecoderState = PushDecoderSymbols;
+	break;
+
+      case PushDecoderSymbols:
+	if (!isFinal && pushBuffer->bytesAvailable() < arithCodec->inputBytesNeeded())
+	  {
+	    //deliver the data decoded so far, so that the events are not delayed until the buffer of the funnel gets full
+	    pushFunnelDevice->flush();
+	    pushSAXEmitter->flush();
+	    waiting = true;
+	    break;
+	  }
+
+	//decode next symbol
+	symbol = context->decode();
+
+	if (symbol == context->endOfMessage)
+	  {
+	    //deliver the data decoded so far to the model
+	    pushFunnelDevice->flush();
+	    pushSAXEmitter->flush();
+	    pushDecoderState = PushDecoderEndOfMessage;
+	  }
+	else
+	  {
+	    appendDecodedSymbol(symbol, pushLastFixedContextSymbol);
+
+	    if (explicitRules)
+	      pushDecoderState = PushDecoderRuleEvent;
+	  }
+	break;
+
+      case PushDecoderRuleEvent:
+	if (!isFinal && pushBuffer->bytesAvailable() < arithCodec->inputBytesNeeded())
+	  {
+	    //deliver the data decoded so far (see above)
+	    pushFunnelDevice->flush();
+	    pushSAXEmitter->flush();
+	    waiting = true;
+	    break;
+	  }
+
+	ruleTable->decodeRuleEvent();
+	pushDecoderState = PushDecoderSymbols;
+	break;
+
+      case PushDecoderEndOfMessage:
+	//finishDecode() reads up to 3 bits
+	if (!isFinal && pushBuffer->bytesAvailable() < arithCodec->inputBytesNeeded(3))
+	  {
+	    waiting = true;
+	    break;
+	  }
+
+	//finish decoding of the arithmetic code
+	arithCodec->finishDecode();
+	arithCodec->doneInputtingBits();
+	pushDecoderState = PushDecoderSyncMark;
+	break;
+
+      case PushDecoderSyncMark:
+	if (!isFinal && !pushBuffer->bytesAvailable())
+	  {
+	    waiting = true;
+	    break;
+	  }
+
+	if (readSyncMark())
+	  //the data continue after a flush point
+	  pushDecoderState = PushDecoderRestart;
+	else
+	  //the end of the data
+	  deletePushDecoder();
+	break;
+
+      case PushDecoderRestart:
+	if (!isFinal && pushBuffer->bytesAvailable() < B_BITS / 8)
+	  {
+	    waiting = true;
+	    break;
+	  }
+
+	arithCodec->startInputtingBits();
+	arithCodec->startDecode();
+
+	if (rePair)
+	  {
+	    //a new block of the Re-Pair grammar starts
+	    ruleTable->purge();
+	    pushDecoderState = PushDecoderRules;
+	  }
+	else
+	  pushDecoderState = PushDecoderSymbols;
+	break;
+
+      case PushDecoderFinished:
+	waiting = true;
+	break;
+      }
+
+  return true;
+}
+
+
+
+/*!
+  All documents share one grammar and one coding context; each document is processed by a new model. The members are separated by the end-of-message symbol. The devices of all members have to be set and prepared.
+
+  \param archive The directory of the archive with the input devices of the members.
+  \param outDevice The output device.
+*/
+bool XmlCodec::encodeArchive(ExaltArchive *archive, IODevice *outDevice)
+{
+  int modelFlags = XML_CODEC_ARCHIVE_FLAG | (dictionary ? XML_CODEC_DICTIONARY_FLAG : 0);
+  long parseResult;
+
+  inputDevice = 0;
+  outputDevice = outDevice;
+
+  //Create a KY grammar
+  NEW(kyGrammar, KYGrammar);
+
+  //Create a coding context for the grammar
+  NEW(context, Context);
+
+  kyGrammar->setOutputDevice(outputDevice);
+  kyGrammar->setTextCodec(textCodec);
+  kyGrammar->setContext(context);
+
+  //Create arithmetic coder/decoder...
+  NEW(arithCodec, ArithCodec);
+
+  //...and bind it with the contexts
+  context->setArithCodec(arithCodec);
+
+
+  //write the version string (excluding terminating \0)
+  outputDevice->writeData(FILE_STAMP, strlen(FILE_STAMP));
+
+  if (ExaltOptions::getOption(ExaltOptions::Model) == ExaltOptions::SimpleModel)
+    outputDevice->putChar(0 | modelFlags);		//to indicate the use of the simple model
+  else
+    outputDevice->putChar(1 | modelFlags);		//to indicate the use of the adaptive model
+
+  if (dictionary)
+    {
+      //store the hash of the dictionary
+      unsigned long dictionaryHash = dictionary->hash();
+
+      for (int i = 3; i >= 0; i--)
+	outputDevice->putChar((dictionaryHash >> (8 * i)) & 0xff);
+    }
+
+  //store the directory of the archive
+  archive->writeDirectory(outputDevice);
+
+  //store F_BITS and B_BITS being used in output
+  outputDevice->putChar(F_BITS);
+  outputDevice->putChar(B_BITS);
+
+  if (dictionary)
+    {
+      primeWithDictionary();
+
+      //the alphabet size is stored only if the dictionary didn't initialize the context
+      kyGrammar->setOutputDevice(context->isInitialized() ? 0 : outputDevice);
+    }
+  
+  //prepare arithCodec for encoding
+  arithCodec->setOutputDevice(outputDevice);
+  arithCodec->startOutputtingBits();
+  arithCodec->startEncode();
+
+  coderType = PullCoder;
+
+  parseResult = encodeArchiveMembers(archive, ExaltOptions::getOption(ExaltOptions::Model) != ExaltOptions::SimpleModel);
+
+  DELETE(kyGrammar);
+
+  if (parseResult)
+    {
+      //stop arithCodec
+      arithCodec->finishEncode();
+      arithCodec->doneOutputtingBits();
+    }
+
+  if (parseResult && ExaltOptions::getOption(ExaltOptions::Verbose) == ExaltOptions::Yes)
+    {
+      DISPLAY_COMPRESSION_SUMMARY;
+    }
+
+  DELETE(arithCodec);
+  DELETE(context);
+
+  return parseResult;
+}
+
+
+
+/*!
+  The existing archive is read from \a inDevice first: all its members are decoded (but not reconstructed) to bring the grammar and the coding context to the state they had at the end of the archive. Then a new segment with the directory of the new members is written to \a outDevice and the members are encoded using the restored grammar and context, so they benefit from everything learned from the previous members. The new segment has to be stored right after the end of the existing archive (\a outDevice typically appends to the same file).
+
+  The members are encoded using the model of the existing archive. The devices of all new members have to be set and prepared.
+
+  \param inDevice The input device with the existing archive.
+  \param archive The directory of the new members with their input devices.
+  \param outDevice The output device.
+*/
+bool XmlCodec::appendArchive(IODevice *inDevice, ExaltArchive *archive, IODevice *outDevice)
+{
+  ExaltArchive existingArchive;
+  int modelByte;
+  long parseResult = 0;
+
+  inputDevice = inDevice;
+
+  if (readArchive(&existingArchive, &modelByte, false))
+    {
+      inputDevice = 0;
+      outputDevice = outDevice;
+
+      //the decoder of the last segment reads B_BITS beyond its end, so they are filled before the new segment starts
+      for (int i = 0; i < B_BITS / 8; i++)
+	outputDevice->putChar(0);
+
+      //store the directory of the new segment
+      archive->writeDirectory(outputDevice);
+
+      //switch the restored grammar to encoding (the alphabet size is already stored)
+      kyGrammar->setContext(context, true);
+      kyGrammar->setOutputDevice(0);
+
+      //the new segment starts a new arithmetic code
+      arithCodec->setOutputDevice(outputDevice);
+      arithCodec->startOutputtingBits();
+      arithCodec->startEncode();
+
+      coderType = PullCoder;
+
+      parseResult = encodeArchiveMembers(archive, modelByte & 1);
+
+      if (parseResult)
+	{
+	  //stop arithCodec
+	  arithCodec->finishEncode();
+	  arithCodec->doneOutputtingBits();
+	}
+
+      if (parseResult && ExaltOptions::getOption(ExaltOptions::Verbose) == ExaltOptions::Yes)
+	{
+	  DISPLAY_COMPRESSION_SUMMARY;
+	}
+    }
+
+  DELETE(kyGrammar);
+  DELETE(arithCodec);
+  DELETE(context);
+
+  return parseResult;
+}
+
+
+
+/*!
+  The codec reads the directory of the archive and decodes all members. Before each member, ExaltArchive::startMember() is called to obtain the SAX receptor for the member; the members without a receptor are decoded, but not reconstructed. After each member, ExaltArchive::endMember() is called.
+
+  \param inDevice The input device.
+  \param archive The archive which receives the directory and the members.
+*/
+bool XmlCodec::decodeArchive(IODevice *inDevice, ExaltArchive *archive)
+{
+  int modelByte;
+  bool result;
+
+  inputDevice = inDevice;
+
+  result = readArchive(archive, &modelByte, true);
+
+  DELETE(kyGrammar);
+  DELETE(arithCodec);
+  DELETE(context);
+
+  return result;
+}
+
+
+
+/*!
+  The directories of all segments of the archive are read. The members appended to the archive are listed after the members of the previous segments. Because the segments are not delimited otherwise, the members are decoded (but not reconstructed).
+
+  \param inDevice The input device.
+  \param archive The archive which receives the directory.
+*/
+bool XmlCodec::listArchive(IODevice *inDevice, ExaltArchive *archive)
+{
+  int modelByte;
+  bool result;
+
+  inputDevice = inDevice;
+
+  result = readArchive(archive, &modelByte, false);
+
+  DELETE(kyGrammar);
+  DELETE(arithCodec);
+  DELETE(context);
+
+  return result;
+}
+
+
+
+/*!
+  Each member is parsed by a new XML parser and processed by a new model using the grammar and the context of the codec. The members are separated by the end-of-message symbol. The arithmetic coder has to be started.
+
+  \param archive The archive with the members to encode.
+  \param adaptive Use the adaptive model?
+
+  \return The total size of the members, or 0 if an error occurred.
+*/
+long XmlCodec::encodeArchiveMembers(ExaltArchive *archive, bool adaptive)
+{
+  ArchiveMemberList *members = archive->members();
+  long parseResult = 1;
+  long totalInput = 0;
+
+  for (ArchiveMember *member = members->first(); member && parseResult; member = members->next())
+    {
+      //Create a XML parser with the device of the member...
+      NEW(xmlParser, XmlParser);
+      xmlParser->setInputDevice(member->device);
+
+      //...and a new model
+      if (!adaptive)
+	{
+	  NEW(xmlModel, XmlSimpleModel);
+	}
+      else
+	{
+	  NEW(xmlModel, XmlAdaptiveModel);
+	}
+
+      xmlParser->setXmlModel(xmlModel);
+      xmlModel->setGrammar(kyGrammar);
+
+      if (ExaltOptions::getOption(ExaltOptions::Verbose) == ExaltOptions::Yes)
+	OUTPUTENL("Adding '" << member->name << "' to the archive.");
+
+      //parse the member
+      parseResult = xmlParser->parse();
+
+      //all symbols of the member have to be encoded before the end of the member is marked
+      kyGrammar->flush();
+
+      DELETE(xmlParser);
+      DELETE(xmlModel);
+
+      if (parseResult)
+	{
+	  //mark the end of the member
+	  context->encodeEndOfMessage();
+	  totalInput += parseResult;
+	}
+    }
+
+  return parseResult ? totalInput : 0;
+}
+
+
+
+/*!
+  Reads the header and all segments of the archive. The grammar, the context and the arithmetic decoder are left in the state they have at the end of the archive; the caller has to delete them.
+
+  \param archive The archive which receives the directory (and the members).
+  \param modelByte The variable where the model byte is stored.
+  \param reconstruct Pass the members to the archive? If false, all members are only decoded.
+
+  \return False if the data end prematurely, true otherwise.
+*/
+bool XmlCodec::readArchive(ExaltArchive *archive, int *modelByte, bool reconstruct)
+{
+  ArchiveMemberList *members;
+  ArchiveMember *member;
+  long lastFixedContextSymbol;
+  size_t decodedMembers = 0;
+
+  //Create a KY grammar
+  NEW(kyGrammar, KYGrammar);
+
+  //Create a decoding context for the grammar
+  NEW(context, Context);
+
+  kyGrammar->setContext(context, false);
+
+  //Create arithmetic coder/decoder...
+  NEW(arithCodec, ArithCodec);
+
+  //...and bind it with the contexts
+  context->setArithCodec(arithCodec);
+
+
+  if (!readHeader(modelByte))
+    return false;
+
+  if (!(*modelByte & XML_CODEC_ARCHIVE_FLAG))
+    {
+      ERR("The data are not a solid archive!");
+      throw ExaltUnknownFileFormatException();
+    }
+
+  archive->readDirectory(inputDevice);
+  members = archive->members();
+
+  kyGrammar->setTextCodec(textCodec);
+
+  if (!startDecoding(&lastFixedContextSymbol))
+    return false;
+
+  for (;;)
+    {
+      //skip the members of the previous segments
+      member = members->first();
+      for (size_t i = 0; i < decodedMembers; i++)
+	member = members->next();
+
+      for (; member; member = members->next())
+	decodeArchiveMember(archive, member, *modelByte, lastFixedContextSymbol, reconstruct);
+
+      decodedMembers = archive->count();
+
+      //finish decoding of the segment
+      arithCodec->finishDecode();
+      arithCodec->doneInputtingBits();
+
+      //read the directory of the appended segment (if any)
+      if (!archive->appendDirectory(inputDevice))
+	break;
+
+      //the segment starts a new arithmetic code
+      arithCodec->startInputtingBits();
+      arithCodec->startDecode();
+    }
+
+  return true;
+}
+
+
+
+/*!
+  Decodes all symbols of one member up to the end-of-message symbol.
+
+  \param archive The archive.
+  \param member The member.
+  \param modelByte The model byte of the archive.
+  \param lastFixedContextSymbol The last fixed symbol of the context (EOM).
+  \param reconstruct Pass the member to the archive?
+*/
+void XmlCodec::decodeArchiveMember(ExaltArchive *archive, ArchiveMember *member, int modelByte, long lastFixedContextSymbol, bool reconstruct)
+{
+  FunnelDevice *funnelDevice = 0;
+  SAXEmitter *saxEmitter = 0;
+  SAXReceptor *receptor;
+  int symbol;
+
+  xmlModel = 0;
+
+  if (reconstruct && (receptor = archive->startMember(member)))
+    {
+      //the member is reconstructed
+      if (!(modelByte & 1))
+	{
+	  NEW(xmlModel, XmlSimpleModel);
+	}
+      else
+	{
+	  NEW(xmlModel, XmlAdaptiveModel);
+	}
+
+      saxEmitter = createSAXEmitter(receptor);
+      xmlModel->setSAXEmitter(saxEmitter);
+
+      NEW(funnelDevice, FunnelDevice(xmlModel, false, XML_CODEC_DECODE_BUFFER_SIZE));
+      funnelDevice->prepare();
+    }
+
+  //the skipped members only update the grammar
+  kyGrammar->setOutputDevice(funnelDevice);
+
+  for (;;)
+    {
+      //decode next symbol
+      symbol = context->decode();
+
+      //the EOM ends the member
+      if (symbol == context->endOfMessage)
+	break;
+
+      appendDecodedSymbol(symbol, lastFixedContextSymbol);
+    }
+
+  kyGrammar->setOutputDevice(0);
+
+  if (funnelDevice)
+    {
+      //deliver the rest of the decoded data to the model
+      funnelDevice->flush();
+      saxEmitter->flush();
+
+      DELETE(xmlModel);
+      DELETE(funnelDevice);
+      DELETE(saxEmitter);
+    }
+
+  if (reconstruct)
+    archive->endMember(member);
+}
+
+
+
+/*!
+  Reads the file stamp and the model byte. If the data were compressed using a dictionary, the hash of the dictionary is compared with the hash of the dictionary of the codec.
+
+  \param modelByte The variable where the model byte (without the dictionary flag, the explicit rules flag and the Re-Pair flag) is stored.
+  \param checkDictionary Indication whether the dictionary should be checked.
+
+  \return False if the data end prematurely, true otherwise.
+*/
+bool XmlCodec::readHeader(int *modelByte, bool checkDictionary = true)
+{
+  char *fileStamp;
+  size_t fileStampLength = strlen(FILE_STAMP);
+  bool limitFollows = false;
+  int byte;
+
+  NEW(fileStamp, char[fileStampLength + 1]);
+
+  inputDevice->readData(fileStamp, fileStampLength);
+  if (inputDevice->errorOccurred() || inputDevice->eof())
+    {
+      DELETE(fileStamp);
+      return false;
+    }
+
+  fileStamp[fileStampLength] = '\0';
+
+  if (strcmp(FILE_STAMP, fileStamp))
+    {
+      DELETE(fileStamp);
+      ERR("File format not recognized!");
+      throw ExaltUnknownFileFormatException();
+    }
+  else
+    {
+      DELETE(fileStamp);
+    }
+
+  //the model (and the other flags)
+  inputDevice->getChar(modelByte);
+  if (inputDevice->errorOccurred() || inputDevice->eof())
+    return false;
+
+  explicitRules = (*modelByte & XML_CODEC_EXPLICIT_RULES_FLAG);
+  *modelByte &= ~XML_CODEC_EXPLICIT_RULES_FLAG;
+
+  rePair = (*modelByte & XML_CODEC_REPAIR_FLAG);
+  *modelByte &= ~XML_CODEC_REPAIR_FLAG;
+
+  useContainers = false;
+  graphLimit = 0;
+
+  if (*modelByte & XML_CODEC_CONTAINERS_FLAG)
+    {
+      if (*modelByte & 1)
+	//the graphs of the elements are limited (adaptive model)
+	limitFollows = true;
+      else
+	//the character data are in the containers (simple model)
+	useContainers = true;
+
+      *modelByte &= ~XML_CODEC_CONTAINERS_FLAG;
+    }
+
+  if (*modelByte & XML_CODEC_TYPED_VALUES_FLAG)
+    {
+      //the numbers and the dates are coded in the binary form
+      NEW(typedValues, XmlTypedValues);
+      *modelByte &= ~XML_CODEC_TYPED_VALUES_FLAG;
+    }
+
+  if (*modelByte & XML_CODEC_VALUE_CACHE_FLAG)
+    {
+      if (*modelByte & 1)
+	{
+	  //the repeated values are coded by their indices (adaptive model)
+	  NEW(valueCache, XmlValueCache);
+	}
+      else
+	{
+	  //the repeated words are coded by their ids (simple model)
+	  NEW(wordTokens, XmlWordTokens);
+	}
+
+      *modelByte &= ~XML_CODEC_VALUE_CACHE_FLAG;
+    }
+
+  if (*modelByte & XML_CODEC_DICTIONARY_FLAG)
+    {
+      //the data were compressed using a dictionary
+      unsigned long dictionaryHash = 0;
+
+      for (int i = 0; i < 4; i++)
+	{
+	  inputDevice->getChar(&byte);
+	  if (inputDevice->errorOccurred() || inputDevice->eof())
+	    return false;
+
+	  dictionaryHash = (dictionaryHash << 8) | (byte & 0xff);
+	}
+
+      if (checkDictionary && !dictionary)
+	{
+	  ERR("The data were compressed using a dictionary (or a DTD)!");
+	  throw ExaltDictionaryMismatchException();
+	}
+
+      if (checkDictionary && dictionary->hash() != dictionaryHash)
+	{
+	  ERR("The data were compressed using another dictionary (or DTD)!");
+	  throw ExaltDictionaryMismatchException();
+	}
+
+      *modelByte &= ~XML_CODEC_DICTIONARY_FLAG;
+    }
+  else
+    if (checkDictionary && dictionary)
+      {
+	ERR("The data were compressed without a dictionary (or a DTD)!");
+	throw ExaltDictionaryMismatchException();
+      }
+
+  if (limitFollows)
+    {
+      //the limit of the graphs follows the hash of the dictionary
+      for (int i = 0; i < 4; i++)
+	{
+	  inputDevice->getChar(&byte);
+	  if (inputDevice->errorOccurred() || inputDevice->eof())
+	    return false;
+
+	  graphLimit = (graphLimit << 8) | (byte & 0xff);
+	}
+    }
+
+  return true;
+}
+
+
+
+/*!
+  Checks F_BITS and B_BITS, primes the grammar and the context with the dictionary (if any), initializes the context and starts the arithmetic decoder. The grammar has no output device after the call.
+
+  \param lastFixedContextSymbol The variable where the last fixed symbol of the context (EOM) is stored.
+
+  \return False if the data end prematurely, true otherwise.
+*/
+bool XmlCodec::startDecoding(long *lastFixedContextSymbol)
+{
+  int byte1, byte2;
+  FibonacciDecoderState fibDecoder;
+  bool finished = false;
+  unsigned long alphabetBaseSize;
+
+  inputDevice->getChar(&byte1);
+  if (inputDevice->errorOccurred() || inputDevice->eof())
+    return false;
+
+  inputDevice->getChar(&byte2);
+  if (inputDevice->errorOccurred() || inputDevice->eof())
+    return false;
+
+  if (byte1 != F_BITS || byte2 != B_BITS)
+    FATAL("Compressed file F_BITS = " << byte1 << ", B_BITS = " << byte2 << ")! Compressor was compiled with F_BITS = " << F_BITS << ", B_BITS = " << B_BITS << ".");
+
+  if (dictionary)
+    {
+      primeWithDictionary();
+
+      kyGrammar->setContext(context, false);
+    }
+
+  kyGrammar->setOutputDevice(0);
+
+  if (context->isInitialized())
+    {
+      //the context has been initialized by the dictionary
+      *lastFixedContextSymbol = context->lastFixedSymbol();
+    }
+  else
+    {
+      //read the Fibonacci code of the base size of the terminal alphabet
+      Fibonacci::resetDecoder(&fibDecoder);
+
+      while (!finished)
+	{
+	  int c;
+
+	  inputDevice->getChar(&c);
+	  if (inputDevice->errorOccurred() || inputDevice->eof())
+	    return false;
+
+	  finished = Fibonacci::decodeChar(&fibDecoder, (unsigned char)c, &alphabetBaseSize);
+	}
+
+
+      context->setType(alphabetBaseSize, DynamicContext);
+
+      //get the last fixed symbol of the context table (EOM)
+      *lastFixedContextSymbol = context->initialize();
+
+      if (ruleBodyContext)
+	{
+	  //the context of the rule bodies has the same base size (Re-Pair format)
+	  ruleBodyContext->setType(alphabetBaseSize, DynamicContext);
+	  ruleBodyContext->initialize();
+	}
+    }
+
+  //prepare arithCodec for decoding
+  arithCodec->setInputDevice(inputDevice);
+  arithCodec->startInputtingBits();
+  arithCodec->startDecode();
+
+  return true;
+}
+
+
+
+/*!
+  The containers are read from the input device (the length of the container section has to be read already) and all of them are decoded, so the model can fetch their data while the structure is decoded.
+
+  \return False if the data end prematurely, true otherwise.
+*/
+bool XmlCodec::readContainers(void)
+{
+  NEW(containers, XmlContainerSet);
+  containers->setTextCodec(textCodec);
+
+  return containers->read(inputDevice);
+}
+
+
+
+/*!
+  Called after the end-of-message symbol has been decoded and the arithmetic decoding has been finished.
+
+  \return True if the data continue after a flush point, false if the data end.
+*/
+bool XmlCodec::readSyncMark(void)
+{
+  int c;
+
+  if (inputDevice->getChar(&c) != ReadOk)
+    return false;
+
+  if (c != XML_CODEC_SYNC_MARK)
+    {
+      ERR("Corrupted flush point!");
+      throw ExaltUnknownFileFormatException();
+    }
+
+  return true;
+}
+
+
+
+/*!
+  The rule events are coded in static contexts bound to the arithmetic coder/decoder (see RULE_EVENT_CONTEXT()).
+*/
+void XmlCodec::createRuleContexts(void)
+{
+  NEW(ruleContexts, ContextBase*[RULE_EVENT_CONTEXTS]);
+
+  for (int i = 0; i < RULE_EVENT_CONTEXTS; i++)
+    {
+      NEW(ruleContexts[i], Context(RULE_EVENTS, StaticContext));
+      ruleContexts[i]->setArithCodec(arithCodec);
+      ruleContexts[i]->initialize();
+    }
+}
+
+
+
+/*!
+  Deletes the contexts created by createRuleContexts().
+*/
+void XmlCodec::deleteRuleContexts(void)
+{
+  for (int i = 0; i < RULE_EVENT_CONTEXTS; i++)
+    DELETE(ruleContexts[i]);
+
+  DELETE_ARRAY(ruleContexts);
+}
+
+
+
+/*!
+  The Re-Pair grammar is used if it is selected by the ExaltOptions::Grammar option (not together with a dictionary), otherwise the KY grammar is used (in the explicit rules format if selected by the ExaltOptions::ExplicitRules option). The context and the arithmetic coder have to exist.
+
+  \param modelFlags The flags of the model byte (the flag of the format is added).
+ */
+void XmlCodec::createEncoderGrammar(int *modelFlags)
+{
+  if (ExaltOptions::getOption(ExaltOptions::Grammar) == ExaltOptions::RePair && !dictionary)
+    {
+      //build the grammar offline
+      *modelFlags |= XML_CODEC_REPAIR_FLAG;
+
+      NEW(rePairGrammar, RePairGrammar);
+
+      NEW(ruleBodyContext, Context);
+      ruleBodyContext->setArithCodec(arithCodec);
+
+      rePairGrammar->setContext(context);
+      rePairGrammar->setRuleBodyContext(ruleBodyContext);
+      rePairGrammar->setOutputDevice(outputDevice);
+      rePairGrammar->setTextCodec(textCodec);
+
+      grammar = rePairGrammar;
+      return;
+    }
+
+  //Create a KY grammar
+  NEW(kyGrammar, KYGrammar);
+
+  kyGrammar->setContext(context);
+  kyGrammar->setOutputDevice(outputDevice);
+  kyGrammar->setTextCodec(textCodec);
+
+  if (ExaltOptions::getOption(ExaltOptions::ExplicitRules) == ExaltOptions::Yes && !dictionary)
+    {
+      //describe the changes of the grammar, so that the decoder doesn't have to repeat them
+      *modelFlags |= XML_CODEC_EXPLICIT_RULES_FLAG;
+      createRuleContexts();
+      kyGrammar->setRuleContexts(ruleContexts);
+    }
+
+  grammar = kyGrammar;
+}
+
+
+
+/*!
+  The grammar encodes all pending symbols when it is deleted.
+ */
+void XmlCodec::deleteEncoderGrammar(void)
+{
+  if (rePairGrammar)
+    {
+      DELETE(rePairGrammar);
+      DELETE(ruleBodyContext);
+    }
+  else
+    DELETE(kyGrammar);
+
+  grammar = 0;
+}
+
+
+
+/*!
+  The format is given by the header of the data (see readHeader()). The context and the arithmetic decoder have to exist.
+ */
+void XmlCodec::createRuleTable(void)
+{
+  NEW(ruleTable, KYRuleTable);
+  ruleTable->setContext(context);
+
+  if (explicitRules)
+    {
+      createRuleContexts();
+      ruleTable->setRuleContexts(ruleContexts);
+    }
+  else
+    {
+      //initialized by startDecoding()
+      NEW(ruleBodyContext, Context);
+      ruleBodyContext->setArithCodec(arithCodec);
+      ruleTable->setRuleBodyContext(ruleBodyContext);
+    }
+}
+
+
+
+/*!
+  Deletes the table together with its contexts.
+ */
+void XmlCodec::deleteRuleTable(void)
+{
+  DELETE(ruleTable);
+
+  if (ruleContexts)
+    deleteRuleContexts();
+
+  if (ruleBodyContext)
+    DELETE(ruleBodyContext);
+}
+
+
+
+/*!
+  If the receptor accepts the events in batches, the events are collected by SAXBatchEmitter, otherwise they are sent to the receptor one by one. If a path filter has been set, the emitter is wrapped by SAXPathFilterEmitter.
+
+  \param receptor The SAX receptor.
+  \return The emitter.
+*/
+SAXEmitter *XmlCodec::createSAXEmitter(SAXReceptor *receptor)
+{
+  SAXEmitter *emitter;
+
+  if (receptor && receptor->acceptsEventBatches())
+    {
+      NEW(emitter, SAXBatchEmitter(receptor));
+    }
+  else
+    {
+      NEW(emitter, SAXEmitter(receptor));
+    }
+
+  if (pathFilter)
+    {
+      NEW(emitter, SAXPathFilterEmitter(emitter, pathFilter));
+    }
+
+  return emitter;
+}
+
+
+
+/*!
+  Appends one decoded symbol (terminal or variable) to the grammar (or to the rule table in the explicit rules format).
+
+  \param symbol The decoded symbol.
+  \param lastFixedContextSymbol The last fixed symbol of the context (EOM).
+*/
+void XmlCodec::appendDecodedSymbol(int symbol, long lastFixedContextSymbol)
+{
+  RuleElement *rel;
+
+  //New variable --> decode it from Fibonacci code
+  //that follows...
+
+  if (symbol == Context::NotKnown)
+    {
+      FATAL("Unknown symbol decoded!!!");
+    }
+
+  if (ruleTable)
+    {
+      //explicit rules format --> only expand the symbol
+      ruleTable->append(symbol);
+      return;
+    }
+
+  if (symbol > lastFixedContextSymbol)
+    {
+      //decoded a variable
+      //--> append it to the grammar
+
+      Rule *rule;
+
+      rel = kyGrammar->newRuleElement();
+      rel->type = Variable;
+
+      //find rule with corresponding id
+      rule = kyGrammar->findRule(symbol - lastFixedContextSymbol);
+
+      CHECK_POINTER(rule);
+
+      rel->rule = rule;
+
+      //increase rule ref count
+      rel->rule->refCount++;
+    }
+  else
+    {
+      //decoded a terminal
+      //--> append it to the grammar
+      rel = kyGrammar->newRuleElement();
+
+      rel->type = Terminal;
+      rel->value = symbol;
+    }
+
+  kyGrammar->appendToRootRule(rel);
+}
+
+
+
+/*!
+  Deletes the grammar, the context, the arithmetic decoder, the model and the devices of the PUSH decoder.
+*/
+void XmlCodec::deletePushDecoder(void)
+{
+  DELETE(kyGrammar);
+  DELETE(arithCodec);
+  DELETE(context);
+
+  if (ruleTable)
+    deleteRuleTable();
+
+  if (xmlModel)
+    DELETE(xmlModel);
+
+  if (pushFunnelDevice)
+    DELETE(pushFunnelDevice);
+
+  if (pushSAXEmitter)
+    DELETE(pushSAXEmitter);
+
+  if (containers)
+    DELETE(containers);
+
+  if (typedValues)
+    DELETE(typedValues);
+
+  if (valueCache)
+    DELETE(valueCache);
+
+  if (wordTokens)
+    DELETE(wordTokens);
+
+  DELETE(pushBuffer);
+
+  inputDevice = 0;
+  pushDecoderState = PushDecoderFinished;
+}
+
+
+
+/*!
+  The documents of the dictionary are encoded in the usual way (using the model stored in the dictionary), but the encoded data are thrown away. After that, the grammar contains the rules of the dictionary and the statistics of the context are adapted to the dictionary. Both the encoder and the decoder call this method before the actual data are processed, so their grammars and contexts are in the same state.
+
+  After the call, the grammar has no output device and uses the context for output; the caller has to set them as appropriate.
+*/
+void XmlCodec::primeWithDictionary(void)
+{
+  NullDevice nullDevice;
+  ArithCodec *primingArithCodec;
+  XmlParser *primingParser;
+  XmlModelBase *primingModel;
+  DictionaryDocumentList *documents = dictionary->documents();
+
+  //the grammar encodes the documents...
+  kyGrammar->setContext(context, true);
+  kyGrammar->setOutputDevice(&nullDevice);
+
+  //...using a temporary arithmetic coder that discards the output
+  NEW(primingArithCodec, ArithCodec);
+  primingArithCodec->setOutputDevice(&nullDevice);
+  primingArithCodec->startOutputtingBits();
+  primingArithCodec->startEncode();
+
+  context->setArithCodec(primingArithCodec);
+
+  for (DictionaryDocument *doc = documents->first(); doc; doc = documents->next())
+    {
+      NEW(primingParser, XmlParser);
+
+      if (dictionary->getModel() == ExaltOptions::SimpleModel)
+	{
+	  NEW(primingModel, XmlSimpleModel);
+	}
+      else
+	{
+	  NEW(primingModel, XmlAdaptiveModel);
+	}
+
+      primingParser->setXmlModel(primingModel);
+      primingModel->setGrammar(kyGrammar);
+      primingModel->setDtd(dictionary->dtd());
+
+      primingParser->parsePush(doc->data, doc->length, true);
+
+      //process the whole document before the model is deleted
+      kyGrammar->flush();
+
+      DELETE(primingParser);
+      DELETE(primingModel);
+    }
+
+  primingArithCodec->finishEncode();
+  primingArithCodec->doneOutputtingBits();
+
+  context->setArithCodec(arithCodec);
+  DELETE(primingArithCodec);
+
+  kyGrammar->setOutputDevice(0);
+}
+
+
+
+/*!
+  Up to XML_CODEC_SAMPLE_SIZE bytes are read from the input device into a newly allocated buffer, which has to be deleted by the caller.
+
+  \param length The variable where the length of the sample is stored.
+  \return Pointer to the buffer.
+ */
+char *XmlCodec::readSample(IOSize *length)
+{
+  char *buf;
+  IOState state;
+
+  NEW(buf, char[XML_CODEC_SAMPLE_SIZE]);
+  *length = 0;
+
+  do
+    {
+      state = inputDevice->readData(buf + *length, XML_CODEC_SAMPLE_SIZE - *length);
+      *length += inputDevice->bytesRead();
+    }
+  while (state == ReadOk && *length < XML_CODEC_SAMPLE_SIZE);
+
+  return buf;
+}
+
+
+
+/*!
+  The sample is encoded by both models (see encodeSample()). Depending on the ExaltOptions::ModelObjective option, the model which was faster (ExaltOptions::Speed), or the model whose output was smaller (ExaltOptions::Ratio) is selected. If a dictionary is used, the model of the dictionary is selected, because the grammar is primed by it.
+
+  \param sample The sample of the input data.
+  \param length The length of the sample.
+  \return The selected model (ExaltOptions::SimpleModel or ExaltOptions::AdaptiveModel).
+ */
+ExaltOptions::OptionValue XmlCodec::selectModel(const char *sample, IOSize length)
+{
+  ExaltOptions::OptionValue model;
+  IOSize simpleSize, adaptiveSize;
+  double simpleTime, adaptiveTime;
+
+  if (dictionary)
+    return dictionary->getModel();
+
+  simpleSize = encodeSample(ExaltOptions::SimpleModel, sample, length, &simpleTime);
+  adaptiveSize = encodeSample(ExaltOptions::AdaptiveModel, sample, length, &adaptiveTime);
+
+  if (ExaltOptions::getOption(ExaltOptions::ModelObjective) == ExaltOptions::Speed)
+    model = adaptiveTime < simpleTime ? ExaltOptions::AdaptiveModel : ExaltOptions::SimpleModel;
+  else
+    model = adaptiveSize < simpleSize ? ExaltOptions::AdaptiveModel : ExaltOptions::SimpleModel;
+
+  if (ExaltOptions::getOption(ExaltOptions::Verbose) == ExaltOptions::Yes)
+    {
+      OUTPUTENL("Model selection (sample of " << length << " B)");
+      OUTPUTENL("  Simple model: \t\t\t" << simpleSize << " B, " << simpleTime << " s");
+      OUTPUTENL("  Adaptive model: \t\t\t" << adaptiveSize << " B, " << adaptiveTime << " s");
+      OUTPUTENL("  Selected model: \t\t\t" << (model == ExaltOptions::SimpleModel ? "simple" : "adaptive"));
+    }
+
+  return model;
+}
+
+
+
+/*!
+  The sample is encoded by a temporary parser, model, grammar and arithmetic coder, and the encoded data are thrown away. The sample is usually cut in the middle of the document, so it is parsed as an incomplete document. The coders of the typed values, the value cache and the word tokens are used as selected by the options; the containers are not used.
+
+  \param model The model (ExaltOptions::SimpleModel or ExaltOptions::AdaptiveModel).
+  \param sample The sample of the input data.
+  \param length The length of the sample.
+  \param seconds The variable where the time of the encoding is stored.
+  \return The size of the encoded sample (in bytes).
+ */
+IOSize XmlCodec::encodeSample(ExaltOptions::OptionValue model, const char *sample, IOSize length, double *seconds)
+{
+  NullDevice nullDevice;
+  Context *sampleContext;
+  ArithCodec *sampleArithCodec;
+  KYGrammar *sampleGrammar;
+  XmlParser *sampleParser;
+  XmlModelBase *sampleModel;
+  XmlTypedValues *sampleTypedValues = 0;
+  XmlValueCache *sampleValueCache = 0;
+  XmlWordTokens *sampleWordTokens = 0;
+  clock_t t1 = clock();
+
+  NEW(sampleContext, Context);
+  NEW(sampleArithCodec, ArithCodec);
+  sampleContext->setArithCodec(sampleArithCodec);
+
+  NEW(sampleGrammar, KYGrammar);
+  sampleGrammar->setContext(sampleContext);
+  sampleGrammar->setOutputDevice(&nullDevice);
+  sampleGrammar->setTextCodec(textCodec);
+
+  NEW(sampleParser, XmlParser);
+
+  if (model == ExaltOptions::SimpleModel)
+    {
+      NEW(sampleModel, XmlSimpleModel);
+
+      if (ExaltOptions::getOption(ExaltOptions::TypedValues) == ExaltOptions::Yes)
+	NEW(sampleTypedValues, XmlTypedValues);
+
+      if (ExaltOptions::getOption(ExaltOptions::WordTokens) == ExaltOptions::Yes)
+	NEW(sampleWordTokens, XmlWordTokens);
+    }
+  else
+    {
+      NEW(sampleModel, XmlAdaptiveModel);
+
+      if (ExaltOptions::getOption(ExaltOptions::ValueCache) == ExaltOptions::Yes)
+	NEW(sampleValueCache, XmlValueCache);
+    }
+
+  sampleParser->setXmlModel(sampleModel);
+  sampleModel->setGrammar(sampleGrammar);
+  sampleModel->setTypedValues(sampleTypedValues);
+  sampleModel->setValueCache(sampleValueCache);
+  sampleModel->setWordTokens(sampleWordTokens);
+
+  sampleArithCodec->setOutputDevice(&nullDevice);
+  sampleArithCodec->startOutputtingBits();
+  sampleArithCodec->startEncode();
+
+  sampleParser->parsePush(sample, length, false);
+
+  //encode all symbols of the sample
+  sampleGrammar->flush();
+  sampleContext->encodeEndOfMessage();
+  sampleArithCodec->finishEncode();
+  sampleArithCodec->doneOutputtingBits();
+
+  *seconds = (double)(clock() - t1) / CLOCKS_PER_SEC;
+
+  DELETE(sampleParser);
+  DELETE(sampleModel);
+
+  if (sampleTypedValues)
+    DELETE(sampleTypedValues);
+
+  if (sampleValueCache)
+    DELETE(sampleValueCache);
+
+  if (sampleWordTokens)
+    DELETE(sampleWordTokens);
+
+  DELETE(sampleGrammar);
+  DELETE(sampleArithCodec);
+  DELETE(sampleContext);
+
+  return nullDevice.bytesWritten();
+}
@@ -34,16 +34,170 @@
 
 
 #include "arithcodec.h"
+#include "bufferdevice.h"
 #include "context.h"
 #include "defs.h"
+#include "exaltarchive.h"
 #include "exceptions.h"
 #include "funneldevice.h"
 #include "kygrammar.h"
+#include "kyruletable.h"
+#include "nulldevice.h"
+#include "repairgrammar.h"
 #include "xmlcodecbase.h"
+#include "xmlcontainerset.h"
+#include "xmltypedvalues.h"
+#include "xmlvaluecache.h"
+#include "xmlwordtokens.h"
 #include "xmlparser.h"
 #include "xmlsimplemodel.h"
 #include "xmladaptivemodel.h"
 
+#include <ctime>
+
+
+
+/*!
+  \brief The size of the buffer for the decoded data.
+
+  The data reconstructed by the grammar are delivered to the XML model in blocks of this size.
+ */
+#define XML_CODEC_DECODE_BUFFER_SIZE	65536
+
+
+/*!
+  \brief The size of the sample of the input data used for the automatic selection of the model.
+
+  Both models encode the sample, and the better one is used for the whole data (see XmlCodec::selectModel()).
+ */
+#define XML_CODEC_SAMPLE_SIZE		262144
+
+
+/*!
+  \brief The flag of the model byte indicating the use of a dictionary.
+
+  If the flag is set, the model byte is followed by the hash of the dictionary (4 bytes, most significant first).
+ */
+#define XML_CODEC_DICTIONARY_FLAG	2
+
+
+/*!
+  \brief The flag of the model byte indicating a solid archive.
+
+  If the flag is set, the header is followed by the directory of the archive (see ExaltArchive). The archive consists of one or more segments: each segment appended to the archive later starts with the directory of its members and a new arithmetic code, but it continues with the grammar and the context of the previous segments.
+ */
+#define XML_CODEC_ARCHIVE_FLAG		4
+
+
+/*!
+  \brief The flag of the model byte indicating the explicit rules format.
+
+  If the flag is set, each symbol of the arithmetic code is followed by the rule event describing the changes of the grammar (see RuleEvent), so the decoder maintains only the table of the rules (see KYRuleTable) instead of repeating the transformation of the grammar. The format is not used together with a dictionary or in solid archives.
+ */
+#define XML_CODEC_EXPLICIT_RULES_FLAG	8
+
+
+/*!
+  \brief The flag of the model byte indicating the Re-Pair format.
+
+  If the flag is set, the data were encoded by RePairGrammar: each block of the data (the whole data, or the data between two flush points) starts with the list of its rules, followed by the root sequence (see RePairGrammar::encodeGrammar()). The decoder maintains only the table of the rules (see KYRuleTable). The format is not used together with a dictionary or in solid archives.
+ */
+#define XML_CODEC_REPAIR_FLAG		16
+
+
+/*!
+  \brief The flag of the model byte indicating the containers of the character data.
+
+  If the flag is set, the character data and the attribute values were routed to the containers of their paths (see XmlContainerSet). The header is followed by the container section and then by the structure. The containers are used only with the simple model, and not by the PUSH encoder or in solid archives.
+ */
+#define XML_CODEC_CONTAINERS_FLAG	32
+
+
+/*!
+  \brief The flag of the model byte indicating the typed values.
+
+  If the flag is set, the numbers and the dates in the character data and in the attribute values were coded in the binary form (see XmlTypedValues). The typed values are used only with the simple model, and not in solid archives.
+ */
+#define XML_CODEC_TYPED_VALUES_FLAG	64
+
+
+/*!
+  \brief The flag of the model byte indicating the value cache.
+
+  If the flag is set, the repeated attribute values and character data were coded by their indices in the cache of the recently used values of their paths (see XmlValueCache). The value cache is used only with the adaptive model, and not in solid archives.
+ */
+#define XML_CODEC_VALUE_CACHE_FLAG	128
+
+
+/*!
+  \brief The flag of the model byte indicating the word tokens.
+
+  If the flag is set, the repeated words of the character data were coded by their ids in the dictionary of the words (see XmlWordTokens). The word tokens are used only with the simple model, so the flag shares its bit with XML_CODEC_VALUE_CACHE_FLAG (the flags are told apart by the model). They are not used in solid archives.
+ */
+#define XML_CODEC_WORD_TOKENS_FLAG	128
+
+
+/*!
+  \brief The flag of the model byte indicating the limited graphs of the elements.
+
+  If the flag is set, the size of the graph of each element was limited (see ElementModeler::prune()). The limit is stored after the hash of the dictionary (4 bytes, most significant first). The limit is used only with the adaptive model, so the flag shares its bit with XML_CODEC_CONTAINERS_FLAG. It is not used in solid archives.
+ */
+#define XML_CODEC_GRAPH_LIMIT_FLAG	32
+
+
+/*!
+  \brief The byte which follows each flush point of the compressed data.
+
+  The end-of-message symbol either ends the data, or it marks a flush point (see XmlCodec::sync()). In the latter case, the arithmetic code is followed by B_BITS / 8 padding bytes and by this byte; then a new arithmetic code starts.
+ */
+#define XML_CODEC_SYNC_MARK		0x5a
+
+
+/*!
+  \brief The number of bytes the PUSH decoder waits for before it reads the header.
+
+  The header (including the start of the arithmetic code) is read at once, so the decoder waits until the longest possible header is available (or until the last chunk of data arrives).
+ */
+#define XML_CODEC_PUSH_HEADER_SIZE	28
+
+
+
+/*!
+  \brief The states of the PUSH decoder.
+ */
+enum PushDecoderState
+{
+  //! Waiting for the header.
+  PushDecoderHeader,
+
+  //! Waiting for the whole container section.
+  PushDecoderContainers,
+
+  //! Starting the decoding of the structure.
+  PushDecoderStart,
+
+  //! Decoding the rules of the block (Re-Pair format).
+  PushDecoderRules,
+
+  //! Decoding the symbols.
+  PushDecoderSymbols,
+
+  //! Decoding the rule event which follows the symbol (explicit rules format).
+  PushDecoderRuleEvent,
+
+  //! The end-of-message symbol has been decoded.
+  PushDecoderEndOfMessage,
+
+  //! Waiting for the sync mark (or for the end of the data).
+  PushDecoderSyncMark,
+
+  //! Waiting for the start of the arithmetic code after a flush point.
+  PushDecoderRestart,
+
+  //! All data have been decoded.
+  PushDecoderFinished
+};
+
 
 /*!
   \brief A XML encoding/decoding class.
@@ -68,12 +222,93 @@ public:
   //! Encode the data in PUSH mode.
   virtual bool encodePush(const char *data, int length, bool isFinal = false);
 
+  //! Make the data encoded so far decodable.
+  virtual void sync(void);
+
   //! Decode data from one device and use given SAX receptor.
   virtual bool decode(IODevice *inDevice, SAXReceptor *receptor, void *userData = 0);
 
+  //! Initialize the decoder in PUSH mode.
+  virtual void initializePushDecoder(SAXReceptor *receptor, void *userData = 0);
+
+  //! Decode the data in PUSH mode.
+  virtual bool decodePush(const char *data, int length, bool isFinal = false);
+
+  //! Encode several documents into one solid archive.
+  virtual bool encodeArchive(ExaltArchive *archive, IODevice *outDevice);
+
+  //! Decode the members of a solid archive.
+  virtual bool decodeArchive(IODevice *inDevice, ExaltArchive *archive);
+
+  //! Append documents to an existing solid archive.
+  virtual bool appendArchive(IODevice *inDevice, ExaltArchive *archive, IODevice *outDevice);
+
+  //! Read the directory of a solid archive.
+  virtual bool listArchive(IODevice *inDevice, ExaltArchive *archive);
+
 
 
 protected:
+  //! Read the header of the compressed data.
+  virtual bool readHeader(int *modelByte, bool checkDictionary = true);
+
+  //! Prepare the context and the arithmetic decoder for decoding.
+  virtual bool startDecoding(long *lastFixedContextSymbol);
+
+  //! Check whether the data continue after the end-of-message symbol.
+  virtual bool readSyncMark(void);
+
+  //! Read and decode the containers of the character data.
+  virtual bool readContainers(void);
+
+  //! Append one decoded symbol to the grammar.
+  virtual void appendDecodedSymbol(int symbol, long lastFixedContextSymbol);
+
+  //! Create the contexts of the rule events (explicit rules format).
+  virtual void createRuleContexts(void);
+
+  //! Delete the contexts of the rule events.
+  virtual void deleteRuleContexts(void);
+
+  //! Create the grammar of the encoder.
+  virtual void createEncoderGrammar(int *modelFlags);
+
+  //! Delete the grammar of the encoder.
+  virtual void deleteEncoderGrammar(void);
+
+  //! Create the table of the rules of the decoder (explicit rules and Re-Pair formats).
+  virtual void createRuleTable(void);
+
+  //! Delete the table of the rules of the decoder.
+  virtual void deleteRuleTable(void);
+
+  //! Create the SAX emitter for the receptor.
+  virtual SAXEmitter *createSAXEmitter(SAXReceptor *receptor);
+
+  //! Encode the members of the archive.
+  virtual long encodeArchiveMembers(ExaltArchive *archive, bool adaptive);
+
+  //! Read all segments of the archive.
+  virtual bool readArchive(ExaltArchive *archive, int *modelByte, bool reconstruct);
+
+  //! Decode one member of the archive.
+  virtual void decodeArchiveMember(ExaltArchive *archive, ArchiveMember *member, int modelByte, long lastFixedContextSymbol, bool reconstruct);
+
+  //! Replay the documents of the dictionary through the grammar and the context.
+  virtual void primeWithDictionary(void);
+
+  //! Read the sample of the input data.
+  virtual char *readSample(IOSize *length);
+
+  //! Select the model by encoding the sample with both models.
+  virtual ExaltOptions::OptionValue selectModel(const char *sample, IOSize length);
+
+  //! Encode the sample with the model and return the size of the output.
+  virtual IOSize encodeSample(ExaltOptions::OptionValue model, const char *sample, IOSize length, double *seconds);
+
+  //! Delete the objects of the PUSH decoder.
+  virtual void deletePushDecoder(void);
+
   //! The input device.
   IODevice *inputDevice;
 
@@ -89,11 +324,80 @@ protected:
   //! The KY grammar.
   KYGrammar *kyGrammar;
 
+  //! The Re-Pair grammar (encoder only).
+  RePairGrammar *rePairGrammar;
+
+  //! The grammar of the encoder (either \a kyGrammar, or \a rePairGrammar).
+  GrammarBase *grammar;
+
+  //! The context of the rule bodies (Re-Pair format only).
+  Context *ruleBodyContext;
+
   //! The arithmetic coding context.
   Context *context;
 
   //! The arithmetic coder/decoder.
   ArithCodec *arithCodec;
+
+  //! The contexts of the rule events (explicit rules format only).
+  ContextBase **ruleContexts;
+
+  //! The table of the rules used instead of the grammar by the decoder of the explicit rules format and of the Re-Pair format.
+  KYRuleTable *ruleTable;
+
+  //! Indication whether the data read by readHeader() use the explicit rules format.
+  bool explicitRules;
+
+  //! Indication whether the data read by readHeader() use the Re-Pair format.
+  bool rePair;
+
+  //! Indication whether the data read by readHeader() use the containers.
+  bool useContainers;
+
+  //! The maximal size of the graphs of the elements (0 if not limited).
+  size_t graphLimit;
+
+  //! The containers of the character data (if used).
+  XmlContainerSet *containers;
+
+  //! The coder of the numeric and date values (if used).
+  XmlTypedValues *typedValues;
+
+  //! The cache of the recently used values (if used).
+  XmlValueCache *valueCache;
+
+  //! The dictionary of the words of the character data (if used).
+  XmlWordTokens *wordTokens;
+
+  //! The buffer of the compressed structure, which is written after the containers (encoder only).
+  BufferDevice *structureDevice;
+
+  //! The buffer of the compressed data (PUSH decoder).
+  BufferDevice *pushBuffer;
+
+  //! The device which delivers the decoded data to the model (PUSH decoder).
+  FunnelDevice *pushFunnelDevice;
+
+  //! The SAX emitter (PUSH decoder).
+  SAXEmitter *pushSAXEmitter;
+
+  //! The SAX receptor (PUSH decoder).
+  SAXReceptor *pushReceptor;
+
+  //! The user data passed to the SAX receptor (PUSH decoder).
+  void *pushUserData;
+
+  //! The last fixed symbol of the context (PUSH decoder).
+  long pushLastFixedContextSymbol;
+
+  //! The model byte read from the header (PUSH decoder).
+  int pushModelByte;
+
+  //! The length of the container section, 0 if not known yet (PUSH decoder).
+  size_t pushContainerSectionLength;
+
+  //! The state of the PUSH decoder.
+  PushDecoderState pushDecoderState;
 };
 
 
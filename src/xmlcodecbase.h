@@ -31,10 +31,13 @@
 
 
 #include "defs.h"
+#include "exaltarchive.h"
+#include "exaltdictionary.h"
 #include "options.h"
 #include "iodevice.h"
 #include "textcodec.h"
 #include "saxreceptor.h"
+#include "xmlpathfilter.h"
 
 
 
@@ -48,7 +51,10 @@ enum XmlCoderType
   PullCoder,
 
   //! A PUSH coder.
-  PushCoder
+  PushCoder,
+
+  //! A PUSH decoder.
+  PushDecoder
 };
 
 
@@ -63,7 +69,7 @@ class XmlCodecBase : public UserOfTextCodec
 {
 public:
   //! A constructor.
-  XmlCodecBase(void) : UserOfTextCodec() { coderType = UnknownCoder; }
+  XmlCodecBase(void) : UserOfTextCodec() { coderType = UnknownCoder; dictionary = 0; pathFilter = 0; }
 
   /*!
     \brief A destructor.
@@ -97,6 +103,13 @@ public:
    */
   virtual bool encodePush(const char *data, int length, bool isFinal = false) = 0;
 
+  /*!
+    \brief Make the data encoded so far decodable (PUSH mode).
+
+    The coder encodes all pending symbols and terminates the arithmetic code, so the decoder can reconstruct all the data pushed so far without waiting for more input. The state of the model, the grammar and the context is kept.
+   */
+  virtual void sync(void) = 0;
+
   /*!
     \brief Decode data from one device and use given SAX receptor.
 
@@ -106,9 +119,85 @@ public:
    */
   virtual bool decode(IODevice *inDevice, SAXReceptor *receptor, void *userData = 0) = 0;
 
+  /*!
+    \brief Initialize the decoder in PUSH mode.
+
+    \param receptor The SAX event receptor.
+    \param userData The user data structure.
+   */
+  virtual void initializePushDecoder(SAXReceptor *receptor, void *userData = 0) = 0;
+
+  /*!
+    \brief Decode the data in PUSH mode.
+
+    The decoder decodes given chunk of compressed data and emits the SAX events as soon as the data suffice.
+
+    \param data The chunk of compressed data.
+    \param length The length of the data.
+    \param isFinal Indication whether the decoder received the last chunk of data.
+   */
+  virtual bool decodePush(const char *data, int length, bool isFinal = false) = 0;
+
+  /*!
+    \brief Encode several documents into one solid archive.
+
+    \param archive The directory of the archive with the input devices of the members.
+    \param outDevice The output device.
+   */
+  virtual bool encodeArchive(ExaltArchive *archive, IODevice *outDevice) = 0;
+
+  /*!
+    \brief Decode the members of a solid archive.
+
+    \param inDevice The input device.
+    \param archive The archive which receives the directory and the members.
+   */
+  virtual bool decodeArchive(IODevice *inDevice, ExaltArchive *archive) = 0;
+
+  /*!
+    \brief Append documents to an existing solid archive.
+
+    \param inDevice The input device with the existing archive.
+    \param archive The directory of the new members with their input devices.
+    \param outDevice The output device (positioned at the end of the existing archive).
+   */
+  virtual bool appendArchive(IODevice *inDevice, ExaltArchive *archive, IODevice *outDevice) = 0;
+
+  /*!
+    \brief Read the directory of a solid archive.
+
+    \param inDevice The input device.
+    \param archive The archive which receives the directory.
+   */
+  virtual bool listArchive(IODevice *inDevice, ExaltArchive *archive) = 0;
+
+  /*!
+    \brief Set the pre-trained dictionary.
+
+    The dictionary has to be set before the coding starts. The same dictionary has to be used both for encoding and decoding. The codec doesn't take the ownership of the dictionary.
+
+    \param dict The dictionary (NULL means no dictionary).
+   */
+  virtual void setDictionary(ExaltDictionary *dict) { dictionary = dict; }
+
+  /*!
+    \brief Set the path filter for the decoding.
+
+    Only the subtrees matching the path are emitted by the decoder. The codec doesn't take the ownership of the filter.
+
+    \param filter The path filter (NULL means no filtering).
+   */
+  virtual void setPathFilter(XmlPathFilter *filter) { pathFilter = filter; }
+
 protected:
   //! The type of the coder.
   XmlCoderType coderType;
+
+  //! The pre-trained dictionary.
+  ExaltDictionary *dictionary;
+
+  //! The path filter used for the decoding.
+  XmlPathFilter *pathFilter;
 };
 
 
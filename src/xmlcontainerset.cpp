@@ -0,0 +1,536 @@
+/***************************************************************************
+    xmlcontainerset.cpp  -  Definitions of XmlContainerSet class methods.
+                             -------------------
+    begin                : October 19 2026
+    copyright            : (C) 2003 by Vojtch Toman
+    email                : vtoman@lit.cz
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+
+
+/*!
+  \file xmlcontainerset.cpp
+  \brief Definitions of XmlContainerSet class methods.
+  
+  This file contains the definitions of XmlContainerSet class methods.
+*/
+
+#ifdef __GNUG__
+# pragma implementation
+#endif
+
+
+#include "xmlcontainerset.h"
+#include "fibonacci.h"
+
+
+
+/*!
+  Creates an empty set.
+ */
+XmlContainerSet::XmlContainerSet(void)
+  : UserOfTextCodec()
+{
+  NEW(containers, XmlContainerTable);
+  NEW(containerList, List<XmlContainer>);
+
+  NEW(pathTable, XmlContainerPath*[XML_CONTAINER_SET_PATH_TABLE_SIZE]);
+
+  for (size_t i = 0; i < XML_CONTAINER_SET_PATH_TABLE_SIZE; i++)
+    pathTable[i] = 0;
+
+  NEW(pathStack, Stack<XmlContainerPath>);
+
+  //key 0 means "no path"
+  pathCounter = 1;
+}
+
+
+
+/*!
+  Deletes the containers (the pending data are not written, see write()) and the paths.
+ */
+XmlContainerSet::~XmlContainerSet(void)
+{
+  XmlContainer *container;
+  XmlContainerPath *path;
+
+  for (container = containerList->first(); container; container = containerList->next())
+    {
+      if (container->grammar)
+	DELETE(container->grammar);
+
+      if (container->context)
+	DELETE(container->context);
+
+      if (container->arithCodec)
+	DELETE(container->arithCodec);
+
+      if (container->device)
+	DELETE(container->device);
+
+      if (container->data)
+	DELETE_ARRAY(container->data);
+
+      DELETE(container);
+    }
+
+  DELETE(containerList);
+  DELETE(containers);
+
+  for (size_t i = 0; i < XML_CONTAINER_SET_PATH_TABLE_SIZE; i++)
+    while ((path = pathTable[i]))
+      {
+	pathTable[i] = path->next;
+	DELETE(path);
+      }
+
+  DELETE_ARRAY(pathTable);
+  DELETE(pathStack);
+}
+
+
+
+/*!
+  The path of the element (the current path extended by the element) becomes the current path.
+
+  \param elementId The id of the element.
+ */
+void XmlContainerSet::enterElement(unsigned long elementId)
+{
+  pathStack->push(findPath(textKey(), 2 * elementId));
+}
+
+
+
+/*!
+  The path of the parent element becomes the current path.
+ */
+void XmlContainerSet::leaveElement(void)
+{
+  pathStack->pop();
+}
+
+
+
+/*!
+  \return The key of the current path (0 outside of the elements).
+ */
+unsigned long XmlContainerSet::textKey(void)
+{
+  XmlContainerPath *path = pathStack->top();
+
+  return path ? path->key : 0;
+}
+
+
+
+/*!
+  The attributes are coded before the name of their element, so the key is given by the path of the parent element and by the name of the attribute.
+
+  \param attributeId The id of the attribute.
+  \return The key of the values of the attribute.
+ */
+unsigned long XmlContainerSet::valueKey(unsigned long attributeId)
+{
+  return findPath(textKey(), 2 * attributeId + 1)->key;
+}
+
+
+
+/*!
+  The container is created at the first call for the key. If the maximal number of containers (XML_CONTAINER_SET_MAX_CONTAINERS) has been reached, no new container is created and the data of the key have to be coded elsewhere.
+
+  \param key The key of the path.
+  \return The grammar of the container, or NULL if the key has no container.
+ */
+GrammarBase *XmlContainerSet::grammar(unsigned long key)
+{
+  XmlContainer *container;
+
+  if (!key)
+    return 0;
+
+  if (!(container = containers->find(key)))
+    {
+      if (containerList->count() >= XML_CONTAINER_SET_MAX_CONTAINERS)
+	return 0;
+
+      container = createContainer(key);
+    }
+
+  return container->grammar;
+}
+
+
+
+/*!
+  The grammars of the containers encode all pending data, the arithmetic codes are finished and the containers are written to the device (see XmlContainerSet for the format).
+
+  \param outDevice The output device.
+ */
+void XmlContainerSet::write(IODevice *outDevice)
+{
+  XmlContainer *container;
+  size_t sectionLength = XML_CONTAINER_SET_NUMBER_SIZE;
+  char *buf;
+  IOSize length;
+
+  for (container = containerList->first(); container; container = containerList->next())
+    {
+      //the grammar encodes the pending data when it is deleted
+      DELETE(container->grammar);
+
+      container->context->encodeEndOfMessage();
+      container->arithCodec->finishEncode();
+      container->arithCodec->doneOutputtingBits();
+
+      sectionLength += 2 * XML_CONTAINER_SET_NUMBER_SIZE + container->device->bytesAvailable();
+    }
+
+  writeNumber(outDevice, sectionLength);
+  writeNumber(outDevice, containerList->count());
+
+  for (container = containerList->first(); container; container = containerList->next())
+    {
+      length = container->device->bytesAvailable();
+
+      writeNumber(outDevice, container->key);
+      writeNumber(outDevice, length);
+
+      NEW(buf, char[length + 1]);
+      container->device->readData(buf, length);
+      outDevice->writeData(buf, length);
+      DELETE_ARRAY(buf);
+
+      if (ExaltOptions::getOption(ExaltOptions::Verbose) == ExaltOptions::Yes)
+	OUTPUTENL("  Container " << container->key << ": \t\t\t" << length << " B");
+
+      DELETE(container->context);
+      DELETE(container->arithCodec);
+      DELETE(container->device);
+    }
+}
+
+
+
+/*!
+  The length is stored in front of the container section, so the PUSH decoder can wait until the whole section is available.
+
+  \param inDevice The input device.
+  \param length The variable where the length of the rest of the section is stored.
+
+  \return False if the data end prematurely, true otherwise.
+ */
+bool XmlContainerSet::readSectionLength(IODevice *inDevice, size_t *length)
+{
+  return readNumber(inDevice, length);
+}
+
+
+
+/*!
+  Reads the containers (the length of the section has to be read by readSectionLength()) and decodes their data.
+
+  \param inDevice The input device.
+
+  \return False if the data end prematurely, true otherwise.
+ */
+bool XmlContainerSet::read(IODevice *inDevice)
+{
+  XmlContainer *container;
+  BufferDevice *device;
+  size_t nrContainers;
+  size_t key;
+  size_t length;
+  char *buf;
+  bool result;
+
+  if (!readNumber(inDevice, &nrContainers))
+    return false;
+
+  for (size_t i = 0; i < nrContainers; i++)
+    {
+      if (!readNumber(inDevice, &key) || !readNumber(inDevice, &length))
+	return false;
+
+      //the arithmetic decoder must not read the data of the next container
+      NEW(buf, char[length + 1]);
+      inDevice->readData(buf, length);
+
+      if (inDevice->errorOccurred() || inDevice->bytesRead() != length)
+	{
+	  DELETE_ARRAY(buf);
+	  return false;
+	}
+
+      NEW(device, BufferDevice);
+      device->prepare();
+      device->writeData(buf, length);
+      DELETE_ARRAY(buf);
+
+      NEW(container, XmlContainer);
+      container->key = key;
+      container->grammar = 0;
+      container->context = 0;
+      container->arithCodec = 0;
+      container->device = 0;
+      container->data = 0;
+      container->length = 0;
+      container->position = 0;
+
+      containers->insert(key, container);
+      containerList->append(container);
+
+      result = decodeContainer(container, device);
+      DELETE(device);
+
+      if (!result)
+	return false;
+    }
+
+  return true;
+}
+
+
+
+/*!
+  Each data item (the character data, or the value of an attribute) ends with the "end of block" symbol. The items of the container are fetched in the same order as they were appended by the encoder.
+
+  \param key The key of the path.
+  \param length The variable where the length of the item (including the "end of block" symbol) is stored.
+
+  \return The data of the item.
+ */
+XmlChar *XmlContainerSet::fetch(unsigned long key, size_t *length)
+{
+  XmlContainer *container;
+  size_t end;
+
+  if (!(container = containers->find(key)))
+    FATAL("Missing container " << key << "!");
+
+  for (end = container->position; end < container->length && container->data[end]; end++);
+
+  if (end == container->length)
+    FATAL("Container " << key << " exhausted!");
+
+  *length = end + 1 - container->position;
+  container->position = end + 1;
+
+  return container->data + end + 1 - *length;
+}
+
+
+
+/*!
+  The paths are kept in a hash table with chaining. A new path gets the next unused key.
+
+  \param parent The key of the parent path.
+  \param name The id of the element (or attribute) extending the path.
+
+  \return The path.
+ */
+XmlContainerPath *XmlContainerSet::findPath(unsigned long parent, unsigned long name)
+{
+  size_t pos = (parent * 31 + name) % XML_CONTAINER_SET_PATH_TABLE_SIZE;
+  XmlContainerPath *path;
+
+  for (path = pathTable[pos]; path; path = path->next)
+    if (path->parent == parent && path->name == name)
+      return path;
+
+  NEW(path, XmlContainerPath);
+  path->parent = parent;
+  path->name = name;
+  path->key = pathCounter++;
+  path->next = pathTable[pos];
+  pathTable[pos] = path;
+
+  return path;
+}
+
+
+
+/*!
+  The grammar of the container writes its compressed data (the size of the alphabet first) to the device of the container.
+
+  \param key The key of the path.
+  \return The container.
+ */
+XmlContainer *XmlContainerSet::createContainer(unsigned long key)
+{
+  XmlContainer *container;
+
+  NEW(container, XmlContainer);
+  container->key = key;
+  container->data = 0;
+  container->length = 0;
+  container->position = 0;
+
+  NEW(container->device, BufferDevice);
+  container->device->prepare();
+
+  NEW(container->context, Context);
+  NEW(container->arithCodec, ArithCodec);
+  container->context->setArithCodec(container->arithCodec);
+
+  container->arithCodec->setOutputDevice(container->device);
+  container->arithCodec->startOutputtingBits();
+  container->arithCodec->startEncode();
+
+  NEW(container->grammar, KYGrammar);
+  container->grammar->setContext(container->context);
+  container->grammar->setOutputDevice(container->device);
+  container->grammar->setTextCodec(textCodec);
+
+  containers->insert(key, container);
+  containerList->append(container);
+
+  return container;
+}
+
+
+
+/*!
+  The data are decoded by a KYGrammar of their own into the buffer of the container.
+
+  \param container The container.
+  \param inDevice The device with the compressed data of the container.
+
+  \return False if the data end prematurely, true otherwise.
+ */
+bool XmlContainerSet::decodeContainer(XmlContainer *container, IODevice *inDevice)
+{
+  KYGrammar *kyGrammar;
+  Context *context;
+  ArithCodec *arithCodec;
+  BufferDevice *outDevice;
+  FibonacciDecoderState fibDecoder;
+  unsigned long alphabetBaseSize;
+  bool finished = false;
+  long lastFixedContextSymbol;
+  int symbol;
+  RuleElement *rel;
+  int c;
+
+  //read the Fibonacci code of the base size of the terminal alphabet
+  Fibonacci::resetDecoder(&fibDecoder);
+
+  while (!finished)
+    {
+      inDevice->getChar(&c);
+      if (inDevice->errorOccurred() || inDevice->eof())
+	return false;
+
+      finished = Fibonacci::decodeChar(&fibDecoder, (unsigned char)c, &alphabetBaseSize);
+    }
+
+  NEW(kyGrammar, KYGrammar);
+  NEW(context, Context);
+  kyGrammar->setContext(context, false);
+  kyGrammar->setTextCodec(textCodec);
+
+  NEW(arithCodec, ArithCodec);
+  context->setArithCodec(arithCodec);
+
+  context->setType(alphabetBaseSize, DynamicContext);
+  lastFixedContextSymbol = context->initialize();
+
+  NEW(outDevice, BufferDevice);
+  outDevice->prepare();
+  kyGrammar->setOutputDevice(outDevice);
+
+  arithCodec->setInputDevice(inDevice);
+  arithCodec->startInputtingBits();
+  arithCodec->startDecode();
+
+  while ((symbol = context->decode()) != context->endOfMessage)
+    {
+      if (symbol == Context::NotKnown)
+	FATAL("Unknown symbol decoded!!!");
+
+      rel = kyGrammar->newRuleElement();
+
+      if (symbol > lastFixedContextSymbol)
+	{
+	  //decoded a variable
+	  rel->type = Variable;
+	  rel->rule = kyGrammar->findRule(symbol - lastFixedContextSymbol);
+
+	  CHECK_POINTER(rel->rule);
+
+	  rel->rule->refCount++;
+	}
+      else
+	{
+	  //decoded a terminal
+	  rel->type = Terminal;
+	  rel->value = symbol;
+	}
+
+      kyGrammar->appendToRootRule(rel);
+    }
+
+  arithCodec->finishDecode();
+  arithCodec->doneInputtingBits();
+
+  DELETE(kyGrammar);
+  DELETE(arithCodec);
+  DELETE(context);
+
+  container->length = outDevice->bytesAvailable() / SIZEOF_XML_CHAR;
+  NEW(container->data, XmlChar[container->length + 1]);
+  outDevice->readData((char *)container->data, container->length * SIZEOF_XML_CHAR);
+
+  DELETE(outDevice);
+
+  return true;
+}
+
+
+
+/*!
+  \param outDevice The output device.
+  \param number The number.
+ */
+void XmlContainerSet::writeNumber(IODevice *outDevice, size_t number)
+{
+  for (int i = XML_CONTAINER_SET_NUMBER_SIZE - 1; i >= 0; i--)
+    outDevice->putChar((number >> (8 * i)) & 0xff);
+}
+
+
+
+/*!
+  \param inDevice The input device.
+  \param number The variable where the number is stored.
+
+  \return False if the data end prematurely, true otherwise.
+ */
+bool XmlContainerSet::readNumber(IODevice *inDevice, size_t *number)
+{
+  int byte;
+
+  *number = 0;
+
+  for (int i = 0; i < XML_CONTAINER_SET_NUMBER_SIZE; i++)
+    {
+      inDevice->getChar(&byte);
+      if (inDevice->errorOccurred() || inDevice->eof())
+	return false;
+
+      *number = (*number << 8) | (byte & 0xff);
+    }
+
+  return true;
+}
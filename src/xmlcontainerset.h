@@ -0,0 +1,222 @@
+/***************************************************************************
+    xmlcontainerset.h  -  Definition of XmlContainerSet class.
+                             -------------------
+    begin                : October 19 2026
+    copyright            : (C) 2003 by Vojtch Toman
+    email                : vtoman@lit.cz
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+
+
+/*!
+  \file xmlcontainerset.h
+  \brief Definition of XmlContainerSet class.
+  
+  This file contains the definition of XmlContainerSet class.
+*/
+
+#ifdef __GNUG__
+# pragma interface
+#endif
+
+#ifndef XMLCONTAINERSET_H
+#define XMLCONTAINERSET_H
+
+
+#include "defs.h"
+#include "arithcodec.h"
+#include "bufferdevice.h"
+#include "context.h"
+#include "grammarbase.h"
+#include "hashtable.h"
+#include "iodevice.h"
+#include "kygrammar.h"
+#include "list.h"
+#include "stack.h"
+#include "textcodec.h"
+#include "xmlchar.h"
+
+
+
+/*!
+  \brief The maximal number of containers.
+
+  Each container has its own grammar, so the number of containers is limited to keep the memory requirements reasonable. The data of the paths without a container are coded together with the structure.
+ */
+#define XML_CONTAINER_SET_MAX_CONTAINERS	64
+
+
+/*!
+  \brief The size of the hash table of the paths.
+ */
+#define XML_CONTAINER_SET_PATH_TABLE_SIZE	1021
+
+
+/*!
+  \brief The size of the fixed-length numbers in the container section.
+ */
+#define XML_CONTAINER_SET_NUMBER_SIZE		4
+
+
+
+/*!
+  \brief A path of the document.
+
+  The path is identified by the path of its parent and by the id of its last element (or attribute). The paths are numbered in the order of their first occurrence, so the encoder and the decoder assign the same keys to them.
+ */
+struct XmlContainerPath
+{
+  //! The key of the parent path (0 for the root).
+  unsigned long parent;
+
+  //! The id of the element (or attribute) extending the parent path.
+  unsigned long name;
+
+  //! The key of the path.
+  unsigned long key;
+
+  //! The next path in the same bucket of the hash table.
+  XmlContainerPath *next;
+};
+
+
+
+/*!
+  \brief A container of the data of one path.
+
+  During encoding, the data are appended to the grammar of the container, which writes its compressed form to the device. During decoding, the data are decoded at once and read from the buffer.
+ */
+struct XmlContainer
+{
+  //! The key of the path of the container.
+  unsigned long key;
+
+  //! The grammar of the container (encoding only).
+  KYGrammar *grammar;
+
+  //! The coding context of the grammar (encoding only).
+  Context *context;
+
+  //! The arithmetic coder of the container (encoding only).
+  ArithCodec *arithCodec;
+
+  //! The compressed data of the container (encoding only).
+  BufferDevice *device;
+
+  //! The decoded data (decoding only).
+  XmlChar *data;
+
+  //! The length of the decoded data.
+  size_t length;
+
+  //! The position of the first unread symbol of the decoded data.
+  size_t position;
+};
+
+
+//! Hashtable of the containers (keys are the keys of the paths).
+typedef HashTable<unsigned long, XmlContainer, List, 257> XmlContainerTable;
+
+
+
+/*!
+  \brief A set of containers of the character data.
+
+  The character data (and the attribute values) of the same path tend to be similar to each other, and unlike the data of the other paths (names vs. numbers vs. prose). The model therefore can route the data to separate containers keyed by the path of the enclosing element (or by the path of the parent element and the name of the attribute, since the attributes are coded before the name of the element). Each container has its own KYGrammar, coding context and arithmetic coder, so its grammar is small and the rules are searched only among the similar data. The containers are independent of each other and of the structure.
+
+  The containers are stored in front of the structure:
+  - the length of the container section (excluding this number),
+  - the number of containers,
+  - for each container: the key of its path, the length of its compressed data, and the data (the alphabet size followed by the arithmetic code).
+
+  All numbers are stored in XML_CONTAINER_SET_NUMBER_SIZE bytes (most significant byte first). The decoder decodes all containers at once before the structure is decoded.
+
+  \sa XmlSimpleModel
+ */
+class XmlContainerSet : public UserOfTextCodec
+{
+public:
+  //! A constructor.
+  XmlContainerSet(void);
+
+  //! A destructor.
+  virtual ~XmlContainerSet(void);
+
+  //! Enter an element.
+  virtual void enterElement(unsigned long elementId);
+
+  //! Leave the current element.
+  virtual void leaveElement(void);
+
+  //! Return the key of the character data of the current element.
+  virtual unsigned long textKey(void);
+
+  //! Return the key of the values of the attribute of the current element.
+  virtual unsigned long valueKey(unsigned long attributeId);
+
+  //! Return the grammar of the container (encoding).
+  virtual GrammarBase *grammar(unsigned long key);
+
+  //! Finish the encoding and write the containers.
+  virtual void write(IODevice *outDevice);
+
+  //! Read the length of the container section.
+  static bool readSectionLength(IODevice *inDevice, size_t *length);
+
+  //! Read and decode the containers.
+  virtual bool read(IODevice *inDevice);
+
+  //! Fetch the next data item of the container (decoding).
+  virtual XmlChar *fetch(unsigned long key, size_t *length);
+
+  /*!
+    \brief Get the number of containers.
+
+    \return The number of containers.
+   */
+  virtual size_t count(void) { return containerList->count(); }
+
+protected:
+  //! The containers.
+  XmlContainerTable *containers;
+
+  //! The containers in the order of their creation.
+  List<XmlContainer> *containerList;
+
+  //! The hash table of the paths.
+  XmlContainerPath **pathTable;
+
+  //! The paths of the open elements.
+  Stack<XmlContainerPath> *pathStack;
+
+  //! The number of paths.
+  unsigned long pathCounter;
+
+  //! Find (or create) the path.
+  virtual XmlContainerPath *findPath(unsigned long parent, unsigned long name);
+
+  //! Create a container for the encoding.
+  virtual XmlContainer *createContainer(unsigned long key);
+
+  //! Decode the compressed data of the container.
+  virtual bool decodeContainer(XmlContainer *container, IODevice *inDevice);
+
+  //! Write the number in XML_CONTAINER_SET_NUMBER_SIZE bytes.
+  static void writeNumber(IODevice *outDevice, size_t number);
+
+  //! Read the number stored in XML_CONTAINER_SET_NUMBER_SIZE bytes.
+  static bool readNumber(IODevice *inDevice, size_t *number);
+};
+
+
+
+#endif //XMLCONTAINERSET_H
@@ -0,0 +1,874 @@
+/***************************************************************************
+    xmldtd.cpp  -  Definitions of XmlDtd class methods.
+                             -------------------
+    begin                : October 19 2026
+    copyright            : (C) 2003 by Vojtch Toman
+    email                : vtoman@lit.cz
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+
+
+/*!
+  \file xmldtd.cpp
+  \brief Definitions of XmlDtd class methods.
+  
+  This file contains the definitions of XmlDtd class methods.
+*/
+
+#ifdef __GNUG__
+# pragma implementation
+#endif
+
+
+#include <cstring>	//for memcpy(), memset(), strncmp()
+
+#include "xmldtd.h"
+
+
+
+/*!
+  \brief Test whether the character may be a part of a name.
+
+  \param _c_ The character.
+*/
+#define IS_NAME_CHARACTER(_c_)							\
+  (((_c_) >= 'a' && (_c_) <= 'z') || ((_c_) >= 'A' && (_c_) <= 'Z') ||		\
+   ((_c_) >= '0' && (_c_) <= '9') || (_c_) == '.' || (_c_) == '-' ||		\
+   (_c_) == '_' || (_c_) == ':' || (unsigned char)(_c_) >= 0x80)
+
+
+/*!
+  \brief Test whether the character is a white space.
+
+  \param _c_ The character.
+*/
+#define IS_SPACE_CHARACTER(_c_)							\
+  ((_c_) == ' ' || (_c_) == '\t' || (_c_) == '\r' || (_c_) == '\n')
+
+
+/*!
+  \brief Skip the white space.
+
+  \param _data_ The data.
+  \param _length_ The length of the data.
+  \param _pos_ The position in the data (it is moved behind the white space).
+*/
+#define SKIP_SPACES(_data_, _length_, _pos_)					\
+{										\
+  while ((_pos_) < (_length_) && IS_SPACE_CHARACTER((_data_)[_pos_]))		\
+    (_pos_)++;									\
+}
+
+
+/*!
+  \brief Skip a name.
+
+  \param _data_ The data.
+  \param _length_ The length of the data.
+  \param _pos_ The position in the data (it is moved behind the name).
+*/
+#define SKIP_NAME(_data_, _length_, _pos_)					\
+{										\
+  while ((_pos_) < (_length_) && IS_NAME_CHARACTER((_data_)[_pos_]))		\
+    (_pos_)++;									\
+}
+
+
+/*!
+  \brief Test whether the data at given position start with the string.
+
+  \param _data_ The data.
+  \param _length_ The length of the data.
+  \param _pos_ The position in the data.
+  \param _str_ The string.
+*/
+#define STARTS_WITH(_data_, _length_, _pos_, _str_)				\
+  ((_length_) - (_pos_) >= strlen(_str_) && !strncmp((_data_) + (_pos_), (_str_), strlen(_str_)))
+
+
+/*!
+  \brief Delete the content model.
+
+  \param _model_ The content model.
+*/
+#define DELETE_CONTENT_MODEL(_model_)			\
+{							\
+  if ((_model_)->positions)				\
+    {							\
+      DELETE_ARRAY((_model_)->elements);		\
+      DELETE_ARRAY((_model_)->first);			\
+      DELETE_ARRAY((_model_)->last);			\
+      DELETE_ARRAY((_model_)->follow);			\
+    }							\
+							\
+  DELETE(_model_);					\
+}
+
+
+
+//! The types of the content particles.
+enum XmlContentParticleType
+{
+  //! An element name or \#PCDATA.
+  ParticleName,
+
+  //! A choice of the particles.
+  ParticleChoice,
+
+  //! A sequence of the particles.
+  ParticleSequence
+};
+
+
+/*!
+  \brief One content particle of the element declaration.
+
+  The particles form the syntactic tree of the content model. The tree exists only while the declaration is being compiled.
+ */
+struct XmlContentParticle
+{
+  //! The type of the particle.
+  XmlContentParticleType type;
+
+  //! The occurrence indicator ('?', '*', '+', or 0).
+  char occurrence;
+
+  //! The position of the name in the content model (names only).
+  size_t position;
+
+  //! The index of the element (names only).
+  long element;
+
+  //! The particles of the choice or of the sequence.
+  List<XmlContentParticle> children;
+
+  //! Indication whether the particle matches the empty content.
+  bool nullable;
+
+  //! The positions which can start the particle.
+  bool *first;
+
+  //! The positions which can end the particle.
+  bool *last;
+};
+
+
+
+/*!
+  Creates an empty DTD.
+ */
+XmlDtd::XmlDtd(void)
+{
+  elementCount = 0;
+  elementsSize = XML_DTD_INITIAL_SIZE;
+
+  NEW(names, XmlChar *[elementsSize]);
+  NEW(models, XmlContentModel *[elementsSize]);
+  NEW(requiredAttributes, bool[elementsSize]);
+
+  NEW(elementIndices, XmlNameIds);
+  elementIndices->setAutoDelete(true);
+
+  NEW(entities, XmlDtdEntityTable);
+}
+
+
+
+/*!
+  Deletes the names and the content models of the elements and the parameter entities.
+ */
+XmlDtd::~XmlDtd(void)
+{
+  XmlDtdEntity *entity;
+
+  DELETE(elementIndices);
+
+  for (size_t i = 0; i < elementCount; i++)
+    {
+      DELETE_ARRAY(names[i]);
+
+      if (models[i])
+	DELETE_CONTENT_MODEL(models[i]);
+    }
+
+  DELETE_ARRAY(names);
+  DELETE_ARRAY(models);
+  DELETE_ARRAY(requiredAttributes);
+
+  DELETE(entities);
+
+  while ((entity = entityList.getFirst()))
+    {
+      DELETE_ARRAY(entity->name);
+      DELETE_ARRAY(entity->value);
+      DELETE(entity);
+    }
+}
+
+
+
+/*!
+  Reads the markup declarations of the DTD. The comments and the processing instructions are skipped, the conditional sections are read (INCLUDE) or skipped (IGNORE). The method can be called several times, the declarations which have been read earlier take precedence.
+
+  \param data The DTD.
+  \param length The length of the DTD.
+ */
+void XmlDtd::parse(const char *data, size_t length)
+{
+  size_t pos = 0;
+  size_t end;
+  char quote;
+
+  while (pos < length)
+    {
+      if (data[pos] != '<')
+	{
+	  //text between the declarations (e.g. the references to the external entities)
+	  pos++;
+	  continue;
+	}
+
+      if (STARTS_WITH(data, length, pos, "<!--"))
+	{
+	  //a comment
+	  for (pos += 4; pos < length && !STARTS_WITH(data, length, pos, "-->"); pos++) ;
+	  pos += 3;
+	  continue;
+	}
+
+      if (STARTS_WITH(data, length, pos, "<?"))
+	{
+	  //a processing instruction
+	  for (pos += 2; pos < length && !STARTS_WITH(data, length, pos, "?>"); pos++) ;
+	  pos += 2;
+	  continue;
+	}
+
+      if (STARTS_WITH(data, length, pos, "<!["))
+	{
+	  //a conditional section
+	  char *keyword = 0;
+	  size_t keywordLength = 0;
+	  size_t keywordSize = 0;
+	  size_t kwPos = 0;
+	  bool ignore;
+
+	  for (end = pos + 3; end < length && data[end] != '['; end++) ;
+
+	  //the keyword may be given by a parameter entity
+	  expand(data + pos + 3, end - pos - 3, &keyword, &keywordLength, &keywordSize, 0);
+	  SKIP_SPACES(keyword, keywordLength, kwPos);
+	  ignore = STARTS_WITH(keyword, keywordLength, kwPos, "IGNORE");
+
+	  if (keyword)
+	    DELETE_ARRAY(keyword);
+
+	  pos = end + 1;
+
+	  if (ignore)
+	    {
+	      //skip the section (including the nested sections)
+	      int nesting = 1;
+
+	      while (pos < length && nesting)
+		{
+		  if (STARTS_WITH(data, length, pos, "<!["))
+		    {
+		      nesting++;
+		      pos += 3;
+		    }
+		  else
+		    if (STARTS_WITH(data, length, pos, "]]>"))
+		      {
+			nesting--;
+			pos += 3;
+		      }
+		    else
+		      pos++;
+		}
+	    }
+
+	  continue;
+	}
+
+      if (STARTS_WITH(data, length, pos, "<!"))
+	{
+	  //a markup declaration --> find its end (the literals may contain '>')
+	  for (end = pos + 2, quote = 0; end < length; end++)
+	    {
+	      if (quote)
+		{
+		  if (data[end] == quote)
+		    quote = 0;
+		}
+	      else
+		if (data[end] == '"' || data[end] == '\'')
+		  quote = data[end];
+		else
+		  if (data[end] == '>')
+		    break;
+	    }
+
+	  parseDeclaration(data + pos + 2, end - pos - 2);
+	  pos = end + 1;
+	  continue;
+	}
+
+      pos++;
+    }
+}
+
+
+
+/*!
+  \param name The name of the element.
+
+  \return The index of the element, or -1 if the DTD doesn't know the element.
+ */
+long XmlDtd::find(const XmlChar *name)
+{
+  unsigned long *index = elementIndices->find((XmlChar *)name);
+
+  return index ? (long)*index : -1;
+}
+
+
+
+/*!
+  If the element is not known, it is added (without a content model).
+
+  \param name The name of the element (not terminated by zero).
+  \param length The length of the name.
+
+  \return The index of the element.
+ */
+size_t XmlDtd::elementIndex(const char *name, size_t length)
+{
+  XmlChar *elName;
+  unsigned long *index;
+
+  NEW(elName, XmlChar[length + 1]);
+  memcpy(elName, name, length);
+  elName[length] = 0;
+
+  if ((index = elementIndices->find(elName)))
+    {
+      DELETE_ARRAY(elName);
+      return *index;
+    }
+
+  if (elementCount == elementsSize)
+    {
+      //the arrays are full --> enlarge them
+      XmlChar **newNames;
+      XmlContentModel **newModels;
+      bool *newRequiredAttributes;
+
+      NEW(newNames, XmlChar *[2 * elementsSize]);
+      NEW(newModels, XmlContentModel *[2 * elementsSize]);
+      NEW(newRequiredAttributes, bool[2 * elementsSize]);
+
+      memcpy(newNames, names, elementCount * sizeof(XmlChar *));
+      memcpy(newModels, models, elementCount * sizeof(XmlContentModel *));
+      memcpy(newRequiredAttributes, requiredAttributes, elementCount * sizeof(bool));
+
+      DELETE_ARRAY(names);
+      DELETE_ARRAY(models);
+      DELETE_ARRAY(requiredAttributes);
+
+      names = newNames;
+      models = newModels;
+      requiredAttributes = newRequiredAttributes;
+      elementsSize *= 2;
+    }
+
+  names[elementCount] = elName;
+  models[elementCount] = 0;
+  requiredAttributes[elementCount] = false;
+
+  elementIndices->insert(elName, new unsigned long(elementCount));
+
+  return elementCount++;
+}
+
+
+
+/*!
+  The references to the unknown (or external) parameter entities are left out.
+
+  \param data The data.
+  \param length The length of the data.
+  \param buffer The buffer of the expanded data (it is enlarged if needed).
+  \param bufferLength The length of the expanded data.
+  \param bufferSize The size of the buffer.
+  \param depth The depth of the expansion.
+ */
+void XmlDtd::expand(const char *data, size_t length, char **buffer, size_t *bufferLength, size_t *bufferSize, int depth)
+{
+  size_t pos = 0;
+  size_t end;
+
+  while (pos < length)
+    {
+      if (data[pos] == '%')
+	{
+	  end = pos + 1;
+	  SKIP_NAME(data, length, end);
+
+	  if (end > pos + 1 && end < length && data[end] == ';')
+	    {
+	      //a parameter entity reference
+	      XmlChar *entityName;
+	      XmlDtdEntity *entity;
+
+	      NEW(entityName, XmlChar[end - pos]);
+	      memcpy(entityName, data + pos + 1, end - pos - 1);
+	      entityName[end - pos - 1] = 0;
+
+	      entity = entities->find(entityName);
+	      DELETE_ARRAY(entityName);
+
+	      if (entity && depth < XML_DTD_MAX_ENTITY_DEPTH)
+		{
+		  //the replacement text is surrounded by spaces
+		  expand(" ", 1, buffer, bufferLength, bufferSize, depth);
+		  expand(entity->value, entity->length, buffer, bufferLength, bufferSize, depth + 1);
+		  expand(" ", 1, buffer, bufferLength, bufferSize, depth);
+		}
+
+	      pos = end + 1;
+	      continue;
+	    }
+	}
+
+      if (*bufferLength == *bufferSize)
+	{
+	  //the buffer is full --> enlarge it
+	  char *newBuffer;
+	  size_t newSize = *bufferSize ? 2 * *bufferSize : 256;
+
+	  NEW(newBuffer, char[newSize]);
+
+	  if (*buffer)
+	    {
+	      memcpy(newBuffer, *buffer, *bufferLength);
+	      DELETE_ARRAY(*buffer);
+	    }
+
+	  *buffer = newBuffer;
+	  *bufferSize = newSize;
+	}
+
+      (*buffer)[(*bufferLength)++] = data[pos++];
+    }
+}
+
+
+
+/*!
+  The element declarations are compiled into the content models, the attribute list declarations are searched for the required attributes and the internal parameter entities are remembered. The other declarations are ignored.
+
+  \param data The declaration (without the leading "<!" and the trailing ">").
+  \param length The length of the declaration.
+ */
+void XmlDtd::parseDeclaration(const char *data, size_t length)
+{
+  char *text = 0;
+  size_t textLength = 0;
+  size_t textSize = 0;
+  size_t pos = 0;
+  size_t start;
+
+  expand(data, length, &text, &textLength, &textSize, 0);
+
+  if (!text)
+    return;
+
+  if (STARTS_WITH(text, textLength, pos, "ENTITY"))
+    {
+      pos += 6;
+      SKIP_SPACES(text, textLength, pos);
+
+      if (pos < textLength && text[pos] == '%')
+	{
+	  //a parameter entity
+	  XmlDtdEntity *entity;
+	  size_t nameEnd;
+	  size_t valueStart;
+	  char quote;
+
+	  pos++;
+	  SKIP_SPACES(text, textLength, pos);
+	  start = pos;
+	  SKIP_NAME(text, textLength, pos);
+	  nameEnd = pos;
+	  SKIP_SPACES(text, textLength, pos);
+
+	  if (nameEnd > start && pos < textLength && (text[pos] == '"' || text[pos] == '\''))
+	    {
+	      //an internal entity (the first declaration is binding)
+	      quote = text[pos++];
+
+	      for (valueStart = pos; pos < textLength && text[pos] != quote; pos++) ;
+
+	      NEW(entity, XmlDtdEntity);
+	      NEW(entity->name, XmlChar[nameEnd - start + 1]);
+	      memcpy(entity->name, text + start, nameEnd - start);
+	      entity->name[nameEnd - start] = 0;
+
+	      entity->length = pos - valueStart;
+	      NEW(entity->value, char[entity->length + 1]);
+	      memcpy(entity->value, text + valueStart, entity->length);
+
+	      if (entities->find(entity->name))
+		{
+		  DELETE_ARRAY(entity->name);
+		  DELETE_ARRAY(entity->value);
+		  DELETE(entity);
+		}
+	      else
+		{
+		  entities->insert(entity->name, entity);
+		  entityList.append(entity);
+		}
+	    }
+	}
+    }
+  else
+    if (STARTS_WITH(text, textLength, pos, "ELEMENT"))
+      {
+	size_t index;
+	XmlContentModel *model = 0;
+
+	pos += 7;
+	SKIP_SPACES(text, textLength, pos);
+	start = pos;
+	SKIP_NAME(text, textLength, pos);
+
+	if (pos > start)
+	  {
+	    index = elementIndex(text + start, pos - start);
+	    SKIP_SPACES(text, textLength, pos);
+
+	    if (STARTS_WITH(text, textLength, pos, "EMPTY"))
+	      {
+		//no content
+		NEW(model, XmlContentModel);
+		model->positions = 0;
+		model->nullable = true;
+		model->mixed = false;
+	      }
+	    else
+	      if (pos < textLength && text[pos] == '(')
+		{
+		  //the content model
+		  XmlContentParticle *particle;
+		  size_t positions = 0;
+
+		  if ((particle = parseParticle(text, textLength, &pos, &positions)))
+		    {
+		      NEW(model, XmlContentModel);
+		      model->positions = positions;
+		      model->mixed = false;
+
+		      NEW(model->elements, long[positions]);
+		      NEW(model->follow, bool[positions * positions]);
+		      memset(model->follow, 0, positions * positions * sizeof(bool));
+
+		      compileParticle(particle, model);
+
+		      //the sets of the whole content are taken over by the model
+		      model->first = particle->first;
+		      model->last = particle->last;
+		      model->nullable = particle->nullable;
+		      particle->first = 0;
+		      particle->last = 0;
+
+		      deleteParticle(particle);
+
+		      for (size_t i = 0; i < positions; i++)
+			if (model->elements[i] == XML_DTD_CHARACTERS)
+			  model->mixed = true;
+		    }
+		}
+
+	    //ANY and the unreadable declarations have no model
+	    if (model)
+	      {
+		if (models[index])
+		  {
+		    //the element has been declared already
+		    DELETE_CONTENT_MODEL(model);
+		  }
+		else
+		  models[index] = model;
+	      }
+	  }
+      }
+    else
+      if (STARTS_WITH(text, textLength, pos, "ATTLIST"))
+	{
+	  size_t index;
+	  char quote = 0;
+
+	  pos += 7;
+	  SKIP_SPACES(text, textLength, pos);
+	  start = pos;
+	  SKIP_NAME(text, textLength, pos);
+
+	  if (pos > start)
+	    {
+	      index = elementIndex(text + start, pos - start);
+
+	      //look for #REQUIRED outside the literals
+	      for (; pos < textLength; pos++)
+		{
+		  if (quote)
+		    {
+		      if (text[pos] == quote)
+			quote = 0;
+		    }
+		  else
+		    if (text[pos] == '"' || text[pos] == '\'')
+		      quote = text[pos];
+		    else
+		      if (STARTS_WITH(text, textLength, pos, "#REQUIRED"))
+			requiredAttributes[index] = true;
+		}
+	    }
+	}
+
+  DELETE_ARRAY(text);
+}
+
+
+
+/*!
+  The positions of the names are numbered in the order of their appearance.
+
+  \param data The declaration.
+  \param length The length of the declaration.
+  \param pos The position in the declaration (it is moved behind the particle).
+  \param positions The number of the positions read so far (it is updated).
+
+  \return The particle, or NULL if the declaration cannot be read.
+ */
+XmlContentParticle *XmlDtd::parseParticle(const char *data, size_t length, size_t *pos, size_t *positions)
+{
+  XmlContentParticle *particle;
+  XmlContentParticle *child;
+  char separator = 0;
+  size_t start;
+
+  SKIP_SPACES(data, length, *pos);
+
+  if (*pos >= length)
+    return 0;
+
+  NEW(particle, XmlContentParticle);
+  particle->occurrence = 0;
+  particle->first = 0;
+  particle->last = 0;
+
+  if (data[*pos] == '(')
+    {
+      //a choice or a sequence
+      (*pos)++;
+      particle->type = ParticleSequence;
+
+      for (;;)
+	{
+	  if (!(child = parseParticle(data, length, pos, positions)))
+	    {
+	      deleteParticle(particle);
+	      return 0;
+	    }
+
+	  particle->children.append(child);
+	  SKIP_SPACES(data, length, *pos);
+
+	  if (*pos < length && data[*pos] == ')')
+	    {
+	      (*pos)++;
+	      break;
+	    }
+
+	  if (*pos >= length || (data[*pos] != '|' && data[*pos] != ',') ||
+	      (separator && data[*pos] != separator))
+	    {
+	      deleteParticle(particle);
+	      return 0;
+	    }
+
+	  separator = data[(*pos)++];
+	}
+
+      if (separator == '|')
+	particle->type = ParticleChoice;
+    }
+  else
+    {
+      //an element name or #PCDATA
+      start = *pos;
+
+      if (data[*pos] == '#')
+	(*pos)++;
+
+      SKIP_NAME(data, length, *pos);
+
+      particle->type = ParticleName;
+      particle->position = (*positions)++;
+
+      if (data[start] == '#')
+	{
+	  if (*pos - start != 7 || strncmp(data + start, "#PCDATA", 7))
+	    {
+	      deleteParticle(particle);
+	      return 0;
+	    }
+
+	  particle->element = XML_DTD_CHARACTERS;
+	}
+      else
+	{
+	  if (*pos == start)
+	    {
+	      deleteParticle(particle);
+	      return 0;
+	    }
+
+	  particle->element = elementIndex(data + start, *pos - start);
+	}
+    }
+
+  if (*pos < length && (data[*pos] == '?' || data[*pos] == '*' || data[*pos] == '+'))
+    particle->occurrence = data[(*pos)++];
+
+  return particle;
+}
+
+
+
+/*!
+  The sets of the children are deleted when they are no longer needed, the follow set is stored directly in the model.
+
+  \param particle The content particle.
+  \param model The content model.
+ */
+void XmlDtd::compileParticle(XmlContentParticle *particle, XmlContentModel *model)
+{
+  size_t n = model->positions;
+  XmlContentParticle *child;
+
+  NEW(particle->first, bool[n]);
+  NEW(particle->last, bool[n]);
+  memset(particle->first, 0, n * sizeof(bool));
+  memset(particle->last, 0, n * sizeof(bool));
+
+  switch (particle->type)
+    {
+    case ParticleName:
+      particle->nullable = false;
+      particle->first[particle->position] = true;
+      particle->last[particle->position] = true;
+      model->elements[particle->position] = particle->element;
+      break;
+
+    case ParticleChoice:
+      particle->nullable = false;
+
+      for (child = particle->children.first(); child; child = particle->children.next())
+	{
+	  compileParticle(child, model);
+
+	  particle->nullable = particle->nullable || child->nullable;
+
+	  for (size_t i = 0; i < n; i++)
+	    {
+	      particle->first[i] = particle->first[i] || child->first[i];
+	      particle->last[i] = particle->last[i] || child->last[i];
+	    }
+
+	  DELETE_ARRAY(child->first);
+	  DELETE_ARRAY(child->last);
+	}
+      break;
+
+    case ParticleSequence:
+      particle->nullable = true;
+
+      for (child = particle->children.first(); child; child = particle->children.next())
+	{
+	  compileParticle(child, model);
+
+	  //the child follows the positions which can end the preceding particles
+	  for (size_t i = 0; i < n; i++)
+	    if (particle->last[i])
+	      for (size_t j = 0; j < n; j++)
+		if (child->first[j])
+		  model->follow[i * n + j] = true;
+
+	  for (size_t i = 0; i < n; i++)
+	    {
+	      if (particle->nullable)
+		particle->first[i] = particle->first[i] || child->first[i];
+
+	      if (child->nullable)
+		particle->last[i] = particle->last[i] || child->last[i];
+	      else
+		particle->last[i] = child->last[i];
+	    }
+
+	  particle->nullable = particle->nullable && child->nullable;
+
+	  DELETE_ARRAY(child->first);
+	  DELETE_ARRAY(child->last);
+	}
+      break;
+    }
+
+  if (particle->occurrence == '*' || particle->occurrence == '+')
+    {
+      //the particle can be repeated
+      for (size_t i = 0; i < n; i++)
+	if (particle->last[i])
+	  for (size_t j = 0; j < n; j++)
+	    if (particle->first[j])
+	      model->follow[i * n + j] = true;
+    }
+
+  if (particle->occurrence == '*' || particle->occurrence == '?')
+    particle->nullable = true;
+}
+
+
+
+/*!
+  The children of the particle are deleted as well.
+
+  \param particle The content particle.
+ */
+void XmlDtd::deleteParticle(XmlContentParticle *particle)
+{
+  XmlContentParticle *child;
+
+  while ((child = particle->children.getFirst()))
+    deleteParticle(child);
+
+  if (particle->first)
+    DELETE_ARRAY(particle->first);
+
+  if (particle->last)
+    DELETE_ARRAY(particle->last);
+
+  DELETE(particle);
+}
@@ -0,0 +1,224 @@
+/***************************************************************************
+    xmldtd.h  -  Definition of XmlDtd class.
+                             -------------------
+    begin                : October 19 2026
+    copyright            : (C) 2003 by Vojtch Toman
+    email                : vtoman@lit.cz
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+
+
+/*!
+  \file xmldtd.h
+  \brief Definition of XmlDtd class.
+  
+  This file contains the definition of XmlDtd class.
+*/
+
+#ifdef __GNUG__
+# pragma interface
+#endif
+
+#ifndef XMLDTD_H
+#define XMLDTD_H
+
+
+#include "defs.h"
+#include "hashtable.h"
+#include "list.h"
+#include "xmlchar.h"
+#include "xmlnametable.h"
+
+
+
+/*!
+  \brief The element index of the positions representing the character data.
+
+  \sa XmlContentModel
+ */
+#define XML_DTD_CHARACTERS		-1
+
+
+/*!
+  \brief The maximal depth of the nested parameter entity references.
+
+  Deeper references are not expanded (this also stops recursive entities).
+ */
+#define XML_DTD_MAX_ENTITY_DEPTH	8
+
+
+/*!
+  \brief The initial size of the arrays of the elements.
+ */
+#define XML_DTD_INITIAL_SIZE		64
+
+
+
+/*!
+  \brief A compiled content model of one element.
+
+  The model is the position automaton of the content model: each occurrence of an element name (or of \#PCDATA) in the declaration is one position, and the content of the element is a path through the positions. Since the content models of XML are deterministic, the successors of each position are different elements.
+ */
+struct XmlContentModel
+{
+  //! The number of positions.
+  size_t positions;
+
+  //! The indices of the elements of the positions (XML_DTD_CHARACTERS for the character data).
+  long *elements;
+
+  //! Indication whether the position can be the first one (one item for each position).
+  bool *first;
+
+  //! Indication whether the position can be the last one (one item for each position).
+  bool *last;
+
+  //! Indication whether position \a j can follow position \a i (item \a i * \a positions + \a j).
+  bool *follow;
+
+  //! Indication whether the content can be empty.
+  bool nullable;
+
+  //! Indication whether the content is mixed (i.e. the character data are a part of the model).
+  bool mixed;
+};
+
+
+//! One internal parameter entity of the DTD.
+struct XmlDtdEntity
+{
+  //! The name of the entity.
+  XmlChar *name;
+
+  //! The replacement text of the entity.
+  char *value;
+
+  //! The length of the replacement text.
+  size_t length;
+};
+
+
+//! Hashtable of the parameter entities (keys are their names).
+typedef HashTable<XmlChar *, XmlDtdEntity, List, 257> XmlDtdEntityTable;
+
+
+struct XmlContentParticle;	//forward declaration, see xmldtd.cpp
+
+
+
+/*!
+  \brief The element declarations of a DTD.
+
+  The class reads the element declarations (and the attribute list declarations) of a DTD and compiles the content models of the elements into position automata (see XmlContentModel). The elements are numbered in the order of their first appearance in the DTD, so the numbering is the same whenever the same DTD is read.
+
+  The internal parameter entities are expanded, the external ones are ignored. The declarations which cannot be read are skipped: the DTD is used only to predict the structure of the documents, so the worst consequence is a worse prediction.
+
+  \sa XmlAdaptiveModel::setDtd()
+ */
+class XmlDtd
+{
+public:
+  //! A constructor.
+  XmlDtd(void);
+
+  //! A destructor.
+  virtual ~XmlDtd(void);
+
+  //! Read the declarations of the DTD.
+  virtual void parse(const char *data, size_t length);
+
+  /*!
+    \brief Get the number of the elements.
+
+    The elements include those which are only referenced by the content models.
+
+    \return The number of the elements.
+   */
+  virtual size_t count(void) { return elementCount; }
+
+  /*!
+    \brief Get the name of the element.
+
+    \param index The index of the element.
+
+    \return The name of the element.
+   */
+  virtual const XmlChar *getName(size_t index) { return names[index]; }
+
+  /*!
+    \brief Get the content model of the element.
+
+    \param index The index of the element.
+
+    \return The content model, or NULL if the element is not declared or if it may contain anything.
+   */
+  virtual XmlContentModel *getContentModel(size_t index) { return models[index]; }
+
+  /*!
+    \brief Test whether the element has some required attributes.
+
+    \param index The index of the element.
+
+    \return True if some attribute of the element is declared as \#REQUIRED, false otherwise.
+   */
+  virtual bool hasRequiredAttributes(size_t index) { return requiredAttributes[index]; }
+
+  //! Find the index of the element.
+  virtual long find(const XmlChar *name);
+
+protected:
+  //! The names of the elements.
+  XmlChar **names;
+
+  //! The content models of the elements.
+  XmlContentModel **models;
+
+  //! Indication whether the elements have some required attributes.
+  bool *requiredAttributes;
+
+  //! The number of the elements.
+  size_t elementCount;
+
+  //! The size of the arrays of the elements.
+  size_t elementsSize;
+
+  //! Hashtable of the indices of the elements (keys are the names).
+  XmlNameIds *elementIndices;
+
+  //! Hashtable of the parameter entities (keys are the names).
+  XmlDtdEntityTable *entities;
+
+  //! %List of the parameter entities.
+  List<XmlDtdEntity> entityList;
+
+  //! Find the index of the element, or add the element.
+  virtual size_t elementIndex(const char *name, size_t length);
+
+  //! Expand the parameter entity references.
+  virtual void expand(const char *data, size_t length, char **buffer, size_t *bufferLength, size_t *bufferSize, int depth);
+
+  //! Process one markup declaration.
+  virtual void parseDeclaration(const char *data, size_t length);
+
+  //! Read one content particle of the element declaration.
+  virtual XmlContentParticle *parseParticle(const char *data, size_t length, size_t *pos, size_t *positions);
+
+  //! Compute the first, last and follow sets of the content particle.
+  virtual void compileParticle(XmlContentParticle *particle, XmlContentModel *model);
+
+  //! Delete the content particle.
+  virtual void deleteParticle(XmlContentParticle *particle);
+};
+
+
+
+#endif //XMLDTD_H
@@ -34,7 +34,13 @@
 #include "list.h"
 #include "queue.h"
 #include "textcodec.h"
+#include "xmlcontainerset.h"
 #include "xmlmodelevents.h"
+#include "xmltypedvalues.h"
+#include "xmlvaluecache.h"
+#include "xmlwordtokens.h"
+#include "xmldtd.h"
+#include "xmlnametable.h"
 #include "saxemitter.h"
 #include "funneldevice.h"
 
@@ -107,14 +113,6 @@ typedef List<XmlChar> ElementNamesList;
 typedef List<XmlChar> AttributeNamesList;
 
 
-//! Hashtable of the element ids (keys are the element names).
-typedef HashTable<XmlChar *, unsigned long, List, 3079> ElementIds;
-
-//! Hashtable of the attribute ids (keys are the attribute names).
-typedef HashTable<XmlChar *, unsigned long, List, 3079> AttributeIds;
-
-
-
 /*!
   \brief An abstract predecessor of the XML models.
 
@@ -136,7 +134,7 @@ public:
   /*!
     \brief Manage one XML event.
 
-    This method should implement the encoding functionality of the model.
+    This method should implement the encoding functionality of the model. The event is owned by the caller and it is valid only during the call.
 
     \param event A XML event.
    */
@@ -155,6 +153,60 @@ public:
   //! Set the grammar for compression.
   virtual void setGrammar(GrammarBase *gr) = 0;
 
+  /*!
+    \brief Set the containers of the character data.
+
+    The models which don't route the data to containers ignore the call.
+
+    \param set The containers (NULL means that all data are coded by the grammar).
+   */
+  virtual void setContainers(XmlContainerSet *set) {}
+
+  /*!
+    \brief Set the coder of the numeric and date values.
+
+    The models which don't recognize the typed values ignore the call.
+
+    \param values The coder (NULL means that all values are coded as text).
+   */
+  virtual void setTypedValues(XmlTypedValues *values) {}
+
+  /*!
+    \brief Set the cache of the recently used values.
+
+    The models which don't code the repeated values by their indices ignore the call.
+
+    \param cache The cache (NULL means that all values are coded as text).
+   */
+  virtual void setValueCache(XmlValueCache *cache) {}
+
+  /*!
+    \brief Set the dictionary of the words of the character data.
+
+    The models which don't code the words by their ids ignore the call.
+
+    \param tokens The dictionary (NULL means that all words are coded as text).
+   */
+  virtual void setWordTokens(XmlWordTokens *tokens) {}
+
+  /*!
+    \brief Set the DTD of the documents.
+
+    The models which don't predict the structure of the elements ignore the call.
+
+    \param dtd The DTD (NULL means that the structure is learnt from the document only).
+   */
+  virtual void setDtd(XmlDtd *dtd) {}
+
+  /*!
+    \brief Set the maximal size of the graphs of the elements.
+
+    The models which don't build the graphs of the elements ignore the call.
+
+    \param limit The maximal number of nodes plus transitions of each graph (0 means no limit).
+   */
+  virtual void setGraphLimit(size_t limit) {}
+
   //! Set the SAX emitter.
   virtual void setSAXEmitter(SAXEmitter *emitter, void *data = 0) = 0;
 };
@@ -100,13 +100,17 @@ struct XmlStartElementEvent : public XmlModelEvent
     \brief A constructor.
     \param name The name of the element.
     \param attr An array of pairs [attribute name, value].
+    \param nameId The interned id of the element name.
+    \param attrIds An array of interned ids of the attribute names.
    */
-  XmlStartElementEvent(const XmlChar *name, const XmlChar **attr)
+  XmlStartElementEvent(const XmlChar *name, const XmlChar **attr, unsigned long nameId, const unsigned long *attrIds)
     : XmlModelEvent()
   {
     type = XmlModelEvent::StartElement;
     this->name = name;
     this->attr = attr;
+    this->nameId = nameId;
+    this->attrIds = attrIds;
   }
 
   //! Name of the element.
@@ -114,6 +118,16 @@ struct XmlStartElementEvent : public XmlModelEvent
 
   //! Array of attributes.
   const XmlChar **attr;
+
+  //! Interned id of the element name (see XmlNameTable).
+  unsigned long nameId;
+
+  /*!
+    \brief Array of interned ids of the attribute names.
+
+    The id of the name \a attr[i] is stored in \a attrIds[i/2].
+   */
+  const unsigned long *attrIds;
 };
 
 
@@ -127,16 +141,21 @@ struct XmlEndElementEvent : public XmlModelEvent
   /*!
     \brief A constructor.
     \param name The name of the element.
+    \param nameId The interned id of the element name.
    */
-  XmlEndElementEvent(const XmlChar *name)
+  XmlEndElementEvent(const XmlChar *name, unsigned long nameId)
     : XmlModelEvent()
   {
     type = XmlModelEvent::EndElement;
     this->name = name;
+    this->nameId = nameId;
   }
 
   //! Name of the element.
   const XmlChar *name;
+
+  //! Interned id of the element name (see XmlNameTable).
+  unsigned long nameId;
 };
 
 
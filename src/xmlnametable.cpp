@@ -0,0 +1,196 @@
+/***************************************************************************
+    xmlnametable.cpp  -  Definitions of XmlNameTable class methods
+                             -------------------
+    begin                : October 19 2026
+    copyright            : (C) 2003 by Vojtch Toman
+    email                : vtoman@lit.cz
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+
+/*!
+  \file xmlnametable.cpp
+  \brief Definition of XmlNameTable and XmlNameIdMap class methods.
+
+  This file contains definition of XmlNameTable and XmlNameIdMap class methods.
+*/
+
+
+#ifdef __GNUG__
+# pragma implementation
+#endif
+
+
+#include "xmlnametable.h"
+
+
+
+/*!
+  \brief Compute the slot of the pointer cache for given name pointer.
+
+  \param _ptr_ The name pointer.
+ */
+#define XML_NAME_CACHE_SLOT(_ptr_)	\
+  ((((size_t)(_ptr_)) >> 2) & (XML_NAME_CACHE_SIZE - 1))
+
+
+
+/*!
+  Creates the hashtable of the names and clears the pointer cache.
+ */
+XmlNameTable::XmlNameTable(void)
+{
+  NEW(nameIds, XmlNameIds);
+  nameIds->setAutoDelete(true);
+
+  namesSize = XML_NAME_TABLE_INITIAL_SIZE;
+  NEW(names, XmlChar *[namesSize]);
+
+  //id 0 is reserved for "no name"
+  names[0] = 0;
+  nameCounter = 1;
+
+  for (size_t i = 0; i < XML_NAME_CACHE_SIZE; i++)
+    {
+      cachedPointers[i] = 0;
+      cachedIds[i] = 0;
+    }
+}
+
+
+
+/*!
+  Frees all the interned names.
+ */
+XmlNameTable::~XmlNameTable(void)
+{
+  DELETE(nameIds);
+
+  for (unsigned long i = 1; i < nameCounter; i++)
+    DELETE_ARRAY(names[i]);
+
+  DELETE_ARRAY(names);
+}
+
+
+
+/*!
+  Looks up the id of given name. The pointer cache is examined first, then the hashtable. If the name is not known, it is copied and a new id is assigned to it.
+
+  \param name The name.
+  \return The id of the name.
+ */
+unsigned long XmlNameTable::intern(const XmlChar *name)
+{
+  size_t slot = XML_NAME_CACHE_SLOT(name);
+  unsigned long id;
+  unsigned long *idPtr;
+
+  if (cachedPointers[slot] == name && !xmlchar_strcmp(names[cachedIds[slot]], name))
+    //the same buffer with the same name as before
+    return cachedIds[slot];
+
+  if ((idPtr = nameIds->find((XmlChar *)name)))
+    id = *idPtr;
+  else
+    {
+      //unknown name --> intern it
+      XmlChar *nameCopy;
+
+      NEW(nameCopy, XmlChar[xmlchar_strlen(name) + 1]);
+      xmlchar_strcpy(nameCopy, name);
+
+      if (nameCounter >= namesSize)
+	{
+	  //enlarge the array of names
+	  XmlChar **newNames;
+
+	  NEW(newNames, XmlChar *[2 * namesSize]);
+	  memcpy(newNames, names, namesSize * sizeof(XmlChar *));
+	  DELETE_ARRAY(names);
+
+	  names = newNames;
+	  namesSize *= 2;
+	}
+
+      id = nameCounter++;
+      names[id] = nameCopy;
+      nameIds->insert(nameCopy, new unsigned long(id));
+    }
+
+  cachedPointers[slot] = name;
+  cachedIds[slot] = id;
+
+  return id;
+}
+
+
+
+//////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////
+
+
+
+/*!
+  Creates an empty map.
+ */
+XmlNameIdMap::XmlNameIdMap(void)
+{
+  idsSize = XML_NAME_TABLE_INITIAL_SIZE;
+  NEW(ids, unsigned long[idsSize]);
+
+  for (size_t i = 0; i < idsSize; i++)
+    ids[i] = 0;
+}
+
+
+
+/*!
+  Frees the array of ids.
+ */
+XmlNameIdMap::~XmlNameIdMap(void)
+{
+  DELETE_ARRAY(ids);
+}
+
+
+
+/*!
+  Assigns an id to given name id. The array of ids is enlarged if necessary.
+
+  \param nameId The name id.
+  \param id The assigned id.
+ */
+void XmlNameIdMap::insert(unsigned long nameId, unsigned long id)
+{
+  if (nameId >= idsSize)
+    {
+      size_t newSize = 2 * idsSize;
+      unsigned long *newIds;
+
+      while (nameId >= newSize)
+	newSize *= 2;
+
+      NEW(newIds, unsigned long[newSize]);
+      memcpy(newIds, ids, idsSize * sizeof(unsigned long));
+
+      for (size_t i = idsSize; i < newSize; i++)
+	newIds[i] = 0;
+
+      DELETE_ARRAY(ids);
+
+      ids = newIds;
+      idsSize = newSize;
+    }
+
+  ids[nameId] = id;
+}
@@ -0,0 +1,155 @@
+/***************************************************************************
+    xmlnametable.h  -  Definition of XmlNameTable class.
+                             -------------------
+    begin                : October 19 2026
+    copyright            : (C) 2003 by Vojtch Toman
+    email                : vtoman@lit.cz
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+
+/*!
+  \file xmlnametable.h
+  \brief Definition of XmlNameTable and XmlNameIdMap classes.
+
+  This file contains definition of XmlNameTable and XmlNameIdMap classes.
+*/
+
+#ifdef __GNUG__
+# pragma interface
+#endif
+
+
+#ifndef XMLNAMETABLE_H
+#define XMLNAMETABLE_H
+
+
+#include "defs.h"
+#include "hashtable.h"
+#include "list.h"
+#include "xmlchar.h"
+#include "xmldefs.h"
+
+
+
+/*!
+  \brief Number of slots in the pointer cache of XmlNameTable.
+
+  Has to be a power of 2.
+ */
+#define XML_NAME_CACHE_SIZE		64
+
+//! Initial size of the arrays used by XmlNameTable and XmlNameIdMap.
+#define XML_NAME_TABLE_INITIAL_SIZE	64
+
+
+//! Hashtable of the name ids (keys are the names).
+typedef HashTable<XmlChar *, unsigned long, List, 3079> XmlNameIds;
+
+
+
+/*!
+  \brief A table of interned element and attribute names.
+
+  Each distinct name is assigned a unique id (starting from 1) when it is seen for the first time. The parser interns the names of the elements and attributes as they come from Expat, so the XML models work with integer ids only and they never need to hash or compare the names themselves.
+
+  Expat often delivers the same name in the same buffer, so the table remembers the ids of the recently seen pointers. Because Expat may also reuse a buffer for a different name, a cache hit is confirmed by a string comparison, which is still much cheaper than the hashing.
+ */
+class XmlNameTable
+{
+public:
+  //! A constructor.
+  XmlNameTable(void);
+
+  //! A destructor.
+  virtual ~XmlNameTable(void);
+
+  //! Return the id of the name (the name is inserted if it is not known yet).
+  unsigned long intern(const XmlChar *name);
+
+  /*!
+    \brief Get the name with given id.
+
+    \param id The id of the name.
+    \return The name, or \a NULL if there is no such id.
+   */
+  const XmlChar *getName(unsigned long id) const
+  {
+    return (id && id < nameCounter) ? names[id] : 0;
+  }
+
+  /*!
+    \brief Get the number of interned names.
+
+    \return The number of names.
+   */
+  unsigned long count(void) const { return nameCounter - 1; }
+
+protected:
+  //! Hashtable of the name ids.
+  XmlNameIds *nameIds;
+
+  //! Array of the names indexed by their ids.
+  XmlChar **names;
+
+  //! The size of the \a names array.
+  size_t namesSize;
+
+  //! Counter for unique name numbering.
+  unsigned long nameCounter;
+
+  //! The recently seen name pointers.
+  const XmlChar *cachedPointers[XML_NAME_CACHE_SIZE];
+
+  //! The ids of the recently seen name pointers.
+  unsigned long cachedIds[XML_NAME_CACHE_SIZE];
+};
+
+
+
+/*!
+  \brief A mapping of the name ids to the ids used by the XML models.
+
+  The models number the elements and the attributes in the order of their appearance in the document. This class translates the ids assigned by XmlNameTable to these numbers by simple indexing.
+ */
+class XmlNameIdMap
+{
+public:
+  //! A constructor.
+  XmlNameIdMap(void);
+
+  //! A destructor.
+  virtual ~XmlNameIdMap(void);
+
+  /*!
+    \brief Find the id assigned to given name id.
+
+    \param nameId The name id.
+    \return The assigned id, or 0 if there is none.
+   */
+  unsigned long find(unsigned long nameId) const
+  {
+    return (nameId < idsSize) ? ids[nameId] : 0;
+  }
+
+  //! Assign an id to given name id.
+  void insert(unsigned long nameId, unsigned long id);
+
+protected:
+  //! Array of the ids indexed by the name ids.
+  unsigned long *ids;
+
+  //! The size of the \a ids array.
+  size_t idsSize;
+};
+
+
+#endif //XMLNAMETABLE_H
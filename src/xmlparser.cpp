@@ -261,6 +261,21 @@ void XmlParser::initParser(const XmlChar *encoding)
   XML_SetParamEntityParsing(innerParser, XML_PARAM_ENTITY_PARSING_NEVER);
 
   charactersTotal = 0;
+
+  //determine the size of the input blocks
+  bufferSize = ExaltOptions::getOption(ExaltOptions::ParserBufferSize);
+
+  if (bufferSize == ExaltOptions::None)
+    bufferSize = XML_BUFFER_SIZE;
+  else if (bufferSize < XML_MIN_BUFFER_SIZE)
+    bufferSize = XML_MIN_BUFFER_SIZE;
+  else if (bufferSize > XML_MAX_BUFFER_SIZE)
+    bufferSize = XML_MAX_BUFFER_SIZE;
+
+  NEW(nameTable, XmlNameTable);
+
+  attrIdsBuffSize = XML_NAME_TABLE_INITIAL_SIZE;
+  NEW(attrIdsBuff, unsigned long[attrIdsBuffSize]);
 }
 
 
@@ -279,18 +294,22 @@ XmlParser::~XmlParser(void)
 
   XML_ParserFree(innerParser);
   deleteDefaultTextCodec();
+
+  DELETE(nameTable);
+  DELETE_ARRAY(attrIdsBuff);
 }
 
 
 
 /*!
-  Reads the data from the input device and parses it.
+  Reads the data from the input device and parses it. The data are read in blocks of \a bufferSize bytes directly into the buffer of Expat, so no copying is necessary.
 
   \return The number of characters parsed so far.
  */
 long XmlParser::parse(void) throw (ExaltParserException, ExaltEncodingException, ExaltIOException)
 {
   bool final;
+  void *buff;
 
 
   if (!inputDevice)
@@ -299,11 +318,18 @@ long XmlParser::parse(void) throw (ExaltParserException, ExaltEncodingException,
     }
   else
     {
-      while (inputDevice->readData(xmlDataBuff, XML_BUFFER_SIZE) == ReadOk)
+      while (true)
 	{
-	  final = inputDevice->bytesRead() < XML_BUFFER_SIZE;
+	  //let the data be read directly into the buffer of expat
+	  buff = XML_GetBuffer(innerParser, bufferSize);
+	  CHECK_POINTER(buff);
+
+	  if (inputDevice->readData((char *)buff, bufferSize) != ReadOk)
+	    break;
+
+	  final = inputDevice->bytesRead() < (IOSize)bufferSize;
 	  
-	  if (!XML_Parse(innerParser, xmlDataBuff, inputDevice->bytesRead(), final))
+	  if (!XML_ParseBuffer(innerParser, inputDevice->bytesRead(), final))
 	    {
 	      reportError();
 	      return 0;
@@ -319,7 +345,7 @@ long XmlParser::parse(void) throw (ExaltParserException, ExaltEncodingException,
       if (inputDevice->errorOccurred())
 	FATAL("Error reading from input device!");
       
-      if (!XML_Parse(innerParser, xmlDataBuff, inputDevice->bytesRead(), true))
+      if (!XML_ParseBuffer(innerParser, inputDevice->bytesRead(), true))
 	{
 	  reportError();
 	  return 0;
@@ -336,7 +362,7 @@ long XmlParser::parse(void) throw (ExaltParserException, ExaltEncodingException,
 
 
 /*!
-  Parses given data in the PUSH mode.
+  Parses given data in the PUSH mode. The buffer is owned by the caller and it is passed to Expat as is, without any intermediate copying. The buffer may be reused as soon as the method returns.
 
   \param data Buffer of XMl data.
   \param length The length of the buffer.
@@ -384,7 +410,7 @@ void XmlParser::reportError(void)
 
 
 /*!
-  Examines the name of the element and the values of its attributes and emits corresponding events to the XML model.
+  Examines the name of the element and the values of its attributes and emits corresponding events to the XML model. The names of the element and of its attributes are interned in the name table, so the model receives their ids.
 
   \param userData Pointer to the user data structure.
   \param name Name of the element.
@@ -421,10 +447,28 @@ void XmlParser::startElement(void *userData, const XmlChar *name, const XmlChar
 
 
 
-  XmlStartElementEvent *ev;
-  NEW(ev, XmlStartElementEvent(name, attr));
+  //intern the names of the element and of its attributes
+  size_t attrCount = 0;
+
+  while (attr[2 * attrCount])
+    attrCount++;
 
-  exposeEvent(ev);
+  if (attrCount > attrIdsBuffSize)
+    {
+      DELETE_ARRAY(attrIdsBuff);
+
+      while (attrCount > attrIdsBuffSize)
+	attrIdsBuffSize *= 2;
+
+      NEW(attrIdsBuff, unsigned long[attrIdsBuffSize]);
+    }
+
+  for (size_t i = 0; i < attrCount; i++)
+    attrIdsBuff[i] = nameTable->intern(attr[2 * i]);
+
+  XmlStartElementEvent ev(name, attr, nameTable->intern(name), attrIdsBuff);
+
+  exposeEvent(&ev);
 }
 
 
@@ -457,10 +501,9 @@ void XmlParser::endElement(void *userData,
   DELETE_ARRAY(ee);
 #endif
 
-  XmlEndElementEvent *ev;
-  NEW(ev, XmlEndElementEvent(name));
+  XmlEndElementEvent ev(name, nameTable->intern(name));
 
-  exposeEvent(ev);
+  exposeEvent(&ev);
 }
 
 
@@ -485,10 +528,9 @@ void XmlParser::characterData(void *userData,
     OUTPUT(data[i]);
 #endif
 
-  XmlCharactersEvent *ev;
-  NEW(ev, XmlCharactersEvent(data, length));
+  XmlCharactersEvent ev(data, length);
 
-  exposeEvent(ev);
+  exposeEvent(&ev);
 
   charactersTotal += length;
 }
@@ -512,10 +554,9 @@ void XmlParser::processingInstruction(void *userData,
   OUTPUT(target << " = " << data);
 #endif
 
-  XmlPIEvent *ev;
-  NEW(ev, XmlPIEvent(target, data));
+  XmlPIEvent ev(target, data);
 
-  exposeEvent(ev);
+  exposeEvent(&ev);
 }
 
 
@@ -535,10 +576,9 @@ void XmlParser::comment(void *userData,
   OUTPUT(data);
 #endif
 
-  XmlCommentEvent *ev;
-  NEW(ev, XmlCommentEvent(data));
+  XmlCommentEvent ev(data);
 
-  exposeEvent(ev);
+  exposeEvent(&ev);
 }
 
 
@@ -556,10 +596,9 @@ void XmlParser::startCDATASection(void *userData)
   OUTPUT("start CDATA");
 #endif
 
-  XmlStartCDATAEvent *ev;
-  NEW(ev, XmlStartCDATAEvent);
+  XmlStartCDATAEvent ev;
 
-  exposeEvent(ev);
+  exposeEvent(&ev);
 }
 
 
@@ -577,10 +616,9 @@ void XmlParser::endCDATASection(void *userData)
   OUTPUT("end CDATA");
 #endif
 
-  XmlEndCDATAEvent *ev;
-  NEW(ev, XmlEndCDATAEvent);
+  XmlEndCDATAEvent ev;
 
-  exposeEvent(ev);
+  exposeEvent(&ev);
 }
 
 
@@ -605,10 +643,9 @@ void XmlParser::defaultHandler(void *userData,
   OUTPUT("DEFAULT");
 #endif
 
-  XmlDefaultEvent *ev;
-  NEW(ev, XmlDefaultEvent(data, length));
+  XmlDefaultEvent ev(data, length);
 
-  exposeEvent(ev);
+  exposeEvent(&ev);
 }
 
 
@@ -703,10 +740,9 @@ void XmlParser::xmlDecl(void *userData,
   OUTPUT("XML declaration: version = " << version << ", encoding = " << encoding << ", standalone = " << standalone);
 #endif
 
-  XmlDeclEvent *ev;
-  NEW(ev, XmlDeclEvent(version, encoding, standalone));
+  XmlDeclEvent ev(version, encoding, standalone);
 
-  exposeEvent(ev);
+  exposeEvent(&ev);
 
 }
 
@@ -733,10 +769,9 @@ void XmlParser::startDoctypeDecl(void *userData,
   OUTPUT("Start Doctype: doctypeName = " << doctypeName << ", systemId = " << systemId << ", publicId = " << publicId << ", has internal subset = " << hasInternalSubset);
 #endif
 
-  XmlStartDoctypeEvent *ev;
-  NEW(ev, XmlStartDoctypeEvent(doctypeName, systemId, publicId, hasInternalSubset));
+  XmlStartDoctypeEvent ev(doctypeName, systemId, publicId, hasInternalSubset);
 
-  exposeEvent(ev);
+  exposeEvent(&ev);
 }
 
 
@@ -754,10 +789,9 @@ void XmlParser::endDoctypeDecl(void *userData)
   OUTPUTNL("End doctype");
 #endif
 
-  XmlEndDoctypeEvent *ev;
-  NEW(ev, XmlEndDoctypeEvent());
+  XmlEndDoctypeEvent ev;
 
-  exposeEvent(ev);
+  exposeEvent(&ev);
 }
 
 
@@ -791,10 +825,9 @@ void XmlParser::entityDecl(void *userData,
   OUTPUT("Entity declaration: name = " << entityName << ", isParameterEntity " << isParameterEntity << ", valueLength = " << valueLength << ", base = " << base << ", systemId = " << systemId << ", publicId = " << publicId << ", notationName = " << notationName);
 #endif
 
-  XmlEntityDeclEvent *ev;
-  NEW(ev, XmlEntityDeclEvent(entityName, isParameterEntity, value, valueLength, /* base, */ systemId, publicId, notationName));
+  XmlEntityDeclEvent ev(entityName, isParameterEntity, value, valueLength, /* base, */ systemId, publicId, notationName);
 
-  exposeEvent(ev);
+  exposeEvent(&ev);
 }
 
 
@@ -819,10 +852,9 @@ void XmlParser::notationDecl(void *userData,
   OUTPUT("Notation declaration: name = " << notationName << ", base = " << base << ", systemId = " << systemId << ", publicId = " << publicId);
 #endif
 
-  XmlNotationDeclEvent *ev;
-  NEW(ev, XmlNotationDeclEvent(notationName, /* base, */ systemId, publicId));
+  XmlNotationDeclEvent ev(notationName, /* base, */ systemId, publicId);
 
-  exposeEvent(ev);
+  exposeEvent(&ev);
 }
 
 
@@ -831,6 +863,8 @@ void XmlParser::notationDecl(void *userData,
 /*!
   Sends a XML event to the XML model.
 
+  The events are constructed on the stack of the SAX handlers, so no memory is allocated per event. The model must not keep the pointer to the event after manageEvent() returns.
+
   \param ev The XML event.
  */
 void XmlParser::exposeEvent(XmlModelEvent *ev)
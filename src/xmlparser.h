@@ -36,11 +36,18 @@
 #include "defs.h"
 #include "xmlparserbase.h"
 #include "xmlchar.h"
+#include "xmlnametable.h"
 #include "options.h"
 
 
-//! Size of the buffer for reading XML data in PULL mode.
-#define XML_BUFFER_SIZE		4096
+//! Default size of the buffer for reading XML data in PULL mode.
+#define XML_BUFFER_SIZE		65536
+
+//! Minimal size of the buffer for reading XML data in PULL mode.
+#define XML_MIN_BUFFER_SIZE	65536
+
+//! Maximal size of the buffer for reading XML data in PULL mode.
+#define XML_MAX_BUFFER_SIZE	4194304
 
 
 
@@ -154,11 +161,11 @@ protected:
   XmlInnerParser innerParser;
 
   /*!
-    Buffer for XML data.
+    \brief Size of the blocks of XML data read in PULL mode.
 
-    Data coming from the XML stream are stored in this buffer. If the size of the data is larger than XML_BUFFER_SIZE, the parsing is done in more blocks.
+    The data are read directly into the buffer of Expat. The size is taken from the ExaltOptions::ParserBufferSize option and limited to the range from XML_MIN_BUFFER_SIZE to XML_MAX_BUFFER_SIZE.
    */
-  char xmlDataBuff[XML_BUFFER_SIZE];
+  int bufferSize;
 
   //! Initialization of the parser with given encoding.
   virtual void initParser(const XmlChar *encoding);
@@ -168,6 +175,15 @@ protected:
 
   //! Total amount of the character data.
   unsigned long charactersTotal;
+
+  //! Table of interned element and attribute names.
+  XmlNameTable *nameTable;
+
+  //! Buffer for the ids of the attribute names of the current element.
+  unsigned long *attrIdsBuff;
+
+  //! The size of the \a attrIdsBuff.
+  size_t attrIdsBuffSize;
 };
 
 
@@ -0,0 +1,162 @@
+/***************************************************************************
+    xmlpathfilter.cpp  -  Definitions of XmlPathFilter class methods.
+                             -------------------
+    begin                : October 19 2026
+    copyright            : (C) 2003 by Vojtch Toman
+    email                : vtoman@lit.cz
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+
+/*!
+  \file xmlpathfilter.cpp
+  \brief Definitions of XmlPathFilter class methods.
+  
+  This file contains the definitions of XmlPathFilter class methods.
+*/
+
+
+#ifdef __GNUG__
+# pragma implementation
+#endif
+
+
+#include "xmlpathfilter.h"
+
+
+
+/*!
+  Compiles the path. If the path is not valid, ExaltPathSyntaxException is raised.
+
+  \param path The path expression.
+ */
+XmlPathFilter::XmlPathFilter(const char *path) throw (ExaltPathSyntaxException)
+{
+  size_t i, start, maxSteps = 1;
+  bool descendant;
+
+  steps = 0;
+  nrSteps = 0;
+
+  if (!path || !path[0])
+    {
+      ERR("Empty path!");
+      throw ExaltPathSyntaxException();
+    }
+
+  for (i = 0; path[i]; i++)
+    if (path[i] == '/')
+      maxSteps++;
+
+  NEW(steps, XmlPathStep[maxSteps]);
+
+  i = 0;
+  descendant = true;
+
+  if (path[0] == '/')
+    {
+      i++;
+      descendant = false;
+
+      if (path[i] == '/')
+	{
+	  i++;
+	  descendant = true;
+	}
+    }
+
+  for (;;)
+    {
+      start = i;
+
+      while (path[i] && path[i] != '/')
+	i++;
+
+      if (i == start || nrSteps == XML_PATH_MAX_STEPS)
+	{
+	  //empty step (e.g. "a///b" or "a/"), or too long path
+	  ERR("Invalid path '" << path << "'!");
+
+	  while (nrSteps)
+	    if (steps[--nrSteps].name)
+	      DELETE_ARRAY(steps[nrSteps].name);
+
+	  DELETE_ARRAY(steps);
+	  throw ExaltPathSyntaxException();
+	}
+
+      steps[nrSteps].descendant = descendant;
+
+      if (i - start == 1 && path[start] == '*')
+	steps[nrSteps].name = 0;
+      else
+	{
+	  NEW(steps[nrSteps].name, XmlChar[i - start + 1]);
+	  xmlchar_cstrncpy(steps[nrSteps].name, path + start, i - start);
+	  steps[nrSteps].name[i - start] = 0;
+	}
+
+      nrSteps++;
+
+      if (!path[i])
+	break;
+
+      //skip the separator
+      i++;
+      descendant = false;
+
+      if (path[i] == '/')
+	{
+	  i++;
+	  descendant = true;
+	}
+    }
+}
+
+
+
+/*!
+  Deletes the steps.
+ */
+XmlPathFilter::~XmlPathFilter(void)
+{
+  for (size_t i = 0; i < nrSteps; i++)
+    if (steps[i].name)
+      DELETE_ARRAY(steps[i].name);
+
+  DELETE_ARRAY(steps);
+}
+
+
+
+/*!
+  The bit \a i of the states means that the first \a i steps have been matched by the ancestors of the element. A step with the descendant axis may skip any number of elements, so its state is kept for the children.
+
+  \param states The states of the parent element.
+  \param name The name of the element.
+  \return The states of the element.
+ */
+XmlPathStates XmlPathFilter::advance(XmlPathStates states, const XmlChar *name) const
+{
+  XmlPathStates newStates = 0;
+
+  for (size_t i = 0; i < nrSteps && (states >> i); i++)
+    if ((states >> i) & 1)
+      {
+	if (steps[i].descendant)
+	  newStates |= 1UL << i;
+
+	if (!steps[i].name || !xmlchar_strcmp(steps[i].name, name))
+	  newStates |= 1UL << (i + 1);
+      }
+
+  return newStates;
+}
@@ -0,0 +1,114 @@
+/***************************************************************************
+    xmlpathfilter.h  -  Definition of the XmlPathFilter class.
+                             -------------------
+    begin                : October 19 2026
+    copyright            : (C) 2003 by Vojtch Toman
+    email                : vtoman@lit.cz
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+
+/*!
+  \file xmlpathfilter.h
+  \brief Definition of the XmlPathFilter class.
+  
+  This file contains the definition of the XmlPathFilter class.
+*/
+
+
+#ifndef XMLPATHFILTER_H
+#define XMLPATHFILTER_H
+
+#ifdef __GNUG__
+# pragma interface
+#endif
+
+
+#include "defs.h"
+#include "exceptions.h"
+#include "xmlchar.h"
+#include "xmldefs.h"
+
+
+/*!
+  \brief The maximal number of the steps of the path.
+
+  The states of the matching are stored as the bits of one unsigned long.
+ */
+#define XML_PATH_MAX_STEPS	(8 * sizeof(unsigned long) - 1)
+
+
+//! Type for the set of the states of the path matching.
+typedef unsigned long XmlPathStates;
+
+
+
+/*!
+  \brief One step of the path.
+ */
+struct XmlPathStep
+{
+  //! The name of the element (NULL matches any element).
+  XmlChar *name;
+
+  //! Indication whether the step uses the descendant axis (//).
+  bool descendant;
+}; //XmlPathStep
+
+
+
+/*!
+  \brief A compiled path expression used for projection decoding.
+
+  The filter supports a simple subset of XPath: the steps are separated by \c / (child axis) or \c // (descendant axis), and each step is either an element name or \c *. For example, \c /dblp/article/title selects the titles of the articles, and \c //title selects all titles. A relative path (e.g. \c article/title) is matched anywhere in the document, as if it started with \c //.
+
+  The matching is performed incrementally, element by element: the set of the partially matched steps is kept for each open element (see advance()). An element matches if all steps have been matched.
+
+  \sa SAXPathFilterEmitter.
+ */
+class XmlPathFilter
+{
+public:
+  //! A constructor.
+  XmlPathFilter(const char *path) throw (ExaltPathSyntaxException);
+
+  //! A destructor.
+  virtual ~XmlPathFilter(void);
+
+  /*!
+    \brief Get the states before the root element.
+
+    \return The initial states.
+   */
+  XmlPathStates initialStates(void) const { return 1; }
+
+  //! Return the states after entering the element.
+  XmlPathStates advance(XmlPathStates states, const XmlChar *name) const;
+
+  /*!
+    \brief Check whether the states represent a matching element.
+
+    \param states The states after entering the element.
+    \return True if the element matches the path.
+   */
+  bool matches(XmlPathStates states) const { return (states >> nrSteps) & 1; }
+
+protected:
+  //! The steps of the path.
+  XmlPathStep *steps;
+
+  //! The number of the steps.
+  size_t nrSteps;
+};
+
+
+
+#endif //XMLPATHFILTER_H
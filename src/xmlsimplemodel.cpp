@@ -74,6 +74,53 @@ if (saxEmitter)				\
 #define RESET_STATE			state = StructuralSymbols::None
 
 
+/*!
+  \brief Test whether the symbol is a character of the character data.
+
+  All the structural symbols are smaller than or equal to StructuralSymbols::LongWordToken (the control characters are not allowed in the XML data). The tab, line feed and carriage return characters are not used as structural symbols.
+
+  \param _c_ The symbol.
+*/
+#define IS_PLAIN_CHARACTER(_c_)						\
+  ((unsigned long)(_c_) > (unsigned long)StructuralSymbols::LongWordToken ||	\
+   (_c_) == '\t' || (_c_) == '\n' || (_c_) == '\r')
+
+
+/*!
+  \brief Append a run of character data to the buffer.
+
+  The data is copied to the buffer in blocks. Whenever the buffer gets full, its content is sent to the SAX emitter.
+
+  \param _data_ The character data.
+  \param _length_ The length of the data.
+*/
+#define APPEND_CHARACTER_RUN(_data_, _length_)					\
+{										\
+  const XmlChar *_run_ = (_data_);						\
+  size_t _runLength_ = (_length_);						\
+  size_t _chunk_;								\
+										\
+  while (_runLength_)								\
+    {										\
+      _chunk_ = XML_MODEL_BUFFER_DEFAULT_SIZE - bufferLength;			\
+      if (_chunk_ > _runLength_)						\
+	_chunk_ = _runLength_;							\
+										\
+      memcpy(buffer + bufferLength, _run_, _chunk_ * sizeof(XmlChar));	\
+      bufferLength += _chunk_;							\
+      _run_ += _chunk_;								\
+      _runLength_ -= _chunk_;							\
+										\
+      if (bufferLength == XML_MODEL_BUFFER_DEFAULT_SIZE)			\
+	{									\
+	  /* character data larger than the buffer --> split it */		\
+	  SAFE_CALL_EMITTER(characterData(userData, buffer, bufferLength));	\
+	  RESET_BUFFER;								\
+	}									\
+    }										\
+}
+
+
 /*!
   Append the \a data of length \a length to the right side of the root rule of the \a grammar. If \a complete is TRUE, insert also "end of chunk symbol".
 
@@ -149,6 +196,9 @@ if (saxEmitter)				\
       /* push element to the stack */						\
       elementStack->push(new unsigned long(elementId));				\
 										\
+      if (containers)								\
+	containers->enterElement(elementId);					\
+										\
       SAFE_CALL_EMITTER(startElement(userData, ec->name, 0));			\
 										\
       /* Element information is now complete */					\
@@ -172,6 +222,10 @@ if (saxEmitter)				\
           }									\
 										\
         elementStack->push(new unsigned long(elementId));			\
+										\
+        if (containers)								\
+          containers->enterElement(elementId);					\
+										\
         SAFE_CALL_EMITTER(startElement(userData, _elementName_, attrs));	\
 										\
         /* delete attribute values */						\
@@ -195,6 +249,11 @@ if (saxEmitter)				\
         dataQueueItem->type = Characters;					\
         dataQueueItem->data = ec->name;						\
         dataQueue->enqueue(dataQueueItem);					\
+										\
+        /* the value of the attribute may be stored in a container */		\
+        if (containers)								\
+          valueContainer = containers->valueKey(elementId);			\
+        valueId = elementId;							\
       }										\
   RESET_STATE;									\
 }
@@ -208,15 +267,20 @@ XmlSimpleModel::XmlSimpleModel(void)
   : XmlModelBase()
 {
   grammar = 0;
+  containers = 0;
+  valueContainer = 0;
+  typedValues = 0;
+  valueId = 0;
+  wordTokens = 0;
 
   state = StructuralSymbols::None;
+  wordReturnState = StructuralSymbols::None;
+  wordTokenSymbol = 0;
   
   buffer = 0;
   bufferLength = 0;
 
-  fibBits = 0;
-  fibCode = 0;
-  fibLastWasOne = false;
+  Fibonacci::resetDecoder(&fibDecoder);
   
   NEW(dataQueue, DataQueue);
   dataQueue->setAutoDelete(true);
@@ -237,8 +301,7 @@ XmlSimpleModel::XmlSimpleModel(void)
 
   elementStack->setAutoDelete(true);
 
-  NEW(elementIds, ElementIds);
-  elementIds->setAutoDelete(true);
+  NEW(elementIds, XmlNameIdMap);
 
   NEW(elements, SimpleElementTable);
   elements->setAutoDelete(true);
@@ -259,6 +322,7 @@ XmlSimpleModel::~XmlSimpleModel(void)
 {
   DELETE(elements);
   DELETE(elementStack);
+  DELETE(elementIds);
 
 
   //display the number of elements and attributes if in verbose mode
@@ -309,13 +373,17 @@ bool XmlSimpleModel::manageEvent(XmlModelEvent *event)
   XmlDefaultEvent *defaultEvent;
 
   XmlChar *elName, *attrName;
-  unsigned long *elId, *attrId;
+  unsigned long elId, attrId;
   unsigned long elementId, attributeId;
 
   SimpleElementContext *ec;
   size_t fibItems;
   XmlChar fibBuf[30];
   Encodings::MIB mib;
+  GrammarBase *container;
+  unsigned long containerKey;
+  XmlChar typedCode[XML_TYPED_VALUES_MAX_CODE_LENGTH];
+  size_t typedLength;
 
   //examine the event type and perform appropriate actions
   switch (event->type)
@@ -565,7 +633,7 @@ bool XmlSimpleModel::manageEvent(XmlModelEvent *event)
 	  //encode the attributes
 	  for (size_t i = 0; startElementEvent->attr[i]; i += 2)
 	    {
-	      if (!(attrId = elementIds->find((XmlChar *)startElementEvent->attr[i])))
+	      if (!(attrId = elementIds->find(startElementEvent->attrIds[i / 2])))
 		{
 		  //unknown attribute started
 		  //--> we'll create new element context for it
@@ -579,7 +647,7 @@ bool XmlSimpleModel::manageEvent(XmlModelEvent *event)
 
 		  //insert new element id to elementIds
 		  attributeId = elementCounter;
-		  elementIds->insert(attrName, new unsigned long(attributeId));
+		  elementIds->insert(startElementEvent->attrIds[i / 2], attributeId);
 
 
 
@@ -609,10 +677,10 @@ bool XmlSimpleModel::manageEvent(XmlModelEvent *event)
 		{
 		  //known attribute started
 		  //--> update its element context
-		  ec = elements->find(*attrId);
+		  ec = elements->find(attrId);
 		  CHECK_POINTER(ec);
 
-		  attributeId = *attrId;
+		  attributeId = attrId;
 
 
 		  //append "known element" symbol to the grammar
@@ -621,11 +689,29 @@ bool XmlSimpleModel::manageEvent(XmlModelEvent *event)
 		  APPEND_BUFFER_DATA(grammar, fibBuf, fibItems);
 		}
 
+	      //the path of the value is created even if the value is empty (the decoder creates it as well)
+	      containerKey = containers ? containers->valueKey(attributeId) : 0;
+
 	      //append the attribute value
 	      if (startElementEvent->attr[i+1][0] == 0)
 		grammar->append(StructuralSymbols::EmptyString);
 	      else
-		APPEND_ALL_DATA(grammar, startElementEvent->attr[i+1], true);
+		if (typedValues &&
+		    (typedLength = typedValues->encode(2 * attributeId + 1, startElementEvent->attr[i+1],
+						       xmlchar_strlen(startElementEvent->attr[i+1]), typedCode)))
+		  {
+		    //the value is a number or a date --> append its binary form
+		    grammar->append(StructuralSymbols::TypedValue);
+		    APPEND_BUFFER_DATA(grammar, typedCode, typedLength);
+		  }
+		else if (containers && (container = containers->grammar(containerKey)))
+		  {
+		    //the value is stored in the container of the attribute
+		    grammar->append(StructuralSymbols::ContainerData);
+		    APPEND_ALL_DATA(container, startElementEvent->attr[i+1], true);
+		  }
+		else
+		  APPEND_ALL_DATA(grammar, startElementEvent->attr[i+1], true);
 	    }
 
 	  //append "end of block" after the element name to indicate that the description of an element with attributes ended
@@ -633,7 +719,7 @@ bool XmlSimpleModel::manageEvent(XmlModelEvent *event)
 
 	}
 
-      if (!(elId = elementIds->find((XmlChar *)startElementEvent->name)))
+      if (!(elId = elementIds->find(startElementEvent->nameId)))
 	{
 	  //unknown element started
 	  //--> we'll create new element context for it
@@ -647,7 +733,7 @@ bool XmlSimpleModel::manageEvent(XmlModelEvent *event)
 
 	  //insert new element id to elementIds
 	  elementId = elementCounter;
-	  elementIds->insert(elName, new unsigned long(elementId));
+	  elementIds->insert(startElementEvent->nameId, elementId);
 
 	  //DBG("New element " << (const char *)startElementEvent->name << " (" << elementId << ") started");
 
@@ -681,10 +767,10 @@ bool XmlSimpleModel::manageEvent(XmlModelEvent *event)
 	{
 	  //known element started
 	  //--> update its element context
-	  ec = elements->find(*elId);
+	  ec = elements->find(elId);
 	  CHECK_POINTER(ec);
 
-	  elementId = *elId;
+	  elementId = elId;
 
 
 	  //  	  DBG("KNOWN: ");
@@ -705,6 +791,9 @@ bool XmlSimpleModel::manageEvent(XmlModelEvent *event)
       //push element name to the stack
       elementStack->push(new unsigned long(elementId));
 
+      if (containers)
+	containers->enterElement(elementId);
+
       break;
 
 
@@ -715,7 +804,7 @@ bool XmlSimpleModel::manageEvent(XmlModelEvent *event)
 
       //SimpleElementContext *ec;
 
-      if (!(elId = elementIds->find((XmlChar *)endElementEvent->name)))
+      if (!(elId = elementIds->find(endElementEvent->nameId)))
 	{
 	  //end of unknown element occurred
 	  //--> should never happen
@@ -730,6 +819,9 @@ bool XmlSimpleModel::manageEvent(XmlModelEvent *event)
 
       elementStack->pop();
 
+      if (containers)
+	containers->leaveElement();
+
       //append "end element" symbol to the grammar
       grammar->append(StructuralSymbols::EndElement);
 
@@ -746,7 +838,33 @@ bool XmlSimpleModel::manageEvent(XmlModelEvent *event)
       //  	{
       //  	  DBG(charactersEvent->data[t]);
       //  	}
-      APPEND_ALL_DATA_LENGTH(grammar, charactersEvent->data, charactersEvent->length, true);
+      if (typedValues && !inCDATA && elementStack->top() &&
+	  (typedLength = typedValues->encode(2 * *elementStack->top(), charactersEvent->data,
+					     charactersEvent->length, typedCode)))
+	{
+	  //the data are a number or a date --> append their binary form
+	  grammar->append(StructuralSymbols::TypedValue);
+	  APPEND_BUFFER_DATA(grammar, typedCode, typedLength);
+	}
+      else if (containers && (container = containers->grammar(containers->textKey())))
+	{
+	  //the data are stored in the container of the enclosing element
+	  grammar->append(StructuralSymbols::ContainerData);
+	  APPEND_ALL_DATA_LENGTH(container, charactersEvent->data, charactersEvent->length, true);
+
+	  if (wordTokens)
+	    {
+	      //the containers are split by the "end of block" symbols, which may occur in the ids of the words
+	      //--> the words are only remembered, the same way the decoder does it
+	      wordTokens->learn(charactersEvent->data, charactersEvent->length);
+	      wordTokens->finishText();
+	    }
+	}
+      else
+	if (wordTokens)
+	  appendWords(charactersEvent->data, charactersEvent->length);
+	else
+	  APPEND_ALL_DATA_LENGTH(grammar, charactersEvent->data, charactersEvent->length, true);
       break;
 
       /**** Default data ****/
@@ -773,6 +891,7 @@ bool XmlSimpleModel::manageEvent(XmlModelEvent *event)
       /**** StartCDATA ****/
     case XmlModelEvent::StartCDATA:
       //startCDATAEvent = (XmlStartCDATAEvent *)event;
+      inCDATA = true;
 
       //append "comment" symbol to the grammar
       grammar->append(StructuralSymbols::CDATA);
@@ -781,6 +900,7 @@ bool XmlSimpleModel::manageEvent(XmlModelEvent *event)
       /**** EndCDATA ****/
     case XmlModelEvent::EndCDATA:
       //endCDATAEvent = (XmlEndCDATAEvent *)event;
+      inCDATA = false;
 
       //append "comment" symbol to the grammar
       grammar->append(StructuralSymbols::CDATA);
@@ -815,17 +935,72 @@ bool XmlSimpleModel::manageEvent(XmlModelEvent *event)
 
     default:
       WRN("Unknown XML event: " << event->type);
-      DELETE(event);
       return false;
     }
 
-  //delete the event structure
-  DELETE(event);
   return true;
 }
 
 
 
+/*!
+  The words (see XmlWordTokens) which are already in the dictionary are replaced by their ids (see XML_SIMPLE_MODEL_SHORT_WORD_IDS), the other words are inserted into the dictionary. The data are ended by the "end of block" symbol.
+
+  \param data The character data.
+  \param length The length of the data.
+ */
+void XmlSimpleModel::appendWords(const XmlChar *data, size_t length)
+{
+  XmlChar fibBuf[30];
+  size_t fibItems;
+  size_t wordStart;
+  long wordId;
+  size_t i = 0;
+
+  while (i < length)
+    {
+      if (!IS_WORD_CHARACTER(data[i]))
+	{
+	  grammar->append((TerminalValue)data[i]);
+	  i++;
+	  continue;
+	}
+
+      //find the end of the word
+      for (wordStart = i; i < length && IS_WORD_CHARACTER(data[i]); i++)
+	;
+
+      if (i - wordStart < XML_WORD_TOKENS_MIN_LENGTH || i - wordStart > XML_WORD_TOKENS_MAX_LENGTH)
+	wordId = -1;
+      else
+	if ((wordId = wordTokens->find(data + wordStart, i - wordStart)) < 0)
+	  wordTokens->insert(data + wordStart, i - wordStart);
+
+      if (wordId >= 0)
+	{
+	  //a known word --> append its id
+	  if (wordId < XML_SIMPLE_MODEL_SHORT_WORD_IDS)
+	    {
+	      grammar->append((TerminalValue)(StructuralSymbols::WordToken + wordId / 256));
+	      grammar->append((TerminalValue)(wordId % 256));
+	    }
+	  else
+	    {
+	      //the Fibonacci codes start at 1
+	      grammar->append(StructuralSymbols::LongWordToken);
+	      fibItems = Fibonacci::encodeToBuffer(fibBuf, SIZEOF_XML_CHAR, wordId - XML_SIMPLE_MODEL_SHORT_WORD_IDS + 1);
+	      APPEND_BUFFER_DATA(grammar, fibBuf, fibItems);
+	    }
+	}
+      else
+	APPEND_ALL_DATA_LENGTH(grammar, (data + wordStart), (i - wordStart), false);
+    }
+
+  grammar->append(StructuralSymbols::EndOfBlock);
+}
+
+
+
 /*!
   This method implements the decoding procedure. It receives data from the underlying grammar and reconstructs the XML data.
 
@@ -842,7 +1017,7 @@ void XmlSimpleModel::receiveData(XmlChar *data, size_t size)
   unsigned long *elId;
 
   //some variables for working with Fibonacci codes
-  unsigned char fibTmpChar, fibMask;
+  unsigned long fibNumber;
   bool fibFinished = false;
 
 
@@ -854,8 +1029,30 @@ void XmlSimpleModel::receiveData(XmlChar *data, size_t size)
 
   for (size_t i = 0; i < size; i++)
     {
+      //the data contains many symbols --> reset the per-symbol variables
+      stateChanged = false;
+      fibFinished = false;
+
+      if ((state == StructuralSymbols::None || state == StructuralSymbols::CDATA) && IS_PLAIN_CHARACTER(data[i]))
+	{
+	  //a run of character data --> find the next structural symbol and copy the whole run at once
+	  size_t runEnd = i + 1;
+
+	  while (runEnd < size && IS_PLAIN_CHARACTER(data[runEnd]))
+	    runEnd++;
+
+	  APPEND_CHARACTER_RUN(data + i, runEnd - i);
+
+	  if (wordTokens && !elementHasAttributes)
+	    wordTokens->learn(data + i, runEnd - i);
+
+	  i = runEnd - 1;
+	  continue;
+	}
+
       //        DBG((unsigned int)data[i]);
-      if (state != StructuralSymbols::KnownElement)
+      if (state != StructuralSymbols::KnownElement && state != StructuralSymbols::TypedValue &&
+	  state != StructuralSymbols::WordToken)
 	{
 	  switch (data[i])
 	    {
@@ -919,6 +1116,9 @@ void XmlSimpleModel::receiveData(XmlChar *data, size_t size)
 		{
 		  elId = elementStack->pop();
 		  CHECK_POINTER(elId);
+
+		  if (containers)
+		    containers->leaveElement();
 		  ec = elements->find(*elId);
 
 		  //DBG("** " << ec->name);
@@ -1024,7 +1224,45 @@ void XmlSimpleModel::receiveData(XmlChar *data, size_t size)
 		}
 	      break;
 
+	    case StructuralSymbols::ContainerData:
+	      if (containers && (state == StructuralSymbols::None || state == StructuralSymbols::CDATA))
+		{
+		  //the data are stored in a container --> decode them as if they were here
+		  XmlChar *containerData;
+		  size_t containerLength;
+
+		  containerData = containers->fetch(elementHasAttributes ? valueContainer : containers->textKey(), &containerLength);
+		  receiveData(containerData, containerLength);
+		  continue;
+		}
+	      break;
+
+	    case StructuralSymbols::TypedValue:
+	      if (typedValues && state == StructuralSymbols::None)
+		{
+		  //the binary form of a number or a date follows
+		  CHANGE_STATE(StructuralSymbols::TypedValue);
+
+		  if (elementHasAttributes)
+		    typedValues->startDecoding(2 * valueId + 1);
+		  else
+		    typedValues->startDecoding(elementStack->top() ? 2 * *elementStack->top() : 0);
+		  continue;
+		}
+	      break;
+
 	    default:
+	      if (wordTokens && (unsigned char)data[i] >= StructuralSymbols::WordToken &&
+		  (unsigned char)data[i] <= StructuralSymbols::LongWordToken &&
+		  (state == StructuralSymbols::None || state == StructuralSymbols::CDATA))
+		{
+		  //the id of a known word follows
+		  wordReturnState = state;
+		  wordTokenSymbol = data[i];
+		  state = StructuralSymbols::WordToken;
+		  continue;
+		}
+
 	      if (!data[i] && !bufferLength && elementHasAttributes)
 		{
 		  //end of the attribute section of the element
@@ -1205,39 +1443,11 @@ void XmlSimpleModel::receiveData(XmlChar *data, size_t size)
 	  //known element started
 	  //--> read complete Fibonacci code of its id
 
-	  //construct reverse Fibonacci code (e.g. 1100101 instead of 1010011) from sequence of
-	  //following bytes
-	  fibMask = 1 << (SIZEOF_CHAR*8 - 1);
-	      
-	  //decode symbol using Fibonacci code
-	  fibTmpChar = (unsigned char)data[i];
-  	  //DBG("SSS: " << (unsigned int)fibTmpChar);
-
-	  while (fibMask)
+	  //decode symbol using Fibonacci code (the code may span several bytes)
+	  if (Fibonacci::decodeChar(&fibDecoder, (unsigned char)data[i], &fibNumber))
 	    {
-	      fibCode >>= 1;
-	      fibBits++;
-		  
-	      if (fibTmpChar & fibMask)
-		{
-		  fibCode = fibCode | ((unsigned long)1) << (SIZEOF_UNSIGNED_LONG*8-1);
-		      
-		  if (!fibLastWasOne)
-		    fibLastWasOne = true;
-		  else
-		    {
-		      //Fibonacci code is now complete
-		      //--> decode the symbol number
-		      fibCode >>= (SIZEOF_UNSIGNED_LONG*8 - fibBits);
-		      elementId = Fibonacci::decode(fibCode);
-		      fibFinished = true;
-		      break;
-		    }
-		}
-	      else
-		fibLastWasOne = false;
-		  
-	      fibMask >>= 1;
+	      elementId = fibNumber;
+	      fibFinished = true;
 	    }
 
 	  if (fibFinished)
@@ -1252,10 +1462,6 @@ void XmlSimpleModel::receiveData(XmlChar *data, size_t size)
 
 
 	      //complete Fibonacci code read and decoded
-	      //reset fibCode, and fibBits
-	      fibCode = 0;
-	      fibBits = 0;
-	      fibLastWasOne = false;
 
 	      RESET_BUFFER;
 	      RESET_STATE;
@@ -1327,7 +1533,7 @@ void XmlSimpleModel::receiveData(XmlChar *data, size_t size)
 	      systemId = dataQueue->dequeue()->data;
 
 	      SAFE_CALL_EMITTER(startDoctypeDecl(userData, doctype, systemId, publicId,
-						 data[0] == StructuralSymbols::HasInternalSubsetYes));
+						 data[i] == StructuralSymbols::HasInternalSubsetYes));
 
 	      if (doctype)
 		DELETE(doctype);
@@ -1396,7 +1602,7 @@ void XmlSimpleModel::receiveData(XmlChar *data, size_t size)
 	      else
 		valueLength = xmlchar_strlen(value);
 
-	      SAFE_CALL_EMITTER(entityDecl(userData, entityName, data[0] == StructuralSymbols::IsParameterEntityYes,
+	      SAFE_CALL_EMITTER(entityDecl(userData, entityName, data[i] == StructuralSymbols::IsParameterEntityYes,
 					   value, valueLength, 0/*base*/, systemId, publicId, notationName));
 
 	      if (entityName)
@@ -1521,6 +1727,50 @@ void XmlSimpleModel::receiveData(XmlChar *data, size_t size)
 
 	  break;
 
+	case StructuralSymbols::TypedValue:
+	  //read the binary form of a number or a date
+	  if (typedValues->decodeSymbol(data[i]))
+	    {
+	      //the value is complete --> decode its text as if it was here
+	      XmlChar typedText[XML_TYPED_VALUES_MAX_LENGTH + 1];
+	      size_t typedLength;
+
+	      typedLength = typedValues->format(typedText);
+	      typedText[typedLength++] = StructuralSymbols::EndOfBlock;
+
+	      RESET_STATE;
+	      receiveData(typedText, typedLength);
+	    }
+	  break;
+
+	case StructuralSymbols::WordToken:
+	  //read the id of a known word
+	  if (wordTokenSymbol != StructuralSymbols::LongWordToken)
+	    {
+	      fibNumber = (wordTokenSymbol - StructuralSymbols::WordToken) * 256 + (unsigned char)data[i];
+	      fibFinished = true;
+	    }
+	  else
+	    if (Fibonacci::decodeChar(&fibDecoder, (unsigned char)data[i], &fibNumber))
+	      {
+		fibNumber += XML_SIMPLE_MODEL_SHORT_WORD_IDS - 1;
+		fibFinished = true;
+	      }
+
+	  if (fibFinished)
+	    {
+	      //the id is complete --> append the word to the character data
+	      const XmlChar *word;
+	      size_t wordLength;
+
+	      if (!(word = wordTokens->word(fibNumber, &wordLength)))
+		FATAL("Unknown word: " << fibNumber);
+
+	      state = wordReturnState;
+	      APPEND_CHARACTER_RUN(word, wordLength);
+	    }
+	  break;
+
 	default:
 	  //characters
 	  if (data[i] == StructuralSymbols::EmptyString)
@@ -1564,6 +1814,9 @@ void XmlSimpleModel::receiveData(XmlChar *data, size_t size)
 		    if (bufferLength)
 		      //send data only if they aren't empty
 		      SAFE_CALL_EMITTER(characterData(userData, buffer, bufferLength));
+
+		    if (wordTokens)
+		      wordTokens->finishText();
 		  }
 
 		RESET_BUFFER;
@@ -1573,6 +1826,9 @@ void XmlSimpleModel::receiveData(XmlChar *data, size_t size)
 	      {
 		buffer[bufferLength] = data[i];
 		bufferLength++;
+
+		if (wordTokens && !elementHasAttributes)
+		  wordTokens->learn(data + i, 1);
 		  
 		if (bufferLength == XML_MODEL_BUFFER_DEFAULT_SIZE)
 		  {
@@ -96,6 +96,18 @@ namespace StructuralSymbols
     //! The default data.
     Default = 16,
 
+    //! The data are stored in a container (see XmlContainerSet).
+    ContainerData = 17,
+
+    //! The binary form of a numeric or date value follows (see XmlTypedValues).
+    TypedValue = 12,
+
+    //! The first of the symbols which start the id of a known word (see XmlWordTokens and XML_SIMPLE_MODEL_SHORT_WORD_IDS).
+    WordToken = 19,
+
+    //! The Fibonacci code of the id of a known word follows (the id doesn't fit in two symbols).
+    LongWordToken = 31,
+
     //! The document is standalone.
     StandaloneYes = 1,
 
@@ -124,6 +136,15 @@ namespace StructuralSymbols
 }
 
 
+/*!
+  \brief The number of the ids of the words coded by two symbols.
+
+  The id \a i smaller than this number is coded by the symbol StructuralSymbols::WordToken + \a i / 256 followed by the symbol \a i % 256. The other ids are coded by StructuralSymbols::LongWordToken followed by the Fibonacci code of \a i - XML_SIMPLE_MODEL_SHORT_WORD_IDS + 1.
+ */
+#define XML_SIMPLE_MODEL_SHORT_WORD_IDS	((StructuralSymbols::LongWordToken - StructuralSymbols::WordToken) * 256)
+
+
+
 /*!
   \brief Structure representing one element context.
  */
@@ -165,6 +186,33 @@ public:
   */
   virtual void setGrammar(GrammarBase *gr) { grammar = gr; }
 
+  /*!
+    \brief Set the containers of the character data.
+
+    The character data and the attribute values are routed to the containers of their paths. The data are replaced by the StructuralSymbols::ContainerData symbol in the structure.
+
+    \param set The containers (NULL means that all data are coded by the grammar).
+  */
+  virtual void setContainers(XmlContainerSet *set) { containers = set; }
+
+  /*!
+    \brief Set the coder of the numeric and date values.
+
+    The character data and the attribute values recognized by the coder are replaced by the StructuralSymbols::TypedValue symbol followed by their binary form.
+
+    \param values The coder (NULL means that all values are coded as text).
+  */
+  virtual void setTypedValues(XmlTypedValues *values) { typedValues = values; }
+
+  /*!
+    \brief Set the dictionary of the words of the character data.
+
+    The known words of the character data are replaced by their ids (see XML_SIMPLE_MODEL_SHORT_WORD_IDS).
+
+    \param tokens The dictionary (NULL means that all words are coded as text).
+  */
+  virtual void setWordTokens(XmlWordTokens *tokens) { wordTokens = tokens; }
+
   //! Set SAX emitter for decoding.
   virtual void setSAXEmitter(SAXEmitter *emitter, void *data = 0);
 
@@ -176,6 +224,43 @@ protected:
   //! The grammar used for compression.
   GrammarBase *grammar;
 
+  //! The containers of the character data (may be NULL).
+  XmlContainerSet *containers;
+
+  /*!
+    \brief The key of the container of the value of the current attribute.
+
+    Used during decoding.
+  */
+  unsigned long valueContainer;
+
+  //! The coder of the numeric and date values (may be NULL).
+  XmlTypedValues *typedValues;
+
+  /*!
+    \brief The id of the attribute whose value is decoded.
+
+    Used during decoding.
+  */
+  unsigned long valueId;
+
+  //! The dictionary of the words of the character data (may be NULL).
+  XmlWordTokens *wordTokens;
+
+  /*!
+    \brief The state to return to after the id of a word has been read.
+
+    Used during decoding.
+  */
+  StructuralSymbols::Symbol wordReturnState;
+
+  /*!
+    \brief The symbol which started the id of the word being read.
+
+    Used during decoding.
+  */
+  unsigned char wordTokenSymbol;
+
 
   //! Indication of CDATA section.
   bool inCDATA;
@@ -196,8 +281,8 @@ protected:
   */
   StructuralSymbols::Symbol state;
 
-  //! Hashtable of element ids.
-  ElementIds *elementIds;
+  //! Mapping of the interned name ids to element ids.
+  XmlNameIdMap *elementIds;
 
   //! Hashtable of element contexts.
   SimpleElementTable *elements;
@@ -227,22 +312,12 @@ protected:
 
   //some variables for working with Fibonacci codes
 
-  /*! 
-    \brief Number of read bits of Fibonacci code.
-    
-    Used during decoding.
-  */
-  size_t fibBits;
-
   /*!
-    \brief Read Fibonacci code.
+    rief State of the Fibonacci decoder.
     
     Used during decoding.
   */
-  unsigned long fibCode;
-
-  //! Helper variable for decoding Fibonacci codes.
-  bool fibLastWasOne;
+  FibonacciDecoderState fibDecoder;
 
   //! The queue of decoded data items (such as names of the attributes, etc.)
   DataQueue *dataQueue;
@@ -260,6 +335,9 @@ protected:
     Used during decoding.
    */
   void *userData;
+
+  //! Append the character data with the known words replaced by their ids.
+  virtual void appendWords(const XmlChar *data, size_t length);
 };
 
 
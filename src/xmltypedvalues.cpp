@@ -0,0 +1,547 @@
+/***************************************************************************
+    xmltypedvalues.cpp  -  Definitions of XmlTypedValues class methods.
+                             -------------------
+    begin                : October 19 2026
+    copyright            : (C) 2003 by Vojtch Toman
+    email                : vtoman@lit.cz
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+
+
+/*!
+  \file xmltypedvalues.cpp
+  \brief Definitions of XmlTypedValues class methods.
+  
+  This file contains the definitions of XmlTypedValues class methods.
+*/
+
+#ifdef __GNUG__
+# pragma implementation
+#endif
+
+
+#include "xmltypedvalues.h"
+
+
+
+//! Test whether the character is a decimal digit.
+#define IS_DIGIT(_c_)	((_c_) >= '0' && (_c_) <= '9')
+
+//! Get the value of the decimal digit.
+#define DIGIT_VALUE(_c_)	((long)((_c_) - '0'))
+
+
+
+/*!
+  Creates an empty table of the histories.
+ */
+XmlTypedValues::XmlTypedValues(void)
+{
+  NEW(histories, XmlTypedValueTable);
+  NEW(historyList, List<XmlTypedValueHistory>);
+  historyList->setAutoDelete(true);
+
+  history = 0;
+  type = 0;
+  nrFields = 0;
+  shift = 0;
+}
+
+
+
+/*!
+  Deletes the histories.
+ */
+XmlTypedValues::~XmlTypedValues(void)
+{
+  DELETE(histories);
+  DELETE(historyList);
+}
+
+
+
+/*!
+  Tests whether the value is a typed value and, if so, writes its binary form and updates the history of the path.
+
+  \param key The key of the path of the value.
+  \param data The value.
+  \param length The length of the value.
+  \param code The buffer for the binary form (at least XML_TYPED_VALUES_MAX_CODE_LENGTH symbols long).
+  \return The length of the binary form, or 0 if the value is not a typed value.
+ */
+size_t XmlTypedValues::encode(unsigned long key, const XmlChar *data, size_t length, XmlChar *code)
+{
+  XmlTypedValueHistory *hist;
+  long number, second;
+  int scale, dateType;
+  size_t len;
+
+  if (!length || length > XML_TYPED_VALUES_MAX_LENGTH || !(IS_DIGIT(data[0]) || data[0] == '-'))
+    return 0;
+
+  if (parseNumber(data, length, &number, &scale))
+    {
+      hist = findHistory(key);
+
+      if (!scale)
+	{
+	  code[0] = Integer;
+	  len = 1 + putNumber(code + 1, number - hist->integer);
+	  hist->integer = number;
+	}
+      else
+	{
+	  code[0] = Decimal;
+	  len = 1 + putNumber(code + 1, number - hist->mantissa);
+	  //the scale is never negative, but it is coded the same way
+	  len += putNumber(code + len, scale);
+	  hist->mantissa = number;
+	}
+
+      return len;
+    }
+
+  if (parseDate(data, length, &number, &second, &dateType))
+    {
+      hist = findHistory(key);
+
+      code[0] = dateType;
+      len = 1 + putNumber(code + 1, number - hist->day);
+      hist->day = number;
+
+      if (dateType != Date)
+	{
+	  len += putNumber(code + len, second - hist->second);
+	  hist->second = second;
+	}
+
+      return len;
+    }
+
+  return 0;
+}
+
+
+
+/*!
+  Prepares the decoding of the binary form of a value. The symbols of the form are then passed to decodeSymbol().
+
+  \param key The key of the path of the value.
+ */
+void XmlTypedValues::startDecoding(unsigned long key)
+{
+  history = findHistory(key);
+  type = 0;
+  nrFields = 0;
+  shift = 0;
+  fields[0] = fields[1] = 0;
+}
+
+
+
+/*!
+  Reads one symbol of the binary form of the value.
+
+  \param symbol The symbol.
+  \retval true The value is complete and can be obtained by format().
+  \retval false More symbols are needed.
+ */
+bool XmlTypedValues::decodeSymbol(XmlChar symbol)
+{
+  unsigned char sym = (unsigned char)symbol;
+  int nrNeeded;
+
+  if (!type)
+    {
+      if (sym < Integer || sym > DateTimeUTC)
+	FATAL("Unknown type of a typed value: " << (int)sym);
+
+      type = sym;
+      return false;
+    }
+
+  if (shift >= 32)
+    FATAL("Typed value too large");
+
+  fields[nrFields] |= (unsigned long)(sym & 0x7f) << shift;
+
+  if (sym & 0x80)
+    {
+      //more bytes follow
+      shift += 7;
+      return false;
+    }
+
+  nrFields++;
+  shift = 0;
+
+  nrNeeded = (type == Integer || type == Date) ? 1 : 2;
+
+  return nrFields == nrNeeded;
+}
+
+
+
+/*!
+  Reconstructs the lexical form of the decoded value and updates the history of the path.
+
+  \param data The buffer for the lexical form (at least XML_TYPED_VALUES_MAX_LENGTH characters long). The form is not terminated.
+  \return The length of the lexical form.
+ */
+size_t XmlTypedValues::format(XmlChar *data)
+{
+  long delta[XML_TYPED_VALUES_MAX_FIELDS];
+  long year, month, day, number;
+  size_t len = 0;
+  int scale;
+  XmlChar digits[XML_TYPED_VALUES_MAX_DIGITS + 1];
+  size_t nrDigits;
+
+  CHECK_POINTER(history);
+
+  //map the unsigned numbers back to the signed differences
+  for (int f = 0; f < nrFields; f++)
+    delta[f] = (fields[f] & 1) ? -(long)(fields[f] >> 1) - 1 : (long)(fields[f] >> 1);
+
+  switch (type)
+    {
+    case Integer:
+    case Decimal:
+      if (type == Integer)
+	{
+	  number = history->integer += delta[0];
+	  scale = 0;
+	}
+      else
+	{
+	  number = history->mantissa += delta[0];
+	  scale = (int)delta[1];
+
+	  if (scale < 1 || scale >= XML_TYPED_VALUES_MAX_DIGITS)
+	    FATAL("Invalid scale of a decimal value: " << scale);
+	}
+
+      if (number < 0)
+	{
+	  data[len++] = '-';
+	  number = -number;
+	}
+
+      nrDigits = putDigits(digits, number, scale + 1);
+
+      for (size_t d = 0; d < nrDigits; d++)
+	{
+	  if (scale && d == nrDigits - scale)
+	    data[len++] = '.';
+
+	  data[len++] = digits[d];
+	}
+      break;
+
+    default:
+      history->day += delta[0];
+      civilFromDays(history->day, &year, &month, &day);
+
+      len += putDigits(data + len, year, 4);
+      data[len++] = '-';
+      len += putDigits(data + len, month, 2);
+      data[len++] = '-';
+      len += putDigits(data + len, day, 2);
+
+      if (type != Date)
+	{
+	  history->second += delta[1];
+
+	  data[len++] = 'T';
+	  len += putDigits(data + len, history->second / 3600, 2);
+	  data[len++] = ':';
+	  len += putDigits(data + len, history->second / 60 % 60, 2);
+	  data[len++] = ':';
+	  len += putDigits(data + len, history->second % 60, 2);
+
+	  if (type == DateTimeUTC)
+	    data[len++] = 'Z';
+	}
+    }
+
+  type = 0;
+  history = 0;
+
+  return len;
+}
+
+
+
+/*!
+  The history of a new path starts with zeros.
+
+  \param key The key of the path.
+  \return The history of the path.
+ */
+XmlTypedValueHistory *XmlTypedValues::findHistory(unsigned long key)
+{
+  XmlTypedValueHistory *hist;
+
+  if (!(hist = histories->find(key)))
+    {
+      NEW(hist, XmlTypedValueHistory);
+      hist->integer = 0;
+      hist->mantissa = 0;
+      hist->day = 0;
+      hist->second = 0;
+
+      histories->insert(key, hist);
+      historyList->append(hist);
+    }
+
+  return hist;
+}
+
+
+
+/*!
+  Recognizes the integers and the decimal numbers in the canonical form: an optional minus sign, no leading zeros, at least one fraction digit if the decimal point is present, and at most XML_TYPED_VALUES_MAX_DIGITS digits. The negative zero is not recognized, since its sign would be lost.
+
+  \param data The value.
+  \param length The length of the value.
+  \param number The digits of the value without the decimal point.
+  \param scale The number of the fraction digits.
+  \retval true The value is a number.
+  \retval false The value is not a number.
+ */
+bool XmlTypedValues::parseNumber(const XmlChar *data, size_t length, long *number, int *scale)
+{
+  size_t i = 0;
+  size_t nrDigits = 0;
+  bool negative = false;
+  long value = 0;
+
+  *scale = 0;
+
+  if (data[0] == '-')
+    {
+      negative = true;
+      i++;
+    }
+
+  if (i == length || !IS_DIGIT(data[i]) || (data[i] == '0' && i + 1 < length && data[i + 1] != '.'))
+    return false;
+
+  for (; i < length && IS_DIGIT(data[i]); i++, nrDigits++)
+    value = value * 10 + DIGIT_VALUE(data[i]);
+
+  if (i < length)
+    {
+      if (data[i] != '.' || i + 1 == length)
+	return false;
+
+      for (i++; i < length && IS_DIGIT(data[i]); i++, nrDigits++, (*scale)++)
+	value = value * 10 + DIGIT_VALUE(data[i]);
+
+      if (i < length)
+	return false;
+    }
+
+  if (nrDigits > XML_TYPED_VALUES_MAX_DIGITS || (negative && !value))
+    return false;
+
+  *number = negative ? -value : value;
+  return true;
+}
+
+
+
+/*!
+  Recognizes the dates (YYYY-MM-DD) and the dates with time (YYYY-MM-DDThh:mm:ss, optionally followed by Z) with valid days and times.
+
+  \param data The value.
+  \param length The length of the value.
+  \param day The number of the day.
+  \param second The second of the day.
+  \param type The type of the value.
+  \retval true The value is a date.
+  \retval false The value is not a date.
+ */
+bool XmlTypedValues::parseDate(const XmlChar *data, size_t length, long *day, long *second, int *type)
+{
+  //the positions of the separators and the digits
+  static const char dateTimePattern[] = "dddd-dd-ddTdd:dd:ddZ";
+  static const int daysInMonth[] = { 31, 29, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+  long year, month, mday, hours, minutes, seconds;
+
+  switch (length)
+    {
+    case 10:
+      *type = Date;
+      break;
+
+    case 19:
+      *type = DateTime;
+      break;
+
+    case 20:
+      *type = DateTimeUTC;
+      break;
+
+    default:
+      return false;
+    }
+
+  for (size_t i = 0; i < length; i++)
+    {
+      if (dateTimePattern[i] == 'd')
+	{
+	  if (!IS_DIGIT(data[i]))
+	    return false;
+	}
+      else
+	if (data[i] != dateTimePattern[i])
+	  return false;
+    }
+
+  year = DIGIT_VALUE(data[0]) * 1000 + DIGIT_VALUE(data[1]) * 100 + DIGIT_VALUE(data[2]) * 10 + DIGIT_VALUE(data[3]);
+  month = DIGIT_VALUE(data[5]) * 10 + DIGIT_VALUE(data[6]);
+  mday = DIGIT_VALUE(data[8]) * 10 + DIGIT_VALUE(data[9]);
+
+  if (!year || month < 1 || month > 12 || mday < 1 || mday > daysInMonth[month - 1])
+    return false;
+
+  if (month == 2 && mday == 29 && !(year % 4 == 0 && (year % 100 != 0 || year % 400 == 0)))
+    return false;
+
+  *day = daysFromCivil(year, month, mday);
+
+  if (*type != Date)
+    {
+      hours = DIGIT_VALUE(data[11]) * 10 + DIGIT_VALUE(data[12]);
+      minutes = DIGIT_VALUE(data[14]) * 10 + DIGIT_VALUE(data[15]);
+      seconds = DIGIT_VALUE(data[17]) * 10 + DIGIT_VALUE(data[18]);
+
+      if (hours > 23 || minutes > 59 || seconds > 59)
+	return false;
+
+      *second = hours * 3600 + minutes * 60 + seconds;
+    }
+
+  return true;
+}
+
+
+
+/*!
+  Uses the proleptic Gregorian calendar, the day 0 is 1970-01-01.
+
+  \param year The year.
+  \param month The month (1-12).
+  \param day The day of the month (1-31).
+  \return The number of the day.
+ */
+long XmlTypedValues::daysFromCivil(long year, long month, long day)
+{
+  long era, yearOfEra, dayOfYear, dayOfEra;
+
+  //the years start in March, so the leap day is the last day of the year
+  if (month <= 2)
+    year--;
+
+  era = (year >= 0 ? year : year - 399) / 400;
+  yearOfEra = year - era * 400;
+  dayOfYear = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;
+  dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+
+  return era * 146097 + dayOfEra - 719468;
+}
+
+
+
+/*!
+  The inverse of daysFromCivil().
+
+  \param days The number of the day.
+  \param year The year.
+  \param month The month (1-12).
+  \param day The day of the month (1-31).
+ */
+void XmlTypedValues::civilFromDays(long days, long *year, long *month, long *day)
+{
+  long era, dayOfEra, yearOfEra, dayOfYear, mp;
+
+  days += 719468;
+  era = (days >= 0 ? days : days - 146096) / 146097;
+  dayOfEra = days - era * 146097;
+  yearOfEra = (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146096) / 365;
+  dayOfYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+  mp = (5 * dayOfYear + 2) / 153;
+
+  *day = dayOfYear - (153 * mp + 2) / 5 + 1;
+  *month = mp < 10 ? mp + 3 : mp - 9;
+  *year = yearOfEra + era * 400 + (*month <= 2 ? 1 : 0);
+}
+
+
+
+/*!
+  The number is mapped to an unsigned number (0, -1, 1, -2, ... to 0, 1, 2, 3, ...) which is written in 7-bit groups, the least significant first. The highest bit of the byte indicates that more bytes follow.
+
+  \param code The output buffer.
+  \param number The number.
+  \return The number of written bytes.
+ */
+size_t XmlTypedValues::putNumber(XmlChar *code, long number)
+{
+  unsigned long value;
+  size_t len = 0;
+
+  if (number >= 0)
+    value = (unsigned long)number << 1;
+  else
+    value = ((unsigned long)(-(number + 1)) << 1) | 1;
+
+  while (value >= 0x80)
+    {
+      code[len++] = (XmlChar)((value & 0x7f) | 0x80);
+      value >>= 7;
+    }
+
+  code[len++] = (XmlChar)value;
+
+  return len;
+}
+
+
+
+/*!
+  \param data The output buffer.
+  \param number The number.
+  \param minDigits The minimal number of digits (the number is padded with leading zeros).
+  \return The number of written digits.
+ */
+size_t XmlTypedValues::putDigits(XmlChar *data, unsigned long number, int minDigits)
+{
+  XmlChar digits[XML_TYPED_VALUES_MAX_DIGITS + 1];
+  int nrDigits = 0;
+
+  do
+    {
+      digits[nrDigits++] = '0' + (XmlChar)(number % 10);
+      number /= 10;
+    }
+  while (number && nrDigits <= XML_TYPED_VALUES_MAX_DIGITS);
+
+  while (nrDigits < minDigits && nrDigits <= XML_TYPED_VALUES_MAX_DIGITS)
+    digits[nrDigits++] = '0';
+
+  for (int d = 0; d < nrDigits; d++)
+    data[d] = digits[nrDigits - 1 - d];
+
+  return nrDigits;
+}
@@ -0,0 +1,196 @@
+/***************************************************************************
+    xmltypedvalues.h  -  Definition of XmlTypedValues class.
+                             -------------------
+    begin                : October 19 2026
+    copyright            : (C) 2003 by Vojtch Toman
+    email                : vtoman@lit.cz
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+
+
+/*!
+  \file xmltypedvalues.h
+  \brief Definition of XmlTypedValues class.
+  
+  This file contains the definition of XmlTypedValues class.
+*/
+
+#ifdef __GNUG__
+# pragma interface
+#endif
+
+#ifndef XMLTYPEDVALUES_H
+#define XMLTYPEDVALUES_H
+
+
+#include "defs.h"
+#include "hashtable.h"
+#include "list.h"
+#include "xmlchar.h"
+
+
+
+/*!
+  \brief The maximal number of digits of the integer and decimal values.
+
+  The values with more digits are coded as text, so the numbers always fit in a long.
+ */
+#define XML_TYPED_VALUES_MAX_DIGITS	9
+
+
+/*!
+  \brief The maximal length of the lexical form of a typed value.
+
+  The longest form is the date and time with the time zone designator (YYYY-MM-DDThh:mm:ssZ).
+ */
+#define XML_TYPED_VALUES_MAX_LENGTH	20
+
+
+/*!
+  \brief The maximal number of symbols of the binary form of a typed value.
+
+  The type, and at most two numbers of at most 5 bytes each.
+ */
+#define XML_TYPED_VALUES_MAX_CODE_LENGTH	11
+
+
+/*!
+  \brief The maximal number of numbers following the type.
+ */
+#define XML_TYPED_VALUES_MAX_FIELDS	2
+
+
+
+/*!
+  \brief The previous values of one path.
+
+  The new values are coded as the differences from these values.
+ */
+struct XmlTypedValueHistory
+{
+  //! The previous integer value.
+  long integer;
+
+  //! The mantissa of the previous decimal value.
+  long mantissa;
+
+  //! The day of the previous date (or date and time).
+  long day;
+
+  //! The second of the day of the previous date and time.
+  long second;
+};
+
+
+//! Hashtable of the histories of the paths.
+typedef HashTable<unsigned long, XmlTypedValueHistory, List, 257> XmlTypedValueTable;
+
+
+
+/*!
+  \brief A coder of the numeric and date values.
+
+  The character data and the attribute values which are integers, decimal numbers, or ISO 8601 dates (YYYY-MM-DD) and dates with time (YYYY-MM-DDThh:mm:ss, optionally followed by Z) are coded in a binary form instead of the text: the type of the value followed by the numbers of the value. Each number is coded as the difference from the previous value of the same type in the same path (the path is given by the key chosen by the model), so the increasing ids and timestamps cost a few bits.
+
+  The numbers are stored in the variable-length form: 7 bits per byte, least significant first, the highest bit indicates that more bytes follow. The signed differences are mapped to unsigned numbers (0, -1, 1, -2, ... to 0, 1, 2, 3, ...).
+
+  Only the values in the canonical lexical form are recognized (e.g. no leading zeros or plus signs), so the decoded text is always identical to the original.
+
+  \sa XmlSimpleModel
+ */
+class XmlTypedValues
+{
+public:
+  //! The types of the values.
+  enum ValueType
+  {
+    //! An integer.
+    Integer = 1,
+
+    //! A decimal number (followed by the number of the fraction digits).
+    Decimal,
+
+    //! A date.
+    Date,
+
+    //! A date and time.
+    DateTime,
+
+    //! A date and time in UTC (with the Z designator).
+    DateTimeUTC
+  };
+
+  //! A constructor.
+  XmlTypedValues(void);
+
+  //! A destructor.
+  virtual ~XmlTypedValues(void);
+
+  //! Encode the value (if it is a typed value).
+  virtual size_t encode(unsigned long key, const XmlChar *data, size_t length, XmlChar *code);
+
+  //! Start the decoding of a value.
+  virtual void startDecoding(unsigned long key);
+
+  //! Decode one symbol of the binary form.
+  virtual bool decodeSymbol(XmlChar symbol);
+
+  //! Write the lexical form of the decoded value.
+  virtual size_t format(XmlChar *data);
+
+protected:
+  //! The histories of the paths.
+  XmlTypedValueTable *histories;
+
+  //! The list of the histories (for the deletion).
+  List<XmlTypedValueHistory> *historyList;
+
+  //! The history of the decoded value.
+  XmlTypedValueHistory *history;
+
+  //! The type of the decoded value (0 if not read yet).
+  int type;
+
+  //! The numbers of the decoded value.
+  unsigned long fields[XML_TYPED_VALUES_MAX_FIELDS];
+
+  //! The number of completely decoded numbers.
+  int nrFields;
+
+  //! The shift of the next 7 bits of the decoded number.
+  int shift;
+
+  //! Find (or create) the history of the path.
+  virtual XmlTypedValueHistory *findHistory(unsigned long key);
+
+  //! Parse a number.
+  static bool parseNumber(const XmlChar *data, size_t length, long *number, int *scale);
+
+  //! Parse a date (and time).
+  static bool parseDate(const XmlChar *data, size_t length, long *day, long *second, int *type);
+
+  //! Convert the date to the number of days.
+  static long daysFromCivil(long year, long month, long day);
+
+  //! Convert the number of days to the date.
+  static void civilFromDays(long days, long *year, long *month, long *day);
+
+  //! Append a signed number in the variable-length form.
+  static size_t putNumber(XmlChar *code, long number);
+
+  //! Write the decimal digits of the number.
+  static size_t putDigits(XmlChar *data, unsigned long number, int minDigits);
+};
+
+
+
+#endif //XMLTYPEDVALUES_H
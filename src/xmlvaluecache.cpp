@@ -0,0 +1,175 @@
+/***************************************************************************
+    xmlvaluecache.cpp  -  Definitions of XmlValueCache class methods.
+                             -------------------
+    begin                : October 19 2026
+    copyright            : (C) 2003 by Vojtch Toman
+    email                : vtoman@lit.cz
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+
+
+/*!
+  \file xmlvaluecache.cpp
+  \brief Definitions of XmlValueCache class methods.
+  
+  This file contains the definitions of XmlValueCache class methods.
+*/
+
+#ifdef __GNUG__
+# pragma implementation
+#endif
+
+
+#include <cstring>	//for memcpy(), memcmp()
+
+#include "xmlvaluecache.h"
+
+
+
+/*!
+  Creates an empty cache.
+ */
+XmlValueCache::XmlValueCache(void)
+{
+  NEW(entries, XmlValueCacheTable);
+  NEW(entryList, List<XmlValueCacheEntry>);
+}
+
+
+
+/*!
+  Deletes the remembered values.
+ */
+XmlValueCache::~XmlValueCache(void)
+{
+  XmlValueCacheEntry *entry;
+
+  for (entry = entryList->first(); entry; entry = entryList->next())
+    {
+      for (size_t i = 0; i < entry->count; i++)
+	DELETE_ARRAY(entry->values[i]);
+
+      DELETE(entry);
+    }
+
+  DELETE(entries);
+  DELETE(entryList);
+}
+
+
+
+/*!
+  The cache is not changed, see update().
+
+  \param key The key of the path.
+  \param data The value.
+  \param length The length of the value.
+  \return The index of the value, or -1 if the value is not in the cache.
+ */
+int XmlValueCache::find(unsigned long key, const XmlChar *data, size_t length)
+{
+  XmlValueCacheEntry *entry;
+
+  if (!length || length > XML_VALUE_CACHE_MAX_LENGTH || !(entry = entries->find(key)))
+    return -1;
+
+  for (size_t i = 0; i < entry->count; i++)
+    {
+      if (entry->lengths[i] == length && !memcmp(entry->values[i], data, length * sizeof(XmlChar)))
+	return i;
+    }
+
+  return -1;
+}
+
+
+
+/*!
+  The cache is not changed, see update().
+
+  \param key The key of the path.
+  \param index The index of the value.
+  \param length The length of the value.
+  \return The value (not terminated by zero), or NULL if the index is invalid.
+ */
+const XmlChar *XmlValueCache::value(unsigned long key, size_t index, size_t *length)
+{
+  XmlValueCacheEntry *entry;
+
+  if (!(entry = entries->find(key)) || index >= entry->count)
+    return 0;
+
+  *length = entry->lengths[index];
+  return entry->values[index];
+}
+
+
+
+/*!
+  The value is moved (or inserted) to the front of the cache of the path. The empty values and the values longer than XML_VALUE_CACHE_MAX_LENGTH are ignored.
+
+  \param key The key of the path.
+  \param data The value.
+  \param length The length of the value.
+ */
+void XmlValueCache::update(unsigned long key, const XmlChar *data, size_t length)
+{
+  XmlValueCacheEntry *entry;
+  XmlChar *front;
+  size_t frontLength;
+  size_t i;
+  int index;
+
+  if (!length || length > XML_VALUE_CACHE_MAX_LENGTH)
+    return;
+
+  if (!(entry = entries->find(key)))
+    {
+      NEW(entry, XmlValueCacheEntry);
+      entry->count = 0;
+
+      entries->insert(key, entry);
+      entryList->append(entry);
+    }
+
+  if ((index = find(key, data, length)) >= 0)
+    {
+      //known value --> move it to the front
+      front = entry->values[index];
+      frontLength = entry->lengths[index];
+      i = index;
+    }
+  else
+    {
+      //new value --> forget the least recently used value if the cache is full
+      if (entry->count == XML_VALUE_CACHE_SIZE)
+	{
+	  entry->count--;
+	  DELETE_ARRAY(entry->values[entry->count]);
+	}
+
+      NEW(front, XmlChar[length]);
+      memcpy(front, data, length * sizeof(XmlChar));
+      frontLength = length;
+      i = entry->count;
+      entry->count++;
+    }
+
+  for (; i > 0; i--)
+    {
+      entry->values[i] = entry->values[i - 1];
+      entry->lengths[i] = entry->lengths[i - 1];
+    }
+
+  entry->values[0] = front;
+  entry->lengths[0] = frontLength;
+}
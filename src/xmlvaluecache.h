@@ -0,0 +1,125 @@
+/***************************************************************************
+    xmlvaluecache.h  -  Definition of XmlValueCache class.
+                             -------------------
+    begin                : October 19 2026
+    copyright            : (C) 2003 by Vojtch Toman
+    email                : vtoman@lit.cz
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+
+
+/*!
+  \file xmlvaluecache.h
+  \brief Definition of XmlValueCache class.
+  
+  This file contains the definition of XmlValueCache class.
+*/
+
+#ifdef __GNUG__
+# pragma interface
+#endif
+
+#ifndef XMLVALUECACHE_H
+#define XMLVALUECACHE_H
+
+
+#include "defs.h"
+#include "hashtable.h"
+#include "list.h"
+#include "xmlchar.h"
+
+
+
+/*!
+  \brief The number of values remembered for each path.
+
+  The index of a value is coded by one symbol, so the size must not exceed 256 - XML_VALUE_CACHE_FIRST_INDEX_SYMBOL.
+ */
+#define XML_VALUE_CACHE_SIZE		32
+
+
+/*!
+  \brief The maximal length of a remembered value.
+
+  The longer values are always coded as text. The length must be smaller than the size of the buffer of the model (see XML_MODEL_BUFFER_DEFAULT_SIZE).
+ */
+#define XML_VALUE_CACHE_MAX_LENGTH	64
+
+
+/*!
+  \brief The symbol that codes the index 0.
+
+  The index \a i is coded by the symbol XML_VALUE_CACHE_FIRST_INDEX_SYMBOL + \a i, so the indices are never mistaken for structural symbols.
+ */
+#define XML_VALUE_CACHE_FIRST_INDEX_SYMBOL	9
+
+
+
+/*!
+  \brief The remembered values of one path.
+ */
+struct XmlValueCacheEntry
+{
+  //! The values, the most recently used first.
+  XmlChar *values[XML_VALUE_CACHE_SIZE];
+
+  //! The lengths of the values.
+  size_t lengths[XML_VALUE_CACHE_SIZE];
+
+  //! The number of the values.
+  size_t count;
+};
+
+
+//! Hashtable of the remembered values of the paths.
+typedef HashTable<unsigned long, XmlValueCacheEntry, List, 257> XmlValueCacheTable;
+
+
+
+/*!
+  \brief A cache of the recently used values of each path.
+
+  The cache remembers the last XML_VALUE_CACHE_SIZE different values of each path (the path is given by the key chosen by the model) in the move-to-front order: a used value is moved to the front of the list, a new value is inserted at the front and the least recently used value is forgotten. A value that is in the cache can be coded by its index, which is small for the values repeating often.
+
+  Both the encoder and the decoder call update() with every complete value of the path, so the contents of their caches are always the same.
+
+  \sa XmlAdaptiveModel
+ */
+class XmlValueCache
+{
+public:
+  //! A constructor.
+  XmlValueCache(void);
+
+  //! A destructor.
+  virtual ~XmlValueCache(void);
+
+  //! Find the value in the cache.
+  virtual int find(unsigned long key, const XmlChar *data, size_t length);
+
+  //! Get the value with given index.
+  virtual const XmlChar *value(unsigned long key, size_t index, size_t *length);
+
+  //! Move the value to the front of the cache.
+  virtual void update(unsigned long key, const XmlChar *data, size_t length);
+
+protected:
+  //! The remembered values of the paths.
+  XmlValueCacheTable *entries;
+
+  //! The list of the entries (for the deletion).
+  List<XmlValueCacheEntry> *entryList;
+};
+
+
+
+#endif //XMLVALUECACHE_H
@@ -0,0 +1,212 @@
+/***************************************************************************
+    xmlwordtokens.cpp  -  Definitions of XmlWordTokens class methods.
+                             -------------------
+    begin                : October 19 2026
+    copyright            : (C) 2003 by Vojtch Toman
+    email                : vtoman@lit.cz
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+
+
+/*!
+  \file xmlwordtokens.cpp
+  \brief Definitions of XmlWordTokens class methods.
+  
+  This file contains the definitions of XmlWordTokens class methods.
+*/
+
+#ifdef __GNUG__
+# pragma implementation
+#endif
+
+
+#include <cstring>	//for memcpy(), memcmp()
+
+#include "xmlwordtokens.h"
+
+
+
+/*!
+  Creates an empty dictionary.
+ */
+XmlWordTokens::XmlWordTokens(void)
+{
+  NEW(table, XmlWordTable);
+
+  capacity = 1024;
+  NEW(words, XmlWord *[capacity]);
+  count = 0;
+
+  pendingLength = 0;
+  pendingTooLong = false;
+}
+
+
+
+/*!
+  Deletes the words.
+ */
+XmlWordTokens::~XmlWordTokens(void)
+{
+  for (size_t i = 0; i < count; i++)
+    {
+      DELETE_ARRAY(words[i]->text);
+      DELETE(words[i]);
+    }
+
+  DELETE_ARRAY(words);
+  DELETE(table);
+}
+
+
+
+/*!
+  \param data The characters of the word.
+  \param length The length of the word.
+  \return The id of the word, or -1 if the word is not in the dictionary.
+ */
+long XmlWordTokens::find(const XmlChar *data, size_t length)
+{
+  XmlWord *word;
+
+  for (word = table->find(hash(data, length)); word; word = word->next)
+    {
+      if (word->length == length && !memcmp(word->text, data, length * sizeof(XmlChar)))
+	return word->id;
+    }
+
+  return -1;
+}
+
+
+
+/*!
+  The word gets the next free id. The words whose length is out of the range from XML_WORD_TOKENS_MIN_LENGTH to XML_WORD_TOKENS_MAX_LENGTH are ignored, as well as all words when the dictionary is full. The word must not be in the dictionary.
+
+  \param data The characters of the word.
+  \param length The length of the word.
+ */
+void XmlWordTokens::insert(const XmlChar *data, size_t length)
+{
+  XmlWord *word;
+  XmlWord *sameHash;
+  unsigned long key;
+
+  if (length < XML_WORD_TOKENS_MIN_LENGTH || length > XML_WORD_TOKENS_MAX_LENGTH || count == XML_WORD_TOKENS_MAX_WORDS)
+    return;
+
+  if (count == capacity)
+    {
+      //the array of the words is full --> enlarge it
+      XmlWord **newWords;
+
+      NEW(newWords, XmlWord *[2 * capacity]);
+      memcpy(newWords, words, count * sizeof(XmlWord *));
+      DELETE_ARRAY(words);
+
+      words = newWords;
+      capacity *= 2;
+    }
+
+  NEW(word, XmlWord);
+  NEW(word->text, XmlChar[length]);
+  memcpy(word->text, data, length * sizeof(XmlChar));
+  word->length = length;
+  word->id = count;
+  word->next = 0;
+
+  key = hash(data, length);
+
+  if ((sameHash = table->find(key)))
+    {
+      //another word has the same hash --> chain the words
+      word->next = sameHash->next;
+      sameHash->next = word;
+    }
+  else
+    table->insert(key, word);
+
+  words[count] = word;
+  count++;
+}
+
+
+
+/*!
+  \param id The id of the word.
+  \param length The length of the word.
+  \return The characters of the word (not terminated by zero), or NULL if the id is invalid.
+ */
+const XmlChar *XmlWordTokens::word(unsigned long id, size_t *length)
+{
+  if (id >= count)
+    return 0;
+
+  *length = words[id]->length;
+  return words[id]->text;
+}
+
+
+
+/*!
+  Each word ended by a character which is not a part of a word is inserted into the dictionary (unless it is already there). The last word of the data is kept, since it may continue in the next call.
+
+  \param data The decoded character data.
+  \param length The length of the data.
+ */
+void XmlWordTokens::learn(const XmlChar *data, size_t length)
+{
+  for (size_t i = 0; i < length; i++)
+    {
+      if (IS_WORD_CHARACTER(data[i]))
+	{
+	  if (pendingLength < XML_WORD_TOKENS_MAX_LENGTH)
+	    pending[pendingLength++] = data[i];
+	  else
+	    pendingTooLong = true;
+	}
+      else
+	if (pendingLength)
+	  finishText();
+    }
+}
+
+
+
+/*!
+  Called at the end of each block of the decoded character data.
+ */
+void XmlWordTokens::finishText(void)
+{
+  if (!pendingTooLong && pendingLength >= XML_WORD_TOKENS_MIN_LENGTH && find(pending, pendingLength) < 0)
+    insert(pending, pendingLength);
+
+  pendingLength = 0;
+  pendingTooLong = false;
+}
+
+
+
+/*!
+  \param data The characters of the word.
+  \param length The length of the word.
+  \return The hash of the word.
+ */
+unsigned long XmlWordTokens::hash(const XmlChar *data, size_t length)
+{
+  unsigned long h = 0;
+
+  for (size_t i = 0; i < length; i++)
+    h = 5 * h + data[i];
+
+  return h;
+}
@@ -0,0 +1,164 @@
+/***************************************************************************
+    xmlwordtokens.h  -  Definition of XmlWordTokens class.
+                             -------------------
+    begin                : October 19 2026
+    copyright            : (C) 2003 by Vojtch Toman
+    email                : vtoman@lit.cz
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+
+
+/*!
+  \file xmlwordtokens.h
+  \brief Definition of XmlWordTokens class.
+  
+  This file contains the definition of XmlWordTokens class.
+*/
+
+#ifdef __GNUG__
+# pragma interface
+#endif
+
+#ifndef XMLWORDTOKENS_H
+#define XMLWORDTOKENS_H
+
+
+#include "defs.h"
+#include "hashtable.h"
+#include "list.h"
+#include "xmlchar.h"
+
+
+
+/*!
+  \brief The minimal length of a word.
+
+  The shorter words are always coded as text, since their tokens wouldn't be shorter.
+ */
+#define XML_WORD_TOKENS_MIN_LENGTH	3
+
+
+/*!
+  \brief The maximal length of a word.
+
+  The longer words are always coded as text.
+ */
+#define XML_WORD_TOKENS_MAX_LENGTH	32
+
+
+/*!
+  \brief The maximal number of the words.
+
+  When the dictionary is full, the new words are no longer remembered.
+ */
+#define XML_WORD_TOKENS_MAX_WORDS	65536
+
+
+/*!
+  \brief Test whether the character is a part of a word.
+
+  The words consist of the ASCII letters and of the bytes of the multibyte characters.
+
+  \param _c_ The character.
+*/
+#define IS_WORD_CHARACTER(_c_)					\
+  (((_c_) >= 'a' && (_c_) <= 'z') || ((_c_) >= 'A' && (_c_) <= 'Z') ||	\
+   (unsigned char)(_c_) >= 0x80)
+
+
+
+/*!
+  \brief One word of the dictionary.
+ */
+struct XmlWord
+{
+  //! The characters of the word (not terminated by zero).
+  XmlChar *text;
+
+  //! The length of the word.
+  size_t length;
+
+  //! The id of the word.
+  unsigned long id;
+
+  //! The next word with the same hash.
+  XmlWord *next;
+};
+
+
+//! Hashtable of the words (keys are the hashes of the words).
+typedef HashTable<unsigned long, XmlWord, List, 4093> XmlWordTable;
+
+
+
+/*!
+  \brief An adaptive dictionary of the words of the character data.
+
+  The words (the maximal runs of the word characters, see IS_WORD_CHARACTER()) are numbered in the order of their first occurrence. A word which is already in the dictionary can be coded by its id, so the grammar gets one token instead of the characters of the word.
+
+  The encoder looks up and inserts the words of the character data by itself. The decoder passes all the decoded character data (but not the expanded tokens) to learn(); the words it hasn't seen are exactly the words the encoder has inserted, so the contents of both dictionaries are always the same.
+
+  \sa XmlSimpleModel
+ */
+class XmlWordTokens
+{
+public:
+  //! A constructor.
+  XmlWordTokens(void);
+
+  //! A destructor.
+  virtual ~XmlWordTokens(void);
+
+  //! Find the word in the dictionary.
+  virtual long find(const XmlChar *data, size_t length);
+
+  //! Insert the word into the dictionary.
+  virtual void insert(const XmlChar *data, size_t length);
+
+  //! Get the word with given id.
+  virtual const XmlChar *word(unsigned long id, size_t *length);
+
+  //! Learn the words of the decoded character data.
+  virtual void learn(const XmlChar *data, size_t length);
+
+  //! Finish the last word of the decoded character data.
+  virtual void finishText(void);
+
+protected:
+  //! The words of the dictionary.
+  XmlWordTable *table;
+
+  //! The words indexed by their ids.
+  XmlWord **words;
+
+  //! The number of the words.
+  size_t count;
+
+  //! The size of the \a words array.
+  size_t capacity;
+
+  //! The characters of the word being learned.
+  XmlChar pending[XML_WORD_TOKENS_MAX_LENGTH];
+
+  //! The number of the characters of the word being learned.
+  size_t pendingLength;
+
+  //! Indication whether the word being learned is too long to be remembered.
+  bool pendingTooLong;
+
+  //! Compute the hash of the word.
+  virtual unsigned long hash(const XmlChar *data, size_t length);
+};
+
+
+
+#endif //XMLWORDTOKENS_H